@@ -17,6 +17,24 @@ void UnregisterAPI(void);
 
 // Internal C API (used across translation units). Not part of stable external SDK yet.
 void API_WEBVIEW_Navigate(const char* url, const char* opts);
+int  API_WEBVIEW_Batch(const char* opsJson);
+bool API_WEBVIEW_GetInstanceInfo(const char* instanceId, char* bufOut, int bufOut_sz);
+bool API_WEBVIEW_GetStats(const char* instanceId, char* bufOut, int bufOut_sz);
+int  API_WEBVIEW_DumpStats(const char* path);
+int  API_WEBVIEW_ExecuteScript(const char* instanceId, const char* js, const char* opts);
+int  API_WEBVIEW_GetScriptResult(int handle, char* bufOut, int bufOut_sz);
+int  API_WEBVIEW_Capture(const char* instanceId, const char* path, const char* opts);
+int  API_WEBVIEW_GetCaptureResult(int handle, char* bufOut, int bufOut_sz);
+int  API_WEBVIEW_FindAll(const char* query, const char* opts);
+int  API_WEBVIEW_GetFindAllResult(int handle, char* bufOut, int bufOut_sz);
+bool API_WEBVIEW_FindAllJump(int handle, const char* instanceId, int index);
+// Shared float buffers (native callers only)
+float* API_WEBVIEW_SharedBufferLock(const char* instanceId, const char* name, int capacity);
+int    API_WEBVIEW_SharedBufferCommit(const char* instanceId, const char* name, int count);
+bool   API_WEBVIEW_SharedBufferWrite(const char* instanceId, const char* name, const float* data, int count);
+// Video frame source (native callers only)
+bool   API_WEBVIEW_VideoAttachProcessor(void* videoProcessor);
+bool   API_WEBVIEW_VideoPushFrame(const void* rgba, int width, int height, int rowspan);
 
 #ifdef __cplusplus
 } // extern "C"
@@ -7,9 +7,13 @@
 #include "globals.h"  // Struct declarations / extern globals
 #include "helpers.h"  // Utilities (strings, domain, tabs)
 #include "log.h"      // Logging
+#include "core/nav_options.h" // Typed single-pass opts parser
+#include "core/batch_ops.h"   // WEBVIEW_Batch parsing / per-instance coalescing
+#include "core/json_cursor.h" // WEBVIEW_ExecuteScript opts
+#include <algorithm>
 #ifdef _WIN32
 #include <shellapi.h>
-#else
+#elif defined(__APPLE__)
 #import <AppKit/AppKit.h>
 #endif
 
@@ -30,8 +34,8 @@ struct ApiRegistrationInfo {
   const char* argTypesCSV;   // "const char*,const char*"
   const char* argNamesCSV;   // "url,opts"
   const char* helpText;      // Multiline help text (ASCII/UTF-8 safe)
-  void (*cFunc)(const char*, const char*); // C-интерфейс (API_*)
-  void* (*varargFunc)(void**, int);        // ReaScript implementation (APIvararg_*)
+  void* cFunc;                // C-интерфейс (API_*), signature described by retType/argTypesCSV
+  void* (*varargFunc)(void**, int);        // ReaScript implementation (APIvararg_*); null = native-only (API_ only)
   const char* defCString;    // Ready null-delimited definition string (generated)
 };
 
@@ -40,13 +44,27 @@ static std::vector<std::unique_ptr<std::string>> g_api_def_storage; // Own stora
 
 // Forward vararg stubs
 static void* Vararg_WEBVIEW_Navigate(void** arglist, int numparms);
+static void* Vararg_WEBVIEW_Batch(void** arglist, int numparms);
+static void* Vararg_WEBVIEW_GetInstanceInfo(void** arglist, int numparms);
+static void* Vararg_WEBVIEW_GetStats(void** arglist, int numparms);
+static void* Vararg_WEBVIEW_DumpStats(void** arglist, int numparms);
+static void* Vararg_WEBVIEW_ExecuteScript(void** arglist, int numparms);
+static void* Vararg_WEBVIEW_GetScriptResult(void** arglist, int numparms);
+static void* Vararg_WEBVIEW_Capture(void** arglist, int numparms);
+static void* Vararg_WEBVIEW_GetCaptureResult(void** arglist, int numparms);
+static void* Vararg_WEBVIEW_FindAll(void** arglist, int numparms);
+static void* Vararg_WEBVIEW_GetFindAllResult(void** arglist, int numparms);
+static void* Vararg_WEBVIEW_FindAllJump(void** arglist, int numparms);
 
 // ------------------------------------------------------------------
 // Actual API function implementations
 // ------------------------------------------------------------------
 
-// Single entry point: url + JSON options or "0"
-void API_WEBVIEW_Navigate(const char* url, const char* opts)
+// Shared body of WEBVIEW_Navigate and each WEBVIEW_Batch op. refreshTitles=false leaves the
+// title/layout/dock refresh to the caller (batch does one per affected instance at the end).
+static WebViewInstanceRecord* ApplyNavigate(const char* url, const std::string& newTitle, const std::string& newInstance,
+                                            ShowPanelMode newShow, bool newBasicCtx, const std::string* newFilter,
+                                            bool refreshTitles)
 {
   // Normalize URL (or decide external dispatch) BEFORE any instance creation.
   std::string normUrl; std::string externalUrl; std::string normReason;
@@ -57,8 +75,10 @@ void API_WEBVIEW_Navigate(const char* url, const char* opts)
 #ifdef _WIN32
   // Use ANSI variant to avoid wide-char conversion boilerplate (externalUrl is UTF-8 but ShellExecuteA will treat as ANSI; acceptable for typical ASCII schemes/hosts). TODO: if full UTF-8 needed, convert to wide and use ShellExecuteW.
   ShellExecuteA(NULL, "open", externalUrl.c_str(), NULL, NULL, SW_SHOWNORMAL);
-#else
+#elif defined(__APPLE__)
       @autoreleasepool { NSString* s=[NSString stringWithUTF8String:externalUrl.c_str()]; if(s) [[NSWorkspace sharedWorkspace] openURL:[NSURL URLWithString:s]]; }
+#else
+      ShellExecute(NULL, "open", externalUrl.c_str(), NULL, NULL, SW_SHOWNORMAL); // SWELL -> xdg-open
 #endif
       LogF("[URL][DispatchExternal][API] original='%s' reason='%s'", url, normReason.c_str());
       url = nullptr; // prevent navigation below
@@ -70,20 +90,6 @@ void API_WEBVIEW_Navigate(const char* url, const char* opts)
       url = nullptr; // invalid
     }
   }
-  // Parse options (without immediate application to globals)
-  std::string newTitle;
-  std::string newInstance;
-  ShowPanelMode newShow = ShowPanelMode::Unset;
-  bool newBasicCtx = false;
-  if (is_truthy(opts)) {
-    newTitle    = GetJsonString(opts, "SetTitle");
-    newInstance = GetJsonString(opts, "InstanceId");
-    newShow     = ParseShowPanel(GetJsonString(opts, "ShowPanel"));
-    // BasicCtxMenu: any truthy => enable basic context menu
-    std::string bcm = GetJsonString(opts, "BasicCtxMenu");
-    if (!bcm.empty()) newBasicCtx = is_truthy(bcm.c_str());
-  }
-
   // --- Multi-instance resolution ---
   // InstanceId rules:
   //   "" (missing) -> wv_default
@@ -104,25 +110,273 @@ void API_WEBVIEW_Navigate(const char* url, const char* opts)
   std::string oldTitle = before ? before->titleOverride : std::string();
   auto* rec = EnsureInstanceAndMaybeNavigate(normalizedId, url?url:std::string(), (url&&*url), newTitle, newShow);
   if (rec && newBasicCtx) rec->basicCtxMenu = true;
+  if (rec && newFilter) SetInstanceContentFilter(rec, *newFilter);
   g_instanceId = normalizedId; // active id
 
   // Global fields no longer authoritative (kept for legacy docker code paths)
   if (rec && rec->wantDockOnCreate >= 0) g_want_dock_on_create = rec->wantDockOnCreate;
 
   // Log call parameters
-  LogF("[API] WEBVIEW_Navigate url='%s' opts='%s' SetTitle='%s' InstanceIdRaw='%s' norm='%s' wasRandom=%d ShowPanel=%d", 
-    url?url:"", opts?opts:"", newTitle.c_str(), newInstance.c_str(), normalizedId.c_str(), (int)wasRandom, (int)newShow);
+  LogF("[API] Navigate url='%s' SetTitle='%s' InstanceIdRaw='%s' norm='%s' wasRandom=%d ShowPanel=%d", 
+    url?url:"", newTitle.c_str(), newInstance.c_str(), normalizedId.c_str(), (int)wasRandom, (int)newShow);
 
   // Proceed to per-instance open (may reuse single window for now)
-  OpenOrActivateInstance(g_instanceId, url?std::string(url):std::string());
+  OpenOrActivateInstance(g_instanceId, url?std::string(url):std::string(), refreshTitles);
 
+  if (rec && rec->hwnd && !newTitle.empty() && newTitle != oldTitle) {
+    LogF("[TitleChange] instance='%s' '%s' -> '%s' (updating docker tab)", normalizedId.c_str(), oldTitle.c_str(), rec->titleOverride.c_str());
+  }
   // Update titles (using hwnd of matched instance)
-  if (rec && rec->hwnd) {
-    if (!newTitle.empty() && newTitle != oldTitle) {
-      LogF("[TitleChange] instance='%s' '%s' -> '%s' (updating docker tab)", normalizedId.c_str(), oldTitle.c_str(), rec->titleOverride.c_str());
+  if (refreshTitles && rec && rec->hwnd) RequestTitlesRefresh(rec->hwnd);
+  return rec;
+}
+
+// Single entry point: url + JSON options or "0"
+void API_WEBVIEW_Navigate(const char* url, const char* opts)
+{
+  // Parse options (without immediate application to globals): one pass, no allocation
+  NavigateOptions no;
+  if (is_truthy(opts) && !ParseNavigateOptions(opts, no))
+    LogF("[API] WEBVIEW_Navigate malformed opts '%s' (keys parsed before error are applied)", opts);
+  LogF("[API] WEBVIEW_Navigate url='%s' opts='%s'", url?url:"", opts?opts:"");
+  // BasicCtxMenu: any truthy => enable basic context menu
+  const std::string filter = no.contentFilter;
+  ApplyNavigate(url, no.setTitle, no.instanceId, no.showPanel, no.basicCtxMenu == 1, no.hasContentFilter ? &filter : nullptr, true);
+}
+
+// Many navigate/title/panel ops in one call: ops are coalesced per instance, then each affected
+// instance gets exactly one title/layout/dock refresh at the end. Returns number of ops applied
+// after coalescing (-1 if nothing could be parsed).
+int API_WEBVIEW_Batch(const char* opsJson)
+{
+  std::vector<BatchOp> ops; int parseErrors = 0;
+  const int parsed = ParseBatchOps(opsJson, ops, &parseErrors);
+  if (!parsed) { LogF("[API][Batch] nothing to apply (errors=%d)", parseErrors); return parseErrors ? -1 : 0; }
+
+  // "current"/"last" are resolved once against the focus state at batch start, so every op in the
+  // batch sees the same target even though applying ops moves the focus chain.
+  const std::string current = g_activeInstanceId, last = g_lastFocusedInstanceId;
+  for (auto& op : ops) {
+    if (op.instanceId == "current") op.instanceId = !current.empty() ? current : std::string("random");
+    else if (op.instanceId == "last") op.instanceId = !last.empty() ? last : (!current.empty() ? current : std::string("random"));
+  }
+  const int folded = CoalesceBatchOps(ops);
+
+  std::vector<WebViewInstanceRecord*> touched; touched.reserve(ops.size());
+  for (auto& op : ops) {
+    WebViewInstanceRecord* rec = ApplyNavigate(op.hasUrl ? op.url.c_str() : nullptr, op.hasTitle ? op.title : std::string(),
+                                               op.instanceId, op.showPanel, op.basicCtxMenu == 1,
+                                               op.hasFilter ? &op.contentFilter : nullptr, false);
+    if (rec && std::find(touched.begin(), touched.end(), rec) == touched.end()) touched.push_back(rec);
+  }
+  for (WebViewInstanceRecord* rec : touched)
+    if (rec->hwnd) RequestTitlesRefresh(rec->hwnd);
+
+  LogF("[API][Batch] parsed=%d folded=%d applied=%d instances=%d errors=%d", parsed, folded, (int)ops.size(), (int)touched.size(), parseErrors);
+  return (int)ops.size();
+}
+
+// "current"/empty -> active instance, "last" -> last focused (active if none), anything else verbatim
+static std::string ResolveApiInstanceId(const char* instanceId)
+{
+  std::string id = instanceId ? instanceId : "";
+  if (id == "current" || id.empty()) id = g_activeInstanceId;
+  else if (id == "last") id = !g_lastFocusedInstanceId.empty() ? g_lastFocusedInstanceId : g_activeInstanceId;
+  return id;
+}
+
+// Hibernation state, memory and resume latency of one instance as JSON (see HELP_INFO).
+// False if the id is unknown or the buffer is too small (output is left empty then).
+bool API_WEBVIEW_GetInstanceInfo(const char* instanceId, char* bufOut, int bufOut_sz)
+{
+  if (!bufOut || bufOut_sz <= 0) return false;
+  bufOut[0] = 0;
+  const std::string id = ResolveApiInstanceId(instanceId);
+  std::string json;
+  if (id.empty() || !DescribeInstanceJson(id, json)) return false;
+  if ((int)json.size() >= bufOut_sz) { LogF("[API] GetInstanceInfo id='%s' needs %d bytes, got %d", id.c_str(), (int)json.size() + 1, bufOut_sz); return false; }
+  memcpy(bufOut, json.c_str(), json.size() + 1);
+  return true;
+}
+
+// Performance counters of one instance, or of all with "*" (see HELP_STATS). Same buffer contract as GetInstanceInfo.
+bool API_WEBVIEW_GetStats(const char* instanceId, char* bufOut, int bufOut_sz)
+{
+  if (!bufOut || bufOut_sz <= 0) return false;
+  bufOut[0] = 0;
+  const bool all = instanceId && !strcmp(instanceId, "*");
+  const std::string id = all ? std::string() : ResolveApiInstanceId(instanceId);
+  std::string json;
+  if ((!all && id.empty()) || !DescribeInstanceStatsJson(id, json)) return false;
+  if ((int)json.size() >= bufOut_sz) { LogF("[API] GetStats id='%s' needs %d bytes, got %d", all ? "*" : id.c_str(), (int)json.size() + 1, bufOut_sz); return false; }
+  memcpy(bufOut, json.c_str(), json.size() + 1);
+  return true;
+}
+
+int API_WEBVIEW_DumpStats(const char* path)
+{
+  return DumpInstanceStatsCsv(path ? std::string(path) : std::string());
+}
+
+// Queues js for the instance and returns a handle for WEBVIEW_GetScriptResult (see HELP_SCRIPT), -1 if the
+// instance is unknown or has too many scripts outstanding. Never waits for the page.
+int API_WEBVIEW_ExecuteScript(const char* instanceId, const char* js, const char* opts)
+{
+  if (!js || !*js) return -1;
+  ScriptLimits limits;
+  if (opts && *opts && strcmp(opts, "0")) {
+    JsonCursor c(opts); JsonValue k, v;
+    if (c.EnterObject()) while (c.NextKey(k)) {
+      if (!c.ReadValue(v)) break;
+      if (v.type == JsonType::Object || v.type == JsonType::Array) { c.SkipValue(); continue; }
+      if (v.type != JsonType::Number) continue;
+      const long n = strtol(std::string(v.ptr, v.len).c_str(), nullptr, 10);
+      if (n <= 0) continue;
+      if (JsonKeyEquals(k, "TimeoutMs")) limits.timeoutMs = (uint32_t)std::min(n, (long)ScriptQueue::kMaxTimeoutMs);
+      else if (JsonKeyEquals(k, "MaxResultBytes")) limits.maxResultBytes = (uint32_t)std::min(n, (long)ScriptQueue::kMaxResultBytes);
+    }
+  }
+  const std::string id = ResolveApiInstanceId(instanceId);
+  return id.empty() ? -1 : ScriptEnqueue(id, js, limits);
+}
+
+// State of a handle (ScriptState codes, see HELP_SCRIPT). A finished handle is released once its text fits
+// bufOut; when it does not, -5 is returned and the result stays readable with a bigger buffer.
+int API_WEBVIEW_GetScriptResult(int handle, char* bufOut, int bufOut_sz)
+{
+  if (bufOut && bufOut_sz > 0) bufOut[0] = 0;
+  std::string out;
+  const ScriptState st = ScriptGetResult(handle, out, false);
+  if (st == ScriptState::Pending || st == ScriptState::Unknown) return (int)st;
+  if (!bufOut || (int)out.size() >= bufOut_sz) {
+    LogF("[API] GetScriptResult handle=%d needs %d bytes, got %d", handle, (int)out.size() + 1, bufOut_sz);
+    return -5;
+  }
+  memcpy(bufOut, out.c_str(), out.size() + 1);
+  ScriptGetResult(handle, out, true);
+  return (int)st;
+}
+
+// Snapshots the panel(s) and returns a handle for WEBVIEW_GetCaptureResult (see HELP_CAPTURE); encoding runs
+// on a worker, the call only starts the backend snapshot.
+int API_WEBVIEW_Capture(const char* instanceId, const char* path, const char* opts)
+{
+  CaptureOptions opt;
+  if (opts && *opts && strcmp(opts, "0")) {
+    JsonCursor c(opts); JsonValue k, v;
+    if (c.EnterObject()) while (c.NextKey(k)) {
+      if (!c.ReadValue(v)) break;
+      if (v.type == JsonType::Object || v.type == JsonType::Array) { c.SkipValue(); continue; }
+      if (JsonKeyEquals(k, "Format") && v.type == JsonType::String) {
+        char fmt[8]; JsonCopyString(v, fmt, sizeof(fmt));
+        for (char* p = fmt; *p; ++p) *p = (char)tolower((unsigned char)*p);
+        if (!strcmp(fmt, "jpg") || !strcmp(fmt, "jpeg")) opt.format = CaptureFormat::Jpg;
+        else if (!strcmp(fmt, "png")) opt.format = CaptureFormat::Png;
+        else return -1;
+      }
+      else if (JsonKeyEquals(k, "Alpha")) opt.alpha = v.type == JsonType::True || (v.type == JsonType::Number && strtol(std::string(v.ptr, v.len).c_str(), nullptr, 10) != 0);
+      else if (v.type == JsonType::Number) {
+        const long n = strtol(std::string(v.ptr, v.len).c_str(), nullptr, 10);
+        if (JsonKeyEquals(k, "Quality")) opt.quality = (int)std::max(1L, std::min(n, 100L));
+        else if (JsonKeyEquals(k, "MaxWidth")) opt.maxWidth = (int)std::max(0L, std::min(n, 16384L));
+      }
+    }
+  }
+  const bool all = instanceId && !strcmp(instanceId, "*");
+  const std::string id = all ? std::string("*") : ResolveApiInstanceId(instanceId);
+  return id.empty() ? -1 : CaptureInstances(id, path ? std::string(path) : std::string(), opt);
+}
+
+// State of a capture handle (see HELP_CAPTURE); same buffer contract as WEBVIEW_GetScriptResult
+int API_WEBVIEW_GetCaptureResult(int handle, char* bufOut, int bufOut_sz)
+{
+  if (bufOut && bufOut_sz > 0) bufOut[0] = 0;
+  std::string json;
+  const int st = CaptureGetResult(handle, json, false);
+  if (st == 0 || st == -4) return st;
+  if (!bufOut || (int)json.size() >= bufOut_sz) {
+    LogF("[API] GetCaptureResult handle=%d needs %d bytes, got %d", handle, (int)json.size() + 1, bufOut_sz);
+    return -5;
+  }
+  memcpy(bufOut, json.c_str(), json.size() + 1);
+  CaptureGetResult(handle, json, true);
+  return st;
+}
+
+// Sends query to every open panel at once and returns a handle for WEBVIEW_GetFindAllResult (see HELP_FINDALL)
+int API_WEBVIEW_FindAll(const char* query, const char* opts)
+{
+  if (!query || !*query) return -1;
+  FindAllOptions opt;
+  if (opts && *opts && strcmp(opts, "0")) {
+    JsonCursor c(opts); JsonValue k, v;
+    if (c.EnterObject()) while (c.NextKey(k)) {
+      if (!c.ReadValue(v)) break;
+      if (v.type == JsonType::Object || v.type == JsonType::Array) { c.SkipValue(); continue; }
+      const long n = v.type == JsonType::Number ? strtol(std::string(v.ptr, v.len).c_str(), nullptr, 10) : (v.type == JsonType::True ? 1 : 0);
+      if (JsonKeyEquals(k, "CaseSensitive")) opt.caseSensitive = n != 0;
+      else if (v.type != JsonType::Number || n < 0) continue;
+      else if (JsonKeyEquals(k, "MaxHits")) opt.maxHits = (int)std::min(n, (long)FindAllSearches::kMaxHitsPerPanel);
+      else if (JsonKeyEquals(k, "Context")) opt.contextChars = (int)std::min(n, 200L);
+      else if (JsonKeyEquals(k, "TimeoutMs") && n > 0) opt.timeoutMs = (uint32_t)std::min(n, 60000L);
     }
-    UpdateTitlesExtractAndApply(rec->hwnd);
   }
+  return FindAllStart(query, opt);
+}
+
+// State of a find-all handle (see HELP_FINDALL); the result stays readable for WEBVIEW_FindAllJump
+int API_WEBVIEW_GetFindAllResult(int handle, char* bufOut, int bufOut_sz)
+{
+  if (bufOut && bufOut_sz > 0) bufOut[0] = 0;
+  std::string json;
+  const int st = FindAllGetResult(handle, json);
+  if (st == 0 || st == -4) return st;
+  if (!bufOut || (int)json.size() >= bufOut_sz) {
+    LogF("[API] GetFindAllResult handle=%d needs %d bytes, got %d", handle, (int)json.size() + 1, bufOut_sz);
+    return -5;
+  }
+  memcpy(bufOut, json.c_str(), json.size() + 1);
+  return st;
+}
+
+bool API_WEBVIEW_FindAllJump(int handle, const char* instanceId, int index)
+{
+  const std::string id = ResolveApiInstanceId(instanceId);
+  return !id.empty() && FindAllJump(handle, id, index);
+}
+
+// Shared float buffers for native callers (see HELP_SHBUF). Lock hands out the page-visible data area
+// (capacity floats); the caller writes count floats in place and commits.
+float* API_WEBVIEW_SharedBufferLock(const char* instanceId, const char* name, int capacity)
+{
+  if (capacity <= 0) return nullptr;
+  return SharedBufferLock(ResolveApiInstanceId(instanceId), name, (uint32_t)capacity);
+}
+
+int API_WEBVIEW_SharedBufferCommit(const char* instanceId, const char* name, int count)
+{
+  return SharedBufferCommit(ResolveApiInstanceId(instanceId), name, count > 0 ? (uint32_t)count : 0u);
+}
+
+bool API_WEBVIEW_SharedBufferWrite(const char* instanceId, const char* name, const float* data, int count)
+{
+  if (count < 0 || (count && !data)) return false;
+  const std::string id = ResolveApiInstanceId(instanceId);
+  float* dst = SharedBufferLock(id, name, count ? (uint32_t)count : 1u);
+  if (!dst) return false;
+  if (count) memcpy(dst, data, (size_t)count * sizeof(float));
+  return SharedBufferCommit(id, name, (uint32_t)count) >= 0;
+}
+
+// Video source for panels subscribed through __rwvState.subscribeVideo (see HELP_VIDEO)
+bool API_WEBVIEW_VideoAttachProcessor(void* videoProcessor)
+{
+  return VideoAttachProcessor(videoProcessor);
+}
+
+bool API_WEBVIEW_VideoPushFrame(const void* rgba, int width, int height, int rowspan)
+{
+  return VideoPushFrame(rgba, width, height, rowspan);
 }
 
 // ----- Example placeholder for future API -----
@@ -142,6 +396,89 @@ static void* Vararg_WEBVIEW_Navigate(void** arglist, int numparms)
   return nullptr; // void
 }
 
+static void* Vararg_WEBVIEW_Batch(void** arglist, int numparms)
+{
+  const char* ops = (numparms > 0 && arglist[0]) ? (const char*)arglist[0] : nullptr;
+  return (void*)(INT_PTR)API_WEBVIEW_Batch(ops);
+}
+
+static void* Vararg_WEBVIEW_GetInstanceInfo(void** arglist, int numparms)
+{
+  const char* id = (numparms > 0 && arglist[0]) ? (const char*)arglist[0] : nullptr;
+  char* buf      = (numparms > 1) ? (char*)arglist[1] : nullptr;
+  const int sz   = (numparms > 2) ? (int)(INT_PTR)arglist[2] : 0;
+  return (void*)(INT_PTR)API_WEBVIEW_GetInstanceInfo(id, buf, sz);
+}
+
+static void* Vararg_WEBVIEW_GetStats(void** arglist, int numparms)
+{
+  const char* id = (numparms > 0 && arglist[0]) ? (const char*)arglist[0] : nullptr;
+  char* buf      = (numparms > 1) ? (char*)arglist[1] : nullptr;
+  const int sz   = (numparms > 2) ? (int)(INT_PTR)arglist[2] : 0;
+  return (void*)(INT_PTR)API_WEBVIEW_GetStats(id, buf, sz);
+}
+
+static void* Vararg_WEBVIEW_DumpStats(void** arglist, int numparms)
+{
+  const char* path = (numparms > 0 && arglist[0]) ? (const char*)arglist[0] : nullptr;
+  return (void*)(INT_PTR)API_WEBVIEW_DumpStats(path);
+}
+
+static void* Vararg_WEBVIEW_ExecuteScript(void** arglist, int numparms)
+{
+  const char* id   = (numparms > 0 && arglist[0]) ? (const char*)arglist[0] : nullptr;
+  const char* js   = (numparms > 1 && arglist[1]) ? (const char*)arglist[1] : nullptr;
+  const char* opts = (numparms > 2 && arglist[2]) ? (const char*)arglist[2] : nullptr;
+  return (void*)(INT_PTR)API_WEBVIEW_ExecuteScript(id, js, opts);
+}
+
+static void* Vararg_WEBVIEW_GetScriptResult(void** arglist, int numparms)
+{
+  const int handle = (numparms > 0) ? (int)(INT_PTR)arglist[0] : 0;
+  char* buf        = (numparms > 1) ? (char*)arglist[1] : nullptr;
+  const int sz     = (numparms > 2) ? (int)(INT_PTR)arglist[2] : 0;
+  return (void*)(INT_PTR)API_WEBVIEW_GetScriptResult(handle, buf, sz);
+}
+
+static void* Vararg_WEBVIEW_Capture(void** arglist, int numparms)
+{
+  const char* id   = (numparms > 0 && arglist[0]) ? (const char*)arglist[0] : nullptr;
+  const char* path = (numparms > 1 && arglist[1]) ? (const char*)arglist[1] : nullptr;
+  const char* opts = (numparms > 2 && arglist[2]) ? (const char*)arglist[2] : nullptr;
+  return (void*)(INT_PTR)API_WEBVIEW_Capture(id, path, opts);
+}
+
+static void* Vararg_WEBVIEW_GetCaptureResult(void** arglist, int numparms)
+{
+  const int handle = (numparms > 0) ? (int)(INT_PTR)arglist[0] : 0;
+  char* buf        = (numparms > 1) ? (char*)arglist[1] : nullptr;
+  const int sz     = (numparms > 2) ? (int)(INT_PTR)arglist[2] : 0;
+  return (void*)(INT_PTR)API_WEBVIEW_GetCaptureResult(handle, buf, sz);
+}
+
+static void* Vararg_WEBVIEW_FindAll(void** arglist, int numparms)
+{
+  const char* query = (numparms > 0 && arglist[0]) ? (const char*)arglist[0] : nullptr;
+  const char* opts  = (numparms > 1 && arglist[1]) ? (const char*)arglist[1] : nullptr;
+  return (void*)(INT_PTR)API_WEBVIEW_FindAll(query, opts);
+}
+
+static void* Vararg_WEBVIEW_GetFindAllResult(void** arglist, int numparms)
+{
+  const int handle = (numparms > 0) ? (int)(INT_PTR)arglist[0] : 0;
+  char* buf        = (numparms > 1) ? (char*)arglist[1] : nullptr;
+  const int sz     = (numparms > 2) ? (int)(INT_PTR)arglist[2] : 0;
+  return (void*)(INT_PTR)API_WEBVIEW_GetFindAllResult(handle, buf, sz);
+}
+
+static void* Vararg_WEBVIEW_FindAllJump(void** arglist, int numparms)
+{
+  const int handle = (numparms > 0) ? (int)(INT_PTR)arglist[0] : 0;
+  const char* id   = (numparms > 1 && arglist[1]) ? (const char*)arglist[1] : nullptr;
+  const int index  = (numparms > 2) ? (int)(INT_PTR)arglist[2] : 0;
+  return (void*)(INT_PTR)API_WEBVIEW_FindAllJump(handle, id, index);
+}
+
 // -------------------- API list definition --------------------
 
 #define HELP_NAV \
@@ -157,16 +494,165 @@ static void* Vararg_WEBVIEW_Navigate(void** arglist, int numparms)
 "                  docker : ensure docked (if REAPER docking available)\n" \
 "                  always : force visible (floating or docked depending on previous state)\n" \
 "    BasicCtxMenu : bool   -> when true show only minimal context menu (Dock/Undock + Close).\n" \
+"    ContentFilter : bool|string -> request filter: true = <resource>/reaper_webview_filter.txt (the default\n" \
+"                  for every panel when that file exists), false = off, 'name.txt' = that list from\n" \
+"                  <resource>/reaper_webview_filters/. Setting it (again) reloads the list file.\n" \
 "  Behavior notes:\n" \
 "    - First call creates instance window if needed.\n" \
 "    - Title override persists per-instance until another SetTitle or plugin unload.\n" \
 "    - Panel caption always shows fallback derived from domain/page, not SetTitle.\n" \
 "    - Docker tab uses SetTitle when provided, otherwise fallback.\n" \
-"    - Unknown JSON keys are ignored silently.\n" \
+"    - Unknown JSON keys (and nested objects/arrays) are ignored silently; keys are case-insensitive.\n" \
+"    - String values may use JSON escapes (\\\", \\n, \\uXXXX); BasicCtxMenu accepts true/false, 0/1 or a string.\n" \
 "    - Pass opts='0' (or NULL) for no options.\n"
 
+#define HELP_BATCH \
+"WEBVIEW_Batch(ops)\n" \
+"  Apply many navigate/title/panel operations in one call.\n" \
+"  ops: JSON array of objects (a single object is accepted too). Each object takes the WEBVIEW_Navigate\n" \
+"       option keys (InstanceId, SetTitle, ShowPanel, BasicCtxMenu, ContentFilter) plus optional Url.\n" \
+"       Example: [{\"InstanceId\":\"wv_a\",\"Url\":\"https://a.example\"},{\"InstanceId\":\"wv_b\",\"SetTitle\":\"B\"}]\n" \
+"  Behavior notes:\n" \
+"    - Ops for the same instance are merged (later Url/SetTitle/ShowPanel/BasicCtxMenu/ContentFilter win).\n" \
+"    - 'random' ops are never merged; 'current'/'last' resolve against focus at batch start.\n" \
+"    - Titles/layout/docker tab are refreshed once per affected instance (next timer tick) after all ops ran.\n" \
+"  Returns number of ops applied after merging, or -1 if ops could not be parsed.\n"
+
+#define HELP_INFO \
+"WEBVIEW_GetInstanceInfo(instanceId)\n" \
+"  Returns (ok, json) describing one instance: hibernation state, memory and resume latency.\n" \
+"  instanceId: id, or 'current'/'last' (empty = current).\n" \
+"  json keys: id, state ('active','suspended','discarded','deferred','closed'), visible, hiddenMs,\n" \
+"             jsHeapBytes (-1 if the engine does not expose it), lastResumeMs (-1 until resumed once),\n" \
+"             suspendCount, discardCount, resumeCount, url,\n" \
+"             stream {topics, hz, messages, bytes, msgPerSec, avgTickUs, maxTickUs} (page state subscription),\n" \
+"             audio {...} and video {sent, shown, skipped, fps, avgLatencyMs, ...} while subscribed,\n" \
+"             filter {list, rules, checked, blocked, avgNs} while a request filter is active.\n" \
+"  Hidden panels are suspended after HibernateSuspendSec (ext-state reaper_webview, default 60, Windows only)\n" \
+"  and discarded after HibernateDiscardSec (default off on Windows, 600 elsewhere); 0 disables a stage.\n" \
+"  Discarded panels reload their URL and scroll position when shown again.\n"
+
+#define HELP_STATS \
+"WEBVIEW_GetStats(instanceId)\n" \
+"  Returns (ok, json) with the performance counters of one instance, or {\"instances\":[...], \"focus\":{...},\n" \
+"  \"scripts\":{...}, \"capture\":{...}, \"findAll\":{...}, \"startup\":{...}} of all with '*' (focus: focusEvents,\n" \
+"  visibilityEvents, changes, idleWakeups of the event-driven focus tracking; scripts: enqueued, batches, maxBatch,\n" \
+"  outstanding, timeouts, tooLarge, lateAnswers of WEBVIEW_ExecuteScript; capture: written, failed, avgEncodeMs of\n" \
+"  WEBVIEW_Capture;\n" \
+"  findAll: searches, panels, timeouts, avgMs, maxMs, avgSequentialMs (sum of panel times) of WEBVIEW_FindAll;\n" \
+"  startup: entryMs (time spent in the plugin entry point during REAPER's launch), then apiLoadedMs,\n" \
+"  commandsRegisteredMs, apiRegisteredMs, stateLoadedMs, firstTickMs, restoreDoneMs, firstWebViewStartMs,\n" \
+"  firstPanelShownMs, firstPageLoadedMs: ms since the entry point was called, -1 = not reached yet).\n" \
+"  instanceId: id, 'current'/'last' (empty = current) or '*'.\n" \
+"  json: {id, url, stats:{createMs (StartWebView -> view attached), firstLoadMs (-> first page loaded), creates,\n" \
+"         uptimeSec, nav {count, avgMs, p50Ms, p95Ms, maxMs, lastMs, buckets (<1,<2,<4.. ms), started, failed, pending},\n" \
+"         title {count, avgUs, maxUs, lastUs} (title/caption refreshes),\n" \
+"         find {rebuilds, avgMs, maxMs, lastMs, matches} (query start -> match count),\n" \
+"         bridge {msgsIn, bytesIn, msgsOut, bytesOut} (page messages in, scripts/state posts out)}}.\n" \
+"  See WEBVIEW_DumpStats for the same counters as CSV.\n"
+
+#define HELP_DUMPSTATS \
+"WEBVIEW_DumpStats(path) -> rows\n" \
+"  Appends the performance counters of every instance to a CSV file, one row per instance per call, so\n" \
+"  repeated calls build a time series.\n" \
+"  path: target file (UTF-8); empty = <resource>/reaper_webview_stats.csv. The file is opened for append;\n" \
+"  the header row is written only when the file is new or empty.\n" \
+"  Columns: time (unix seconds), id, creates, createMs, firstLoadMs, uptimeSec, navCount, navFailed, navAvgMs,\n" \
+"  navP50Ms, navP95Ms, navMaxMs, titleCount, titleAvgUs, titleMaxUs, findRebuilds, findAvgMs, findMaxMs,\n" \
+"  findMatches, msgsIn, bytesIn, msgsOut, bytesOut (meanings as in WEBVIEW_GetStats; -1 = not measured yet).\n" \
+"  An id containing a comma, quote or line break is quoted CSV-style.\n" \
+"  Returns the number of rows written (0 with no instances: only the header on a new file), or -1 if there is\n" \
+"  no resource path or the file cannot be opened or written.\n"
+
+#define HELP_SCRIPT \
+"WEBVIEW_ExecuteScript(instanceId, js, opts) -> handle\n" \
+"  Queues js (an expression or statements; the value of the last one is the result) for the page and returns\n" \
+"  at once with a handle > 0, or -1 (unknown instance, empty js, 256 scripts already outstanding).\n" \
+"  instanceId: id, or 'current'/'last' (empty = current).\n" \
+"  opts: JSON or '0': TimeoutMs (default 5000, max 600000; counted from this call, queue wait included),\n" \
+"        MaxResultBytes (default 1048576, max 67108864).\n" \
+"  All scripts queued for a panel are sent as one evaluation on the next timer tick (~30 ms); each runs in its\n" \
+"  own try/catch in the page's global scope, so one error does not affect the others. A hibernated panel or one\n" \
+"  still creating its view runs them once it is live (the timeout keeps running).\n" \
+"WEBVIEW_GetScriptResult(handle) -> (state, result)\n" \
+"  Never blocks; poll from a defer loop. state: 0 pending, 1 done (result = JSON.stringify of the value,\n" \
+"  'null' for undefined), -1 script error or panel closed/navigated (result = error text), -2 timed out,\n" \
+"  -3 result over MaxResultBytes, -4 unknown handle (already read, or unread for 60 s after finishing),\n" \
+"  -5 result does not fit bufOut (kept; read again with a bigger buffer). A finished result is released\n" \
+"  once returned.\n"
+
+#define HELP_CAPTURE \
+"WEBVIEW_Capture(instanceId, path, opts) -> handle\n" \
+"  Snapshots the visible page of a panel (or of every open panel with '*') into PNG/JPEG files and returns at\n" \
+"  once with a handle > 0, -1 (unknown instance, no open panel for '*', bad opts, no resource path) or -2 (16\n" \
+"  captures still running).\n" \
+"  The snapshot is taken by the browser engine; scaling and encoding run on a background thread.\n" \
+"  instanceId: id, 'current'/'last' (empty = current) or '*'.\n" \
+"  path: output file for one panel; the directory for '*' (files named <id>.png / <id>.jpg). Empty =\n" \
+"        <resource>/reaper_webview_captures (created if missing).\n" \
+"  opts: JSON or '0': Format ('png' default, 'jpg'), Quality (JPEG 1..100, default 90), MaxWidth (0 = full\n" \
+"        size, otherwise scaled down keeping the aspect ratio), Alpha (PNG with alpha channel, default false).\n" \
+"  Hibernated panels and panels without a live view are reported as failed rather than woken.\n" \
+"WEBVIEW_GetCaptureResult(handle) -> (state, json)\n" \
+"  Never blocks; poll from a defer loop. state: 0 pending, 1 every file written, -1 finished with failures,\n" \
+"  -4 unknown handle (already read), -5 json does not fit bufOut (kept). json: {\"captures\":[{id, path, w, h,\n" \
+"  ms (call -> file written), encodeMs} or {id, error}]}. A finished result is released once returned.\n"
+
+#define HELP_FINDALL \
+"WEBVIEW_FindAll(query, opts) -> handle\n" \
+"  Searches every open panel at once (each page counts its own matches concurrently, so the wait is the\n" \
+"  slowest panel, not the sum) and returns a handle > 0, or -1 (empty query, no panel, 8 searches running).\n" \
+"  opts: JSON or '0': CaseSensitive (default false), MaxHits (context snippets per panel, default 20, max 200;\n" \
+"        the count is always complete), Context (characters around each hit, default 30), TimeoutMs (default\n" \
+"        3000; panels that have not answered by then are reported as 'timeout').\n" \
+"  Hibernated panels and panels without a live view are reported as 'no live view' rather than woken.\n" \
+"WEBVIEW_GetFindAllResult(handle) -> (state, json)\n" \
+"  Never blocks. state: 0 pending, 1 every panel answered, -1 finished with failures/timeouts, -4 unknown\n" \
+"  handle, -5 json does not fit bufOut. json: {\"query\", \"total\", \"ms\" (slowest panel), \"panels\":[{id,\n" \
+"  title, matches, ms, pageMs, hits:[snippet...]} or {id, title, error}]}. The 32 latest results stay readable.\n" \
+"WEBVIEW_FindAllJump(handle, instanceId, index) -> bool\n" \
+"  Brings the panel to front and selects match index (1-based, any match up to its count) of that search.\n" \
+"  The action 'WebView: Find in all panels' does the same interactively, with the hits as a menu.\n"
+
+// Native-only entries (float* has no ReaScript mapping): registered as API_ for C/C++ extensions
+#define HELP_SHBUF \
+"WEBVIEW_SharedBufferLock(instanceId, name, capacity) -> float*\n" \
+"WEBVIEW_SharedBufferCommit(instanceId, name, count) -> seq (-1 if the buffer does not exist)\n" \
+"WEBVIEW_SharedBufferWrite(instanceId, name, data, count) -> bool (Lock + copy + Commit)\n" \
+"  Named float32 buffer shared with the page (name: [A-Za-z0-9_.-], max 64 chars). WebView2 maps the memory\n" \
+"  into the page, which reads it in place; WebKit receives a base64 copy. The latest commit is published once\n" \
+"  per timer tick; page side: window.__rwvBuffers.get(name) and the 'rwvbuffer' event.\n"
+
+#define HELP_VIDEO \
+"WEBVIEW_VideoAttachProcessor(IREAPERVideoProcessor* vproc) -> bool (null detaches)\n" \
+"WEBVIEW_VideoPushFrame(rgba, width, height, rowspan) -> bool (false if no panel listens)\n" \
+"  Video frames for panels that called window.__rwvState.subscribeVideo({maxWidth, fps}). Attach wraps the\n" \
+"  process_frame of a processor created with video_CreateVideoProcessor (e.g. by a companion video FX): the\n" \
+"  creator's callback still runs and its output is what the panels see (input 0 when it has none). The\n" \
+"  processor stays owned by its creator, which must call WEBVIEW_VideoAttachProcessor(null) before\n" \
+"  destroying it (detach restores the creator's own process_frame). Attaching another\n" \
+"  processor detaches the previous one. PushFrame takes RGBA frames from any single producer thread.\n" \
+"  Frames are scaled to the widest subscriber once, the newest one wins, and a panel still drawing the\n" \
+"  previous frame skips it.\n"
+
 static ApiRegistrationInfo g_api_list[] = {
-  { "WEBVIEW_Navigate", "void", "const char*,const char*", "url,opts", HELP_NAV, &API_WEBVIEW_Navigate, &Vararg_WEBVIEW_Navigate, nullptr },
+  { "WEBVIEW_Navigate", "void", "const char*,const char*", "url,opts", HELP_NAV, (void*)&API_WEBVIEW_Navigate, &Vararg_WEBVIEW_Navigate, nullptr },
+  { "WEBVIEW_Batch", "int", "const char*", "ops", HELP_BATCH, (void*)&API_WEBVIEW_Batch, &Vararg_WEBVIEW_Batch, nullptr },
+  { "WEBVIEW_GetInstanceInfo", "bool", "const char*,char*,int", "instanceId,bufOut,bufOut_sz", HELP_INFO, (void*)&API_WEBVIEW_GetInstanceInfo, &Vararg_WEBVIEW_GetInstanceInfo, nullptr },
+  { "WEBVIEW_GetStats", "bool", "const char*,char*,int", "instanceId,bufOut,bufOut_sz", HELP_STATS, (void*)&API_WEBVIEW_GetStats, &Vararg_WEBVIEW_GetStats, nullptr },
+  { "WEBVIEW_DumpStats", "int", "const char*", "path", HELP_DUMPSTATS, (void*)&API_WEBVIEW_DumpStats, &Vararg_WEBVIEW_DumpStats, nullptr },
+  { "WEBVIEW_ExecuteScript", "int", "const char*,const char*,const char*", "instanceId,js,opts", HELP_SCRIPT, (void*)&API_WEBVIEW_ExecuteScript, &Vararg_WEBVIEW_ExecuteScript, nullptr },
+  { "WEBVIEW_GetScriptResult", "int", "int,char*,int", "handle,bufOut,bufOut_sz", HELP_SCRIPT, (void*)&API_WEBVIEW_GetScriptResult, &Vararg_WEBVIEW_GetScriptResult, nullptr },
+  { "WEBVIEW_Capture", "int", "const char*,const char*,const char*", "instanceId,path,opts", HELP_CAPTURE, (void*)&API_WEBVIEW_Capture, &Vararg_WEBVIEW_Capture, nullptr },
+  { "WEBVIEW_GetCaptureResult", "int", "int,char*,int", "handle,bufOut,bufOut_sz", HELP_CAPTURE, (void*)&API_WEBVIEW_GetCaptureResult, &Vararg_WEBVIEW_GetCaptureResult, nullptr },
+  { "WEBVIEW_FindAll", "int", "const char*,const char*", "query,opts", HELP_FINDALL, (void*)&API_WEBVIEW_FindAll, &Vararg_WEBVIEW_FindAll, nullptr },
+  { "WEBVIEW_GetFindAllResult", "int", "int,char*,int", "handle,bufOut,bufOut_sz", HELP_FINDALL, (void*)&API_WEBVIEW_GetFindAllResult, &Vararg_WEBVIEW_GetFindAllResult, nullptr },
+  { "WEBVIEW_FindAllJump", "bool", "int,const char*,int", "handle,instanceId,index", HELP_FINDALL, (void*)&API_WEBVIEW_FindAllJump, &Vararg_WEBVIEW_FindAllJump, nullptr },
+  { "WEBVIEW_SharedBufferLock", "float*", "const char*,const char*,int", "instanceId,name,capacity", HELP_SHBUF, (void*)&API_WEBVIEW_SharedBufferLock, nullptr, nullptr },
+  { "WEBVIEW_SharedBufferCommit", "int", "const char*,const char*,int", "instanceId,name,count", HELP_SHBUF, (void*)&API_WEBVIEW_SharedBufferCommit, nullptr, nullptr },
+  { "WEBVIEW_SharedBufferWrite", "bool", "const char*,const char*,const float*,int", "instanceId,name,data,count", HELP_SHBUF, (void*)&API_WEBVIEW_SharedBufferWrite, nullptr, nullptr },
+  { "WEBVIEW_VideoAttachProcessor", "bool", "void*", "videoProcessor", HELP_VIDEO, (void*)&API_WEBVIEW_VideoAttachProcessor, nullptr, nullptr },
+  { "WEBVIEW_VideoPushFrame", "bool", "const void*,int,int,int", "rgba,width,height,rowspan", HELP_VIDEO, (void*)&API_WEBVIEW_VideoPushFrame, nullptr, nullptr },
   // Add new API entries here
 };
 
@@ -190,16 +676,16 @@ void RegisterAPI()
   for (size_t i=0; i<count; ++i)
   {
     auto& api = g_api_list[i];
+    // keys in a stack buffer: this runs on REAPER's launch path, once per entry
+    char key[160];
+    snprintf(key, sizeof(key), "API_%s", api.name);
+    plugin_register(key, (void*)api.cFunc);
+    if (!api.varargFunc) continue; // native-only: not exposed to ReaScript
     BuildDefString(api);
-
-  std::string base = api.name; // without prefix
-    std::string key_func   = "API_"        + base;
-    std::string key_def    = "APIdef_"     + base;
-    std::string key_vararg = "APIvararg_"  + base;
-
-    plugin_register(key_func.c_str(),   (void*)api.cFunc);
-    plugin_register(key_def.c_str(),    (void*)api.defCString);
-    plugin_register(key_vararg.c_str(), (void*)api.varargFunc);
+    snprintf(key, sizeof(key), "APIdef_%s", api.name);
+    plugin_register(key, (void*)api.defCString);
+    snprintf(key, sizeof(key), "APIvararg_%s", api.name);
+    plugin_register(key, (void*)api.varargFunc);
   }
   g_api_registered = true;
 }
@@ -213,9 +699,11 @@ void UnregisterAPI()
     auto& api = g_api_list[i];
     std::string base = api.name;
     plugin_register(("-API_"       + base).c_str(), (void*)api.cFunc);
+    if (!api.varargFunc) continue;
     plugin_register(("-APIdef_"    + base).c_str(), (void*)api.defCString);
     plugin_register(("-APIvararg_" + base).c_str(), (void*)api.varargFunc);
   }
   g_api_registered = false;
+  for (size_t i=0; i<count; ++i) g_api_list[i].defCString = nullptr; // storage below goes away
   g_api_def_storage.clear();
 }
@@ -0,0 +1,32 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// asset_glue.mm
+#include "predef.h"
+#include "globals.h"
+#include "helpers.h"
+#include "log.h"
+#include "webview.h"
+
+// ============================== rwv:// assets ==============================
+// Panel assets embedded at build time (www/ -> tools/compile_resources.py --bundle); every backend's scheme
+// handler lands here. Bodies are inflated once and served from memory afterwards.
+static AssetServer& AppAssets()
+{
+  static AssetServer s_server(GetEmbeddedAssetBundle());
+  return s_server;
+}
+
+void ServeAppAsset(const std::string& url, const char* ifNoneMatch, AssetReply& out)
+{
+  AppAssets().Serve(url, ifNoneMatch, out);
+  LogDebugF("[Asset] %s -> %d bytes=%zu %.1f us", url.c_str(), out.status, out.body ? out.body->size() : (size_t)0, out.us);
+}
+
+void AppAssetsShutdown()
+{
+  if (AppAssets().Requests())
+    LogF("[Asset] requests=%llu notModified=%llu notFound=%llu inflates=%llu avgUs=%.1f maxUs=%.1f cached=%zu",
+         AppAssets().Requests(), AppAssets().NotModified(), AppAssets().NotFound(), AppAssets().Inflates(),
+         AppAssets().AvgUs(), AppAssets().MaxUs(), AppAssets().CachedBytes());
+}
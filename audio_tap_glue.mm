@@ -0,0 +1,118 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// audio_tap_glue.mm
+#include "predef.h"
+#include "globals.h"
+#include "helpers.h"
+#include "log.h"
+#include "webview.h"
+#include "core/audio_tap.h"
+
+// ============================== Audio tap ==============================
+// Pages subscribe through __rwvState.subscribeAudio ("AUD|o1,o2|outCh|rate"). The hardware hook is only
+// registered while someone listens; OnAudioBuffer copies the captured channels into the tap's lock-free
+// ring, its worker downmixes/decimates, and the timer tick hands each subscriber's output to its "audio"
+// shared buffer: [rate, channels, frames, interleaved samples...].
+static AudioTap* g_audioTap = nullptr;
+static bool g_audioHookOn = false;
+
+static void OnAudioTapBuffer(bool isPost, int len, double srate, audio_hook_register_t* reg)
+{
+  AudioTap* tap = (AudioTap*)reg->userdata1;
+  if (!isPost || !tap || !reg->GetBuffer) return;
+  const uint32_t want = tap->CaptureMask();
+  if (!want) return;
+  const ReaSample* ch[kAudioTapChannels] = {};
+  uint32_t mask = 0;
+  for (int c = 0; c < kAudioTapChannels; ++c) {
+    if (!(want & (1u << c))) continue;
+    const bool output = c < 8; const int idx = output ? c : c - 8;
+    if (idx >= (output ? reg->output_nch : reg->input_nch)) continue;
+    if (const ReaSample* p = reg->GetBuffer(output, idx)) { ch[c] = p; mask |= 1u << c; }
+  }
+  tap->Push(ch, mask, len, srate);
+}
+
+static audio_hook_register_t g_audioHookReg = { OnAudioTapBuffer, nullptr, nullptr, 0, 0, nullptr };
+
+static void AudioTapUpdateHook()
+{
+  const bool want = g_audioTap && g_audioTap->HasSubscribers();
+  if (want == g_audioHookOn || !Audio_RegHardwareHook) return;
+  if (want) {
+    g_audioTap->Start();
+    g_audioHookReg.userdata1 = g_audioTap;
+    g_audioHookOn = Audio_RegHardwareHook(true, &g_audioHookReg) != 0;
+    if (!g_audioHookOn) g_audioTap->Stop();
+  } else {
+    Audio_RegHardwareHook(false, &g_audioHookReg);
+    g_audioHookOn = false;
+    g_audioTap->Stop();
+  }
+  LogF("[AudioTap] hook %s", g_audioHookOn ? "registered" : "removed");
+}
+
+void OnAudioTapMessage(WebViewInstanceRecord* rec, const std::string& msg)
+{
+  const size_t b1 = msg.find('|', 4), b2 = b1 == std::string::npos ? b1 : msg.find('|', b1 + 1);
+  const std::string chans = msg.substr(4, b1 == std::string::npos ? std::string::npos : b1 - 4);
+  const uint32_t bits = ParseAudioTapChannels(chans.data(), chans.size());
+  if (!bits) {
+    if (g_audioTap && g_audioTap->Unsubscribe(rec->id)) LogF("[AudioTap] id='%s' unsubscribed", rec->id.c_str());
+    AudioTapUpdateHook();
+    return;
+  }
+  if (!Audio_RegHardwareHook) { LogRaw("[AudioTap] Audio_RegHardwareHook unavailable"); return; }
+  if (!g_audioTap) g_audioTap = new AudioTap();
+  AudioTapConfig cfg;
+  cfg.channels = bits;
+  if (b1 != std::string::npos) cfg.outChannels = atoi(msg.c_str() + b1 + 1) == 1 ? 1 : 2;
+  if (b2 != std::string::npos && atoi(msg.c_str() + b2 + 1) > 0) cfg.rate = atoi(msg.c_str() + b2 + 1);
+  g_audioTap->Subscribe(rec->id, cfg);
+  LogF("[AudioTap] id='%s' subscribed channels=%s out=%d rate=%d", rec->id.c_str(), chans.c_str(), cfg.outChannels, cfg.rate);
+  AudioTapUpdateHook();
+}
+
+void AudioTapTick()
+{
+  if (!g_audioTap || !g_audioHookOn) return;
+  static std::vector<float> s_out;
+  for (auto& kv : g_instances) {
+    WebViewInstanceRecord* rec = kv.second.get();
+    int ch = 2; double rate = 0;
+    if (!rec || !g_audioTap->Take(rec->id, s_out, ch, rate)) continue; // drained even while hidden
+    const uint32_t n = (uint32_t)s_out.size();
+    float* d = SharedBufferLock(rec->id, "audio", 3 + n);
+    if (!d) continue;
+    d[0] = (float)rate; d[1] = (float)ch; d[2] = (float)(n / ch);
+    memcpy(d + 3, s_out.data(), n * sizeof(float));
+    SharedBufferCommit(rec->id, "audio", 3 + n);
+  }
+}
+
+// Instance closed: its subscription goes with it
+void AudioTapRelease(WebViewInstanceRecord* rec)
+{
+  if (g_audioTap && rec && g_audioTap->Unsubscribe(rec->id)) AudioTapUpdateHook();
+}
+
+void AudioTapShutdown()
+{
+  if (!g_audioTap) return;
+  if (g_audioHookOn && Audio_RegHardwareHook) Audio_RegHardwareHook(false, &g_audioHookReg);
+  g_audioHookOn = false;
+  g_audioTap->Stop();
+  LogF("[AudioTap] blocks=%llu ringDrops=%llu outputDrops=%llu workerMs=%.1f",
+       g_audioTap->BlocksPushed(), g_audioTap->BlocksDropped(), g_audioTap->FramesDropped(), g_audioTap->WorkerMs());
+  delete g_audioTap; g_audioTap = nullptr;
+}
+
+void AudioTapAppendInstanceJson(WebViewInstanceRecord* rec, std::string& out)
+{
+  if (!g_audioTap || !rec || !g_audioTap->IsSubscribed(rec->id)) return;
+  char buf[160];
+  snprintf(buf, sizeof(buf), ",\"audio\":{\"blocks\":%llu,\"ringDrops\":%llu,\"outputDrops\":%llu,\"workerMs\":%.1f}",
+           g_audioTap->BlocksPushed(), g_audioTap->BlocksDropped(), g_audioTap->FramesDropped(), g_audioTap->WorkerMs());
+  out += buf;
+}
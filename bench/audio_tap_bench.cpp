@@ -0,0 +1,122 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// bench/audio_tap_bench.cpp
+// Audio tap under a simulated audio thread: 48 kHz stereo (double samples, like ReaSample) in 128-frame
+// blocks, paced faster than real time, while the tap's own worker drains the ring. Reports the cost of
+// Push on the "audio thread" (avg/max), ring drops, and checks the output of three subscribers (stereo,
+// mono downmix, single channel) against the known DC levels. A second pass stalls the consumer to show
+// that a full ring only drops blocks - Push never waits.
+//
+//   reaper_webview_audio_tap_bench [--check] [seconds of audio] [speedup]
+
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <thread>
+#include <vector>
+
+#include "bench_util.h"
+#include "core/audio_tap.h"
+
+static const double kRate = 48000.0;
+static const int kBlock = 128;
+static const double kLeft = 0.25, kRight = -0.5;
+
+struct Producer
+{
+  double avgNs = 0, maxNs = 0;
+  long blocks = 0;
+};
+
+static void RunProducer(AudioTap& tap, long blocks, double speedup, Producer& p)
+{
+  std::vector<double> l(kBlock, kLeft), r(kBlock, kRight);
+  const double* ch[kAudioTapChannels] = { l.data(), r.data() };
+  const auto period = std::chrono::duration<double>(kBlock / kRate / speedup);
+  auto next = clk::now();
+  double total = 0;
+  for (long b = 0; b < blocks; ++b) {
+    const auto t = clk::now();
+    tap.Push(ch, 3u, kBlock, kRate);
+    const double ns = std::chrono::duration<double, std::nano>(clk::now() - t).count();
+    total += ns; if (ns > p.maxNs) p.maxNs = ns;
+    if (speedup > 0) { next += std::chrono::duration_cast<clk::duration>(period); std::this_thread::sleep_until(next); }
+  }
+  p.blocks = blocks; p.avgNs = total / (double)blocks;
+}
+
+static int Check(const char* what, const std::vector<float>& v, int outCh, double want0, double want1)
+{
+  int bad = 0;
+  for (size_t i = 0; i < v.size(); ++i) {
+    const double want = (outCh == 2 && (i & 1)) ? want1 : want0;
+    if (fabs(v[i] - want) > 1e-6) ++bad;
+  }
+  if (bad) printf("  %s: %d samples off\n", what, bad);
+  return bad;
+}
+
+int main(int argc, char** argv)
+{
+  BenchParseArgs(argc, argv);
+  const double seconds = argc > 1 ? atof(argv[1]) : 5.0;
+  const double speedup = argc > 2 ? atof(argv[2]) : 8.0;
+  if (seconds <= 0 || speedup <= 0) { fprintf(stderr, "usage: %s [--check] [seconds>0] [speedup>0]\n", argv[0]); return 1; }
+  const long blocks = (long)(seconds * kRate / kBlock);
+  int mismatches = 0;
+
+  {
+    AudioTap tap;
+    AudioTapConfig st; st.channels = 3; st.outChannels = 2; st.rate = 12000;     // o1/o2 stereo, factor 4
+    AudioTapConfig mono; mono.channels = 3; mono.outChannels = 1; mono.rate = 8000; // o1+o2 mono, factor 6
+    AudioTapConfig one; one.channels = 2; one.outChannels = 2; one.rate = 48000;  // o2 on both sides, factor 1
+    tap.Subscribe("st", st); tap.Subscribe("mono", mono); tap.Subscribe("one", one);
+    tap.Start();
+    Producer p;
+    std::vector<float> out, acc[3];
+    const char* ids[3] = { "st", "mono", "one" };
+    int outCh[3] = { 2, 1, 2 }; double outRate[3] = { 0, 0, 0 };
+    std::thread audio([&]() { RunProducer(tap, blocks, speedup, p); });
+    bool done = false;
+    while (!done) { // stands in for the 30 Hz timer collecting output
+      done = tap.BlocksPushed() + tap.BlocksDropped() >= (unsigned long long)blocks;
+      std::this_thread::sleep_for(std::chrono::milliseconds(33));
+      for (int i = 0; i < 3; ++i)
+        if (tap.Take(ids[i], out, outCh[i], outRate[i])) acc[i].insert(acc[i].end(), out.begin(), out.end());
+    }
+    audio.join();
+    tap.Stop();
+    tap.Process();
+    for (int i = 0; i < 3; ++i)
+      if (tap.Take(ids[i], out, outCh[i], outRate[i])) acc[i].insert(acc[i].end(), out.begin(), out.end());
+
+    const long framesIn = (long)(tap.BlocksPushed() * kBlock);
+    BenchPrintf("%ld blocks of %d frames at %.0fx real time: push avg %.0f ns max %.0f ns, ring drops %llu, worker %.1f ms\n",
+                p.blocks, kBlock, speedup, p.avgNs, p.maxNs, tap.BlocksDropped(), tap.WorkerMs());
+    const int factor[3] = { 4, 6, 1 };
+    const double want[3][2] = { { kLeft, kRight }, { (kLeft + kRight) / 2, 0 }, { kRight, kRight } };
+    for (int i = 0; i < 3; ++i) {
+      const long frames = (long)acc[i].size() / outCh[i];
+      BenchPrintf("  %-5s %d ch at %.0f Hz: %ld frames (expected %ld)\n", ids[i], outCh[i], outRate[i], frames, framesIn / factor[i]);
+      if (frames != framesIn / factor[i] || outRate[i] != kRate / factor[i]) ++mismatches;
+      mismatches += Check(ids[i], acc[i], outCh[i], want[i][0], want[i][1]) ? 1 : 0;
+    }
+  }
+
+  {
+    // stalled consumer: the ring fills up, later blocks are dropped and counted, Push stays flat
+    AudioTap tap(1u << 14);
+    AudioTapConfig st; tap.Subscribe("st", st);
+    Producer p;
+    RunProducer(tap, 2000, 0, p);
+    const unsigned long long kept = tap.BlocksPushed();
+    BenchPrintf("stalled consumer: %llu blocks kept, %llu dropped, push avg %.0f ns max %.0f ns\n",
+                kept, tap.BlocksDropped(), p.avgNs, p.maxNs);
+    if (kept + tap.BlocksDropped() != 2000 || !tap.BlocksDropped()) ++mismatches;
+    if (tap.Process() != kept * kBlock) ++mismatches;
+  }
+
+  return BenchResult(mismatches);
+}
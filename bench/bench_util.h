@@ -0,0 +1,41 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// bench/bench_util.h
+// Shared by the benches: steady clock helpers, the CHECK counter and the result line. Every bench also runs
+// as a ctest check: "--check" (first argument, the positional ones keep their meaning) keeps the cross-checks
+// and drops the timing report, so only failures and "mismatches=N" are printed. Exit code 2 on mismatches.
+#pragma once
+
+#include <chrono>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+typedef std::chrono::steady_clock clk;
+static inline double NsSince(clk::time_point t) { return std::chrono::duration<double, std::nano>(clk::now() - t).count(); }
+static inline double UsSince(clk::time_point t) { return std::chrono::duration<double, std::micro>(clk::now() - t).count(); }
+static inline double MsSince(clk::time_point t) { return std::chrono::duration<double, std::milli>(clk::now() - t).count(); }
+
+inline int g_mismatches = 0;
+#define CHECK(cond) do { if (!(cond)) { printf("check failed (line %d): %s\n", __LINE__, #cond); ++g_mismatches; } } while (0)
+
+inline bool g_benchCheckOnly = false;
+
+static inline void BenchParseArgs(int& argc, char**& argv)
+{
+  if (argc > 1 && !strcmp(argv[1], "--check")) { g_benchCheckOnly = true; argv[1] = argv[0]; ++argv; --argc; }
+}
+
+// Timing / report lines: skipped under --check
+static inline void BenchPrintf(const char* fmt, ...)
+{
+  if (g_benchCheckOnly) return;
+  va_list ap; va_start(ap, fmt); vprintf(fmt, ap); va_end(ap);
+}
+
+static inline int BenchResult(int mismatches)
+{
+  printf("mismatches=%d\n", mismatches);
+  return mismatches ? 2 : 0;
+}
@@ -0,0 +1,218 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// bench/core_bench.cpp
+// Headless driver for the platform-neutral core: thousands of synthetic instances hosted on
+// SWELL-generic headless windows (no display, no REAPER). Prints ns/op per scenario.
+//
+//   reaper_webview_core_bench [instances] [iterations]
+
+#define WDL_NO_DEFINE_MINMAX
+#include "WDL/swell/swell.h"
+#include "WDL/swell/swell-dlggen.h"
+
+#include <chrono>
+#include <memory>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+#include "core/instance_registry.h"
+#include "core/instance_ids.h"
+#include "core/title_policy.h"
+#include "core/focus_chain.h"
+#include "core/url_utils.h"
+#include "core/refresh_scheduler.h"
+
+// swell-wnd-generic references this; headless builds have no OS window to maximize
+void swell_oswindow_maximize(HWND, bool) {}
+
+#define IDD_BENCH_HOST 100
+SWELL_DEFINE_DIALOG_RESOURCE_BEGIN(IDD_BENCH_HOST, WS_CAPTION|WS_CLIPCHILDREN, "bench", 300, 200, 1.0)
+SWELL_DEFINE_DIALOG_RESOURCE_END(IDD_BENCH_HOST)
+
+static INT_PTR WINAPI BenchDlgProc(HWND, UINT, WPARAM, LPARAM) { return 0; }
+
+// Same fields the core touches on WebViewInstanceRecord
+struct BenchRecord
+{
+  std::string id;
+  HWND hwnd = nullptr;
+  unsigned long lastFocusTick = 0;
+  bool hostVisible = false;
+  std::string titleOverride;
+  ShowPanelMode panelMode = ShowPanelMode::Unset;
+  std::string lastUrl;
+};
+
+static volatile size_t g_sink = 0; // keeps results observable
+
+template <class F>
+static void Run(const char* name, size_t ops, F&& fn)
+{
+  const auto t0 = std::chrono::steady_clock::now();
+  fn();
+  const auto t1 = std::chrono::steady_clock::now();
+  const double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+  printf("%-34s %10zu ops %12.1f ns/op\n", name, ops, ops ? ns / (double)ops : 0.0);
+}
+
+int main(int argc, char** argv)
+{
+  const int nInst = argc > 1 ? atoi(argv[1]) : 2000;
+  const int iters = argc > 2 ? atoi(argv[2]) : 20;
+  if (nInst <= 0 || iters <= 0) { fprintf(stderr, "usage: %s [instances>0] [iterations>0]\n", argv[0]); return 1; }
+
+  static const char* kUrls[] = {
+    "https://www.reaper.fm/download.php", "http://localhost:8080/app?x=1", "https://user@example.com:443/a#b",
+    "file:///home/user/index.html", "reaper.fm/sdk", "spotify:track:123", "  https://[::1]:9000/  ", "about:blank",
+  };
+  const size_t nUrls = sizeof(kUrls) / sizeof(kUrls[0]);
+
+  HWND root = CreateDialog(NULL, MAKEINTRESOURCE(IDD_BENCH_HOST), NULL, BenchDlgProc);
+  InstanceRegistry<BenchRecord> reg; reg.reserve((size_t)nInst);
+  std::vector<HWND> hosts; hosts.reserve((size_t)nInst);
+  int randomCounter = 0;
+  for (int i = 0; i < nInst; ++i) {
+    auto rec = std::make_unique<BenchRecord>();
+    rec->id = NormalizeInstanceIdWith(i == 0 ? std::string() : std::string("random"), randomCounter);
+    rec->hwnd = CreateDialog(NULL, MAKEINTRESOURCE(IDD_BENCH_HOST), root, BenchDlgProc);
+    rec->titleOverride = (i % 3) ? "WebView" : "Custom " + std::to_string(i);
+    rec->panelMode = (ShowPanelMode)(i % 4);
+    rec->lastUrl = kUrls[(size_t)i % nUrls];
+    if (i % 2) ShowWindow(rec->hwnd, SW_SHOWNA);
+    hosts.push_back(rec->hwnd);
+    const std::string id = rec->id;
+    reg.Insert(id, std::move(rec));
+  }
+  printf("core bench: %d instances, %d iterations\n", nInst, iters);
+
+  std::vector<std::string> ids; ids.reserve(reg.size());
+  for (auto& kv : reg) ids.push_back(kv.first);
+
+  const size_t lookups = (size_t)iters * ids.size();
+  Run("NormalizeInstanceId", lookups, [&]{
+    int c = 0; size_t s = 0;
+    for (int it = 0; it < iters; ++it) for (auto& id : ids) s += NormalizeInstanceIdWith(id, c).size();
+    g_sink += s;
+  });
+  Run("Registry::Find(id)", lookups, [&]{
+    size_t s = 0;
+    for (int it = 0; it < iters; ++it) for (auto& id : ids) s += reg.Find(id) != nullptr;
+    g_sink += s;
+  });
+  const size_t hwndOps = (size_t)iters * hosts.size();
+  Run("Registry::FindByHwnd", hwndOps, [&]{
+    size_t s = 0;
+    for (int it = 0; it < iters; ++it) for (HWND h : hosts) s += reg.FindByHwnd(h) != nullptr;
+    g_sink += s;
+  });
+  Run("DecideTitles", lookups, [&]{
+    size_t s = 0; const std::string domain = "reaper.fm", page = "REAPER | Audio Production";
+    for (int it = 0; it < iters; ++it)
+      for (auto& kv : reg) {
+        BenchRecord* r = kv.second.get();
+        TitleDecision d = DecideTitles(r->titleOverride, "WebView", r->panelMode, (it & 1) != 0, domain, page);
+        s += d.panelVisible + d.wndCaption.size();
+      }
+    g_sink += s;
+  });
+  Run("ExtractDomainFromUrl", lookups, [&]{
+    size_t s = 0;
+    for (int it = 0; it < iters; ++it) for (auto& kv : reg) s += ExtractDomainFromUrl(kv.second->lastUrl).size();
+    g_sink += s;
+  });
+  Run("NormalizeOrDispatchURL", lookups, [&]{
+    size_t s = 0; std::string n, e, why;
+    for (int it = 0; it < iters; ++it) for (auto& kv : reg) s += NormalizeOrDispatchURL(kv.second->lastUrl, n, e, why);
+    g_sink += s;
+  });
+  std::string primary, active, last;
+  Run("AdvanceFocusChain+tick", lookups, [&]{
+    size_t s = 0; unsigned long tick = 1;
+    for (int it = 0; it < iters; ++it)
+      for (auto& id : ids) {
+        s += AdvanceFocusChain(primary, active, last, id);
+        if (BenchRecord* r = reg.Find(id)) r->lastFocusTick = tick++;
+      }
+    g_sink += s;
+  });
+  // Nothing alive under primary/last -> full visible scan with tick comparison
+  const size_t resolveOps = (size_t)iters * 16;
+  Run("ResolveFocusFallback (scan)", resolveOps, [&]{
+    size_t s = 0; const std::string none;
+    for (size_t k = 0; k < resolveOps; ++k)
+      s += ResolveFocusFallback(reg, none, none,
+        [](BenchRecord* r){ return r->hwnd && IsWindow(r->hwnd); },
+        [](BenchRecord* r){ return IsWindowVisible(r->hwnd) != 0; }) != nullptr;
+    g_sink += s;
+  });
+
+  // Visibility: one resolve per show/hide notification (docker tab switch) instead of a 500 ms poll that walks
+  // every instance; an idle minute costs the poll 120 wakeups and no notifications at all
+  {
+    std::string act, lst; size_t toggles = 0;
+    for (auto& kv : reg) kv.second->hostVisible = true;
+    Run("ResolveActiveOnVisibility (event)", resolveOps, [&]{
+      size_t s = 0;
+      for (size_t k = 0; k < resolveOps; ++k) {
+        BenchRecord* r = reg.Find(ids[k % ids.size()]);
+        r->hostVisible = !r->hostVisible; ++toggles;
+        s += ResolveActiveOnVisibility(reg, act, lst, [](BenchRecord* x){ return x->hostVisible; }) != nullptr;
+      }
+      g_sink += s;
+    });
+    printf("  idle minute, %zu instances: poll wakeups=120 visibility checks=%zu, event wakeups=0 (%zu toggles resolved)\n",
+      ids.size(), ids.size() * 120, toggles);
+  }
+
+  // Title churn: every host fires 8 title/navigation events per timer tick -> one refresh per host per tick
+  {
+    RefreshScheduler sched; size_t refreshed = 0; const int ticks = iters;
+    Run("RefreshScheduler burst+flush", (size_t)ticks * hosts.size() * 8, [&]{
+      for (int t = 0; t < ticks; ++t) {
+        for (int burst = 0; burst < 8; ++burst) for (HWND h : hosts) sched.Request((void*)h);
+        sched.Flush([&](void* key){ refreshed += reg.FindByHwnd((HWND)key) != nullptr; });
+      }
+    });
+    printf("  requested=%llu executed=%llu coalesced=%llu flushes=%llu refreshed=%zu\n",
+      sched.Requested(), sched.Executed(), sched.Coalesced(), sched.Flushes(), refreshed);
+  }
+
+  // Lookup scaling: indexed FindByHwnd/FindByNativeView vs the old linear scan, on synthetic handles
+  // (the index never dereferences them) so large counts do not need real windows
+  printf("lookup scaling (ns/op):\n%8s %14s %14s %14s\n", "N", "FindByHwnd", "FindByView", "linear scan");
+  for (size_t n : { (size_t)100, (size_t)1000, (size_t)10000 }) {
+    InstanceRegistry<BenchRecord> sr; sr.reserve(n);
+    std::vector<HWND> hs; std::vector<const void*> vs; hs.reserve(n); vs.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+      const std::string id = "wv_" + std::to_string(i);
+      auto rec = std::make_unique<BenchRecord>(); rec->id = id;
+      BenchRecord* r = sr.Insert(id, std::move(rec));
+      hs.push_back((HWND)(uintptr_t)(0x10000 + i * 16)); vs.push_back((const void*)(uintptr_t)(0x900000 + i * 32));
+      sr.SetHwnd(r, hs.back()); sr.SetNativeView(r, vs.back());
+    }
+    const size_t q = 200000; size_t s = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (size_t k = 0; k < q; ++k) s += sr.FindByHwnd(hs[(k * 7919) % n]) != nullptr;
+    auto t1 = std::chrono::steady_clock::now();
+    for (size_t k = 0; k < q; ++k) s += sr.FindByNativeView(vs[(k * 7919) % n]) != nullptr;
+    auto t2 = std::chrono::steady_clock::now();
+    const size_t qLin = q / (n / 100); // keep the O(n) column affordable
+    for (size_t k = 0; k < qLin; ++k) {
+      HWND h = hs[(k * 7919) % n];
+      for (auto& kv : sr) if (kv.second->hwnd == h) { ++s; break; }
+    }
+    auto t3 = std::chrono::steady_clock::now();
+    auto ns = [](std::chrono::steady_clock::duration d, size_t ops){ return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(d).count() / (double)ops; };
+    printf("%8zu %14.1f %14.1f %14.1f\n", n, ns(t1 - t0, q), ns(t2 - t1, q), ns(t3 - t2, qLin));
+    g_sink += s;
+  }
+
+  for (HWND h : hosts) DestroyWindow(h);
+  DestroyWindow(root);
+  printf("sink=%zu\n", (size_t)g_sink);
+  return 0;
+}
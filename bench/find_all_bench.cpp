@@ -0,0 +1,145 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// bench/find_all_bench.cpp
+// Find in all panels (core/find_all.h) without pages: panels answer the count script after a simulated page
+// time, the way the generated script would answer. Reports the wait for a result list when the query is
+// dispatched to every panel at once (bounded by the slowest panel) against asking the panels one after the
+// other, and the native cost per panel; checks routing by handle, failed evaluations, timeouts with late
+// answers, the pending cap and the result JSON.
+//
+//   reaper_webview_find_all_bench [--check] [searches]
+
+#include <algorithm>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+#include "bench_util.h"
+#include "core/find_all.h"
+#include "core/json_cursor.h"
+
+// Page answer: [handle, matches, [snippets], pageMs]
+static std::string Answer(int handle, int matches, const std::vector<std::string>& hits, int pageMs)
+{
+  std::string out = "[" + std::to_string(handle) + "," + std::to_string(matches) + ",[";
+  for (size_t i = 0; i < hits.size(); ++i) { if (i) out += ','; JsonAppendQuoted(out, hits[i]); }
+  return out + "]," + std::to_string(pageMs) + "]";
+}
+
+static std::vector<std::pair<std::string, std::string>> Panels(int n)
+{
+  std::vector<std::pair<std::string, std::string>> p;
+  for (int i = 0; i < n; ++i) p.emplace_back("wv_" + std::to_string(i), "Manual " + std::to_string(i));
+  return p;
+}
+
+int main(int argc, char** argv)
+{
+  BenchParseArgs(argc, argv);
+  const long searches = argc > 1 ? atol(argv[1]) : 20000;
+  if (searches <= 0) { fprintf(stderr, "usage: %s [--check] [searches>0]\n", argv[0]); return 1; }
+  std::string json;
+
+  // scripts: the query travels JSON-quoted, options are clamped
+  {
+    FindAllOptions o; o.maxHits = 1000; o.contextChars = -5;
+    const std::string js = FindAllCountScript(42, "say \"hi\"\n", o);
+    CHECK(js.find("(42,\"say \\\"hi\\\"\\n\",false,200,0,0)") != std::string::npos);
+    CHECK(FindAllJumpScript("x", true, 0).find(",true,0,0,1)") != std::string::npos);
+  }
+
+  // routing: answers by handle, interleaved searches, failed evaluation, result JSON
+  {
+    FindAllSearches f; uint64_t now = 1000;
+    const int a = f.Begin("reaper", FindAllOptions(), Panels(3), now);
+    const int b = f.Begin("track", FindAllOptions(), Panels(2), now + 1);
+    CHECK(a > 0 && b > 0 && a != b && f.Pending() == 2);
+    f.OnPanelResult("wv_1", Answer(b, 4, { "…a track…" }, 2), now + 5);
+    f.OnPanelResult("wv_1", Answer(a, 7, { "…reaper one…", "…reaper two…" }, 3), now + 8);
+    CHECK(f.Get(a, json) == 0 && f.Get(b, json) == 0);
+    f.OnPanelResult("wv_0", "", now + 9); // failed evaluation: the oldest search waiting for wv_0
+    f.OnPanelResult("wv_2", Answer(a, 0, {}, 1), now + 20);
+    CHECK(f.Get(a, json) == -1);
+    CHECK(json.find("\"query\":\"reaper\",\"total\":7,\"ms\":20,") != std::string::npos);
+    CHECK(json.find("{\"id\":\"wv_0\",\"title\":\"Manual 0\",\"error\":\"evaluation failed\"}") != std::string::npos);
+    CHECK(json.find("\"matches\":7,\"ms\":8,\"pageMs\":3,\"hits\":[\"…reaper one…\",\"…reaper two…\"]") != std::string::npos);
+    CHECK(f.Get(b, json) == 0);
+    f.OnPanelResult("wv_0", Answer(b, 1, { "track" }, 1), now + 30);
+    CHECK(f.Get(b, json) == 1 && json.find("\"total\":5") != std::string::npos);
+    CHECK(f.Get(a, json) == -1); // still readable for the jump
+    CHECK(f.Find(a) && f.Find(a)->query == "reaper");
+    CHECK(f.Get(a + b + 100, json) == -4);
+  }
+
+  // timeouts: the slow panel is reported, its late answer dropped; Fail for panels without a view
+  {
+    FindAllSearches f; uint64_t now = 50;
+    FindAllOptions o; o.timeoutMs = 100;
+    const int h = f.Begin("x", o, Panels(3), now);
+    f.Fail(h, "wv_2", "no live view", now);
+    f.OnPanelResult("wv_0", Answer(h, 2, {}, 1), now + 10);
+    f.Expire(now + 99); CHECK(f.Get(h, json) == 0);
+    f.Expire(now + 100); CHECK(f.Get(h, json) == -1);
+    CHECK(json.find("{\"id\":\"wv_1\",\"title\":\"Manual 1\",\"error\":\"timeout\"}") != std::string::npos);
+    CHECK(json.find("\"error\":\"no live view\"") != std::string::npos);
+    f.OnPanelResult("wv_1", Answer(h, 9, {}, 1), now + 150); // late
+    CHECK(f.Get(h, json) == -1 && json.find("\"total\":2") != std::string::npos);
+    CHECK(f.Timeouts() == 1 && f.Pending() == 0);
+  }
+
+  // caps: pending searches, kept results
+  {
+    FindAllSearches f; uint64_t now = 1;
+    std::vector<int> hs;
+    for (int i = 0; i < FindAllSearches::kMaxPending; ++i) hs.push_back(f.Begin("q", FindAllOptions(), Panels(1), now));
+    CHECK(f.Begin("q", FindAllOptions(), Panels(1), now) == -1);
+    for (int h : hs) f.OnPanelResult("wv_0", Answer(h, 1, {}, 0), now);
+    CHECK(f.Pending() == 0);
+    for (int i = 0; i < FindAllSearches::kMaxKept + 5; ++i) {
+      const int h = f.Begin("q", FindAllOptions(), Panels(1), now);
+      f.OnPanelResult("wv_0", Answer(h, 1, {}, 0), now);
+    }
+    CHECK(f.Get(hs[0], json) == -4); // oldest dropped
+  }
+  CHECK(FindAllSearches().Begin("", FindAllOptions(), Panels(1), 0) == -1);
+
+  // latency: 6 panels of different sizes; page time per search drawn around a per-panel base
+  const int panels = 6;
+  const int baseMs[panels] = { 4, 9, 15, 22, 35, 60 }; // small doc page .. long manual
+  FindAllSearches f;
+  uint64_t now = 0;
+  unsigned rnd = 12345;
+  std::vector<std::pair<int, int>> order; // (answer time, panel)
+  const std::vector<std::pair<std::string, std::string>> list = Panels(panels);
+  const std::vector<std::string> hits = { "…the track routing…", "…track FX chain…" };
+  double parallelMs = 0, sequentialMs = 0;
+  clk::time_point t0 = clk::now();
+  for (long i = 0; i < searches; ++i) {
+    const int h = f.Begin("track", FindAllOptions(), list, now);
+    const std::string js = FindAllCountScript(h, "track", FindAllOptions()); // built once, sent to every panel
+    if (js.empty()) ++g_mismatches;
+    order.clear();
+    int seq = 0;
+    for (int p = 0; p < panels; ++p) {
+      rnd = rnd * 1103515245u + 12345u;
+      const int ms = baseMs[p] + (int)((rnd >> 16) % (unsigned)(baseMs[p] / 2 + 1));
+      order.emplace_back(ms, p);
+      seq += ms;
+    }
+    std::sort(order.begin(), order.end());
+    for (const auto& o : order) f.OnPanelResult(list[o.second].first, Answer(h, 3, hits, o.first), now + o.first);
+    if (f.Get(h, json) != 1) ++g_mismatches;
+    parallelMs += order.back().first;
+    sequentialMs += seq;
+    now += 1000;
+  }
+  const double perPanelNs = NsSince(t0) / (double)(searches * panels);
+
+  BenchPrintf("%ld searches over %d panels: result list after %.1f ms dispatched at once vs %.1f ms one panel after another (%.1fx)\n",
+              searches, panels, parallelMs / (double)searches, sequentialMs / (double)searches, sequentialMs / parallelMs);
+  BenchPrintf("aggregator: avg %.1f ms, max %llu ms, sequential equivalent %.1f ms\n", f.AvgTotalMs(), f.MaxTotalMs(), f.AvgPanelSumMs());
+  BenchPrintf("native cost per panel (script + answer parse + result JSON): %.0f ns\n", perPanelNs);
+  return BenchResult(g_mismatches);
+}
@@ -0,0 +1,135 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// bench/find_index_bench.cpp
+// Find-in-page on a large synthetic document: the old per-keystroke path (join every text node,
+// lowercase the whole string, indexOf loop - what __rwvFind v4 did before wrapping spans) vs FindIndex
+// (snapshot loaded once, incremental queries, SIMD scan). Also cross-checks that both report the same hits.
+//
+//   reaper_webview_find_index_bench [--check] [textNodes] [rounds]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+#include "bench_util.h"
+#include "core/find_index.h"
+
+static std::u16string U16(const char* ascii) { std::u16string s; while (*ascii) s.push_back((char16_t)(unsigned char)*ascii++); return s; }
+
+// ---------------- synthetic page ----------------
+struct Page { std::vector<std::u16string> nodes; };
+
+static Page MakePage(size_t nodeCount)
+{
+  static const char* kWords[] = { "Search", "research", "track", "Mixer", "send", "return", "Routing", "volume", "pan",
+                                  "envelope", "Item", "take", "marker", "Region", "tempo", "project", "render", "the", "a", "of" };
+  static const char16_t kCyr[][8] = { u"Река", u"рекорд", u"трек", u"Микшер", u"поиск" };
+  Page p; p.nodes.reserve(nodeCount);
+  uint32_t seed = 12345;
+  auto rnd = [&seed]() { seed = seed * 1103515245u + 12345u; return (seed >> 16) & 0x7FFF; };
+  for (size_t i = 0; i < nodeCount; ++i) {
+    std::u16string n;
+    const int words = 6 + (int)(rnd() % 30);
+    for (int w = 0; w < words; ++w) {
+      if (rnd() % 9 == 0) n += kCyr[rnd() % 5]; else n += U16(kWords[rnd() % (sizeof(kWords) / sizeof(kWords[0]))]);
+      n.push_back(rnd() % 11 == 0 ? u'.' : u' ');
+    }
+    p.nodes.push_back(std::move(n));
+  }
+  return p;
+}
+
+// ---------------- legacy per-keystroke path ----------------
+static void LegacySearch(const Page& p, const std::u16string& term, bool cs, std::vector<uint32_t>& out)
+{
+  out.clear();
+  std::u16string big; // parts.join('')
+  for (const auto& n : p.nodes) big += n;
+  std::u16string t = term;
+  if (!cs) { for (auto& c : big) c = FoldCase16(c); for (auto& c : t) c = FoldCase16(c); } // toLowerCase() on both
+  size_t pos = 0;
+  while ((pos = big.find(t, pos)) != std::u16string::npos) { out.push_back((uint32_t)pos); pos += t.size() ? t.size() : 1; }
+}
+
+static volatile size_t g_sink = 0;
+
+int main(int argc, char** argv)
+{
+  BenchParseArgs(argc, argv);
+  const long nodeCount = argc > 1 ? atol(argv[1]) : 20000;
+  const long rounds = argc > 2 ? atol(argv[2]) : 5;
+  if (nodeCount <= 0 || rounds <= 0) { fprintf(stderr, "usage: %s [--check] [textNodes>0] [rounds>0]\n", argv[0]); return 1; }
+
+  const Page page = MakePage((size_t)nodeCount);
+  std::u16string text; std::vector<uint32_t> lens;
+  for (const auto& n : page.nodes) { text += n; lens.push_back((uint32_t)n.size()); }
+  BenchPrintf("document: %ld text nodes, %zu UTF-16 units\n", nodeCount, text.size());
+
+  // Typing sessions: every prefix of the word is one keystroke
+  const std::u16string sessions[] = { U16("search"), U16("envelope"), u"река", U16("tempo"), U16("ab") };
+
+  // ---- correctness: index (incremental) == legacy, SIMD == scalar
+  int mismatches = 0;
+  {
+    FindIndex idx; idx.Load(text, lens, 1);
+    std::vector<uint32_t> legacy, a, b;
+    for (int cs = 0; cs < 2; ++cs)
+      for (const auto& word : sessions)
+        for (size_t k = 1; k <= word.size(); ++k) {
+          const std::u16string q = word.substr(0, k);
+          LegacySearch(page, q, cs != 0, legacy);
+          if (idx.Search(q, cs != 0) != legacy) { ++mismatches; printf("hit mismatch cs=%d len=%zu\n", cs, k); }
+          a.clear(); b.clear();
+          FindAllU16(text.data(), text.size(), q.data(), q.size(), a);
+          FindAllU16Scalar(text.data(), text.size(), q.data(), q.size(), b);
+          if (a != b) { ++mismatches; printf("simd/scalar mismatch len=%zu\n", k); }
+        }
+  }
+
+  // ---- legacy: every keystroke re-joins, re-lowercases and re-scans the page
+  size_t keystrokes = 0;
+  auto t0 = clk::now();
+  for (long r = 0; r < rounds; ++r)
+    for (const auto& word : sessions)
+      for (size_t k = 1; k <= word.size(); ++k) { std::vector<uint32_t> h; LegacySearch(page, word.substr(0, k), false, h); g_sink += h.size(); ++keystrokes; }
+  const double legacyMs = MsSince(t0);
+
+  // ---- index: one snapshot load per round (DOM changed), then incremental keystrokes
+  double loadMs = 0, firstMs = 0, refineMs = 0; size_t firsts = 0, refines = 0;
+  for (long r = 0; r < rounds; ++r) {
+    FindIndex idx;
+    auto tl = clk::now(); idx.Load(text, lens, (uint32_t)r + 1); loadMs += MsSince(tl);
+    for (const auto& word : sessions)
+      for (size_t k = 1; k <= word.size(); ++k) {
+        auto tq = clk::now();
+        g_sink += idx.Search(word.substr(0, k), false).size();
+        if (idx.LastSearchRefined()) { refineMs += MsSince(tq); ++refines; } else { firstMs += MsSince(tq); ++firsts; }
+      }
+  }
+  const double indexMs = loadMs + firstMs + refineMs;
+
+  // ---- raw scan: SIMD vs scalar over the folded text, full query each time
+  std::u16string folded(text.size(), u'\0'); FoldCase16(text.data(), text.size(), &folded[0]);
+  double simdMs = 0, scalarMs = 0; size_t scans = 0;
+  for (long r = 0; r < rounds; ++r)
+    for (const auto& word : sessions) {
+      std::u16string q(word.size(), u'\0'); FoldCase16(word.data(), word.size(), &q[0]);
+      std::vector<uint32_t> o; o.reserve(1 << 16);
+      auto ts = clk::now(); FindAllU16(folded.data(), folded.size(), q.data(), q.size(), o); simdMs += MsSince(ts); g_sink += o.size(); o.clear();
+      auto tc = clk::now(); FindAllU16Scalar(folded.data(), folded.size(), q.data(), q.size(), o); scalarMs += MsSince(tc); g_sink += o.size();
+      ++scans;
+    }
+
+  BenchPrintf("%-34s %6zu keys %10.3f ms/key\n", "legacy join+lowercase+indexOf", keystrokes, legacyMs / (double)keystrokes);
+  BenchPrintf("%-34s %6zu keys %10.3f ms/key  (x%.1f)\n", "FindIndex (load + incremental)", keystrokes, indexMs / (double)keystrokes,
+              indexMs > 0 ? legacyMs / indexMs : 0.0);
+  BenchPrintf("  %-32s %6ld      %10.3f ms\n", "snapshot load", rounds, loadMs / (double)rounds);
+  BenchPrintf("  %-32s %6zu      %10.3f ms\n", "first keystroke (fold + scan)", firsts, firsts ? firstMs / (double)firsts : 0.0);
+  BenchPrintf("  %-32s %6zu      %10.3f ms\n", "refined keystroke", refines, refines ? refineMs / (double)refines : 0.0);
+  BenchPrintf("%-34s %6zu scans %9.3f ms/scan\n", "FindAllU16Scalar", scans, scalarMs / (double)scans);
+  BenchPrintf("%-34s %6zu scans %9.3f ms/scan (x%.1f)\n", "FindAllU16 (SIMD filter)", scans, simdMs / (double)scans, simdMs > 0 ? scalarMs / simdMs : 0.0);
+  BenchPrintf("sink=%zu\n", (size_t)g_sink);
+  return BenchResult(mismatches);
+}
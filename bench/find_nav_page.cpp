@@ -0,0 +1,76 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// bench/find_nav_page.cpp
+// Writes a self-contained HTML page that measures find next/previous latency in a real engine
+// (open it in Safari / WebKitGTK MiniBrowser / Edge). It embeds the shipped __rwvFind helper verbatim
+// and compares, per keypress (step + forced layout):
+//   - range highlights (CSS Highlight API)   : __rwvFind.step(1), scroll + repaint of the painted window
+//   - overlay layer (no Highlight API)       : same
+//   - legacy spans                           : 5000 wrapped spans, querySelectorAll + restyle of every span
+//
+//   reaper_webview_find_nav_page [matches] [out.html]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+
+#include "core/find_script.h"
+
+static const char* kHarnessJS = R"JS(
+function legacySelect(i){var L=document.querySelectorAll('span.__rwv_find'); for(var k=0;k<L.length;k++){L[k].classList.remove('__rwv_find_current'); L[k].style.background='rgba(255,230,128,0.9)'; L[k].style.outline='1px solid rgba(255,180,0,0.4)';} if(i>=1 && i<=L.length){var el=L[i-1]; el.classList.add('__rwv_find_current'); el.style.background='rgba(255,150,0,0.95)'; el.style.outline='2px solid rgba(255,90,0,0.9)'; el.scrollIntoView({block:'center'});}}
+function hitsFor(F,term){var snap=F.snapshot(0), text=snap[2].toLowerCase(), hits=[], p=0; while((p=text.indexOf(term,p))!==-1){hits.push(p);p+=term.length;} return [snap[0],hits];}
+function prepare(term){var F=window.__rwvFind, s=hitsFor(F,term), t0=performance.now(), n=F.apply(s[0],term.length,s[1]); return {count:n, applyMs:performance.now()-t0};}
+// Old renderer: wrap up to 5000 matches in spans, back to front (as __rwvFind v4 did)
+function legacyWrap(term){
+  var F=window.__rwvFind; F.clear(); var s=hitsFor(F,term), hits=s[1], L=term.length; if(hits.length>5000) hits.length=5000;
+  var t0=performance.now();
+  for(var j=hits.length-1;j>=0;j--){var a=F.locate(hits[j]), b=F.locate(hits[j]+L-1), r=document.createRange(); r.setStart(F.nodes[a],hits[j]-F.starts[a]); r.setEnd(F.nodes[b],hits[j]+L-F.starts[b]);
+    var sp=document.createElement('span'); sp.className='__rwv_find'; sp.style.background='rgba(255,230,128,0.9)'; sp.appendChild(r.extractContents()); r.insertNode(sp);}
+  void document.body.offsetHeight;
+  return {count:hits.length, applyMs:performance.now()-t0};
+}
+function measure(fn,steps){
+  var t=[];
+  for(var k=1;k<=steps;k++){var t0=performance.now(); fn(k); void document.body.offsetHeight; t.push(performance.now()-t0);}
+  t.sort(function(a,b){return a-b;});
+  return {median:t[t.length>>1], p95:t[Math.floor(t.length*0.95)], max:t[t.length-1]};
+}
+function fmt(label,prep,m,steps,what){return label+': matches='+prep.count+' apply='+prep.applyMs.toFixed(1)+' ms | '+steps+' '+what+' median='+m.median.toFixed(3)+' p95='+m.p95.toFixed(3)+' max='+m.max.toFixed(3)+' ms';}
+function run(){
+  var out=[], F=window.__rwvFind, term='match', hl=F.useHL, scroll=function(){window.scrollBy(0,400); F.render();};
+  if(hl){ var a=prepare(term); out.push(fmt('range highlights',a,measure(function(){F.step(1);},500),500,'keypresses')); out.push(fmt('range highlights',a,measure(scroll,200),200,'scroll+repaint')); F.clear(); window.scrollTo(0,0); }
+  else out.push('range highlights: CSS Highlight API not available in this engine');
+  F.useHL=false;
+  var b=prepare(term); out.push(fmt('overlay layer   ',b,measure(function(){F.step(1);},500),500,'keypresses')); out.push(fmt('overlay layer   ',b,measure(scroll,200),200,'scroll+repaint'));
+  F.clear(); F.useHL=hl; window.scrollTo(0,0);
+  var c=legacyWrap(term); out.push(fmt('legacy spans    ',c,measure(function(k){legacySelect(k);},50),50,'keypresses'));
+  document.getElementById('out').textContent=out.join('\n'); console.log(out.join('\n'));
+}
+)JS";
+
+int main(int argc, char** argv)
+{
+  const long matches = argc > 1 ? atol(argv[1]) : 50000;
+  const char* path = argc > 2 ? argv[2] : "find_nav_bench.html";
+  if (matches <= 0) { fprintf(stderr, "usage: %s [matches>0] [out.html]\n", argv[0]); return 1; }
+
+  std::string body;
+  static const char* kFiller[] = { "Routing", "send", "volume", "envelope", "Region", "tempo", "render" };
+  for (long i = 0; i < matches; ++i) {
+    if (i % 20 == 0) body += i ? "</p>\n<p>" : "<p>";
+    body += kFiller[i % 7]; body += (i % 3) ? " Match " : " match "; body += kFiller[(i * 3) % 7]; body += ". ";
+  }
+  body += "</p>\n";
+
+  FILE* f = fopen(path, "wb");
+  if (!f) { fprintf(stderr, "cannot write %s\n", path); return 1; }
+  fprintf(f, "<!doctype html>\n<html><head><meta charset=\"utf-8\"><title>rwv find navigation bench</title>\n"
+             "<style>body{font:14px sans-serif;margin:2em}#out{position:fixed;top:0;right:0;background:#fff;border:1px solid #888;padding:6px;white-space:pre}</style>\n"
+             "</head><body>\n<button onclick=\"run()\" style=\"position:fixed;top:0;left:0\">run</button><pre id=\"out\">press run</pre>\n");
+  fputs(body.c_str(), f);
+  fprintf(f, "<script>\n%s\n%s\n</script>\n</body></html>\n", kFindHelperJS, kHarnessJS);
+  fclose(f);
+  printf("wrote %s: %ld matches, helper v%d\n", path, matches, kFindHelperVersion);
+  return 0;
+}
@@ -0,0 +1,149 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// bench/log_ring_bench.cpp
+// Logging cost on the calling thread: the old path (timestamp + fopen/append/fclose per line) against
+// LogWriter (format + one ring slot, writer thread batching), single-threaded and with several threads
+// logging at once. Checks that every line not counted as dropped reaches the files, that rotation keeps
+// the configured number of files under the size limit, and the tag/level filter.
+//
+//   reaper_webview_log_ring_bench [--check] [lines] [threads] [dir]
+
+#include <chrono>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <thread>
+#include <time.h>
+#include <vector>
+
+#include "bench_util.h"
+#include "core/log_ring.h"
+
+// What log.h did per line before the ring
+static void OldWriteLine(const std::string& path, const char* s)
+{
+  char line[4600];
+  const time_t now = time(nullptr);
+  struct tm tmv;
+#ifdef _WIN32
+  localtime_s(&tmv, &now);
+#else
+  localtime_r(&now, &tmv);
+#endif
+  snprintf(line, sizeof(line), "%04d-%02d-%02d %02d:%02d:%02d.000 %s", tmv.tm_year + 1900, tmv.tm_mon + 1, tmv.tm_mday,
+           tmv.tm_hour, tmv.tm_min, tmv.tm_sec, s);
+  FILE* f = fopen(path.c_str(), "ab");
+  if (f) { fputs(line, f); fputc('\n', f); fclose(f); }
+}
+
+static void PushF(LogWriter& w, const char* fmt, ...)
+{
+  char buf[kLogTextMax + 1];
+  va_list ap; va_start(ap, fmt);
+  const int n = vsnprintf(buf, sizeof(buf), fmt, ap);
+  va_end(ap);
+  if (n >= 0) w.Push(kLogInfo, buf, (size_t)n < sizeof(buf) ? (size_t)n : sizeof(buf) - 1);
+}
+
+static size_t CountLines(const std::string& path, size_t* bytes = nullptr)
+{
+  FILE* f = fopen(path.c_str(), "rb");
+  if (!f) return 0;
+  size_t n = 0, b = 0; char buf[65536]; size_t r;
+  while ((r = fread(buf, 1, sizeof(buf), f)) > 0) { b += r; for (size_t i = 0; i < r; ++i) n += buf[i] == '\n'; }
+  fclose(f);
+  if (bytes) *bytes = b;
+  return n;
+}
+
+static std::string Numbered(const std::string& base, int i) { return base + "." + std::to_string(i) + ".txt"; }
+
+int main(int argc, char** argv)
+{
+  BenchParseArgs(argc, argv);
+  const long lines = argc > 1 ? atol(argv[1]) : 20000;
+  const int threads = argc > 2 ? atoi(argv[2]) : 4;
+  const std::string dir = argc > 3 ? argv[3] : ".";
+  if (lines <= 0 || threads <= 0) { fprintf(stderr, "usage: %s [--check] [lines>0] [threads>0] [dir]\n", argv[0]); return 1; }
+  int mismatches = 0;
+
+  // old path, one thread (fewer lines: it is slow)
+  const std::string oldPath = dir + "/rwv_log_bench_old.txt";
+  remove(oldPath.c_str());
+  const long oldLines = lines / 10 ? lines / 10 : 1;
+  clk::time_point t0 = clk::now();
+  char msg[256];
+  for (long i = 0; i < oldLines; ++i) { snprintf(msg, sizeof(msg), "[Find] query='abc' idx=%ld total=%ld", i, lines); OldWriteLine(oldPath, msg); }
+  const double oldNs = NsSince(t0) / (double)oldLines;
+  remove(oldPath.c_str());
+
+  // ring, one thread then N threads; ring sized so a burst fits, the writer drains in the background
+  const std::string base = dir + "/rwv_log_bench";
+  auto clean = [&]() { remove((base + ".txt").c_str()); for (int i = 1; i <= 9; ++i) remove(Numbered(base, i).c_str()); };
+  clean();
+  LogWriterOptions o;
+  o.path = base + ".txt"; o.maxBytes = 0; o.toStderr = false; o.ringSlots = 8192;
+  double oneNs = 0, multiNs = 0;
+  {
+    LogWriter w;
+    w.Start(o);
+    t0 = clk::now();
+    for (long i = 0; i < lines; ++i) PushF(w, "[Find] query='abc' idx=%ld total=%ld", i, lines);
+    oneNs = NsSince(t0) / (double)lines;
+    std::vector<std::thread> ts;
+    std::vector<double> per(threads);
+    for (int t = 0; t < threads; ++t)
+      ts.emplace_back([&, t]() {
+        const clk::time_point s = clk::now();
+        for (long i = 0; i < lines; ++i) PushF(w, "[FocusTick] thread=%d line=%ld", t, i);
+        per[t] = NsSince(s) / (double)lines;
+      });
+    for (auto& th : ts) th.join();
+    for (double d : per) multiNs += d / threads;
+    w.Stop();
+    const size_t written = CountLines(o.path);
+    const unsigned long long expect = (unsigned long long)lines * (threads + 1);
+    BenchPrintf("ring: %llu lines pushed, %llu dropped, %zu in file, %llu batches (max %llu lines), writer %.1f ms\n",
+                expect, w.Dropped(), written, w.Batches(), w.MaxBatch(), w.WriteMs());
+    if (written + w.Dropped() != expect || w.Lines() != written) ++mismatches;
+  }
+  clean();
+
+  // rotation: 64 KB files, 2 kept
+  {
+    LogWriter w;
+    o.maxBytes = 64 << 10; o.keepFiles = 2;
+    w.Start(o);
+    for (long i = 0; i < 5000; ++i) { PushF(w, "[Rotate] line %ld padding padding padding padding", i); if (i % 512 == 0) std::this_thread::sleep_for(std::chrono::milliseconds(1)); }
+    w.Stop();
+    size_t b0 = 0, b1 = 0, b2 = 0;
+    CountLines(o.path, &b0); CountLines(Numbered(base, 1), &b1); CountLines(Numbered(base, 2), &b2);
+    FILE* extra = fopen(Numbered(base, 3).c_str(), "rb");
+    BenchPrintf("rotation: %llu rotations, files %zu / %zu / %zu bytes\n", w.Rotations(), b0, b1, b2);
+    if (extra) { fclose(extra); ++mismatches; }
+    if (!w.Rotations() || b0 > o.maxBytes || b1 > o.maxBytes || b2 > o.maxBytes || !b1 || !b2) ++mismatches;
+  }
+  clean();
+
+  // filter
+  LogFilter f;
+  f.SetTags("-FocusTick,-Find");
+  if (f.Allows(kLogInfo, "[FocusTick] x") || f.Allows(kLogInfo, "[FindNav] x") || !f.Allows(kLogInfo, "[API] x") || !f.Allows(kLogInfo, "untagged")) ++mismatches;
+  f.SetTags("Asset, Filter");
+  if (!f.Allows(kLogInfo, "[Asset] x") || f.Allows(kLogInfo, "[API] x")) ++mismatches;
+  f.SetTags(""); f.SetLevel(ParseLogLevel("WARN", kLogDebug));
+  if (f.Allows(kLogInfo, "[API] x") || !f.Allows(kLogError, "[API] x")) ++mismatches;
+  t0 = clk::now();
+  size_t passed = 0;
+  f.SetLevel(kLogDebug); f.SetTags("-FocusTick");
+  for (long i = 0; i < lines; ++i) passed += f.Allows(kLogInfo, (i & 1) ? "[FocusTick] %s" : "[Find] %s");
+  const double filterNs = NsSince(t0) / (double)lines;
+  if (passed != (size_t)lines / 2) ++mismatches;
+
+  BenchPrintf("per line on the caller: fopen/append/fclose %.0f ns, ring %.0f ns (x%.0f), ring with %d threads %.0f ns, filter check %.1f ns\n",
+              oldNs, oneNs, oneNs > 0 ? oldNs / oneNs : 0.0, threads + 0, multiNs, filterNs);
+  return BenchResult(mismatches);
+}
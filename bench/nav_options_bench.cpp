@@ -0,0 +1,119 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// bench/nav_options_bench.cpp
+// WEBVIEW_Navigate opts parsing: legacy per-key GetJsonString scans (verbatim copy of the old helpers)
+// vs the single-pass ParseNavigateOptions. Also cross-checks that both agree on the common inputs.
+//
+//   reaper_webview_nav_options_bench [--check] [iterations]
+
+#include <chrono>
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+#include "bench_util.h"
+#include "core/nav_options.h"
+
+// ---------------- legacy helpers (as they were in helpers.mm) ----------------
+static const char* LegacyStrCaseStr(const char* h, const char* n) // strcasestr, portable
+{
+  const size_t nl = strlen(n);
+  for (; *h; ++h) {
+    size_t i = 0; while (i < nl && h[i] && tolower((unsigned char)h[i]) == tolower((unsigned char)n[i])) ++i;
+    if (i == nl) return h;
+  }
+  return nullptr;
+}
+
+static bool legacy_is_truthy(const char* s) { return s && *s && !(s[0] == '0' && s[1] == '\0'); }
+
+static std::string LegacyGetJsonString(const char* json, const char* key)
+{
+  if (!json || !*json) return {};
+  const char* p = json;
+  std::string pat = "\""; pat += key; pat += "\"";
+  const char* k = LegacyStrCaseStr(p, pat.c_str());
+  if (!k) return {};
+  const char* c = strchr(k, ':'); if (!c) return {};
+  while (*c && (*c == ':' || *c == ' ' || *c == '\t')) ++c;
+
+  std::string out;
+  if (*c == '\"') {
+    ++c;
+    while (*c && *c != '\"') { out.push_back(*c); ++c; }
+  } else {
+    while (*c && *c != ',' && *c != '}') { out.push_back(*c); ++c; }
+    while (!out.empty() && isspace((unsigned char)out.back())) out.pop_back();
+  }
+  size_t i = 0; while (i < out.size() && isspace((unsigned char)out[i])) ++i;
+  return out.substr(i);
+}
+
+static ShowPanelMode LegacyParseShowPanel(const std::string& v) { return ParseShowPanel(v.c_str(), v.size()); }
+
+struct LegacyResult { std::string title, inst; ShowPanelMode show = ShowPanelMode::Unset; bool basic = false; };
+
+static void LegacyParse(const char* opts, LegacyResult& r)
+{
+  r = LegacyResult();
+  if (!legacy_is_truthy(opts)) return;
+  r.title = LegacyGetJsonString(opts, "SetTitle");
+  r.inst  = LegacyGetJsonString(opts, "InstanceId");
+  r.show  = LegacyParseShowPanel(LegacyGetJsonString(opts, "ShowPanel"));
+  std::string bcm = LegacyGetJsonString(opts, "BasicCtxMenu");
+  if (!bcm.empty()) r.basic = legacy_is_truthy(bcm.c_str());
+}
+
+// ---------------- bench ----------------
+static volatile size_t g_sink = 0;
+
+int main(int argc, char** argv)
+{
+  BenchParseArgs(argc, argv);
+  const long iters = argc > 1 ? atol(argv[1]) : 200000;
+  if (iters <= 0) { fprintf(stderr, "usage: %s [--check] [iterations>0]\n", argv[0]); return 1; }
+
+  static const char* kInputs[] = {
+    "0",
+    "{\"InstanceId\":\"wv_mixer\"}",
+    "{\"SetTitle\":\"Mixer notes\",\"InstanceId\":\"wv_notes\",\"ShowPanel\":\"docker\",\"BasicCtxMenu\":1}",
+    "{ \"instanceid\" : \"random\" , \"showpanel\" : \"ALWAYS\" }",
+    "{\"Meta\":{\"a\":[1,2,{\"b\":\"}\"}]},\"Extra\":12.5e3,\"Flag\":true,\"InstanceId\":\"wv_deep\",\"SetTitle\":\"Track FX\"}",
+  };
+  const size_t nIn = sizeof(kInputs) / sizeof(kInputs[0]);
+
+  // agreement check on inputs both parsers understand
+  int mismatches = 0;
+  for (size_t i = 0; i < nIn; ++i) {
+    LegacyResult lr; LegacyParse(kInputs[i], lr);
+    NavigateOptions no; ParseNavigateOptions(kInputs[i], no);
+    const bool same = lr.title == no.setTitle && lr.inst == no.instanceId && lr.show == no.showPanel && lr.basic == (no.basicCtxMenu == 1);
+    if (!same) { ++mismatches; printf("mismatch on input %zu: '%s'\n", i, kInputs[i]); }
+  }
+  // escaped quote: legacy truncates at the backslash-quote, the new parser keeps it
+  {
+    const char* esc = "{\"SetTitle\":\"Say \\\"hi\\\" \\u2192 ok\"}";
+    LegacyResult lr; LegacyParse(esc, lr); NavigateOptions no; ParseNavigateOptions(esc, no);
+    BenchPrintf("escaped title: legacy='%s' new='%s'\n", lr.title.c_str(), no.setTitle);
+  }
+
+  const size_t ops = (size_t)iters * nIn;
+
+  auto t0 = clk::now();
+  for (long it = 0; it < iters; ++it)
+    for (size_t i = 0; i < nIn; ++i) { LegacyResult r; LegacyParse(kInputs[i], r); g_sink += r.title.size() + (size_t)r.show; }
+  auto t1 = clk::now();
+  for (long it = 0; it < iters; ++it)
+    for (size_t i = 0; i < nIn; ++i) { NavigateOptions o; ParseNavigateOptions(kInputs[i], o); g_sink += (size_t)o.hasSetTitle + (size_t)o.showPanel; }
+  auto t2 = clk::now();
+
+  const double legacyNs = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count() / (double)ops;
+  const double newNs    = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1).count() / (double)ops;
+  BenchPrintf("%-28s %10zu ops %10.1f ns/op\n", "legacy GetJsonString x4", ops, legacyNs);
+  BenchPrintf("%-28s %10zu ops %10.1f ns/op  (x%.2f)\n", "ParseNavigateOptions", ops, newNs, newNs > 0 ? legacyNs / newNs : 0.0);
+  BenchPrintf("sink=%zu\n", (size_t)g_sink);
+  return BenchResult(mismatches);
+}
@@ -0,0 +1,220 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// bench/panel_capture_bench.cpp
+// WEBVIEW_Capture worker (core/panel_capture.h) on synthetic page-sized snapshots: what the main thread pays
+// per capture (hand-off to the worker) against encoding in place, worker throughput for PNG / JPEG /
+// downsampled thumbnails, and checks: the PNG decodes (libpng) back to the exact pixels, straight alpha
+// survives the un-premultiply, the box filter averages blocks exactly, encoded snapshots are written
+// through or decoded, failures and the pending-handle cap are reported. Files go to the current directory.
+//
+//   reaper_webview_panel_capture_bench [--check] [captures]
+
+#include <algorithm>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench_util.h"
+#include "WDL/libpng/png.h"
+#include "core/json_cursor.h"
+#include "core/panel_capture.h"
+#include "core/perf_stats.h"
+
+// Page-like content: flat background, text-ish runs, a gradient header, an image block
+static CapturePixels MakePage(int w, int h, unsigned seed)
+{
+  CapturePixels p; p.w = w; p.h = h; p.rowBytes = w * 4; p.px.resize((size_t)p.rowBytes * h);
+  for (int y = 0; y < h; ++y) {
+    uint8_t* row = p.px.data() + (size_t)y * p.rowBytes;
+    for (int x = 0; x < w; ++x) {
+      uint8_t b = 250, g = 250, r = 250;
+      if (y < 64) { b = (uint8_t)(120 + x * 100 / w); g = 60; r = 40; }
+      else if (x > w / 2 && y > 120 && y < 420) { const unsigned v = (x * 7 + y * 13 + seed) & 255; b = (uint8_t)v; g = (uint8_t)(v ^ 0x5a); r = (uint8_t)(v * 3); }
+      else if (((y / 18) & 1) == 0 && ((x * 31 + (y / 18) * 17 + seed) % 97) < 60 && (y % 18) > 3 && (y % 18) < 14) { b = g = r = 30; }
+      row[x * 4 + 0] = b; row[x * 4 + 1] = g; row[x * 4 + 2] = r; row[x * 4 + 3] = 255;
+    }
+  }
+  return p;
+}
+
+struct MemReader { const uint8_t* p; size_t left; bool truncated; };
+static void ReadMem(png_structp png, png_bytep out, png_size_t n)
+{
+  MemReader* r = (MemReader*)png_get_io_ptr(png);
+  const size_t k = n < r->left ? n : r->left; // zeros past the end fail the chunk CRC inside libpng
+  memcpy(out, r->p, k); memset(out + k, 0, n - k);
+  r->p += k; r->left -= k; r->truncated |= k < n;
+}
+
+// PNG -> BGRA (straight alpha, 255 when the file has none)
+static bool DecodePngTo(const uint8_t* data, size_t len, std::vector<uint8_t>& bgra, int& w, int& h)
+{
+  png_structp png = png_create_read_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
+  png_infop info = png ? png_create_info_struct(png) : nullptr;
+  if (!info) { png_destroy_read_struct(&png, nullptr, nullptr); return false; }
+  MemReader r{ data, len, false };
+  std::vector<png_bytep> rows;
+  if (setjmp(png_jmpbuf(png))) { png_destroy_read_struct(&png, &info, nullptr); return false; }
+  png_set_read_fn(png, &r, ReadMem);
+  png_read_info(png, info);
+  w = (int)png_get_image_width(png, info); h = (int)png_get_image_height(png, info);
+  png_set_expand(png); png_set_strip_16(png); png_set_gray_to_rgb(png); png_set_bgr(png);
+  png_set_filler(png, 0xff, PNG_FILLER_AFTER);
+  png_read_update_info(png, info);
+  bgra.resize((size_t)w * h * 4);
+  rows.resize((size_t)h);
+  for (int y = 0; y < h; ++y) rows[(size_t)y] = bgra.data() + (size_t)y * w * 4;
+  png_read_image(png, rows.data());
+  png_read_end(png, nullptr);
+  png_destroy_read_struct(&png, &info, nullptr);
+  return !r.truncated;
+}
+
+static std::vector<uint8_t> ReadFile(const std::string& path)
+{
+  std::vector<uint8_t> d;
+  if (FILE* f = fopen(path.c_str(), "rb")) { uint8_t buf[65536]; size_t n; while ((n = fread(buf, 1, sizeof(buf), f)) > 0) d.insert(d.end(), buf, buf + n); fclose(f); }
+  return d;
+}
+
+static bool ReadPng(const std::string& path, std::vector<uint8_t>& bgra, int& w, int& h)
+{
+  const std::vector<uint8_t> d = ReadFile(path);
+  return !d.empty() && DecodePngTo(d.data(), d.size(), bgra, w, h);
+}
+
+// Test decoder standing in for the WebView2 backend's WIC decoder
+static bool DecodePng(const uint8_t* data, size_t len, CapturePixels& out)
+{
+  if (!DecodePngTo(data, len, out.px, out.w, out.h)) return false;
+  out.rowBytes = out.w * 4; out.premultiplied = false;
+  return true;
+}
+
+static int Wait(PanelCapture& cap, int handle, std::string& json)
+{
+  for (int i = 0; i < 20000; ++i) {
+    const int st = cap.Get(handle, json, true);
+    if (st != 0) return st;
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return 0;
+}
+
+static bool JsonValid(const std::string& s) { JsonCursor c(s.data(), s.size()); return c.SkipValue(); }
+
+int main(int argc, char** argv)
+{
+  BenchParseArgs(argc, argv);
+  const int captures = argc > 1 ? atoi(argv[1]) : 12;
+  if (captures <= 0) { fprintf(stderr, "usage: %s [--check] [captures>0]\n", argv[0]); return 1; }
+  const int W = 1280, H = 800;
+  std::vector<std::string> files;
+  std::string json, err;
+
+  // box filter: 4x4 blocks of one colour average to exactly that colour
+  {
+    CapturePixels in; in.w = 64; in.h = 32; in.rowBytes = 256; in.px.resize(256 * 32);
+    for (int y = 0; y < 32; ++y) for (int x = 0; x < 64; ++x) { uint8_t* p = &in.px[(size_t)y * 256 + x * 4]; p[0] = (uint8_t)(x / 4 * 16); p[1] = (uint8_t)(y / 4 * 30); p[2] = 7; p[3] = 255; }
+    CapturePixels out;
+    CHECK(CaptureDownsample(in, 16, out) && out.w == 16 && out.h == 8);
+    bool exact = true;
+    for (int y = 0; y < 8; ++y) for (int x = 0; x < 16; ++x) { const uint8_t* p = &out.px[(size_t)y * out.rowBytes + x * 4]; exact &= p[0] == x * 16 && p[1] == y * 30 && p[2] == 7 && p[3] == 255; }
+    CHECK(exact);
+    CHECK(!CaptureDownsample(in, 64, out) && !CaptureDownsample(in, 0, out)); // never upscales
+  }
+
+  // PNG round trip (opaque page, full size) and straight alpha
+  {
+    CapturePixels page = MakePage(W, H, 1);
+    const std::vector<uint8_t> orig = page.px;
+    files.push_back("rwv_capture_bench_full.png");
+    CHECK(CaptureWriteFile(page, files.back(), CaptureOptions(), err));
+    std::vector<uint8_t> back; int w = 0, h = 0;
+    CHECK(ReadPng(files.back(), back, w, h) && w == W && h == H && back == orig);
+
+    CapturePixels a; a.w = 2; a.h = 1; a.rowBytes = 8; a.px = { 50, 25, 100, 128, 10, 20, 30, 255 }; // premultiplied
+    CaptureOptions ao; ao.alpha = true;
+    files.push_back("rwv_capture_bench_alpha.png");
+    CHECK(CaptureWriteFile(a, files.back(), ao, err));
+    CHECK(ReadPng(files.back(), back, w, h) && w == 2 && back.size() == 8);
+    if (back.size() == 8) CHECK(abs(back[0] - 100) <= 1 && abs(back[1] - 50) <= 1 && abs(back[2] - 199) <= 1 && back[3] == 128 && back[4] == 10 && back[7] == 255);
+  }
+
+  // main thread: synchronous encode (what the UI thread would pay) vs hand-off to the worker
+  double syncPngMs = 0;
+  {
+    CapturePixels page = MakePage(W, H, 2);
+    files.push_back("rwv_capture_bench_sync.png");
+    clk::time_point t0 = clk::now();
+    CHECK(CaptureWriteFile(page, files.back(), CaptureOptions(), err));
+    syncPngMs = UsSince(t0) / 1000.0;
+  }
+
+  PanelCapture cap;
+  cap.SetDecoder(DecodePng);
+  struct Mode { const char* name; CaptureOptions opt; const char* ext; };
+  Mode modes[3];
+  modes[0] = { "png", CaptureOptions(), "png" };
+  modes[1] = { "jpg q85", CaptureOptions(), "jpg" }; modes[1].opt.format = CaptureFormat::Jpg; modes[1].opt.quality = 85;
+  modes[2] = { "png thumbnail 320", CaptureOptions(), "png" }; modes[2].opt.maxWidth = 320;
+  for (const Mode& m : modes) {
+    std::vector<CapturePixels> pages; for (int i = 0; i < captures; ++i) pages.push_back(MakePage(W, H, (unsigned)i));
+    const int handle = cap.Begin(captures, PerfNowUs());
+    std::vector<double> handoffUs;
+    clk::time_point t0 = clk::now();
+    for (int i = 0; i < captures; ++i) {
+      char name[96]; snprintf(name, sizeof(name), "rwv_capture_bench_%s_%d.%s", m.opt.maxWidth ? "thumb" : m.ext, i, m.ext);
+      files.push_back(name);
+      clk::time_point h0 = clk::now();
+      cap.Submit(handle, "wv_" + std::to_string(i), name, m.opt, std::move(pages[i]));
+      handoffUs.push_back(UsSince(h0));
+    }
+    const int st = Wait(cap, handle, json);
+    const double totalMs = UsSince(t0) / 1000.0;
+    CHECK(st == 1 && JsonValid(json));
+    if (m.opt.format == CaptureFormat::Jpg) { const std::vector<uint8_t> d = ReadFile(files.back()); CHECK(d.size() > 2 && d[0] == 0xFF && d[1] == 0xD8); }
+    if (m.opt.maxWidth) { std::vector<uint8_t> back; int w = 0, h = 0; CHECK(ReadPng(files.back(), back, w, h) && w == 320 && h == 200); }
+    std::sort(handoffUs.begin(), handoffUs.end());
+    BenchPrintf("%-18s %d x %dx%d: main thread median %.1f us (max %.1f) per capture, worker %.1f ms per capture\n",
+                m.name, captures, W, H, handoffUs[handoffUs.size() / 2], handoffUs.back(), totalMs / captures);
+  }
+
+  // encoded snapshots (WebView2): written through for full-size PNG, decoded for thumbnails
+  {
+    const std::vector<uint8_t> png = ReadFile("rwv_capture_bench_full.png");
+    CapturePixels e1; e1.encoded = png;
+    CapturePixels e2; e2.encoded = png;
+    CaptureOptions thumb; thumb.maxWidth = 640;
+    const int handle = cap.Begin(3, PerfNowUs());
+    files.push_back("rwv_capture_bench_through.png"); cap.Submit(handle, "wv_a", files.back(), CaptureOptions(), std::move(e1));
+    files.push_back("rwv_capture_bench_decoded.png"); cap.Submit(handle, "wv_b", files.back(), thumb, std::move(e2));
+    cap.Fail(handle, "wv_c", "view not created");
+    CHECK(Wait(cap, handle, json) == -1 && JsonValid(json) && json.find("view not created") != std::string::npos);
+    CHECK(ReadFile("rwv_capture_bench_through.png") == png);
+    std::vector<uint8_t> back; int w = 0, h = 0;
+    CHECK(ReadPng("rwv_capture_bench_decoded.png", back, w, h) && w == 640 && h == 400);
+    CHECK(cap.Get(handle, json, true) == -4);
+  }
+
+  // pending cap
+  {
+    PanelCapture c2;
+    int last = 0;
+    for (int i = 0; i < PanelCapture::kMaxPending; ++i) last = c2.Begin(1, 0);
+    CHECK(last > 0 && c2.Begin(1, 0) == -1);
+    c2.Fail(last, "wv_x", "closed");
+    CHECK(c2.Begin(1, 0) > 0);
+  }
+
+  BenchPrintf("synchronous PNG encode on the calling thread: %.1f ms per %dx%d capture\n", syncPngMs, W, H);
+  BenchPrintf("worker: %llu written, %llu failed, avg encode %.1f ms\n", cap.Written(), cap.Failed(), cap.AvgEncodeMs());
+  cap.Stop();
+  for (const std::string& f : files) remove(f.c_str());
+  return BenchResult(g_mismatches);
+}
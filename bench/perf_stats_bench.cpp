@@ -0,0 +1,104 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// bench/perf_stats_bench.cpp
+// Cost of recording the per-instance counters (core/perf_stats.h) on the main thread, and checks: histogram
+// percentiles against the exact sorted samples (within one log2 bucket), the JSON parses with JsonCursor,
+// the CSV row has as many columns as the header.
+//
+//   reaper_webview_perf_stats_bench [--check] [events]
+
+#include <algorithm>
+#include <math.h>
+#include <random>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+#include "bench_util.h"
+#include "core/json_cursor.h"
+#include "core/perf_stats.h"
+
+static size_t Columns(const std::string& row)
+{
+  size_t n = 1; bool q = false;
+  for (char c : row) { if (c == '"') q = !q; else if (c == ',' && !q) ++n; }
+  return n;
+}
+
+// Walks the whole document; false on any syntax error
+static bool JsonValid(const std::string& s)
+{
+  JsonCursor c(s.data(), s.size());
+  return c.SkipValue();
+}
+
+int main(int argc, char** argv)
+{
+  BenchParseArgs(argc, argv);
+  const long events = argc > 1 ? atol(argv[1]) : 1000000;
+  if (events <= 0) { fprintf(stderr, "usage: %s [--check] [events>0]\n", argv[0]); return 1; }
+  int mismatches = 0;
+
+  // navigation latencies: log-normal around 300 ms, like page loads
+  std::mt19937 rng(7);
+  std::lognormal_distribution<double> dist(log(300.0), 0.8);
+  std::vector<double> samples((size_t)(events < 200000 ? events : 200000));
+  for (double& d : samples) d = dist(rng);
+
+  InstanceStats st;
+  uint64_t now = 1000000;
+  st.CreateStarted(now); st.ViewCreated(now + 45000);
+  clk::time_point t0 = clk::now();
+  for (size_t i = 0; i < samples.size(); ++i) {
+    st.NavStarted(now);
+    now += (uint64_t)(samples[i] * 1000.0);
+    st.NavFinished(now, true);
+  }
+  const double navNs = NsSince(t0) / (double)samples.size();
+
+  std::sort(samples.begin(), samples.end());
+  const LatencyHistogram& h = st.Nav();
+  for (double p : { 0.5, 0.95, 0.99 }) {
+    const double exact = samples[(size_t)(p * (double)(samples.size() - 1))];
+    const double est = h.PercentileMs(p);
+    // bucket upper edge: at least the exact value, less than twice it
+    if (!(est >= exact * 0.999 && est <= exact * 2.0 + 1.0)) { printf("p%.0f: exact %.1f ms, histogram %.1f ms\n", p * 100, exact, est); ++mismatches; }
+  }
+  if (h.Count() != samples.size() || fabs(h.MaxMs() - samples.back()) > 0.01) ++mismatches;
+  if (st.FirstLoadMs() < 0 || fabs(st.CreateMs() - 45.0) > 0.01) ++mismatches;
+
+  // redirects and failures: a second start keeps the first, a failure is not a latency sample
+  InstanceStats r;
+  r.NavStarted(1000); r.NavStarted(5000); r.NavFinished(11000, true);
+  r.NavStarted(20000); r.NavFinished(25000, false);
+  r.NavFinished(30000, true); // completion without a start
+  if (r.Nav().Count() != 1 || fabs(r.Nav().LastMs() - 10.0) > 0.001 || r.NavFailed() != 1) ++mismatches;
+
+  // the rest of the counters
+  t0 = clk::now();
+  for (long i = 0; i < events; ++i) {
+    st.TitleRefreshed((uint64_t)(i & 255));
+    st.BridgeOut(120); st.BridgeIn(24);
+    if ((i & 15) == 0) { st.FindStarted(now); st.FindCounted(now + 3000, (int)(i & 63)); }
+  }
+  const double otherNs = NsSince(t0) / (double)events;
+  if (st.Title().count != (unsigned long long)events || st.MsgsOut() != (unsigned long long)events ||
+      st.BytesIn() != (unsigned long long)events * 24 || fabs(st.Find().AvgUs() - 3000.0) > 0.01) ++mismatches;
+
+  std::string json;
+  t0 = clk::now();
+  st.AppendJson(json, now);
+  const double jsonUs = NsSince(t0) / 1000.0;
+  if (!JsonValid(json)) { printf("bad json: %s\n", json.c_str()); ++mismatches; }
+
+  std::string row;
+  st.AppendCsv(row, "wv_a,\"quoted\"", 1700000000, now);
+  if (Columns(row) != Columns(InstanceStats::CsvHeader())) { printf("csv: %zu columns, header %zu\n", Columns(row), Columns(InstanceStats::CsvHeader())); ++mismatches; }
+
+  BenchPrintf("nav p50 %.0f ms p95 %.0f ms max %.0f ms over %llu loads\n", h.PercentileMs(0.5), h.PercentileMs(0.95), h.MaxMs(), h.Count());
+  BenchPrintf("per event: navigation start+finish %.1f ns, title+bridge+find %.1f ns; JSON %zu bytes in %.1f us\n",
+              navNs, otherNs, json.size(), jsonUs);
+  return BenchResult(mismatches);
+}
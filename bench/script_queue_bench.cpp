@@ -0,0 +1,169 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// bench/script_queue_bench.cpp
+// WEBVIEW_ExecuteScript queue (core/script_queue.h) without a page: the batch answers are produced the way
+// the generated batch script would produce them. Reports round trips per script (one evaluate per tick
+// instead of one per call) and the native cost per script; checks coalescing per instance, one batch in
+// flight, timeouts with late answers, size limits, errors, the outstanding cap, closing and unread expiry.
+//
+//   reaper_webview_script_queue_bench [--check] [scripts]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include "bench_util.h"
+#include "core/json_cursor.h"
+#include "core/script_queue.h"
+
+static size_t Count(const std::string& s, const char* needle)
+{
+  size_t n = 0;
+  for (size_t p = s.find(needle); p != std::string::npos; p = s.find(needle, p + 1)) ++n;
+  return n;
+}
+
+static unsigned BatchSeq(const std::string& js)
+{
+  const size_t p = js.rfind("{b:");
+  return p == std::string::npos ? 0u : (unsigned)strtoul(js.c_str() + p + 3, nullptr, 10);
+}
+
+// Page answer: entries are [type, value] with type 1 ok (value = JSON text), 0 threw, 2 too large
+struct Entry { int type; std::string value; };
+static std::string Answer(unsigned seq, const std::vector<Entry>& entries)
+{
+  std::string out = "{\"b\":" + std::to_string(seq) + ",\"r\":[";
+  for (size_t i = 0; i < entries.size(); ++i) {
+    if (i) out += ',';
+    out += '['; out += std::to_string(entries[i].type); out += ',';
+    if (entries[i].type == 2) out += entries[i].value; else JsonAppendQuoted(out, entries[i].value);
+    out += ']';
+  }
+  return out + "]}";
+}
+
+int main(int argc, char** argv)
+{
+  BenchParseArgs(argc, argv);
+  const long scripts = argc > 1 ? atol(argv[1]) : 200000;
+  if (scripts <= 0) { fprintf(stderr, "usage: %s [--check] [scripts>0]\n", argv[0]); return 1; }
+  std::string js, out;
+  std::vector<std::string> ready;
+
+  // coalescing: every queued script of an instance goes out in one batch, one batch in flight per instance
+  {
+    ScriptQueue q; uint64_t now = 1000;
+    std::vector<int> a, b;
+    for (int i = 0; i < 10; ++i) a.push_back(q.Enqueue("wv_a", "document.title+" + std::to_string(i), ScriptLimits(), now));
+    for (int i = 0; i < 3; ++i) b.push_back(q.Enqueue("wv_b", "1+" + std::to_string(i), ScriptLimits(), now));
+    q.ReadyInstances(ready); CHECK(ready.size() == 2);
+    CHECK(q.BuildBatch("wv_a", now, js)); CHECK(Count(js, "try{") == 10);
+    const unsigned seqA = BatchSeq(js); CHECK(seqA != 0);
+    CHECK(js.find("\"document.title+9\"") != std::string::npos);
+    const int extra = q.Enqueue("wv_a", "2", ScriptLimits(), now);
+    q.ReadyInstances(ready); CHECK(ready.size() == 1 && ready[0] == "wv_b"); // wv_a waits for its batch
+    CHECK(!q.BuildBatch("wv_a", now, js));
+    std::vector<Entry> ans;
+    for (int i = 0; i < 10; ++i) ans.push_back(i == 4 ? Entry{ 0, "ReferenceError: x is not defined" } : Entry{ 1, "\"t" + std::to_string(i) + "\"" });
+    CHECK(q.Get(a[0], out, false) == ScriptState::Pending);
+    q.OnBatchResult("wv_a", Answer(seqA, ans), now + 5);
+    CHECK(q.Get(a[3], out, true) == ScriptState::Done && out == "\"t3\"");
+    CHECK(q.Get(a[3], out, true) == ScriptState::Unknown); // consumed
+    CHECK(q.Get(a[4], out, true) == ScriptState::Error && out.find("ReferenceError") == 0);
+    CHECK(q.Get(a[9], out, false) == ScriptState::Done && out == "\"t9\"");
+    CHECK(q.BuildBatch("wv_a", now, js) && Count(js, "try{") == 1); // the script queued meanwhile
+    q.OnBatchResult("wv_a", "", now + 6); // evaluation failed (navigation, closed view)
+    CHECK(q.Get(extra, out, true) == ScriptState::Error);
+    CHECK(q.BuildBatch("wv_b", now, js) && Count(js, "try{") == 3);
+    q.OnBatchResult("wv_b", Answer(BatchSeq(js), { { 1, "1" } }), now + 7); // short answer
+    CHECK(q.Get(b[0], out, true) == ScriptState::Done && out == "1");
+    CHECK(q.Get(b[2], out, true) == ScriptState::Error);
+  }
+
+  // timeouts: an expired batch is abandoned, its late answer dropped, the next batch goes out
+  {
+    ScriptQueue q; uint64_t now = 5000;
+    ScriptLimits lim; lim.timeoutMs = 100;
+    const int h = q.Enqueue("wv_a", "new Promise(()=>{})", lim, now);
+    CHECK(q.BuildBatch("wv_a", now, js)); const unsigned seq = BatchSeq(js);
+    const int queuedLong = q.Enqueue("wv_a", "3", lim, now + 50);
+    q.Expire(now + 99); CHECK(q.Get(h, out, false) == ScriptState::Pending);
+    q.Expire(now + 100); CHECK(q.Get(h, out, false) == ScriptState::Timeout);
+    CHECK(q.BuildBatch("wv_a", now + 100, js)); const unsigned seq2 = BatchSeq(js);
+    q.OnBatchResult("wv_a", Answer(seq, { { 1, "7" } }), now + 120); // late
+    CHECK(q.LateAnswers() == 1 && q.Get(h, out, false) == ScriptState::Timeout);
+    q.OnBatchResult("wv_a", Answer(seq2, { { 1, "3" } }), now + 121);
+    CHECK(q.Get(queuedLong, out, true) == ScriptState::Done && out == "3");
+    // waiting in the queue counts toward the timeout
+    const int starved = q.Enqueue("wv_b", "1", lim, now);
+    q.Expire(now + 200); CHECK(q.Get(starved, out, false) == ScriptState::Timeout);
+    CHECK(!q.BuildBatch("wv_b", now + 200, js));
+    CHECK(q.Timeouts() == 2);
+  }
+
+  // size limits: checked in the page (type 2) and again on the decoded bytes
+  {
+    ScriptQueue q; uint64_t now = 1;
+    ScriptLimits lim; lim.maxResultBytes = 8;
+    const int big = q.Enqueue("wv_a", "'x'.repeat(1e6)", lim, now);
+    const int multi = q.Enqueue("wv_a", "'\\u00e9'.repeat(6)", lim, now); // 8 UTF-16 units, 14 bytes
+    const int fits = q.Enqueue("wv_a", "42", lim, now);
+    CHECK(q.BuildBatch("wv_a", now, js) && js.find("s.length>8?") != std::string::npos);
+    q.OnBatchResult("wv_a", Answer(BatchSeq(js), { { 2, "1000002" }, { 1, "\"\xc3\xa9\xc3\xa9\xc3\xa9\xc3\xa9\xc3\xa9\xc3\xa9\"" }, { 1, "42" } }), now);
+    CHECK(q.Get(big, out, true) == ScriptState::TooLarge);
+    CHECK(q.Get(multi, out, true) == ScriptState::TooLarge);
+    CHECK(q.Get(fits, out, true) == ScriptState::Done && out == "42");
+    CHECK(q.TooLarge() == 2);
+  }
+
+  // outstanding cap, closing an instance, unread results
+  {
+    ScriptQueue q; uint64_t now = 1;
+    int last = 0;
+    for (size_t i = 0; i < ScriptQueue::kMaxOutstanding; ++i) last = q.Enqueue("wv_a", "1", ScriptLimits(), now);
+    CHECK(last > 0 && q.Enqueue("wv_a", "1", ScriptLimits(), now) == -1);
+    CHECK(q.Enqueue("wv_b", "1", ScriptLimits(), now) > 0); // the cap is per instance
+    q.DropInstance("wv_a", now);
+    CHECK(q.Get(last, out, false) == ScriptState::Error && out == "instance closed");
+    q.Expire(now + ScriptQueue::kUnreadKeepMs);
+    CHECK(q.Get(last, out, false) == ScriptState::Unknown);
+    CHECK(q.Enqueue("wv_a", "1", ScriptLimits(), now) > 0); // capacity released
+  }
+
+  // throughput: scripts arriving in bursts of `burst` per tick on 4 panels
+  const int burst = 16;
+  ScriptQueue q;
+  uint64_t now = 0;
+  const char* ids[4] = { "wv_1", "wv_2", "wv_3", "wv_4" };
+  std::vector<int> handles; handles.reserve(burst * 4);
+  std::vector<Entry> ans;
+  long done = 0, roundTrips = 0;
+  size_t batchBytes = 0;
+  clk::time_point t0 = clk::now();
+  while (done < scripts) {
+    handles.clear();
+    for (int i = 0; i < burst * 4 && done + (long)handles.size() < scripts; ++i)
+      handles.push_back(q.Enqueue(ids[i & 3], "document.querySelectorAll('a').length", ScriptLimits(), now));
+    q.Expire(now);
+    q.ReadyInstances(ready);
+    for (const std::string& id : ready) {
+      if (!q.BuildBatch(id, now, js)) continue;
+      ++roundTrips; batchBytes += js.size();
+      ans.assign(Count(js, "try{"), Entry{ 1, "17" });
+      q.OnBatchResult(id, Answer(BatchSeq(js), ans), now + 3);
+    }
+    for (int h : handles) { if (q.Get(h, out, true) == ScriptState::Done) ++done; else { ++g_mismatches; ++done; } }
+    now += 33;
+  }
+  const double perScriptNs = NsSince(t0) / (double)scripts;
+  CHECK(q.Outstanding() == 0);
+
+  BenchPrintf("%ld scripts: %ld evaluate round trips batched (%.2f per script) vs %ld unbatched, max batch %llu, avg batch script %zu bytes\n",
+              scripts, roundTrips, (double)roundTrips / (double)scripts, scripts, q.MaxBatch(), roundTrips ? batchBytes / (size_t)roundTrips : (size_t)0);
+  BenchPrintf("native cost per script (enqueue + batch + answer parse + poll): %.0f ns\n", perScriptNs);
+  return BenchResult(g_mismatches);
+}
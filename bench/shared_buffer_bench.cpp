@@ -0,0 +1,138 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// bench/shared_buffer_bench.cpp
+// Bulk float transfer into a page, native side: the JSON path (format every float, then the engine parses
+// it back) vs shared buffer slots - base64 publish (WebKit) and in-place write + name-only notification
+// (WebView2 mapping). Cross-checks the base64 payload. With an output path it also writes an HTML page that
+// times the page side of each path (JSON.parse, base64 decode into a reused Float32Array, mapped view).
+//
+//   reaper_webview_shared_buffer_bench [--check] [rounds] [out.html]
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include "bench_util.h"
+#include "core/shared_buffer.h"
+#include "core/stream_script.h"
+
+static void JsonFloats(const float* v, size_t n, std::string& out)
+{
+  out = "[";
+  char num[32];
+  for (size_t i = 0; i < n; ++i) { int k = snprintf(num, sizeof(num), i ? ",%.7g" : "%.7g", v[i]); out.append(num, (size_t)k); }
+  out += ']';
+}
+
+static bool Base64Decode(const char* s, size_t n, std::vector<uint8_t>& out)
+{
+  auto val = [](char c) -> int {
+    if (c >= 'A' && c <= 'Z') return c - 'A';
+    if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+    if (c >= '0' && c <= '9') return c - '0' + 52;
+    if (c == '+') return 62;
+    if (c == '/') return 63;
+    return -1;
+  };
+  out.clear();
+  if (n % 4) return false;
+  for (size_t i = 0; i < n; i += 4) {
+    int a = val(s[i]), b = val(s[i + 1]), c = s[i + 2] == '=' ? 0 : val(s[i + 2]), d = s[i + 3] == '=' ? 0 : val(s[i + 3]);
+    if (a < 0 || b < 0 || c < 0 || d < 0) return false;
+    const uint32_t v = (uint32_t)a << 18 | (uint32_t)b << 12 | (uint32_t)c << 6 | (uint32_t)d;
+    out.push_back((uint8_t)(v >> 16));
+    if (s[i + 2] != '=') out.push_back((uint8_t)(v >> 8));
+    if (s[i + 3] != '=') out.push_back((uint8_t)v);
+  }
+  return true;
+}
+
+static volatile size_t g_sink = 0;
+
+static const char* kPageJS = R"JS(
+function b64(u8){var s='';for(var i=0;i<u8.length;i+=0x8000)s+=String.fromCharCode.apply(null,u8.subarray(i,i+0x8000));return btoa(s);}
+function run(){
+  var out=[], sizes=[1024,16384,262144];
+  for(var si=0;si<sizes.length;si++){
+    var n=sizes[si], src=new Float32Array(n); for(var i=0;i<n;i++) src[i]=Math.sin(i*0.01)*0.5;
+    var json=JSON.stringify(Array.from(src)), enc=b64(new Uint8Array(src.buffer));
+    var rounds=Math.max(5, Math.round(2e6/n)), t0=performance.now(), sink=0;
+    for(var r=0;r<rounds;r++){ var a=new Float32Array(JSON.parse(json)); sink+=a[n>>1]; }
+    var tJson=(performance.now()-t0)/rounds;
+    window.__rwvBuffers.slots={}; t0=performance.now();
+    for(var r2=0;r2<rounds;r2++){ window.__rwvBuffers._put('bench', (r2+1)*2, n, enc); sink+=window.__rwvBuffers.get('bench')[n>>1]; }
+    var tB64=(performance.now()-t0)/rounds;
+    var ab=new ArrayBuffer(16+n*4); new Float32Array(ab,16).set(src); var hdr=new Uint32Array(ab,0,4); hdr[2]=n;
+    window.__rwvBuffers.attach('mapped', ab); t0=performance.now();
+    for(var r3=0;r3<rounds;r3++){ hdr[1]=n; hdr[0]=(r3+1)*2; window.__rwvBuffers.publish('mapped'); sink+=window.__rwvBuffers.get('mapped')[n>>1]; }
+    var tMap=(performance.now()-t0)/rounds;
+    out.push(n+' floats: JSON.parse '+tJson.toFixed(3)+' ms | base64 _put '+tB64.toFixed(3)+' ms | mapped publish '+tMap.toFixed(4)+' ms  (sink '+sink.toFixed(1)+')');
+  }
+  document.getElementById('out').textContent=out.join('\n'); console.log(out.join('\n'));
+}
+)JS";
+
+int main(int argc, char** argv)
+{
+  BenchParseArgs(argc, argv);
+  const long rounds = argc > 1 ? atol(argv[1]) : 50;
+  const char* html = argc > 2 ? argv[2] : nullptr;
+  if (rounds <= 0) { fprintf(stderr, "usage: %s [--check] [rounds>0] [out.html]\n", argv[0]); return 1; }
+
+  int mismatches = 0;
+  const size_t sizes[] = { 1024, 16384, 262144 };
+  BenchPrintf("%-10s %14s %14s %14s %12s %12s\n", "floats", "json us", "base64 us", "mapped us", "json bytes", "b64 bytes");
+  for (size_t n : sizes) {
+    std::vector<float> src(n);
+    for (size_t i = 0; i < n; ++i) src[i] = (float)(sin((double)i * 0.01) * 0.5);
+
+    std::string json; double jsonUs = 0;
+    for (long r = 0; r < rounds; ++r) { src[r % n] += 1e-6f; auto t = clk::now(); JsonFloats(src.data(), n, json); jsonUs += UsSince(t); g_sink += json.size(); }
+
+    SharedBufferSlot heap; heap.name = "bench"; heap.AllocHeap((uint32_t)n);
+    std::string js; double b64Us = 0;
+    for (long r = 0; r < rounds; ++r) {
+      src[r % n] += 1e-6f;
+      auto t = clk::now();
+      memcpy(heap.BeginWrite(), src.data(), n * sizeof(float)); heap.EndWrite((uint32_t)n);
+      js = SharedBufferPutScript(heap);
+      b64Us += UsSince(t); g_sink += js.size();
+    }
+    // base64 payload decodes back to the committed floats; checked before src moves on
+    const size_t q1 = js.find(",\"") + 2, q2 = js.rfind('"');
+    std::vector<uint8_t> dec;
+    if (!Base64Decode(js.data() + q1, q2 - q1, dec) || dec.size() != n * sizeof(float) || memcmp(dec.data(), src.data(), dec.size())) ++mismatches;
+
+    std::vector<uint8_t> shared(SharedBufferSlot::BytesFor((uint32_t)n)); // stands in for the WebView2 mapping
+    SharedBufferSlot mapped; mapped.name = "bench"; mapped.AdoptMapped(shared.data(), (uint32_t)n, nullptr);
+    std::string note; double mapUs = 0;
+    for (long r = 0; r < rounds; ++r) {
+      src[r % n] += 1e-6f;
+      auto t = clk::now();
+      memcpy(mapped.BeginWrite(), src.data(), n * sizeof(float)); mapped.EndWrite((uint32_t)n);
+      note = "{\"rwvBuffer\":\"" + mapped.name + "\"}";
+      mapUs += UsSince(t); g_sink += note.size();
+    }
+
+    // the seqlock ends even
+    if ((heap.Seq() & 1) || (mapped.Seq() & 1) || mapped.Count() != n) ++mismatches;
+
+    BenchPrintf("%-10zu %14.1f %14.1f %14.2f %12zu %12zu\n", n, jsonUs / rounds, b64Us / rounds, mapUs / rounds, json.size(), js.size());
+  }
+
+  if (html) {
+    FILE* f = fopen(html, "wb");
+    if (!f) { fprintf(stderr, "cannot write %s\n", html); return 1; }
+    fprintf(f, "<!doctype html>\n<html><head><meta charset=\"utf-8\"><title>rwv shared buffer bench</title></head><body>\n"
+               "<button onclick=\"run()\">run</button><pre id=\"out\">press run</pre>\n<script>\n%s\n%s\n</script>\n</body></html>\n",
+            kSharedBufferJS, kPageJS);
+    fclose(f);
+    BenchPrintf("wrote %s\n", html);
+  }
+  BenchPrintf("sink=%zu\n", (size_t)g_sink);
+  return BenchResult(mismatches);
+}
@@ -0,0 +1,120 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// bench/startup_bench.cpp
+// Cold start of the Linux plugin the way REAPER loads it, without REAPER: dlopen of the built .so (WebKitGTK and
+// GTK come in with it), SWELL_dllMain with the headless SWELL API, ReaperPluginEntry with a stub
+// reaper_plugin_info_t (plugin_register records the timer and the API_ entries; GetResourcePath is a temp
+// directory), then the first timer tick. Prints the plugin's share of REAPER's launch (dlopen + SWELL attach +
+// entry point), the first tick, and the plugin's own startup timeline read back through WEBVIEW_GetStats("*").
+// Run it as a fresh process each time: only the first load in a process is cold.
+//
+//   reaper_webview_startup_bench [path/to/reaper_webview.so]
+
+#define WDL_NO_DEFINE_MINMAX
+#include "WDL/swell/swell.h"
+
+#include <dlfcn.h>
+#include <map>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+#include "bench_util.h"
+#include "sdk/reaper_plugin.h"
+
+#ifndef RWV_PLUGIN_PATH
+  #define RWV_PLUGIN_PATH "reaper_webview.so"
+#endif
+
+// swell-wnd-generic references this; headless builds have no OS window to maximize
+void swell_oswindow_maximize(HWND, bool) {}
+
+extern "C" void* SWELLAPI_GetFunc(const char* name); // swell-appstub-generic (swell_headless)
+
+static std::map<std::string, void*> g_registered; // last pointer per registration key
+static int g_nextCommand = 40000;
+static int g_registrations = 0;
+static std::string g_resourcePath;
+
+static int StubPluginRegister(const char* name, void* info)
+{
+  if (!name) return 0;
+  ++g_registrations;
+  if (!strcmp(name, "command_id")) return g_nextCommand++;
+  if (name[0] == '-') { g_registered.erase(name + 1); return 1; }
+  g_registered[name] = info;
+  return 1;
+}
+static const char* StubGetResourcePath() { return g_resourcePath.c_str(); }
+static const char* StubGetExtState(const char*, const char*) { return ""; }
+
+static void* StubGetFunc(const char* name)
+{
+  if (!name) return nullptr;
+  if (!strcmp(name, "plugin_register")) return (void*)&StubPluginRegister;
+  if (!strcmp(name, "GetResourcePath")) return (void*)&StubGetResourcePath;
+  if (!strcmp(name, "GetExtState")) return (void*)&StubGetExtState;
+  return nullptr; // everything else: the plugin runs with the functions it got, as with an older REAPER
+}
+
+int main(int argc, char** argv)
+{
+  const char* path = argc > 1 ? argv[1] : RWV_PLUGIN_PATH;
+  char tmpl[] = "/tmp/rwv_startup_XXXXXX";
+  if (!mkdtemp(tmpl)) { perror("mkdtemp"); return 1; }
+  g_resourcePath = tmpl;
+
+  clk::time_point t = clk::now();
+  void* mod = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+  const double dlopenMs = MsSince(t);
+  if (!mod) { fprintf(stderr, "dlopen %s: %s\n", path, dlerror()); return 1; }
+
+  typedef int (*SwellDllMainFn)(HINSTANCE, DWORD, LPVOID);
+  typedef int (*EntryFn)(REAPER_PLUGIN_HINSTANCE, reaper_plugin_info_t*);
+  SwellDllMainFn swellMain = (SwellDllMainFn)dlsym(mod, "SWELL_dllMain");
+  EntryFn entry = (EntryFn)dlsym(mod, REAPER_PLUGIN_ENTRYPOINT_NAME);
+  if (!swellMain || !entry) { fprintf(stderr, "%s: SWELL_dllMain/%s not exported\n", path, REAPER_PLUGIN_ENTRYPOINT_NAME); return 1; }
+
+  t = clk::now();
+  swellMain((HINSTANCE)mod, DLL_PROCESS_ATTACH, (LPVOID)&SWELLAPI_GetFunc);
+  const double swellMs = MsSince(t);
+
+  reaper_plugin_info_t rec;
+  memset(&rec, 0, sizeof(rec));
+  rec.caller_version = REAPER_PLUGIN_VERSION;
+  rec.Register = &StubPluginRegister;
+  rec.GetFunc = &StubGetFunc;
+  t = clk::now();
+  const int ok = entry((REAPER_PLUGIN_HINSTANCE)mod, &rec);
+  const double entryMs = MsSince(t);
+  if (!ok) { fprintf(stderr, "entry point returned 0\n"); return 1; }
+  const int entryRegistrations = g_registrations;
+
+  void (*timer)() = (void (*)())g_registered["timer"];
+  double tickMs = -1;
+  if (timer) { t = clk::now(); timer(); tickMs = MsSince(t); }
+
+  std::string timeline = "(WEBVIEW_GetStats not registered)";
+  typedef bool (*GetStatsFn)(const char*, char*, int);
+  if (GetStatsFn getStats = (GetStatsFn)g_registered["API_WEBVIEW_GetStats"]) {
+    static char buf[1 << 16];
+    if (getStats("*", buf, (int)sizeof(buf))) {
+      const char* at = strstr(buf, "\"startup\":");
+      timeline = at ? std::string(at) : std::string(buf);
+      if (!timeline.empty() && timeline.back() == '}') timeline.pop_back(); // closes the outer object
+    }
+  }
+
+  printf("plugin: %s\n", path);
+  printf("dlopen %.2f ms (module + WebKitGTK/GTK dependencies), SWELL attach %.2f ms, entry point %.2f ms (%d registrations)\n",
+         dlopenMs, swellMs, entryMs, entryRegistrations);
+  printf("share of REAPER launch: %.2f ms\n", dlopenMs + swellMs + entryMs);
+  printf("first timer tick (after launch): %.2f ms\n", tickMs);
+  printf("timeline %s\n", timeline.c_str());
+  printf("resource dir (state/log of this run): %s\n", tmpl);
+
+  entry((REAPER_PLUGIN_HINSTANCE)mod, nullptr); // unload path: REAPER calls the entry point with rec == NULL
+  return 0;
+}
@@ -0,0 +1,103 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// bench/state_stream_bench.cpp
+// State streaming cost for one subscribed page: a full JSON snapshot every frame vs StateStream deltas,
+// on a synthetic session (playback with moving meters, occasional renames/selection changes, a stop
+// phase with silent meters). Cross-checks that the page-side merge of the deltas ends on the same meters.
+//
+//   reaper_webview_state_stream_bench [--check] [tracks] [seconds] [hz]
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+#include "bench_util.h"
+#include "core/json_cursor.h"
+#include "core/state_stream.h"
+
+// What __rwvState.push keeps for meters: apply "meterCount" / "meters":[i,l,r,...] in order
+static void MergeMeters(const std::string& msg, std::vector<int>& meters)
+{
+  JsonCursor c(msg.data(), msg.size()); JsonValue k, v;
+  if (!c.EnterObject()) return;
+  while (c.NextKey(k)) {
+    if (JsonKeyEquals(k, "meterCount") && c.ReadValue(v)) { meters.assign((size_t)atoi(v.ptr) * 2, -600); continue; }
+    if (JsonKeyEquals(k, "meters")) {
+      int trip[3], n = 0;
+      if (c.EnterArray()) while (c.NextElement() && c.ReadValue(v)) {
+        trip[n++] = atoi(v.ptr);
+        if (n == 3) { if ((size_t)trip[0] * 2 + 1 < meters.size()) { meters[trip[0] * 2] = trip[1]; meters[trip[0] * 2 + 1] = trip[2]; } n = 0; }
+      }
+      continue;
+    }
+    c.SkipValue();
+  }
+}
+
+static int Db10(float lin) { if (!(lin > 0.001f)) return -600; int v = (int)lrintf(200.0f * log10f(lin)); return v < -600 ? -600 : (v > 240 ? 240 : v); }
+
+int main(int argc, char** argv)
+{
+  BenchParseArgs(argc, argv);
+  const long tracks = argc > 1 ? atol(argv[1]) : 64;
+  const long seconds = argc > 2 ? atol(argv[2]) : 60;
+  const long hz = argc > 3 ? atol(argv[3]) : 30;
+  if (tracks <= 0 || seconds <= 0 || hz <= 0 || hz > StateStream::kMaxHz) {
+    fprintf(stderr, "usage: %s [--check] [tracks>0] [seconds>0] [hz 1..%d]\n", argv[0], StateStream::kMaxHz); return 1;
+  }
+
+  StreamFrame f; f.topics = kStreamAllTopics;
+  f.transport.bpm = 120; f.transport.playState = 1;
+  for (long i = 0; i < tracks; ++i) {
+    StreamTrack t; char b[64];
+    snprintf(b, sizeof(b), "{%08lX-0000-0000-0000-%012lX}", i * 2654435761ul, (unsigned long)i); t.guid = b;
+    snprintf(b, sizeof(b), "Track %ld", i + 1); t.name = b;
+    f.tracks.push_back(t);
+  }
+  f.peaks.assign((size_t)(tracks + 1) * 2, 0.0f);
+
+  StateStream delta; delta.Subscribe(kStreamAllTopics, (int)hz);
+  std::vector<int> merged;
+  const long frames = seconds * hz;
+  const uint32_t stepMs = (uint32_t)(1000 / hz);
+  uint32_t seed = 777;
+  auto rnd = [&seed]() { seed = seed * 1103515245u + 12345u; return (seed >> 16) & 0x7FFF; };
+
+  size_t fullBytes = 0, deltaBytes = 0, deltaMsgs = 0; double fullUs = 0, deltaUs = 0;
+  std::string out;
+  for (long n = 0; n < frames; ++n) {
+    const uint32_t now = 1000u + (uint32_t)n * stepMs;
+    const bool playing = n < frames * 3 / 4; // last quarter: stopped, meters fall silent
+    f.transport.playState = playing ? 1 : 0;
+    if (playing) f.transport.position = n / (double)hz;
+    for (size_t s = 0; s < f.peaks.size(); ++s)
+      f.peaks[s] = playing && (s / 2) % 5 != 4 ? 0.05f + (float)(rnd() % 1000) / 1100.0f : 0.0f; // every 5th strip silent
+    if (n % (hz * 5) == 0) f.tracks[(size_t)(rnd() % tracks)].flags ^= kStreamTrackSelected;
+    if (n % (hz * 20) == 7) f.tracks[(size_t)(rnd() % tracks)].name += "*";
+
+    // old way: the whole snapshot serialized each frame
+    auto t0 = clk::now();
+    StateStream full; full.Subscribe(kStreamAllTopics, (int)hz);
+    if (full.Encode(f, now, out)) fullBytes += out.size();
+    fullUs += UsSince(t0);
+
+    auto t1 = clk::now();
+    const bool sent = delta.Due(now) && delta.Encode(f, now, out);
+    deltaUs += UsSince(t1);
+    if (sent) { deltaBytes += out.size(); ++deltaMsgs; MergeMeters(out, merged); }
+  }
+
+  int mismatches = 0;
+  for (size_t s = 0; s < f.peaks.size(); ++s) if (s >= merged.size() || merged[s] != Db10(f.peaks[s])) ++mismatches;
+
+  BenchPrintf("session: %ld tracks, %ld s at %ld Hz (%ld frames)\n", tracks, seconds, hz, frames);
+  BenchPrintf("%-24s %8ld msgs %10.1f bytes/frame %8.2f us/frame %9.1f KB/s\n", "full snapshot", frames,
+              fullBytes / (double)frames, fullUs / (double)frames, fullBytes / 1024.0 / (double)seconds);
+  BenchPrintf("%-24s %8zu msgs %10.1f bytes/frame %8.2f us/frame %9.1f KB/s  (x%.1f less traffic)\n", "StateStream delta", deltaMsgs,
+              deltaBytes / (double)frames, deltaUs / (double)frames, deltaBytes / 1024.0 / (double)seconds,
+              deltaBytes ? fullBytes / (double)deltaBytes : 0.0);
+  return BenchResult(mismatches);
+}
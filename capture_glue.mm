@@ -0,0 +1,102 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// capture_glue.mm
+#include "predef.h"
+#include "globals.h"
+#include "helpers.h"
+#include "log.h"
+#include "webview.h"
+
+// ============================== Panel capture ==============================
+// WEBVIEW_Capture (core/panel_capture.h): the backend snapshot lands here on the main thread and goes
+// straight to the encoder worker; ReaScript polls the handle through WEBVIEW_GetCaptureResult.
+static PanelCapture g_capture;
+struct CaptureJob { int handle; std::string id, path; CaptureOptions opt; };
+static std::unordered_map<int, CaptureJob> g_captureJobs; // snapshot token -> job
+static int g_captureToken = 0;
+
+static void OnPanelSnapshot(const std::string& id, int token, CapturePixels* px, const char* error)
+{
+  auto it = g_captureJobs.find(token);
+  if (it == g_captureJobs.end()) return; // plugin shutting down
+  const CaptureJob job = std::move(it->second);
+  g_captureJobs.erase(it);
+  if (px) g_capture.Submit(job.handle, id, job.path, job.opt, std::move(*px));
+  else g_capture.Fail(job.handle, id, error ? error : "snapshot failed");
+}
+
+static std::string CaptureDefaultDir()
+{
+  const char* res = GetResourcePath ? GetResourcePath() : nullptr;
+  if (!res || !*res) return std::string();
+#ifdef _WIN32
+  return std::string(res) + "\\reaper_webview_captures";
+#else
+  return std::string(res) + "/reaper_webview_captures";
+#endif
+}
+
+int CaptureInstances(const std::string& id, const std::string& path, const CaptureOptions& opt)
+{
+#ifdef _WIN32
+  const char sep = '\\';
+  g_capture.SetDecoder(WebViewDecodeSnapshot);
+#else
+  const char sep = '/';
+#endif
+  std::vector<WebViewInstanceRecord*> recs;
+  if (id == "*") { // open panels only: restored-but-never-shown and closed records have nothing to capture
+    for (auto& kv : g_instances) if (kv.second && kv.second->hwnd && IsWindow(kv.second->hwnd)) recs.push_back(kv.second.get());
+  }
+  else if (WebViewInstanceRecord* rec = GetInstanceById(id)) recs.push_back(rec);
+  if (recs.empty()) return -1;
+  // one panel: path is the file; "*": path is the directory, one <id>.<ext> per panel
+  std::string dir = id == "*" ? path : std::string();
+  if ((id == "*" || path.empty()) && dir.empty()) dir = CaptureDefaultDir();
+  if ((id == "*" || path.empty()) && dir.empty()) return -1;
+  if (!dir.empty()) {
+    while (dir.size() > 1 && (dir.back() == '/' || dir.back() == '\\')) dir.pop_back();
+    if (RecursiveCreateDirectory) RecursiveCreateDirectory(dir.c_str(), 0);
+  }
+  const int handle = g_capture.Begin((int)recs.size(), PerfNowUs());
+  if (handle < 0) { LogF("[Capture] too many captures in flight (%d)", PanelCapture::kMaxPending); return -2; }
+  const char* ext = opt.format == CaptureFormat::Jpg ? ".jpg" : ".png";
+  for (WebViewInstanceRecord* rec : recs) {
+    const std::string file = dir.empty() ? path : dir + sep + rec->id + ext;
+    // hibernated / not created yet: nothing to capture, the part fails rather than waking the panel
+    if (rec->hibernate != HibernateState::Active || !WebViewHasView(rec)) { g_capture.Fail(handle, rec->id, "no live view"); continue; }
+    if (++g_captureToken <= 0) g_captureToken = 1;
+    const int token = g_captureToken;
+    g_captureJobs[token] = CaptureJob{ handle, rec->id, file, opt };
+    WebViewSnapshot(rec, token, OnPanelSnapshot);
+  }
+  LogF("[Capture] handle=%d id='%s' panels=%d", handle, id.c_str(), (int)recs.size());
+  return handle;
+}
+
+int CaptureGetResult(int handle, std::string& json, bool consume) { return g_capture.Get(handle, json, consume); }
+
+// The panel goes away: its snapshots may never complete (WebView2 drops the callback with the controller)
+void CaptureRelease(WebViewInstanceRecord* rec)
+{
+  if (!rec) return;
+  for (auto it = g_captureJobs.begin(); it != g_captureJobs.end();) {
+    if (it->second.id != rec->id) { ++it; continue; }
+    g_capture.Fail(it->second.handle, rec->id, "instance closed");
+    it = g_captureJobs.erase(it);
+  }
+}
+
+void CaptureShutdown()
+{
+  g_captureJobs.clear(); // late snapshots are dropped in OnPanelSnapshot
+  g_capture.Stop();
+}
+
+void CaptureAppendStatsJson(std::string& out)
+{
+  char buf[128];
+  snprintf(buf, sizeof(buf), "{\"written\":%llu,\"failed\":%llu,\"avgEncodeMs\":%.1f}", g_capture.Written(), g_capture.Failed(), g_capture.AvgEncodeMs());
+  out += buf;
+}
@@ -0,0 +1,104 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// core/asset_bundle.cpp
+
+#include "core/asset_bundle.h"
+
+#include <chrono>
+#include <string.h>
+
+#include "zlib/zlib.h"
+
+static int HexVal(char c)
+{
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return -1;
+}
+
+bool AssetPathFromUrl(const std::string& url, std::string& path)
+{
+  path.clear();
+  if (url.size() < 4 || (url[0] | 0x20) != 'r' || (url[1] | 0x20) != 'w' || (url[2] | 0x20) != 'v' || url[3] != ':') return false;
+  size_t i = 4;
+  if (url.compare(i, 2, "//") == 0) { i = url.find_first_of("/?#", i + 2); if (i == std::string::npos) i = url.size(); } // skip authority
+  const size_t end = url.find_first_of("?#", i);
+  const size_t stop = end == std::string::npos ? url.size() : end;
+  while (i < stop && url[i] == '/') ++i;
+  for (; i < stop; ++i) {
+    char c = url[i];
+    if (c == '%' && i + 2 < stop) {
+      const int hi = HexVal(url[i + 1]), lo = HexVal(url[i + 2]);
+      if (hi >= 0 && lo >= 0) { c = (char)(hi * 16 + lo); i += 2; }
+    }
+    if (c == '\0' || c == '\\') return false;
+    path += c;
+  }
+  if (path.empty() || path.back() == '/') path += "index.html";
+  size_t seg = 0; // reject "." and ".." segments
+  while (seg <= path.size()) {
+    size_t next = path.find('/', seg); if (next == std::string::npos) next = path.size();
+    const size_t len = next - seg;
+    if ((len == 1 && path[seg] == '.') || (len == 2 && path[seg] == '.' && path[seg + 1] == '.')) return false;
+    seg = next + 1;
+  }
+  return true;
+}
+
+AssetServer::AssetServer(const AssetBundleData* bundle) : m_bundle(bundle)
+{
+  m_cache.resize(Count());
+}
+
+const AssetEntry* AssetServer::Find(const std::string& path) const
+{
+  if (!m_bundle) return nullptr;
+  size_t lo = 0, hi = m_bundle->count;
+  while (lo < hi) {
+    const size_t mid = (lo + hi) / 2;
+    const int c = strcmp(m_bundle->entries[mid].path, path.c_str());
+    if (c == 0) return &m_bundle->entries[mid];
+    if (c < 0) lo = mid + 1; else hi = mid;
+  }
+  return nullptr;
+}
+
+const std::string* AssetServer::Body(const AssetEntry& e)
+{
+  std::unique_ptr<std::string>& slot = m_cache[&e - m_bundle->entries];
+  if (slot) return slot.get();
+  const auto t0 = std::chrono::steady_clock::now();
+  std::unique_ptr<std::string> body(new std::string(e.size, '\0'));
+  const unsigned char* src = m_bundle->blob + e.offset;
+  if (e.packed == e.size) {
+    if (e.size) memcpy(&(*body)[0], src, e.size);
+  } else {
+    uLongf len = e.size;
+    if (uncompress((Bytef*)&(*body)[0], &len, src, e.packed) != Z_OK || len != e.size) return nullptr;
+    ++m_inflates;
+  }
+  m_inflateUs += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+  m_cachedBytes += e.size;
+  slot = std::move(body);
+  return slot.get();
+}
+
+void AssetServer::Serve(const std::string& url, const char* ifNoneMatch, AssetReply& out)
+{
+  const auto t0 = std::chrono::steady_clock::now();
+  out = AssetReply();
+  std::string path;
+  const AssetEntry* e = AssetPathFromUrl(url, path) ? Find(path) : nullptr;
+  if (!e) { out.status = 404; ++m_notFound; }
+  else {
+    out.mime = e->mime; out.etag = e->etag;
+    // If-None-Match: "*" or a list of validators; ours are quoted, so a substring hit is a match (W/ included)
+    if (ifNoneMatch && (!strcmp(ifNoneMatch, "*") || strstr(ifNoneMatch, e->etag))) { out.status = 304; ++m_notModified; }
+    else if ((out.body = Body(*e))) out.status = 200;
+    else out.status = 500;
+  }
+  out.us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+  ++m_requests; m_totalUs += out.us; if (out.us > m_maxUs) m_maxUs = out.us;
+}
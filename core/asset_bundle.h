@@ -0,0 +1,77 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// core/asset_bundle.h
+// rwv:// assets. tools/compile_resources.py --bundle packs a directory (www/ by default) into one
+// generated translation unit: a path-sorted entry table plus a blob of zlib streams (files that do not
+// shrink are stored). AssetServer answers scheme requests from it: binary search on the path, inflate
+// once into an in-memory cache, ETag / If-None-Match -> 304, and per-request timing. Main thread only
+// (WebResourceRequested, WKURLSchemeHandler and WebKitGTK URI scheme callbacks all run there).
+#pragma once
+
+#include <memory>
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+struct AssetEntry
+{
+  const char* path;   // relative, '/'-separated, no leading slash
+  const char* mime;
+  const char* etag;   // quoted strong validator ("crc32-size")
+  uint32_t size;      // bytes after inflate
+  uint32_t offset;    // into the blob
+  uint32_t packed;    // bytes in the blob; == size when stored uncompressed
+};
+
+struct AssetBundleData
+{
+  const AssetEntry* entries; // sorted by path (byte order)
+  uint32_t count;
+  const unsigned char* blob;
+};
+
+// Generated by tools/compile_resources.py --bundle (linked into the plugin and the bench)
+const AssetBundleData* GetEmbeddedAssetBundle();
+
+struct AssetReply
+{
+  int status = 404;                   // 200, 304, 404 or 500 (corrupt entry)
+  const char* mime = "text/plain";
+  const char* etag = "";
+  const std::string* body = nullptr;  // 200 only; owned by the server cache, stable until it is destroyed
+  double us = 0;                      // time spent in Serve
+};
+
+// rwv://host/dir/file?q#f -> "dir/file" (percent-decoded; "" or a trailing '/' maps to index.html).
+// False for other schemes and for paths with "." / ".." segments or NUL bytes.
+bool AssetPathFromUrl(const std::string& url, std::string& path);
+
+class AssetServer
+{
+public:
+  explicit AssetServer(const AssetBundleData* bundle);
+
+  void Serve(const std::string& url, const char* ifNoneMatch, AssetReply& out);
+  const AssetEntry* Find(const std::string& path) const;
+
+  unsigned long long Requests() const { return m_requests; }
+  unsigned long long NotModified() const { return m_notModified; }
+  unsigned long long NotFound() const { return m_notFound; }
+  unsigned long long Inflates() const { return m_inflates; }
+  double AvgUs() const { return m_requests ? m_totalUs / (double)m_requests : 0.0; }
+  double MaxUs() const { return m_maxUs; }
+  double InflateUs() const { return m_inflateUs; }
+  size_t CachedBytes() const { return m_cachedBytes; }
+  uint32_t Count() const { return m_bundle ? m_bundle->count : 0; }
+
+private:
+  const std::string* Body(const AssetEntry& e);
+
+  const AssetBundleData* m_bundle;
+  std::vector<std::unique_ptr<std::string>> m_cache; // per entry, filled on first request
+  size_t m_cachedBytes = 0;
+  unsigned long long m_requests = 0, m_notModified = 0, m_notFound = 0, m_inflates = 0;
+  double m_totalUs = 0, m_maxUs = 0, m_inflateUs = 0;
+};
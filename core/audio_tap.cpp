@@ -0,0 +1,157 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// core/audio_tap.cpp
+
+#include "core/audio_tap.h"
+
+#include <chrono>
+#include <math.h>
+#include <stdlib.h>
+
+static const double kMaxPendingSec = 2.0; // uncollected output beyond this is dropped (oldest first)
+
+uint32_t ParseAudioTapChannels(const char* s, size_t n)
+{
+  uint32_t bits = 0;
+  size_t i = 0;
+  while (i < n) {
+    while (i < n && (s[i] == ',' || s[i] == ' ')) ++i;
+    if (i >= n) break;
+    const char kind = s[i++];
+    int num = 0; bool digits = false;
+    while (i < n && s[i] >= '0' && s[i] <= '9') { num = num * 10 + (s[i++] - '0'); digits = true; if (num > 99) break; }
+    while (i < n && s[i] != ',') ++i;
+    if (!digits || num < 1 || num > 8) continue;
+    if (kind == 'o' || kind == 'O') bits |= 1u << (num - 1);
+    else if (kind == 'i' || kind == 'I') bits |= 1u << (8 + num - 1);
+  }
+  return bits;
+}
+
+AudioTap::AudioTap(size_t ringFloats) : m_ring(ringFloats) {}
+
+AudioTap::~AudioTap() { Stop(); }
+
+void AudioTap::UpdateMask()
+{
+  uint32_t mask = 0;
+  for (const Sub& s : m_subs) mask |= s.cfg.channels;
+  m_mask.store(mask, std::memory_order_relaxed);
+}
+
+void AudioTap::Subscribe(const std::string& id, const AudioTapConfig& cfg)
+{
+  std::lock_guard<std::mutex> lk(m_lock);
+  Sub* s = nullptr;
+  for (Sub& x : m_subs) if (x.id == id) s = &x;
+  if (!s) { m_subs.push_back(Sub()); s = &m_subs.back(); s->id = id; }
+  s->cfg = cfg;
+  if (s->cfg.outChannels != 1) s->cfg.outChannels = 2;
+  if (s->cfg.rate < 100) s->cfg.rate = 100;
+  s->srcRate = 0; s->pending.clear(); // re-derive the decimation on the next block
+  UpdateMask();
+}
+
+bool AudioTap::Unsubscribe(const std::string& id)
+{
+  std::lock_guard<std::mutex> lk(m_lock);
+  for (size_t i = 0; i < m_subs.size(); ++i)
+    if (m_subs[i].id == id) { m_subs.erase(m_subs.begin() + i); UpdateMask(); return true; }
+  return false;
+}
+
+bool AudioTap::IsSubscribed(const std::string& id)
+{
+  std::lock_guard<std::mutex> lk(m_lock);
+  for (const Sub& s : m_subs) if (s.id == id) return true;
+  return false;
+}
+
+bool AudioTap::Take(const std::string& id, std::vector<float>& out, int& outChannels, double& outRate)
+{
+  out.clear();
+  std::lock_guard<std::mutex> lk(m_lock);
+  for (Sub& s : m_subs) {
+    if (s.id != id) continue;
+    out.swap(s.pending);
+    outChannels = s.cfg.outChannels; outRate = s.outRate;
+    return !out.empty();
+  }
+  return false;
+}
+
+void AudioTap::Start()
+{
+  if (m_run.exchange(true)) return;
+  m_worker = std::thread([this]() {
+    while (m_run.load(std::memory_order_relaxed)) {
+      Process();
+      std::this_thread::sleep_for(std::chrono::milliseconds(5)); // ~5 ms of audio per wakeup at most
+    }
+  });
+}
+
+void AudioTap::Stop()
+{
+  if (!m_run.exchange(false)) return;
+  if (m_worker.joinable()) m_worker.join();
+}
+
+void AudioTap::Downmix(Sub& s, const float* frames, int n, int nch, const int* pos, double srate)
+{
+  if (srate != s.srcRate) {
+    s.srcRate = srate;
+    s.factor = (int)lround(srate / s.cfg.rate); if (s.factor < 1) s.factor = 1;
+    s.outRate = srate / s.factor;
+    s.phase = 0; s.acc[0] = s.acc[1] = 0;
+  }
+  int slot[kAudioTapChannels], used = 0; // positions within a frame of this subscriber's channels, in channel order
+  for (int c = 0; c < kAudioTapChannels; ++c) if ((s.cfg.channels & (1u << c)) && pos[c] >= 0) slot[used++] = pos[c];
+  const bool stereo = s.cfg.outChannels == 2;
+  const float invF = 1.0f / (float)s.factor;
+  for (int f = 0; f < n; ++f) {
+    const float* fr = frames + (size_t)f * nch;
+    float l = 0, r = 0; int nl = 0, nr = 0;
+    for (int k = 0; k < used; ++k) {
+      if (stereo && (k & 1)) { r += fr[slot[k]]; ++nr; } else { l += fr[slot[k]]; ++nl; }
+    }
+    if (nl) l /= (float)nl;
+    if (nr) r /= (float)nr; else r = l; // one selected channel feeds both sides
+    s.acc[0] += l; s.acc[1] += r;
+    if (++s.phase < s.factor) continue;
+    s.pending.push_back(s.acc[0] * invF);
+    if (stereo) s.pending.push_back(s.acc[1] * invF);
+    s.phase = 0; s.acc[0] = s.acc[1] = 0;
+  }
+  const size_t cap = (size_t)(s.outRate * kMaxPendingSec) * (size_t)s.cfg.outChannels;
+  if (cap && s.pending.size() > cap) {
+    const size_t drop = (s.pending.size() - cap / 2) / s.cfg.outChannels * s.cfg.outChannels;
+    s.pending.erase(s.pending.begin(), s.pending.begin() + drop);
+    m_pendingDropped += drop / s.cfg.outChannels;
+  }
+}
+
+size_t AudioTap::Process()
+{
+  const auto t0 = std::chrono::steady_clock::now();
+  size_t framesIn = 0;
+  float hdr[kAudioTapBlockHeader];
+  std::lock_guard<std::mutex> lk(m_lock);
+  while (m_ring.Peek(hdr, kAudioTapBlockHeader)) {
+    const uint32_t mask = (uint32_t)hdr[0];
+    const int n = (int)hdr[1];
+    int nch = 0, pos[kAudioTapChannels];
+    for (int c = 0; c < kAudioTapChannels; ++c) pos[c] = (mask & (1u << c)) ? nch++ : -1;
+    const size_t total = kAudioTapBlockHeader + (size_t)n * (size_t)nch;
+    if (m_ring.Available() < total) break; // blocks are committed whole; defensive only
+    if (m_scratch.size() < total) m_scratch.resize(total);
+    m_ring.Read(m_scratch.data(), total);
+    for (Sub& s : m_subs) Downmix(s, m_scratch.data() + kAudioTapBlockHeader, n, nch, pos, (double)hdr[2]);
+    framesIn += (size_t)n;
+  }
+  if (framesIn)
+    m_workerNs.fetch_add((unsigned long long)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t0).count(),
+                         std::memory_order_relaxed);
+  return framesIn;
+}
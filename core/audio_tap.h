@@ -0,0 +1,107 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// core/audio_tap.h
+// Hardware audio tap for panels. The audio thread copies the captured channels into an SpscRing as
+// blocks of {mask, frames, srate, interleaved samples}: no locks, no allocation, a full ring drops the
+// block and counts it. A worker thread drains the ring and, per subscriber, downmixes the selected
+// channels to mono/stereo and decimates (boxcar average) towards the requested rate. The main thread
+// collects each subscriber's output with Take().
+//
+// Tap channel space: bits 0-7 hardware outputs 1-8 (post-processing), bits 8-15 hardware inputs 1-8.
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <stdint.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/spsc_ring.h"
+
+static const int kAudioTapChannels = 16;
+static const size_t kAudioTapBlockHeader = 3; // mask, frames, srate (as floats)
+
+struct AudioTapConfig
+{
+  uint32_t channels = 3;   // tap channel bits
+  int outChannels = 2;     // 1 = mono average, 2 = stereo (selected channels alternate L/R)
+  int rate = 11025;        // target rate; actual = srate / round(srate / rate)
+};
+
+// "o1,o2,i1" -> tap channel bits (1-based hardware channel numbers); 0 if nothing valid
+uint32_t ParseAudioTapChannels(const char* s, size_t n);
+
+class AudioTap
+{
+public:
+  explicit AudioTap(size_t ringFloats = 1u << 18);
+  ~AudioTap();
+
+  // ---- audio thread
+  uint32_t CaptureMask() const { return m_mask.load(std::memory_order_relaxed); }
+  // chans[c] must be valid for every bit c of mask (others are not touched); mask is narrowed to CaptureMask()
+  template <class S> void Push(const S* const* chans, uint32_t mask, int frames, double srate);
+
+  // ---- main thread
+  void Subscribe(const std::string& id, const AudioTapConfig& cfg);
+  bool Unsubscribe(const std::string& id);   // true if it was subscribed
+  bool HasSubscribers() const { return CaptureMask() != 0; }
+  bool IsSubscribed(const std::string& id);
+  // Output produced since the previous call (interleaved, outChannels per frame); false if none
+  bool Take(const std::string& id, std::vector<float>& out, int& outChannels, double& outRate);
+  void Start();                              // worker thread (idempotent)
+  void Stop();
+
+  // ---- worker: drains the ring into the subscribers (called by the worker thread; directly in benches)
+  size_t Process();
+
+  unsigned long long BlocksPushed() const { return m_pushed.load(std::memory_order_relaxed); }
+  unsigned long long BlocksDropped() const { return m_dropped.load(std::memory_order_relaxed); } // ring full
+  unsigned long long FramesDropped() const { return m_pendingDropped; } // output not collected in time
+  double WorkerMs() const { return m_workerNs.load(std::memory_order_relaxed) / 1e6; }
+
+private:
+  struct Sub
+  {
+    std::string id;
+    AudioTapConfig cfg;
+    double srcRate = 0, outRate = 0;
+    int factor = 1, phase = 0;
+    float acc[2] = { 0, 0 };
+    std::vector<float> pending;
+  };
+  void Downmix(Sub& s, const float* frames, int n, int nch, const int* pos, double srate);
+  void UpdateMask();
+
+  SpscRing<float> m_ring;
+  std::atomic<uint32_t> m_mask{0};
+  std::atomic<unsigned long long> m_pushed{0}, m_dropped{0}, m_workerNs{0};
+  unsigned long long m_pendingDropped = 0;   // under m_lock
+  std::mutex m_lock;                          // subscribers (worker + main thread, never the audio thread)
+  std::vector<Sub> m_subs;
+  std::vector<float> m_scratch;               // worker only
+  std::thread m_worker;
+  std::atomic<bool> m_run{false};
+};
+
+template <class S>
+void AudioTap::Push(const S* const* chans, uint32_t mask, int frames, double srate)
+{
+  mask &= CaptureMask();
+  if (!mask || frames <= 0) return;
+  int nch = 0; for (uint32_t m = mask; m; m &= m - 1) ++nch;
+  const size_t need = kAudioTapBlockHeader + (size_t)frames * (size_t)nch;
+  float* a; float* b; size_t na, nb;
+  if (!m_ring.Reserve(need, a, na, b, nb)) { m_dropped.fetch_add(1, std::memory_order_relaxed); return; }
+  const S* src[kAudioTapChannels] = {}; int k = 0;
+  for (int c = 0; c < kAudioTapChannels; ++c) if (mask & (1u << c)) src[k++] = chans[c];
+  float* dst = a; size_t left = na;
+  auto put = [&](float v) { if (!left) { dst = b; left = nb; } *dst++ = v; --left; };
+  put((float)mask); put((float)frames); put((float)srate);
+  for (int f = 0; f < frames; ++f)
+    for (int c = 0; c < nch; ++c) put((float)src[c][f]);
+  m_ring.Commit(need);
+  m_pushed.fetch_add(1, std::memory_order_relaxed);
+}
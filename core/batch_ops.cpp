@@ -0,0 +1,90 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// core/batch_ops.cpp
+
+#include "core/batch_ops.h"
+#include "core/nav_options.h"
+
+#include <string.h>
+#include <unordered_map>
+
+static std::string SpanToString(const JsonValue& v)
+{
+  if (!v.escaped) return std::string(v.ptr, v.len);
+  std::string s; s.resize(v.len + 1); // unescaping never grows the text
+  s.resize(JsonCopyString(v, &s[0], s.size()));
+  return s;
+}
+
+static bool ParseOneOp(const char* p, size_t n, BatchOp& op)
+{
+  NavigateOptions no;
+  if (!ParseNavigateOptions(p, n, no)) return false;
+  op.instanceId = no.instanceId;
+  if (no.url.type == JsonType::String) { op.hasUrl = true; op.url = SpanToString(no.url); }
+  if (no.hasSetTitle) { op.hasTitle = true; op.title = no.setTitle; }
+  op.showPanel = no.showPanel;
+  op.basicCtxMenu = no.basicCtxMenu;
+  if (no.hasContentFilter) { op.hasFilter = true; op.contentFilter = no.contentFilter; }
+  return true;
+}
+
+int ParseBatchOps(const char* json, std::vector<BatchOp>& out, int* outErrors)
+{
+  int errors = 0, added = 0;
+  if (outErrors) *outErrors = 0;
+  if (!json) return 0;
+  const size_t len = strlen(json);
+  JsonCursor c(json, len);
+  JsonValue v;
+  if (!c.ReadValue(v)) { if (outErrors) *outErrors = 1; return 0; }
+
+  if (v.type == JsonType::Object) {
+    const char* s = v.ptr; c.SkipValue();
+    BatchOp op; if (ParseOneOp(s, (size_t)(c.Pos() - s), op)) { out.push_back(std::move(op)); ++added; } else ++errors;
+  } else if (v.type == JsonType::Array) {
+    c.EnterArray();
+    while (c.NextElement()) {
+      if (!c.ReadValue(v)) break;
+      if (v.type != JsonType::Object) { if (v.type == JsonType::Array) c.SkipValue(); ++errors; continue; }
+      const char* s = v.ptr;
+      if (!c.SkipValue()) break;
+      BatchOp op; if (ParseOneOp(s, (size_t)(c.Pos() - s), op)) { out.push_back(std::move(op)); ++added; } else ++errors;
+    }
+    if (c.Failed()) ++errors; // truncated / malformed array: ops before the error are kept
+  } else {
+    ++errors;
+  }
+  if (outErrors) *outErrors = errors;
+  return added;
+}
+
+std::string BatchMergeKey(const std::string& id)
+{
+  if (id == "random") return std::string();
+  if (id.empty() || id.rfind("wv_", 0) != 0) return "wv_default";
+  return id;
+}
+
+int CoalesceBatchOps(std::vector<BatchOp>& ops)
+{
+  std::unordered_map<std::string, size_t> first; first.reserve(ops.size());
+  std::vector<BatchOp> merged; merged.reserve(ops.size());
+  for (auto& op : ops) {
+    const std::string key = BatchMergeKey(op.instanceId);
+    if (key.empty()) { merged.push_back(std::move(op)); continue; }
+    auto it = first.find(key);
+    if (it == first.end()) { first.emplace(key, merged.size()); merged.push_back(std::move(op)); continue; }
+    BatchOp& dst = merged[it->second];
+    if (op.hasUrl)   { dst.hasUrl = true;   dst.url = std::move(op.url); }
+    if (op.hasTitle) { dst.hasTitle = true; dst.title = std::move(op.title); }
+    if (op.showPanel != ShowPanelMode::Unset) dst.showPanel = op.showPanel;
+    if (op.basicCtxMenu >= 0) dst.basicCtxMenu = op.basicCtxMenu;
+    if (op.hasFilter) { dst.hasFilter = true; dst.contentFilter = std::move(op.contentFilter); }
+    dst.merged += op.merged;
+  }
+  const int removed = (int)(ops.size() - merged.size());
+  ops.swap(merged);
+  return removed;
+}
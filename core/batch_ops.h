@@ -0,0 +1,35 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// core/batch_ops.h
+// WEBVIEW_Batch: parse a JSON array of navigate-style operations and coalesce them per instance.
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "core/panel_mode.h"
+
+struct BatchOp
+{
+  std::string instanceId;          // raw InstanceId ("", "random", "current", "last", "wv_*")
+  bool hasUrl   = false; std::string url;
+  bool hasTitle = false; std::string title;
+  ShowPanelMode showPanel = ShowPanelMode::Unset;
+  int  basicCtxMenu = -1;          // -1 absent, 0/1
+  bool hasFilter = false; std::string contentFilter; // ContentFilter list name ("" = off)
+  int  merged = 1;                 // how many source ops were folded into this one
+};
+
+// Accepts `[ {op}, {op}, ... ]` or a single `{op}`. Each op uses WEBVIEW_Navigate option keys plus "Url".
+// Non-object elements and malformed objects are skipped and counted in *outErrors.
+// Returns the number of ops appended to out.
+int ParseBatchOps(const char* json, std::vector<BatchOp>& out, int* outErrors);
+
+// Key under which ops are merged: ""/non-wv_ ids -> "wv_default"; "random" never merges (empty key).
+// "current"/"last" must be resolved to real ids by the caller before coalescing.
+std::string BatchMergeKey(const std::string& instanceId);
+
+// Folds ops with the same merge key into the first one (later Url/SetTitle/ShowPanel/BasicCtxMenu/ContentFilter win).
+// Relative order of first appearance is preserved. Returns the number of ops removed.
+int CoalesceBatchOps(std::vector<BatchOp>& ops);
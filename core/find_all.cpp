@@ -0,0 +1,223 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// core/find_all.cpp
+#include "find_all.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "json_cursor.h"
+
+// One function for both scripts: jump == 0 counts and collects snippets, jump == i selects match i.
+// Text nodes are collected like __rwvFind.collect (core/find_script.cpp); case folding keeps the length so
+// offsets stay valid for the Range (characters whose lower case is longer are compared as they are).
+static const char* const kFindAllJS = R"JS((function(H,q,cs,mx,cx,jump){
+var t0=performance.now(),nodes=[],parts=[],st=[],acc=0,b=document.body;
+if(b){var w=document.createTreeWalker(b,NodeFilter.SHOW_TEXT,null);
+while(w.nextNode()){var n=w.currentNode;if(!n.nodeValue)continue;var p=n.parentNode;if(!p)continue;
+var t=p.nodeName;if(t==='SCRIPT'||t==='STYLE'||t==='NOSCRIPT')continue;nodes.push(n);parts.push(n.data);st.push(acc);acc+=n.data.length;}}
+var fold=function(s){var l=s.toLowerCase();return l.length===s.length?l:Array.prototype.map.call(s,function(c){var d=c.toLowerCase();return d.length===1?d:c;}).join('');};
+var text=parts.join(''),hay=cs?text:fold(text),nd=cs?q:fold(q),count=0,hits=[],at=-1,i=0;
+if(nd.length)while((i=hay.indexOf(nd,i))!==-1){++count;
+if(jump){if(count===jump)at=i;}
+else if(hits.length<mx){var a=Math.max(0,i-cx),e=Math.min(text.length,i+nd.length+cx);
+hits.push((a>0?'…':'')+text.slice(a,e).replace(/\s+/g,' ')+(e<text.length?'…':''));}
+i+=nd.length;}
+if(!jump)return JSON.stringify([H,count,hits,Math.round(performance.now()-t0)]);
+if(at<0)return -1;
+var loc=function(pos){var lo=0,hi=st.length-1;while(lo<hi){var m=(lo+hi+1)>>1;if(st[m]<=pos)lo=m;else hi=m-1;}return lo;};
+var s=loc(at),f=loc(at+nd.length-1),r=document.createRange();
+r.setStart(nodes[s],at-st[s]);r.setEnd(nodes[f],at+nd.length-st[f]);
+var sel=window.getSelection();if(sel){sel.removeAllRanges();sel.addRange(r);}
+var el=nodes[s].parentElement;if(el&&el.scrollIntoView)el.scrollIntoView({block:'center'});
+return count;
+}))JS";
+
+static std::string Invoke(int handle, const std::string& query, bool caseSensitive, int maxHits, int contextChars, int jump)
+{
+  std::string js = kFindAllJS;
+  char num[96];
+  snprintf(num, sizeof(num), "(%d,", handle);
+  js += num;
+  JsonAppendQuoted(js, query);
+  snprintf(num, sizeof(num), ",%s,%d,%d,%d)", caseSensitive ? "true" : "false", maxHits, contextChars, jump);
+  js += num;
+  return js;
+}
+
+std::string FindAllCountScript(int handle, const std::string& query, const FindAllOptions& opt)
+{
+  const int mx = opt.maxHits < 0 ? 0 : (opt.maxHits > FindAllSearches::kMaxHitsPerPanel ? FindAllSearches::kMaxHitsPerPanel : opt.maxHits);
+  const int cx = opt.contextChars < 0 ? 0 : (opt.contextChars > 200 ? 200 : opt.contextChars);
+  return Invoke(handle, query, opt.caseSensitive, mx, cx, 0);
+}
+
+std::string FindAllJumpScript(const std::string& query, bool caseSensitive, int index)
+{
+  return Invoke(0, query, caseSensitive, 0, 0, index < 1 ? 1 : index);
+}
+
+static long ReadInt(const JsonValue& v)
+{
+  if (v.type != JsonType::Number || v.len >= 32) return -1;
+  char buf[32]; memcpy(buf, v.ptr, v.len); buf[v.len] = 0;
+  return strtol(buf, nullptr, 10);
+}
+
+int FindAllSearches::Begin(const std::string& query, const FindAllOptions& opt, const std::vector<std::pair<std::string, std::string>>& panels, uint64_t nowMs)
+{
+  if (query.empty() || panels.empty() || m_pending >= kMaxPending) return -1;
+  if (m_nextHandle <= 0) m_nextHandle = 1;
+  while (m_map.count(m_nextHandle)) if (++m_nextHandle <= 0) m_nextHandle = 1;
+  const int h = m_nextHandle++;
+  Search& s = m_map[h];
+  s.query = query; s.opt = opt;
+  s.startMs = nowMs; s.deadlineMs = nowMs + (opt.timeoutMs ? opt.timeoutMs : 1);
+  s.panels.resize(panels.size());
+  for (size_t i = 0; i < panels.size(); ++i) { s.panels[i].id = panels[i].first; s.panels[i].title = panels[i].second; }
+  s.pending = (int)panels.size();
+  ++m_pending; ++m_started; m_panelsQueried += panels.size();
+  return h;
+}
+
+void FindAllSearches::Answer(Search& s, Panel& p, uint64_t nowMs)
+{
+  p.done = true;
+  p.answeredMs = nowMs - s.startMs;
+  if (--s.pending == 0) Finish(s, nowMs);
+}
+
+void FindAllSearches::Finish(Search& s, uint64_t nowMs)
+{
+  s.finishSeq = ++m_finishSeq;
+  --m_pending; ++m_finished;
+  const uint64_t total = nowMs - s.startMs;
+  m_totalMs += total;
+  if (total > m_maxTotalMs) m_maxTotalMs = total;
+  for (const Panel& p : s.panels) m_panelSumMs += p.answeredMs;
+  // keep at most kMaxKept finished searches
+  size_t finished = 0; auto oldest = m_map.end();
+  for (auto i = m_map.begin(); i != m_map.end(); ++i) {
+    if (i->second.pending) continue;
+    ++finished;
+    if (oldest == m_map.end() || i->second.finishSeq < oldest->second.finishSeq) oldest = i;
+  }
+  if (finished > (size_t)kMaxKept && oldest != m_map.end()) m_map.erase(oldest);
+}
+
+void FindAllSearches::OnPanelResult(const std::string& instanceId, const std::string& result, uint64_t nowMs)
+{
+  JsonCursor c(result.data(), result.size());
+  JsonValue v;
+  long handle = -1, matches = -1, pageMs = 0;
+  std::vector<std::string> hits;
+  if (!result.empty() && c.EnterArray()) {
+    for (int n = 0; c.NextElement(); ++n) { // [handle, matches, [snippets], pageMs]
+      if (!c.ReadValue(v)) break;
+      if (n == 2 && v.type == JsonType::Array && c.EnterArray()) {
+        while (c.NextElement()) {
+          JsonValue e;
+          if (!c.ReadValue(e)) break;
+          if (e.type == JsonType::Object || e.type == JsonType::Array) { c.SkipValue(); continue; }
+          if (e.type != JsonType::String) continue;
+          std::string text(e.len + 1, '\0');
+          text.resize(JsonCopyString(e, &text[0], text.size()));
+          hits.push_back(std::move(text));
+        }
+        continue;
+      }
+      if (v.type == JsonType::Object || v.type == JsonType::Array) { c.SkipValue(); continue; }
+      if (n == 0) handle = ReadInt(v); else if (n == 1) matches = ReadInt(v); else if (n == 3) pageMs = ReadInt(v);
+    }
+  }
+  const bool ok = !c.Failed() && handle > 0 && matches >= 0;
+  Search* s = nullptr; Panel* p = nullptr;
+  if (ok) {
+    auto it = m_map.find((int)handle);
+    if (it != m_map.end()) for (Panel& q : it->second.panels) if (!q.done && q.id == instanceId) { s = &it->second; p = &q; break; }
+  } else {
+    // no handle to route by: the oldest search still waiting for this instance
+    uint64_t oldest = 0;
+    for (auto& kv : m_map) {
+      if (!kv.second.pending || (s && kv.second.startMs >= oldest)) continue;
+      for (Panel& q : kv.second.panels) if (!q.done && q.id == instanceId) { s = &kv.second; p = &q; oldest = kv.second.startMs; break; }
+    }
+  }
+  if (!s || !p) return; // late answer of a timed-out panel
+  if (ok) {
+    p->matches = (int)matches; p->pageMs = pageMs > 0 ? (uint32_t)pageMs : 0;
+    if (hits.size() > (size_t)kMaxHitsPerPanel) hits.resize(kMaxHitsPerPanel);
+    p->hits = std::move(hits);
+  } else p->error = "evaluation failed";
+  Answer(*s, *p, nowMs);
+}
+
+void FindAllSearches::Fail(int handle, const std::string& instanceId, const std::string& error, uint64_t nowMs)
+{
+  auto it = m_map.find(handle);
+  if (it == m_map.end()) return;
+  for (Panel& p : it->second.panels) if (!p.done && p.id == instanceId) { p.error = error; Answer(it->second, p, nowMs); return; }
+}
+
+void FindAllSearches::DropInstance(const std::string& instanceId, const std::string& error, uint64_t nowMs)
+{
+  if (!m_pending) return;
+  std::vector<int> running; // Fail may finish a search, which can drop older ones from the map
+  for (const auto& kv : m_map) if (kv.second.pending) running.push_back(kv.first);
+  for (int h : running) Fail(h, instanceId, error, nowMs);
+}
+
+void FindAllSearches::Expire(uint64_t nowMs)
+{
+  if (!m_pending) return;
+  std::vector<int> expired;
+  for (const auto& kv : m_map) if (kv.second.pending && nowMs >= kv.second.deadlineMs) expired.push_back(kv.first);
+  for (int h : expired) {
+    Search& s = m_map[h]; // only finished searches are ever dropped, these are still pending
+    for (Panel& p : s.panels) {
+      if (p.done) continue;
+      p.error = "timeout"; ++m_timeouts;
+      p.done = true; p.answeredMs = nowMs - s.startMs;
+    }
+    s.pending = 0;
+    Finish(s, nowMs);
+  }
+}
+
+const FindAllSearches::Search* FindAllSearches::Find(int handle) const
+{
+  auto it = m_map.find(handle);
+  return it == m_map.end() ? nullptr : &it->second;
+}
+
+int FindAllSearches::Get(int handle, std::string& json) const
+{
+  const Search* s = Find(handle);
+  if (!s) return -4;
+  if (s->pending) return 0;
+  long long total = 0;
+  uint64_t slowest = 0;
+  bool failed = false;
+  std::string panels;
+  char num[128];
+  for (const Panel& p : s->panels) {
+    if (!panels.empty()) panels += ',';
+    panels += "{\"id\":"; JsonAppendQuoted(panels, p.id);
+    panels += ",\"title\":"; JsonAppendQuoted(panels, p.title);
+    if (p.answeredMs > slowest) slowest = p.answeredMs;
+    if (!p.error.empty()) { failed = true; panels += ",\"error\":"; JsonAppendQuoted(panels, p.error); panels += '}'; continue; }
+    total += p.matches;
+    snprintf(num, sizeof(num), ",\"matches\":%d,\"ms\":%llu,\"pageMs\":%u,\"hits\":[", p.matches, (unsigned long long)p.answeredMs, p.pageMs);
+    panels += num;
+    for (size_t i = 0; i < p.hits.size(); ++i) { if (i) panels += ','; JsonAppendQuoted(panels, p.hits[i]); }
+    panels += "]}";
+  }
+  json = "{\"query\":"; JsonAppendQuoted(json, s->query);
+  snprintf(num, sizeof(num), ",\"total\":%lld,\"ms\":%llu,\"panels\":[", total, (unsigned long long)slowest);
+  json += num;
+  json += panels;
+  json += "]}";
+  return failed ? -1 : 1;
+}
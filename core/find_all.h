@@ -0,0 +1,91 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// core/find_all.h
+// "Find in all panels": one query goes to every live panel in the same tick (one evaluate each, so the
+// pages search concurrently and the total is bounded by the slowest panel, not the sum). Each page counts
+// the matches over its text nodes (same collection and non-overlapping rule as the find bar's JS path,
+// core/find_script.h) and returns a short context snippet per hit; the answers are aggregated under one
+// handle. A hit is reached again with the jump script, which re-locates match #i and selects it.
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+struct FindAllOptions
+{
+  bool     caseSensitive = false;
+  int      maxHits = 20;        // context snippets kept per panel (the count is always complete)
+  int      contextChars = 30;   // snippet text on each side of a hit
+  uint32_t timeoutMs = 3000;    // panels that have not answered by then are reported as timed out
+};
+
+// Page scripts. Count answers JSON [handle, matches, [snippets], pageMs]; jump selects match `index`
+// (1-based, any match, not only the listed ones) and answers its total or -1 if there is no such match.
+std::string FindAllCountScript(int handle, const std::string& query, const FindAllOptions& opt);
+std::string FindAllJumpScript(const std::string& query, bool caseSensitive, int index);
+
+class FindAllSearches
+{
+public:
+  static const int kMaxPending = 8;       // searches still waiting for panels
+  static const int kMaxKept = 32;         // finished searches kept readable (oldest dropped first)
+  static const int kMaxHitsPerPanel = 200;
+
+  struct Panel
+  {
+    std::string id, title;
+    int  matches = -1;            // -1 until answered
+    std::vector<std::string> hits;
+    uint32_t pageMs = 0;          // time spent in the page
+    uint64_t answeredMs = 0;      // since Begin
+    std::string error;            // timeout / evaluation failed / no live view
+    bool done = false;
+  };
+  struct Search
+  {
+    std::string query;
+    FindAllOptions opt;
+    std::vector<Panel> panels;
+    uint64_t startMs = 0, deadlineMs = 0, finishSeq = 0;
+    int pending = 0;
+  };
+
+  // New handle for `panels` ((id, title) pairs), or -1 with kMaxPending searches still running
+  int  Begin(const std::string& query, const FindAllOptions& opt, const std::vector<std::pair<std::string, std::string>>& panels, uint64_t nowMs);
+  // Page answer of a count script. An empty/unparsable answer (navigation, closed view) fails the oldest
+  // panel of that instance still pending.
+  void OnPanelResult(const std::string& instanceId, const std::string& result, uint64_t nowMs);
+  void Fail(int handle, const std::string& instanceId, const std::string& error, uint64_t nowMs);
+  // Fails the instance's pending panel in every running search (panel closed before it answered)
+  void DropInstance(const std::string& instanceId, const std::string& error, uint64_t nowMs);
+  void Expire(uint64_t nowMs);
+
+  // 0 pending, 1 every panel answered, -1 finished with failures/timeouts, -4 unknown handle. json:
+  // {"query","total","ms","panels":[{"id","title","matches","ms","pageMs","hits":[...]} | {"id","title","error"}]}
+  // Results stay readable (for the jump) until kMaxKept newer searches finish.
+  int  Get(int handle, std::string& json) const;
+  const Search* Find(int handle) const;
+  int  Pending() const { return m_pending; }
+
+  unsigned long long Searches() const { return m_started; }
+  unsigned long long PanelsQueried() const { return m_panelsQueried; }
+  unsigned long long Timeouts() const { return m_timeouts; }
+  double AvgTotalMs() const { return m_finished ? (double)m_totalMs / (double)m_finished : 0.0; }
+  unsigned long long MaxTotalMs() const { return m_maxTotalMs; }
+  double AvgPanelSumMs() const { return m_finished ? (double)m_panelSumMs / (double)m_finished : 0.0; } // sequential equivalent
+
+private:
+  void Answer(Search& s, Panel& p, uint64_t nowMs);
+  void Finish(Search& s, uint64_t nowMs);
+
+  std::unordered_map<int, Search> m_map;
+  int m_nextHandle = 1;
+  int m_pending = 0;
+  uint64_t m_finishSeq = 0;
+  unsigned long long m_started = 0, m_panelsQueried = 0, m_timeouts = 0, m_finished = 0;
+  unsigned long long m_totalMs = 0, m_maxTotalMs = 0, m_panelSumMs = 0;
+};
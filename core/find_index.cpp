@@ -0,0 +1,201 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// core/find_index.cpp
+
+#include "core/find_index.h"
+
+#include <algorithm>
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #include <emmintrin.h>
+  #define RWV_FIND_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+  #include <arm_neon.h>
+  #define RWV_FIND_NEON 1
+#endif
+#ifdef _MSC_VER
+  #include <intrin.h>
+#endif
+
+static inline unsigned Ctz64(uint64_t v)
+{
+#ifdef _MSC_VER
+  unsigned long i; _BitScanForward64(&i, v); return (unsigned)i;
+#else
+  return (unsigned)__builtin_ctzll(v);
+#endif
+}
+
+// ---------------------------------------------------------------- case folding
+static char16_t FoldOne(char16_t c)
+{
+  if (c < 0x80) return (c >= 'A' && c <= 'Z') ? (char16_t)(c + 32) : c;
+  if (c >= 0xC0 && c <= 0xDE && c != 0xD7) return (char16_t)(c + 32);
+  if (c >= 0x100 && c <= 0x17F) {
+    if (c == 0x130) return 'i';
+    if (c == 0x178) return 0xFF;
+    const bool even = (c & 1) == 0;
+    if ((c <= 0x12F || (c >= 0x132 && c <= 0x137) || (c >= 0x14A && c <= 0x177)) && even) return (char16_t)(c + 1);
+    if (((c >= 0x139 && c <= 0x148) || (c >= 0x179 && c <= 0x17E)) && !even) return (char16_t)(c + 1);
+    return c;
+  }
+  if (c >= 0x386 && c <= 0x3A9) {
+    if (c >= 0x391 && c != 0x3A2) return (char16_t)(c + 0x20);
+    if (c == 0x386) return 0x3AC;
+    if (c >= 0x388 && c <= 0x38A) return (char16_t)(c + 0x25);
+    if (c == 0x38C) return 0x3CC;
+    if (c == 0x38E || c == 0x38F) return (char16_t)(c + 0x3F);
+    return c;
+  }
+  if (c >= 0x400 && c <= 0x4BF) {
+    if (c >= 0x410 && c <= 0x42F) return (char16_t)(c + 0x20);
+    if (c <= 0x40F) return (char16_t)(c + 0x50);
+    if (((c >= 0x460 && c <= 0x481) || c >= 0x48A) && (c & 1) == 0) return (char16_t)(c + 1);
+  }
+  return c;
+}
+
+static const char16_t* FoldTable()
+{
+  static std::u16string s_table; // 64K entries, built once
+  if (s_table.empty()) {
+    s_table.resize(0x10000);
+    for (uint32_t c = 0; c < 0x10000; ++c) s_table[c] = FoldOne((char16_t)c);
+  }
+  return s_table.data();
+}
+
+char16_t FoldCase16(char16_t c) { return FoldTable()[c]; }
+
+void FoldCase16(const char16_t* in, size_t n, char16_t* out)
+{
+  const char16_t* t = FoldTable();
+  for (size_t i = 0; i < n; ++i) out[i] = t[in[i]]; // surrogate halves map to themselves
+}
+
+// ---------------------------------------------------------------- substring search
+static inline bool TailEquals(const char16_t* at, const char16_t* needle, size_t m)
+{
+  return m <= 2 || !memcmp(at + 1, needle + 1, (m - 2) * sizeof(char16_t));
+}
+
+void FindAllU16Scalar(const char16_t* hay, size_t n, const char16_t* needle, size_t m, std::vector<uint32_t>& out)
+{
+  if (!m || m > n) return;
+  const char16_t first = needle[0], lastc = needle[m - 1];
+  for (size_t i = 0, last = n - m; i <= last; ++i)
+    if (hay[i] == first && hay[i + m - 1] == lastc && TailEquals(hay + i, needle, m)) out.push_back((uint32_t)i);
+}
+
+void FindAllU16(const char16_t* hay, size_t n, const char16_t* needle, size_t m, std::vector<uint32_t>& out)
+{
+  if (!m || m > n) return;
+  const size_t last = n - m; // last valid start
+  size_t i = 0;
+#if RWV_FIND_SSE2
+  // Candidate lanes: first and last needle units both match (8 starts per step), then verify the middle
+  const __m128i vf = _mm_set1_epi16((short)needle[0]);
+  const __m128i vl = _mm_set1_epi16((short)needle[m - 1]);
+  for (; i + 8 <= last + 1; i += 8) {
+    const __m128i a = _mm_loadu_si128((const __m128i*)(hay + i));
+    const __m128i b = _mm_loadu_si128((const __m128i*)(hay + i + m - 1));
+    uint64_t mask = (uint32_t)_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi16(a, vf), _mm_cmpeq_epi16(b, vl)));
+    while (mask) {
+      const unsigned lane = Ctz64(mask) >> 1; // 2 mask bits per 16-bit lane
+      if (TailEquals(hay + i + lane, needle, m)) out.push_back((uint32_t)(i + lane));
+      mask &= ~(3ull << (lane * 2));
+    }
+  }
+#elif RWV_FIND_NEON
+  const uint16x8_t vf = vdupq_n_u16((uint16_t)needle[0]);
+  const uint16x8_t vl = vdupq_n_u16((uint16_t)needle[m - 1]);
+  for (; i + 8 <= last + 1; i += 8) {
+    const uint16x8_t a = vld1q_u16((const uint16_t*)(hay + i));
+    const uint16x8_t b = vld1q_u16((const uint16_t*)(hay + i + m - 1));
+    const uint16x8_t eq = vandq_u16(vceqq_u16(a, vf), vceqq_u16(b, vl));
+    uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(eq, 4)), 0); // 8 mask bits per lane
+    while (mask) {
+      const unsigned lane = Ctz64(mask) >> 3;
+      if (TailEquals(hay + i + lane, needle, m)) out.push_back((uint32_t)(i + lane));
+      mask &= ~(0xFFull << (lane * 8));
+    }
+  }
+#endif
+  const char16_t first = needle[0], lastc = needle[m - 1];
+  for (; i <= last; ++i)
+    if (hay[i] == first && hay[i + m - 1] == lastc && TailEquals(hay + i, needle, m)) out.push_back((uint32_t)i);
+}
+
+// ---------------------------------------------------------------- FindIndex
+bool FindIndex::Load(std::u16string text, const std::vector<uint32_t>& nodeLens, uint32_t generation)
+{
+  Clear();
+  uint64_t total = 0;
+  for (uint32_t l : nodeLens) total += l;
+  if (total != text.size() || total > 0xFFFFFFF0ull) return false;
+  m_nodeStarts.reserve(nodeLens.size());
+  uint32_t acc = 0;
+  for (uint32_t l : nodeLens) { m_nodeStarts.push_back(acc); acc += l; }
+  m_text = std::move(text);
+  m_generation = generation;
+  return true;
+}
+
+void FindIndex::Clear()
+{
+  m_text.clear(); m_folded.clear(); m_foldedValid = false; m_nodeStarts.clear(); m_generation = 0;
+  m_lastQuery.clear(); m_occ.clear(); m_hits.clear(); m_lastRefined = false;
+}
+
+const std::u16string& FindIndex::Folded()
+{
+  if (!m_foldedValid) {
+    m_folded.resize(m_text.size());
+    FoldCase16(m_text.data(), m_text.size(), &m_folded[0]);
+    m_foldedValid = true;
+  }
+  return m_folded;
+}
+
+const std::vector<uint32_t>& FindIndex::Search(const std::u16string& query, bool caseSensitive)
+{
+  m_hits.clear(); m_lastRefined = false;
+  if (query.empty() || m_text.empty()) { m_lastQuery.clear(); m_occ.clear(); return m_hits; }
+
+  std::u16string q = query;
+  if (!caseSensitive) FoldCase16(q.data(), q.size(), &q[0]);
+  const std::u16string& hay = caseSensitive ? m_text : Folded();
+
+  // Every occurrence of the new query is an occurrence of a query it extends: re-check those only
+  const bool refine = !m_lastQuery.empty() && caseSensitive == m_lastCase && q.size() >= m_lastQuery.size() &&
+                      q.compare(0, m_lastQuery.size(), m_lastQuery) == 0;
+  if (refine) {
+    if (q.size() != m_lastQuery.size()) {
+      size_t w = 0;
+      for (uint32_t p : m_occ)
+        if (p + q.size() <= hay.size() && !memcmp(hay.data() + p, q.data(), q.size() * sizeof(char16_t))) m_occ[w++] = p;
+      m_occ.resize(w);
+    }
+    m_lastRefined = true;
+  } else {
+    m_occ.clear();
+    FindAllU16(hay.data(), hay.size(), q.data(), q.size(), m_occ);
+  }
+  m_lastQuery.swap(q); m_lastCase = caseSensitive;
+
+  const size_t len = m_lastQuery.size();
+  uint64_t end = 0;
+  for (uint32_t p : m_occ) if (p >= end) { m_hits.push_back(p); end = (uint64_t)p + len; }
+  return m_hits;
+}
+
+bool FindIndex::Locate(uint32_t pos, uint32_t& node, uint32_t& offset) const
+{
+  if (pos >= m_text.size() || m_nodeStarts.empty()) return false;
+  auto it = std::upper_bound(m_nodeStarts.begin(), m_nodeStarts.end(), pos) - 1; // last node starting at or before pos
+  node = (uint32_t)(it - m_nodeStarts.begin());
+  offset = pos - *it;
+  return true;
+}
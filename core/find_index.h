@@ -0,0 +1,64 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// core/find_index.h
+// Find-in-page text index for the JS highlight path (macOS). The page hands its text nodes over once per
+// DOM generation (UTF-16, concatenated, plus per-node lengths); queries then run natively against a
+// case-folded copy instead of re-walking and re-lowercasing the DOM on every keystroke.
+//
+// Offsets are UTF-16 code units so they map 1:1 onto DOM Range offsets. Matches are reported like the
+// old JS indexOf loop (non-overlapping, left to right); internally every occurrence is kept so a query
+// that extends the previous one ("ab" -> "abc") only re-checks the previous occurrences.
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+class FindIndex
+{
+public:
+  // Replaces the indexed text. nodeLens: UTF-16 length of each text node in document order; they must add
+  // up to text.size() (otherwise the index is left empty and false is returned).
+  bool Load(std::u16string text, const std::vector<uint32_t>& nodeLens, uint32_t generation);
+  void Clear();
+
+  uint32_t Generation() const { return m_generation; }
+  bool     Empty() const { return m_text.empty(); }
+  size_t   TextLength() const { return m_text.size(); }
+  size_t   NodeCount() const { return m_nodeStarts.size(); }
+
+  // Match starts (ascending, non-overlapping). Empty query -> no matches.
+  const std::vector<uint32_t>& Search(const std::u16string& query, bool caseSensitive);
+  const std::vector<uint32_t>& Hits() const { return m_hits; }
+  bool LastSearchRefined() const { return m_lastRefined; } // answered from the previous occurrence set
+
+  // Text offset -> (text node index, offset inside that node). False past the end.
+  bool Locate(uint32_t pos, uint32_t& node, uint32_t& offset) const;
+
+private:
+  const std::u16string& Folded();
+
+  std::u16string        m_text;
+  std::u16string        m_folded;      // built on the first case-insensitive query of a generation
+  bool                  m_foldedValid = false;
+  std::vector<uint32_t> m_nodeStarts;
+  uint32_t              m_generation = 0;
+
+  std::u16string        m_lastQuery;   // as searched (folded when case-insensitive)
+  bool                  m_lastCase = false;
+  std::vector<uint32_t> m_occ;         // every occurrence of m_lastQuery (overlapping)
+  std::vector<uint32_t> m_hits;        // m_occ filtered to non-overlapping
+  bool                  m_lastRefined = false;
+};
+
+// Simple length-preserving case fold: ASCII, Latin-1, Latin Extended-A pairs, Greek and Cyrillic
+// capitals. Covers what the old toLowerCase() comparison matched in practice without ICU.
+char16_t FoldCase16(char16_t c);
+void     FoldCase16(const char16_t* in, size_t n, char16_t* out);
+
+// Appends every occurrence (overlapping) of needle in hay. First/last code unit filter, 8 units per
+// step with SSE2/NEON; FindAllU16Scalar is the plain reference loop (benchmarks, cross-checks).
+void FindAllU16(const char16_t* hay, size_t n, const char16_t* needle, size_t m, std::vector<uint32_t>& out);
+void FindAllU16Scalar(const char16_t* hay, size_t n, const char16_t* needle, size_t m, std::vector<uint32_t>& out);
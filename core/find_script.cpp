@@ -0,0 +1,185 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// core/find_script.cpp
+
+#include "core/find_script.h"
+
+const char* const kFindHelperJS = R"JS((function(){
+if (window.__rwvFind && window.__rwvFind.version === 7) return;
+if (window.__rwvFind && window.__rwvFind.clear) { try { window.__rwvFind.clear(); } catch (_) {} }
+var F = window.__rwvFind = {
+  version: 7, gen: 0, dirty: true, nodes: [], starts: [], hits: [], rc: [], len: 0, cur: 0, obs: null, styled: false,
+  win: [0, 0], raf: 0, layer: null, boxes: [], curBoxes: [], listening: false,
+  MARGIN: 1.0,      // viewports painted above and below the visible one
+  MAX_PAINTED: 4000, // ranges registered per frame, whatever the total
+  // CSS Custom Highlight API when present, otherwise boxes in one absolutely positioned overlay layer.
+  // Neither touches the page's own nodes.
+  useHL: !!(window.CSS && CSS.highlights && window.Highlight),
+  watch: function() {
+    if (this.obs || !window.MutationObserver || !document.documentElement) return;
+    var self = this;
+    this.obs = new MutationObserver(function() { self.dirty = true; });
+    this.obs.observe(document.documentElement, { subtree: true, childList: true, characterData: true });
+  },
+  quiet: function() { if (this.obs) this.obs.takeRecords(); }, // drop records caused by our own DOM writes
+  collect: function() {
+    if (!document.body) return [];
+    var w = document.createTreeWalker(document.body, NodeFilter.SHOW_TEXT, null), out = [];
+    while (w.nextNode()) {
+      var n = w.currentNode; if (!n.nodeValue) continue;
+      var p = n.parentNode; if (!p) continue;
+      var t = p.nodeName; if (t === 'SCRIPT' || t === 'STYLE' || t === 'NOSCRIPT') continue;
+      out.push(n);
+    }
+    return out;
+  },
+  snapshot: function(known) {
+    this.watch();
+    if (!this.dirty && this.gen && known === this.gen) return null;
+    this.clear();
+    var n = this.collect(), lens = new Array(n.length), parts = new Array(n.length), st = new Array(n.length), acc = 0;
+    for (var i = 0; i < n.length; i++) { var d = n[i].data; parts[i] = d; lens[i] = d.length; st[i] = acc; acc += d.length; }
+    this.nodes = n; this.starts = st; this.dirty = false; this.gen++;
+    return [this.gen, lens.join(','), parts.join('')];
+  },
+  locate: function(p) {
+    var s = this.starts, lo = 0, hi = s.length - 1, r = 0;
+    while (lo <= hi) { var m = (lo + hi) >> 1; if (s[m] <= p) { r = m; lo = m + 1; } else hi = m - 1; }
+    return r;
+  },
+  // Range of match i (0-based), created on first use only
+  rangeAt: function(i) {
+    var r = this.rc[i];
+    if (r === undefined) {
+      r = null;
+      try {
+        var p = this.hits[i], a = this.locate(p), b = this.locate(p + this.len - 1);
+        r = document.createRange(); r.setStart(this.nodes[a], p - this.starts[a]); r.setEnd(this.nodes[b], p + this.len - this.starts[b]);
+      } catch (e) { r = null; }
+      this.rc[i] = r;
+    }
+    return r;
+  },
+  rectAt: function(i) { var r = this.rangeAt(i); return r ? r.getBoundingClientRect() : null; },
+  style: function() {
+    if (this.styled) return; this.styled = true;
+    var st = document.createElement('style');
+    st.textContent = '::highlight(rwv-find){background-color:rgba(255,230,128,0.9);color:inherit}' +
+                     '::highlight(rwv-find-current){background-color:rgba(255,150,0,0.95);color:inherit}' +
+                     '.__rwv_find_box{position:absolute;pointer-events:none;background:rgba(255,230,128,0.55);mix-blend-mode:multiply;outline:1px solid rgba(255,180,0,0.4)}' +
+                     '.__rwv_find_box.cur{background:rgba(255,150,0,0.6);outline:2px solid rgba(255,90,0,0.9)}';
+    (document.head || document.documentElement).appendChild(st);
+    this.quiet();
+  },
+  listen: function() {
+    if (this.listening) return; this.listening = true;
+    var self = this, kick = function() { if (self.hits.length) self.schedule(); };
+    document.addEventListener('scroll', kick, true); // capture: inner scroll containers too
+    window.addEventListener('resize', kick);
+  },
+  schedule: function() {
+    if (this.raf) return;
+    var self = this;
+    this.raf = requestAnimationFrame(function() { self.raf = 0; self.render(); });
+  },
+  clear: function() {
+    if (this.raf) { cancelAnimationFrame(this.raf); this.raf = 0; }
+    if (window.CSS && CSS.highlights) { CSS.highlights.delete('rwv-find'); CSS.highlights.delete('rwv-find-current'); }
+    if (this.layer) { this.layer.remove(); this.layer = null; this.boxes = []; this.curBoxes = []; this.quiet(); }
+    this.hits = []; this.rc = []; this.cur = 0; this.win = [0, 0];
+  },
+  apply: function(gen, len, hits) {
+    if (gen !== this.gen || this.dirty) return -3;
+    this.clear();
+    this.len = len; this.hits = hits;
+    if (!hits.length) return 0;
+    this.style(); this.listen(); this.render();
+    return hits.length;
+  },
+  // [first, last) of the matches inside the viewport +- MARGIN viewports. Matches are in document order,
+  // so their vertical position is (nearly) monotonic: binary search for the first, walk to the last.
+  visible: function() {
+    var n = this.hits.length, vh = window.innerHeight, top = -vh * this.MARGIN, bottom = vh * (1 + this.MARGIN);
+    var lo = 0, hi = n;
+    while (lo < hi) { var m = (lo + hi) >> 1, rc = this.rectAt(m); if (rc && rc.bottom < top) lo = m + 1; else hi = m; }
+    var end = lo;
+    while (end < n && end - lo < this.MAX_PAINTED) { var rc2 = this.rectAt(end); if (rc2 && rc2.top > bottom && rc2.height) break; end++; }
+    return [lo, end];
+  },
+  render: function() {
+    if (!this.hits.length) return;
+    var w = this.visible(), a = w[0], b = w[1];
+    this.win = w;
+    if (this.useHL) {
+      var h = new Highlight();
+      for (var i = a; i < b; i++) { var r = this.rangeAt(i); if (r) h.add(r); }
+      CSS.highlights.set('rwv-find', h);
+    } else {
+      this.paintBoxes(this.boxes, a, b, false);
+    }
+    this.paintCurrent();
+  },
+  ensureLayer: function() {
+    if (this.layer) return this.layer;
+    var l = document.createElement('div');
+    l.setAttribute('aria-hidden', 'true');
+    l.style.cssText = 'position:absolute;left:0;top:0;width:0;height:0;overflow:visible;pointer-events:none;z-index:2147483647';
+    document.documentElement.appendChild(l); // outside body: never part of the text snapshot
+    this.layer = l;
+    return l;
+  },
+  // Reuses pooled box elements; only boxes for matches in [a, b) are shown
+  paintBoxes: function(pool, a, b, current) {
+    var layer = this.ensureLayer(), sx = window.scrollX, sy = window.scrollY, used = 0;
+    for (var i = a; i < b; i++) {
+      var r = this.rangeAt(i); if (!r) continue;
+      var rects = r.getClientRects();
+      for (var k = 0; k < rects.length; k++) {
+        var q = rects[k]; if (!q.width || !q.height) continue;
+        var el = pool[used];
+        if (!el) { el = document.createElement('div'); el.className = current ? '__rwv_find_box cur' : '__rwv_find_box'; layer.appendChild(el); pool.push(el); }
+        el.style.cssText = 'left:' + (q.left + sx) + 'px;top:' + (q.top + sy) + 'px;width:' + q.width + 'px;height:' + q.height + 'px';
+        used++;
+      }
+    }
+    for (var j = used; j < pool.length; j++) pool[j].style.display = 'none';
+    this.quiet();
+  },
+  paintCurrent: function() {
+    var i = this.cur - 1, r = (i >= 0 && i < this.hits.length) ? this.rangeAt(i) : null;
+    if (this.useHL) { if (r) CSS.highlights.set('rwv-find-current', new Highlight(r)); else CSS.highlights.delete('rwv-find-current'); }
+    else if (r) this.paintBoxes(this.curBoxes, i, i + 1, true);
+    else if (this.curBoxes.length) this.paintBoxes(this.curBoxes, 0, 0, true);
+  },
+  // Scroll only when the match is off screen: one layout read, no writes unless needed
+  reveal: function(r) {
+    var rc = r.getBoundingClientRect();
+    if (rc.height && rc.top >= 0 && rc.bottom <= window.innerHeight) return false;
+    var el = r.startContainer.nodeType === 1 ? r.startContainer : r.startContainer.parentElement;
+    if (el && el.scrollIntoView) el.scrollIntoView({ block: 'nearest' }); // bring scrolling containers along
+    rc = r.getBoundingClientRect();
+    if (rc.top < 0 || rc.bottom > window.innerHeight) window.scrollBy(0, rc.top - window.innerHeight / 2);
+    return true;
+  },
+  // Current match i (1-based, 0 = none): repaints the current marker only; the painted window follows
+  // on the next frame if the page had to scroll. Returns the time spent in the page (ms).
+  select: function(i) {
+    var t0 = window.performance ? performance.now() : 0;
+    this.cur = i;
+    var r = (i >= 1 && i <= this.hits.length) ? this.rangeAt(i - 1) : null;
+    if (r && this.reveal(r)) this.schedule();
+    this.paintCurrent();
+    return window.performance ? performance.now() - t0 : 0;
+  },
+  // Wrapping step relative to the page's own current match; returns the new 1-based index
+  step: function(dir) {
+    var n = this.hits.length;
+    if (!n) return 0;
+    var i = this.cur + (dir < 0 ? -1 : 1);
+    if (i < 1) i = n; else if (i > n) i = 1;
+    this.select(i);
+    return i;
+  }
+};
+})();)JS";
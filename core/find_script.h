@@ -0,0 +1,24 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// core/find_script.h
+// Page-side half of the JS find path (macOS): window.__rwvFind. Injected idempotently before each query.
+//
+//   __rwvFind.snapshot(knownGen) -> null while the DOM is unchanged since generation knownGen, otherwise
+//                                   [gen, "len0,len1,...", text] (text nodes in document order, UTF-16)
+//   __rwvFind.apply(gen, len, [starts]) -> match count; -3 if gen is stale (re-snapshot and retry).
+//                                      Ranges are created lazily; only matches within one viewport above
+//                                      and below the visible one are painted (re-painted on scroll/resize),
+//                                      via the CSS Highlight API or, without it, one overlay layer of boxes.
+//                                      The page's own DOM is never modified.
+//   __rwvFind.select(i)             -> marks match i (1-based) current, scrolls it into view if off screen;
+//                                      O(1): only the current marker is repainted.
+//                                      Returns ms spent in the page.
+//   __rwvFind.step(dir)             -> wrapping next (+1) / previous (-1) from the page's current match
+//   __rwvFind.clear()
+//
+// Match offsets come from FindIndex (core/find_index.h) and index the concatenated snapshot text.
+#pragma once
+
+extern const char* const kFindHelperJS;
+static const int kFindHelperVersion = 7; // keep in sync with "version" inside the script
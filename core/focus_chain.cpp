@@ -0,0 +1,19 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// core/focus_chain.cpp
+
+#include "core/focus_chain.h"
+
+bool AdvanceFocusChain(std::string& primary, std::string& active, std::string& last, const std::string& inst)
+{
+  if (inst.empty()) return false;
+  if (primary == inst) {
+    if (active != inst) { if (!active.empty()) last = active; active = inst; }
+    return false;
+  }
+  if (!primary.empty() && last != primary) last = primary;
+  primary = inst;
+  if (active != inst) { if (!active.empty()) last = active; active = inst; }
+  return true;
+}
@@ -0,0 +1,78 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// core/focus_chain.h
+// Focus chain bookkeeping (primary / active / last-focused ids) and the non-UI part of search target
+// resolution. The UI part (GetFocus ancestry, window under cursor) stays in main.mm.
+#pragma once
+
+#include <string>
+
+// Moves inst to the head of the chain. Returns false when inst already was primary
+// (caller only refreshes its focus tick), true when the primary switched.
+bool AdvanceFocusChain(std::string& primary, std::string& active, std::string& last, const std::string& inst);
+
+// GetTickCount-style 32-bit wrap-safe "a is newer than or equal to b"
+inline bool FocusTickNotOlder(unsigned long a, unsigned long b)
+{
+  return (unsigned int)((unsigned int)a - (unsigned int)b) < 0x80000000u;
+}
+
+// Fallback order once no window has real focus:
+//   primary (alive) -> last focused (alive) -> most recent lastFocusTick among visible ->
+//   first visible -> any record.
+// alive(rec)/visible(rec) are supplied by the caller (IsWindow / IsWindowVisible in the plugin).
+template <class Registry, class Alive, class Visible>
+auto ResolveFocusFallback(Registry& reg, const std::string& primary, const std::string& last, Alive alive, Visible visible)
+  -> decltype(reg.Find(primary))
+{
+  if (!primary.empty()) { auto r = reg.Find(primary); if (r && alive(r)) return r; }
+  if (!last.empty())    { auto r = reg.Find(last);    if (r && alive(r)) return r; }
+  decltype(reg.Find(primary)) best = nullptr, firstVisible = nullptr, any = nullptr;
+  unsigned long bestTick = 0;
+  for (auto& kv : reg) {
+    auto r = kv.second.get(); if (!r) continue;
+    if (!any) any = r;
+    if (!alive(r) || !visible(r)) continue;
+    if (!firstVisible) firstVisible = r;
+    if (r->lastFocusTick && (!best || FocusTickNotOlder(r->lastFocusTick, bestTick))) { best = r; bestTick = r->lastFocusTick; }
+  }
+  if (best) return best;
+  if (firstVisible) return firstVisible;
+  return any;
+}
+
+// Visibility is event driven (host show/hide, view hide/unhide, window attach): the caller keeps a per-record
+// visible flag current from those notifications and calls this after each change instead of polling.
+//   - an active instance that is no longer visible is demoted to last (active cleared);
+//   - with no active instance left, the only visible one (exactly one) becomes active and is returned.
+// demoted is set when the active id was cleared.
+template <class Registry, class Visible>
+auto ResolveActiveOnVisibility(Registry& reg, std::string& active, std::string& last, Visible visible, bool* demoted = nullptr)
+  -> decltype(reg.Find(active))
+{
+  if (demoted) *demoted = false;
+  if (!active.empty()) {
+    auto a = reg.Find(active);
+    if (a && visible(a)) return nullptr;
+    if (last != active) last = active;
+    active.clear();
+    if (demoted) *demoted = true;
+  }
+  decltype(reg.Find(active)) only = nullptr;
+  for (auto& kv : reg) {
+    auto r = kv.second.get();
+    if (!r || !visible(r)) continue;
+    if (only) return nullptr; // several visible: leave the choice to the next real focus
+    only = r;
+  }
+  if (only) active = only->id;
+  return only;
+}
+
+// Wakeups spent on focus/visibility tracking. Every notification is an event; one that changed neither the
+// focus chain nor a visibility flag is an idle wakeup (a polling timer would add one per period).
+struct FocusEventCounters
+{
+  unsigned long long focusEvents = 0, visibilityEvents = 0, changes = 0, idleWakeups = 0;
+};
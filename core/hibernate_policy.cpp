@@ -0,0 +1,24 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// core/hibernate_policy.cpp
+
+#include "core/hibernate_policy.h"
+
+HibernateAction DecideHibernate(HibernateState st, bool visible, unsigned hiddenMs, bool busy, const HibernatePolicy& p)
+{
+  if (visible) return st != HibernateState::Active ? HibernateAction::Resume : HibernateAction::None;
+  if (busy || st == HibernateState::Discarded) return HibernateAction::None;
+  if (p.discardAfterMs && hiddenMs >= p.discardAfterMs) return HibernateAction::Discard;
+  if (st == HibernateState::Active && p.canSuspend && p.suspendAfterMs && hiddenMs >= p.suspendAfterMs) return HibernateAction::Suspend;
+  return HibernateAction::None;
+}
+
+const char* HibernateStateName(HibernateState st)
+{
+  switch (st) {
+    case HibernateState::Suspended: return "suspended";
+    case HibernateState::Discarded: return "discarded";
+    default: return "active";
+  }
+}
@@ -0,0 +1,24 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// core/hibernate_policy.h
+// Idle policy for hidden panels. The host samples visibility about once a second and applies the
+// returned action: Suspend = native suspend (WebView2 TrySuspend), Discard = snapshot URL/scroll and
+// drop the browser, Resume = bring it back (on show).
+#pragma once
+
+enum class HibernateState { Active, Suspended, Discarded };
+enum class HibernateAction { None, Suspend, Discard, Resume };
+
+struct HibernatePolicy
+{
+  unsigned suspendAfterMs = 60000; // 0 = never
+  unsigned discardAfterMs = 0;     // 0 = never
+  bool     canSuspend = true;      // backend has a native suspend
+};
+
+// hiddenMs: how long the host has been hidden (0 while visible). busy: playing audio or otherwise
+// must not be put to sleep.
+HibernateAction DecideHibernate(HibernateState st, bool visible, unsigned hiddenMs, bool busy, const HibernatePolicy& p);
+
+const char* HibernateStateName(HibernateState st);
@@ -0,0 +1,251 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// core/host_filter.cpp
+
+#include "core/host_filter.h"
+
+#include <algorithm>
+#include <string.h>
+
+static inline char Lower(char c) { return (c >= 'A' && c <= 'Z') ? (char)(c | 0x20) : c; }
+static inline bool IsSpace(char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n'; }
+static inline bool IsHostChar(char c)
+{
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '-' || c == '.' || c == '_';
+}
+
+// FNV-1a, fed right to left so every label suffix of a host is a prefix of the hash chain
+static const uint64_t kFnvBasis = 1469598103934665603ULL, kFnvPrime = 1099511628211ULL;
+static inline uint64_t HashStep(uint64_t h, char c) { return (h ^ (unsigned char)Lower(c)) * kFnvPrime; }
+static inline uint64_t Slotted(uint64_t h) { return h ? h : 1; }
+
+void HostFilter::Clear()
+{
+  m_slots.clear(); m_arena.clear(); m_patterns.clear();
+  m_used = m_blocked = m_allowed = 0;
+}
+
+void HostFilter::Rehash(size_t capacity)
+{
+  std::vector<Slot> old; old.swap(m_slots);
+  m_slots.assign(capacity, Slot{ 0, 0, 0, 0 });
+  const size_t mask = capacity - 1;
+  for (const Slot& s : old) {
+    if (!s.hash) continue;
+    size_t i = (size_t)s.hash & mask;
+    while (m_slots[i].hash) i = (i + 1) & mask;
+    m_slots[i] = s;
+  }
+}
+
+void HostFilter::AddHost(const char* host, size_t len, uint8_t flag)
+{
+  while (len && host[len - 1] == '.') --len;
+  while (len && host[0] == '.') { ++host; --len; }
+  if (!len || len > 0xFFFF) return;
+  uint64_t h = kFnvBasis;
+  for (size_t i = len; i-- > 0;) h = HashStep(h, host[i]);
+  h = Slotted(h);
+  if ((m_used + 1) * 2 > m_slots.size()) Rehash(m_slots.empty() ? 64 : m_slots.size() * 2);
+  const size_t mask = m_slots.size() - 1;
+  size_t i = (size_t)h & mask;
+  for (; m_slots[i].hash; i = (i + 1) & mask) {
+    Slot& s = m_slots[i];
+    if (s.hash != h || s.len != len) continue;
+    size_t k = 0;
+    while (k < len && m_arena[s.off + k] == Lower(host[k])) ++k;
+    if (k < len) continue;
+    if (!(s.flags & flag)) { s.flags |= flag; ++(flag == kBlock ? m_blocked : m_allowed); }
+    return;
+  }
+  Slot& s = m_slots[i];
+  s.hash = h; s.off = (uint32_t)m_arena.size(); s.len = (uint16_t)len; s.flags = flag;
+  for (size_t k = 0; k < len; ++k) m_arena += Lower(host[k]);
+  ++m_used; ++(flag == kBlock ? m_blocked : m_allowed);
+}
+
+void HostFilter::AddPattern(const char* p, size_t len)
+{
+  Pattern pat;
+  pat.anchored = len && p[0] == '|';
+  if (pat.anchored) { ++p; --len; }
+  if (len && p[len - 1] == '|') --len; // end anchor: treated as unanchored
+  pat.source.assign(p, len);
+  std::string cur;
+  for (size_t i = 0; i <= len; ++i) {
+    if (i == len || p[i] == '*' || p[i] == '^') { // '^' (separator) approximated by a wildcard
+      if (!cur.empty()) pat.parts.push_back(cur);
+      else if (pat.parts.empty() && i < len) pat.anchored = false;
+      cur.clear();
+    }
+    else cur += Lower(p[i]);
+  }
+  if (pat.parts.empty()) return; // would match everything
+  m_patterns.push_back(std::move(pat));
+}
+
+size_t HostFilter::Load(const char* text, size_t len)
+{
+  Clear();
+  size_t pos = 0;
+  while (pos < len) {
+    size_t eol = pos;
+    while (eol < len && text[eol] != '\n') ++eol;
+    size_t b = pos, e = eol;
+    pos = eol + 1;
+    while (b < e && IsSpace(text[b])) ++b;
+    while (e > b && IsSpace(text[e - 1])) --e;
+    if (b == e || text[b] == '!' || text[b] == '#' || text[b] == '[') continue;
+    const std::string line(text + b, e - b);
+    if (line.find("##") != std::string::npos || line.find("#@#") != std::string::npos) continue; // cosmetic rules
+
+    // hosts file: "0.0.0.0 host [# comment]"
+    const size_t ws = line.find_first_of(" \t");
+    if (ws != std::string::npos && line[0] >= '0' && line[0] <= '9') {
+      size_t hb = line.find_first_not_of(" \t", ws);
+      if (hb == std::string::npos) continue;
+      size_t he = line.find_first_of(" \t#", hb); if (he == std::string::npos) he = line.size();
+      const std::string host = line.substr(hb, he - hb);
+      if (host == "localhost" || host == "localhost.localdomain" || host == "local" || host == "broadcasthost" || host == "0.0.0.0") continue;
+      AddHost(host.data(), host.size(), kBlock);
+      continue;
+    }
+
+    size_t s = 0, n = line.size();
+    const bool allow = line.compare(0, 2, "@@") == 0;
+    if (allow) s = 2;
+    const size_t opts = line.find('$', s); if (opts != std::string::npos) n = opts;
+    if (s >= n) continue;
+    const bool domainAnchor = line.compare(s, 2, "||") == 0;
+    if (domainAnchor) s += 2;
+    size_t he = s;
+    while (he < n && IsHostChar(line[he])) ++he;
+    const bool hostOnly = he > s && (he == n || ((line[he] == '^' || line[he] == '/') && he + 1 == n));
+    if (hostOnly && (domainAnchor || line.find('.', s) < he)) { AddHost(line.data() + s, he - s, allow ? kAllow : kBlock); continue; }
+    if (allow) continue; // URL-level exceptions are not supported; host exceptions cover the usual cases
+    if (domainAnchor) { const std::string p = "://" + line.substr(s, n - s); AddPattern(p.data(), p.size()); }
+    else AddPattern(line.data() + s, n - s);
+  }
+  return m_blocked + m_allowed + m_patterns.size();
+}
+
+bool HostFilter::HostOf(const char* url, size_t len, size_t& begin, size_t& end)
+{
+  size_t i = 0;
+  while (i < len && url[i] != ':' && url[i] != '/' && url[i] != '?' && url[i] != '#') ++i;
+  if (i == 0 || i + 2 >= len || url[i] != ':' || url[i + 1] != '/' || url[i + 2] != '/') return false;
+  size_t b = i + 3, e = b;
+  while (e < len && url[e] != '/' && url[e] != '?' && url[e] != '#') ++e;
+  for (size_t k = e; k-- > b;) if (url[k] == '@') { b = k + 1; break; } // userinfo
+  if (b < e && url[b] == '[') { // IPv6 literal
+    size_t k = b; while (k < e && url[k] != ']') ++k;
+    begin = b + 1; end = k; return end > begin;
+  }
+  size_t k = b; while (k < e && url[k] != ':') ++k;
+  while (k > b && url[k - 1] == '.') --k;
+  begin = b; end = k;
+  return end > begin;
+}
+
+uint8_t HostFilter::HostFlags(const char* host, size_t len) const
+{
+  if (m_slots.empty()) return 0;
+  const size_t mask = m_slots.size() - 1;
+  uint8_t flags = 0;
+  uint64_t h = kFnvBasis;
+  for (size_t i = len; i-- > 0;) {
+    h = HashStep(h, host[i]);
+    if (i && host[i - 1] != '.') continue;
+    const uint64_t key = Slotted(h);
+    const size_t n = len - i;
+    for (size_t s = (size_t)key & mask; m_slots[s].hash; s = (s + 1) & mask) {
+      const Slot& slot = m_slots[s];
+      if (slot.hash != key || slot.len != n) continue;
+      const char* a = m_arena.data() + slot.off;
+      size_t k = 0;
+      while (k < n && a[k] == Lower(host[i + k])) ++k;
+      if (k == n) { flags |= slot.flags; break; }
+    }
+    if (flags & kAllow) return flags;
+  }
+  return flags;
+}
+
+bool HostFilter::PatternHit(const char* url, size_t len) const
+{
+  char buf[2048];
+  const size_t n = len < sizeof(buf) - 1 ? len : sizeof(buf) - 1;
+  for (size_t i = 0; i < n; ++i) buf[i] = Lower(url[i] ? url[i] : ' ');
+  buf[n] = '\0';
+  for (const Pattern& p : m_patterns) {
+    const char* at = buf;
+    size_t k = 0;
+    if (p.anchored) {
+      const std::string& first = p.parts[0];
+      if (strncmp(buf, first.c_str(), first.size())) continue;
+      at += first.size(); k = 1;
+    }
+    for (; k < p.parts.size(); ++k) {
+      const char* hit = strstr(at, p.parts[k].c_str());
+      if (!hit) break;
+      at = hit + p.parts[k].size();
+    }
+    if (k == p.parts.size()) return true;
+  }
+  return false;
+}
+
+FilterVerdict HostFilter::Check(const char* url, size_t len) const
+{
+  size_t hb, he;
+  if (m_used && HostOf(url, len, hb, he)) {
+    const uint8_t f = HostFlags(url + hb, he - hb);
+    if (f & kAllow) return FilterVerdict::Allow;
+    if (f & kBlock) return FilterVerdict::BlockHost;
+  }
+  if (!m_patterns.empty() && PatternHit(url, len)) return FilterVerdict::BlockPattern;
+  return FilterVerdict::Allow;
+}
+
+static void AppendRegexEscaped(std::string& out, const std::string& s)
+{
+  for (char c : s) {
+    if (strchr(".*+?()[]{}|^$\\", c)) out += "\\\\"; // regex escape, itself escaped for JSON
+    if (c == '"') out += '\\';
+    if ((unsigned char)c < 0x20) continue;
+    out += c;
+  }
+}
+
+std::string HostFilter::ContentRulesJson() const
+{
+  std::vector<const Slot*> hosts;
+  for (const Slot& s : m_slots) if (s.hash) hosts.push_back(&s);
+  std::sort(hosts.begin(), hosts.end(), [this](const Slot* a, const Slot* b) {
+    return m_arena.compare(a->off, a->len, m_arena, b->off, b->len) < 0;
+  });
+  std::string out = "[";
+  auto rule = [&out](const std::string& filter, const char* action) {
+    if (out.size() > 1) out += ',';
+    out += "{\"trigger\":{\"url-filter\":\""; out += filter;
+    out += "\"},\"action\":{\"type\":\""; out += action; out += "\"}}";
+  };
+  auto hostRules = [&](uint8_t flag, const char* action) {
+    for (const Slot* s : hosts) {
+      if (!(s->flags & flag)) continue;
+      std::string esc; AppendRegexEscaped(esc, m_arena.substr(s->off, s->len));
+      rule("^[^:]+://" + esc + "[:/]", action);          // the host itself
+      rule("^[^:]+://[^/]+\\\\." + esc + "[:/]", action); // its subdomains
+    }
+  };
+  hostRules(kBlock, "block");
+  for (const Pattern& p : m_patterns) {
+    std::string f = p.anchored ? "^" : "";
+    for (size_t k = 0; k < p.parts.size(); ++k) { if (k) f += ".*"; AppendRegexEscaped(f, p.parts[k]); }
+    rule(f, "block");
+  }
+  hostRules(kAllow, "ignore-previous-rules");
+  out += "]";
+  return out;
+}
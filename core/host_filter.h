@@ -0,0 +1,61 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// core/host_filter.h
+// Request filter for panels. A list file is compiled once into an open-addressing table keyed by a hash
+// of every blocked host read right to left, so one backwards pass over the request host probes each
+// label suffix ("ads.example.com", "example.com", "com") without splitting, lowering or allocating.
+// URL patterns ('*' wildcards) are kept as ordered literal pieces and only scanned when present. The
+// same rules are exported as a WebKit content blocker list for the backends that filter in WebKit.
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+enum class FilterVerdict : uint8_t { Allow, BlockHost, BlockPattern };
+
+class HostFilter
+{
+public:
+  // One rule per line; '!' and '#' start comments, "[Adblock ...]" headers are ignored.
+  //   example.com  ||example.com^  0.0.0.0 example.com   block the host and its subdomains
+  //   @@||example.com^                                   exception: never block it (or its subdomains)
+  //   /ads/*.js  |https://x.test/track                   URL pattern, '*' = any run, case-insensitive
+  // Anything after '$' (adblock options) is dropped. Returns the number of rules compiled.
+  size_t Load(const char* text, size_t len);
+  void Clear();
+
+  FilterVerdict Check(const char* url, size_t len) const;
+  FilterVerdict Check(const std::string& url) const { return Check(url.data(), url.size()); }
+
+  bool Empty() const { return !m_blocked && m_patterns.empty(); }
+  size_t HostRules() const { return m_blocked; }
+  size_t ExceptionRules() const { return m_allowed; }
+  size_t PatternRules() const { return m_patterns.size(); }
+  size_t TableSlots() const { return m_slots.size(); }
+
+  // WKContentRuleList / WebKitUserContentFilter JSON: block rules, then patterns, then exceptions
+  // as ignore-previous-rules. "[]" when empty.
+  std::string ContentRulesJson() const;
+
+  // Host part of scheme://[user@]host[:port]/...; false when the URL has no authority
+  static bool HostOf(const char* url, size_t len, size_t& begin, size_t& end);
+
+private:
+  enum : uint8_t { kBlock = 1, kAllow = 2 };
+  struct Slot { uint64_t hash; uint32_t off; uint16_t len; uint8_t flags; };
+  struct Pattern { std::vector<std::string> parts; bool anchored; std::string source; };
+
+  void AddHost(const char* host, size_t len, uint8_t flag);
+  void AddPattern(const char* p, size_t len);
+  void Rehash(size_t capacity);
+  uint8_t HostFlags(const char* host, size_t len) const;
+  bool PatternHit(const char* url, size_t len) const;
+
+  std::vector<Slot> m_slots;  // power-of-two capacity, hash 0 = empty
+  std::string m_arena;        // lowercase host strings referenced by the slots
+  std::vector<Pattern> m_patterns;
+  size_t m_used = 0, m_blocked = 0, m_allowed = 0;
+};
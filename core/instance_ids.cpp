@@ -0,0 +1,36 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// core/instance_ids.cpp
+
+#include "core/instance_ids.h"
+
+#include <stdio.h>
+
+std::string NormalizeInstanceIdWith(const std::string& raw, int& randomCounter, bool* outWasRandom)
+{
+  if (outWasRandom) *outWasRandom = false;
+  if (raw.empty()) return "wv_default";
+
+  if (raw == "random") {
+    if (outWasRandom) *outWasRandom = true;
+    ++randomCounter;
+    char buf[64]; snprintf(buf, sizeof(buf), "wv_%d", randomCounter);
+    return buf;
+  }
+
+  // Правило: пользователь обязан передать id, начинающийся с wv_. Если не так — игнор и default.
+  if (raw.rfind("wv_", 0) != 0) return "wv_default";
+  return raw;
+}
+
+int RandomInstanceNumber(const std::string& id)
+{
+  if (id.size() <= 3 || id.size() > 12 || id.rfind("wv_", 0) != 0) return 0;
+  int n = 0;
+  for (size_t i = 3; i < id.size(); ++i) {
+    if (id[i] < '0' || id[i] > '9') return 0;
+    n = n * 10 + (id[i] - '0');
+  }
+  return n;
+}
@@ -0,0 +1,13 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// core/instance_ids.h
+// InstanceId normalization rules ("wv_default", "random" -> wv_N, only wv_* accepted)
+#pragma once
+
+#include <string>
+
+// Counter is the caller's random id sequence (g_randomInstanceCounter in the plugin).
+std::string NormalizeInstanceIdWith(const std::string& raw, int& randomCounter, bool* outWasRandom = nullptr);
+// N of an id "random" produced (wv_<digits>), 0 for any other id
+int RandomInstanceNumber(const std::string& id);
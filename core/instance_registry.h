@@ -0,0 +1,117 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// core/instance_registry.h
+// id -> record storage for WebView instances. Header-only template so the plugin (WebViewInstanceRecord)
+// and the headless bench (synthetic records) share the same lookup code. Rec must expose `id` and `hwnd`.
+// Secondary hash indexes (host hwnd -> record, native view -> record) make the per-message lookups O(1);
+// they are only correct if hwnd / native view changes go through SetHwnd / SetNativeView.
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+template <class Rec>
+class InstanceRegistry
+{
+public:
+  using Map            = std::unordered_map<std::string, std::unique_ptr<Rec>>;
+  using iterator       = typename Map::iterator;
+  using const_iterator = typename Map::const_iterator;
+
+  Rec* Find(const std::string& id) const
+  {
+    auto it = m_map.find(id);
+    return it == m_map.end() ? nullptr : it->second.get();
+  }
+
+  template <class H>
+  Rec* FindByHwnd(H hwnd) const
+  {
+    if (!hwnd) return nullptr;
+    auto it = m_byHwnd.find((const void*)hwnd);
+    if (it == m_byHwnd.end()) return nullptr;
+    return it->second->hwnd == hwnd ? it->second : nullptr; // guard against a field changed behind our back
+  }
+
+  // Native view: ICoreWebView2* / WKWebView* / WebKitWebView*, whatever identifies the page host
+  Rec* FindByNativeView(const void* view) const
+  {
+    if (!view) return nullptr;
+    auto it = m_byView.find(view);
+    return it == m_byView.end() ? nullptr : it->second;
+  }
+
+  // Assigns rec->hwnd and keeps the hwnd index in sync (nullptr unbinds)
+  template <class H>
+  void SetHwnd(Rec* rec, H hwnd)
+  {
+    if (!rec) return;
+    if (rec->hwnd) { auto it = m_byHwnd.find((const void*)rec->hwnd); if (it != m_byHwnd.end() && it->second == rec) m_byHwnd.erase(it); }
+    rec->hwnd = hwnd;
+    if (hwnd) m_byHwnd[(const void*)hwnd] = rec;
+  }
+
+  // Associates (or with nullptr, dissociates) the record's native view. The field itself stays
+  // platform-typed in Rec; the registry remembers the pointer to drop it later.
+  void SetNativeView(Rec* rec, const void* view)
+  {
+    if (!rec) return;
+    auto prev = m_viewOf.find(rec);
+    if (prev != m_viewOf.end()) {
+      if (prev->second == view) return;
+      auto it = m_byView.find(prev->second); if (it != m_byView.end() && it->second == rec) m_byView.erase(it);
+      m_viewOf.erase(prev);
+    }
+    if (view) { m_byView[view] = rec; m_viewOf[rec] = view; }
+  }
+
+  // Inserts (or replaces) the record stored under id; returns the stored pointer
+  Rec* Insert(const std::string& id, std::unique_ptr<Rec> rec)
+  {
+    Rec* raw = rec.get();
+    auto it = m_map.find(id);
+    if (it != m_map.end()) Unindex(it->second.get());
+    if (raw && raw->hwnd) m_byHwnd[(const void*)raw->hwnd] = raw;
+    m_map[id] = std::move(rec);
+    return raw;
+  }
+
+  // Erases every record for which dead(rec) is true; onErase(rec) runs right before removal
+  template <class Dead, class OnErase>
+  size_t PurgeIf(Dead dead, OnErase onErase)
+  {
+    size_t n = 0;
+    for (auto it = m_map.begin(); it != m_map.end(); ) {
+      if (dead(it->second.get())) { onErase(it->second.get()); it = erase(it); ++n; }
+      else ++it;
+    }
+    return n;
+  }
+
+  // map-like surface (existing `for (auto& kv : g_instances)` loops keep working)
+  iterator       begin()       { return m_map.begin(); }
+  iterator       end()         { return m_map.end(); }
+  const_iterator begin() const { return m_map.begin(); }
+  const_iterator end()   const { return m_map.end(); }
+  iterator       find(const std::string& id) { return m_map.find(id); }
+  iterator       erase(iterator it)          { Unindex(it->second.get()); return m_map.erase(it); }
+  size_t         size()  const { return m_map.size(); }
+  bool           empty() const { return m_map.empty(); }
+  void           clear()       { m_map.clear(); m_byHwnd.clear(); m_byView.clear(); m_viewOf.clear(); }
+  void           reserve(size_t n) { m_map.reserve(n); m_byHwnd.reserve(n); m_byView.reserve(n); m_viewOf.reserve(n); }
+
+private:
+  void Unindex(Rec* rec)
+  {
+    if (!rec) return;
+    if (rec->hwnd) { auto it = m_byHwnd.find((const void*)rec->hwnd); if (it != m_byHwnd.end() && it->second == rec) m_byHwnd.erase(it); }
+    SetNativeView(rec, nullptr);
+  }
+
+  Map m_map;
+  std::unordered_map<const void*, Rec*> m_byHwnd;
+  std::unordered_map<const void*, Rec*> m_byView;
+  std::unordered_map<const Rec*, const void*> m_viewOf;
+};
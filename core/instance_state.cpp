@@ -0,0 +1,69 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// core/instance_state.cpp
+
+#include "core/instance_state.h"
+
+#include <string.h>
+
+enum : uint8_t { kFlagDockFloat = 1, kFlagBasicCtx = 2, kFlagFindCase = 4, kFlagWasOpen = 8 };
+
+static void PutU32(std::string& o, uint32_t v) { char b[4] = { (char)(v & 0xFF), (char)((v >> 8) & 0xFF), (char)((v >> 16) & 0xFF), (char)(v >> 24) }; o.append(b, 4); }
+static void PutU16(std::string& o, uint16_t v) { char b[2] = { (char)(v & 0xFF), (char)(v >> 8) }; o.append(b, 2); }
+static void PutStr(std::string& o, const std::string& s) { PutU32(o, (uint32_t)s.size()); o.append(s); }
+
+struct StateReader
+{
+  const unsigned char* p; const unsigned char* end; bool ok = true;
+  uint32_t U32() { if (end - p < 4) { ok = false; return 0; } uint32_t v = p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24); p += 4; return v; }
+  uint16_t U16() { if (end - p < 2) { ok = false; return 0; } uint16_t v = (uint16_t)(p[0] | (p[1] << 8)); p += 2; return v; }
+  uint8_t  U8()  { if (end - p < 1) { ok = false; return 0; } return *p++; }
+  void Str(std::string& s) { const uint32_t n = U32(); if (!ok || (size_t)(end - p) < n) { ok = false; return; } s.assign((const char*)p, n); p += n; }
+};
+
+void EncodeInstanceRecord(const PersistedInstance& in, std::string& out)
+{
+  out.clear();
+  PutU32(out, 0); // patched below
+  PutStr(out, in.id); PutStr(out, in.lastUrl); PutStr(out, in.titleOverride); PutStr(out, in.findQuery);
+  PutU32(out, (uint32_t)in.panelMode); PutU32(out, (uint32_t)in.wantDockOnCreate); PutU32(out, (uint32_t)in.lastDockIdx);
+  out.push_back((char)((in.lastDockFloat ? kFlagDockFloat : 0) | (in.basicCtxMenu ? kFlagBasicCtx : 0) |
+                       (in.findCaseSensitive ? kFlagFindCase : 0) | (in.wasOpen ? kFlagWasOpen : 0)));
+  PutStr(out, in.contentFilter);
+  const uint32_t len = (uint32_t)(out.size() - 4);
+  std::string hdr; PutU32(hdr, len); memcpy(&out[0], hdr.data(), 4);
+}
+
+void BuildStateSnapshot(const std::vector<const std::string*>& records, std::string& out)
+{
+  size_t total = 12; for (const std::string* r : records) total += r->size();
+  out.clear(); out.reserve(total);
+  out.append("RWVS", 4); PutU16(out, kInstanceStateVersion); PutU16(out, 0); PutU32(out, (uint32_t)records.size());
+  for (const std::string* r : records) out.append(*r);
+}
+
+bool ParseStateSnapshot(const char* data, size_t len, std::vector<PersistedInstance>& out)
+{
+  if (!data || len < 12 || memcmp(data, "RWVS", 4)) return false;
+  StateReader r{ (const unsigned char*)data + 4, (const unsigned char*)data + len };
+  const uint16_t ver = r.U16(); r.U16();
+  if (ver == 0) return false;
+  const uint32_t count = r.U32();
+  for (uint32_t i = 0; i < count && r.ok; ++i) {
+    const uint32_t n = r.U32();
+    if (!r.ok || (size_t)(r.end - r.p) < n) return false;
+    StateReader rr{ r.p, r.p + n };
+    PersistedInstance pi;
+    rr.Str(pi.id); rr.Str(pi.lastUrl); rr.Str(pi.titleOverride); rr.Str(pi.findQuery);
+    pi.panelMode = (int)rr.U32(); pi.wantDockOnCreate = (int)rr.U32(); pi.lastDockIdx = (int)rr.U32();
+    const uint8_t f = rr.U8();
+    if (rr.ok && rr.p < rr.end) rr.Str(pi.contentFilter);
+    r.p += n;
+    if (!rr.ok || pi.id.empty()) continue; // damaged record: skip it, keep the rest
+    pi.lastDockFloat = (f & kFlagDockFloat) != 0; pi.basicCtxMenu = (f & kFlagBasicCtx) != 0;
+    pi.findCaseSensitive = (f & kFlagFindCase) != 0; pi.wasOpen = (f & kFlagWasOpen) != 0;
+    out.push_back(std::move(pi));
+  }
+  return r.ok;
+}
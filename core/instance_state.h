@@ -0,0 +1,48 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// core/instance_state.h
+// Versioned binary snapshot of per-instance state (reaper_webview_state.bin in the REAPER resource dir).
+//
+//   header : "RWVS" u16 version u16 reserved u32 count
+//   record : u32 payloadLen, payload   (length-prefixed so readers skip fields appended by newer versions)
+//   payload: str id, str lastUrl, str titleOverride, str findQuery (u32 len + bytes),
+//            i32 panelMode, i32 wantDockOnCreate, i32 lastDockIdx, u8 flags
+//            [, str contentFilter]  (appended later; absent in older files -> "default")
+//
+// All integers little-endian. Encoding is per record so the plugin can cache each record's bytes and
+// rewrite the file only when one of them actually changed. A newer version only appends fields to the
+// payload, so an older reader decodes the fields it knows and skips the rest; an incompatible layout
+// would need a new magic.
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+static const uint16_t kInstanceStateVersion = 1;
+
+struct PersistedInstance
+{
+  std::string id;
+  std::string lastUrl;
+  std::string titleOverride;
+  std::string findQuery;
+  int  panelMode = 0;         // ShowPanelMode
+  int  wantDockOnCreate = -1;
+  int  lastDockIdx = -1;
+  bool lastDockFloat = false;
+  bool basicCtxMenu = false;
+  bool findCaseSensitive = false;
+  bool wasOpen = false;       // had a live window when saved -> recreate on startup
+  std::string contentFilter = "default"; // request filter list name, "" = off
+};
+
+// Record payload with its u32 length prefix, ready to append after the header
+void EncodeInstanceRecord(const PersistedInstance& in, std::string& out);
+// Header + already encoded records
+void BuildStateSnapshot(const std::vector<const std::string*>& records, std::string& out);
+// False on bad magic/truncation; records decoded before the error are kept in out. Files of a newer
+// version are read (known fields only).
+bool ParseStateSnapshot(const char* data, size_t len, std::vector<PersistedInstance>& out);
@@ -0,0 +1,226 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// core/json_cursor.cpp
+
+#include "core/json_cursor.h"
+
+#include <string.h>
+
+static inline bool IsWs(char c) { return c==' ' || c=='\t' || c=='\r' || c=='\n'; }
+static inline char LowerAscii(char c) { return (c>='A' && c<='Z') ? (char)(c - 'A' + 'a') : c; }
+
+JsonCursor::JsonCursor(const char* s) : m_p(s), m_end(s ? s + strlen(s) : s) {}
+
+void JsonCursor::SkipWs() { while (m_p < m_end && IsWs(*m_p)) ++m_p; }
+
+bool JsonCursor::EnterObject()
+{
+  SkipWs();
+  if (m_p >= m_end || *m_p != '{') return Fail();
+  ++m_p; m_needComma = false;
+  return true;
+}
+
+bool JsonCursor::EnterArray()
+{
+  SkipWs();
+  if (m_p >= m_end || *m_p != '[') return Fail();
+  ++m_p; m_needComma = false;
+  return true;
+}
+
+bool JsonCursor::NextKey(JsonValue& key)
+{
+  if (m_failed) return false;
+  SkipWs();
+  if (m_p < m_end && *m_p == '}') { ++m_p; m_needComma = true; return false; }
+  if (m_needComma) {
+    if (m_p >= m_end || *m_p != ',') return Fail();
+    ++m_p; SkipWs();
+    if (m_p < m_end && *m_p == '}') { ++m_p; m_needComma = true; return false; } // tolerate trailing comma
+  }
+  if (m_p >= m_end || *m_p != '"') return Fail();
+  if (!ScanString(key)) return false;
+  SkipWs();
+  if (m_p >= m_end || *m_p != ':') return Fail();
+  ++m_p; m_needComma = false;
+  return true;
+}
+
+bool JsonCursor::NextElement()
+{
+  if (m_failed) return false;
+  SkipWs();
+  if (m_p < m_end && *m_p == ']') { ++m_p; m_needComma = true; return false; }
+  if (m_needComma) {
+    if (m_p >= m_end || *m_p != ',') return Fail();
+    ++m_p; SkipWs();
+    if (m_p < m_end && *m_p == ']') { ++m_p; m_needComma = true; return false; }
+  }
+  if (m_p >= m_end) return Fail();
+  m_needComma = false;
+  return true;
+}
+
+bool JsonCursor::ScanString(JsonValue& v)
+{
+  // at opening quote
+  const char* s = ++m_p; bool esc = false;
+  while (m_p < m_end && *m_p != '"') {
+    if (*m_p == '\\') { esc = true; if (++m_p >= m_end) break; }
+    ++m_p;
+  }
+  if (m_p >= m_end) return Fail();
+  v.type = JsonType::String; v.ptr = s; v.len = (size_t)(m_p - s); v.escaped = esc;
+  ++m_p;
+  return true;
+}
+
+bool JsonCursor::ReadValue(JsonValue& v)
+{
+  v = JsonValue();
+  if (m_failed) return false;
+  SkipWs();
+  if (m_p >= m_end) return Fail();
+  const char c = *m_p;
+  if (c == '"') { if (!ScanString(v)) return false; m_needComma = true; return true; }
+  if (c == '{' || c == '[') { v.type = c=='{' ? JsonType::Object : JsonType::Array; v.ptr = m_p; v.len = 1; return true; }
+
+  // number / literal / bare word (legacy opts allowed unquoted values: {"ShowPanel":docker},
+  // {"SetTitle": My Panel}); runs to the next delimiter, trailing whitespace trimmed
+  const char* s = m_p;
+  while (m_p < m_end && *m_p != ',' && *m_p != '}' && *m_p != ']') ++m_p;
+  const char* e = m_p;
+  while (e > s && IsWs(e[-1])) --e;
+  v.ptr = s; v.len = (size_t)(e - s);
+  if (!v.len) return Fail();
+  if ((c>='0' && c<='9') || c=='-' || c=='+' || c=='.') v.type = JsonType::Number;
+  else if (v.len==4 && !memcmp(s,"true",4))  v.type = JsonType::True;
+  else if (v.len==5 && !memcmp(s,"false",5)) v.type = JsonType::False;
+  else if (v.len==4 && !memcmp(s,"null",4))  v.type = JsonType::Null;
+  else v.type = JsonType::String;
+  m_needComma = true;
+  return true;
+}
+
+bool JsonCursor::SkipValue()
+{
+  if (m_failed) return false;
+  SkipWs();
+  if (m_p >= m_end) return Fail();
+  if (*m_p != '{' && *m_p != '[') { JsonValue v; return ReadValue(v); }
+  int depth = 0;
+  while (m_p < m_end) {
+    const char c = *m_p;
+    if (c == '"') { JsonValue tmp; if (!ScanString(tmp)) return false; continue; }
+    if (c == '{' || c == '[') ++depth;
+    else if (c == '}' || c == ']') { if (--depth == 0) { ++m_p; m_needComma = true; return true; } }
+    ++m_p;
+  }
+  return Fail();
+}
+
+bool JsonKeyEquals(const JsonValue& key, const char* name)
+{
+  if (!name) return false;
+  size_t i = 0;
+  for (; i < key.len; ++i) { if (!name[i] || LowerAscii(key.ptr[i]) != LowerAscii(name[i])) return false; }
+  return name[i] == 0;
+}
+
+static size_t PutUtf8(unsigned int cp, char* o)
+{
+  if (cp < 0x80)    { o[0]=(char)cp; return 1; }
+  if (cp < 0x800)   { o[0]=(char)(0xC0|(cp>>6)); o[1]=(char)(0x80|(cp&0x3F)); return 2; }
+  if (cp < 0x10000) { o[0]=(char)(0xE0|(cp>>12)); o[1]=(char)(0x80|((cp>>6)&0x3F)); o[2]=(char)(0x80|(cp&0x3F)); return 3; }
+  o[0]=(char)(0xF0|(cp>>18)); o[1]=(char)(0x80|((cp>>12)&0x3F)); o[2]=(char)(0x80|((cp>>6)&0x3F)); o[3]=(char)(0x80|(cp&0x3F)); return 4;
+}
+
+static int Hex4(const char* p, const char* end, unsigned int* out)
+{
+  if (end - p < 4) return 0;
+  unsigned int v = 0;
+  for (int i=0;i<4;++i) {
+    const char c = p[i]; v <<= 4;
+    if (c>='0'&&c<='9') v |= (unsigned)(c-'0'); else if (c>='a'&&c<='f') v |= (unsigned)(c-'a'+10); else if (c>='A'&&c<='F') v |= (unsigned)(c-'A'+10); else return 0;
+  }
+  *out = v; return 1;
+}
+
+size_t JsonCopyString(const JsonValue& v, char* out, size_t cap)
+{
+  if (!out || !cap) return 0;
+  size_t n = 0;
+  const char* p = v.ptr; const char* end = v.ptr + v.len;
+  if (!p) { out[0] = 0; return 0; }
+  while (p < end) {
+    char tmp[4]; size_t tl = 0;
+    if (v.escaped && *p == '\\' && p + 1 < end) {
+      const char e = p[1]; p += 2;
+      switch (e) {
+        case 'n': tmp[0]='\n'; tl=1; break;
+        case 't': tmp[0]='\t'; tl=1; break;
+        case 'r': tmp[0]='\r'; tl=1; break;
+        case 'b': tmp[0]='\b'; tl=1; break;
+        case 'f': tmp[0]='\f'; tl=1; break;
+        case 'u': {
+          unsigned int cp = 0;
+          if (!Hex4(p, end, &cp)) { tmp[0]='?'; tl=1; break; }
+          p += 4;
+          if (cp >= 0xD800 && cp < 0xDC00 && end - p >= 6 && p[0]=='\\' && p[1]=='u') {
+            unsigned int lo = 0;
+            if (Hex4(p+2, end, &lo) && lo >= 0xDC00 && lo < 0xE000) { cp = 0x10000 + ((cp-0xD800)<<10) + (lo-0xDC00); p += 6; }
+          }
+          tl = PutUtf8(cp, tmp);
+          break;
+        }
+        default: tmp[0]=e; tl=1; break; // \" \\ \/ and unknown escapes -> literal char
+      }
+    } else {
+      // copy a whole UTF-8 sequence so truncation never splits it
+      const unsigned char c = (unsigned char)*p;
+      tl = c < 0x80 ? 1 : (c >= 0xF0 ? 4 : (c >= 0xE0 ? 3 : (c >= 0xC0 ? 2 : 1)));
+      if ((size_t)(end - p) < tl) tl = (size_t)(end - p);
+      memcpy(tmp, p, tl); p += tl;
+    }
+    if (n + tl >= cap) break;
+    memcpy(out + n, tmp, tl); n += tl;
+  }
+  out[n] = 0;
+  return n;
+}
+
+void JsonAppendQuoted(std::string& out, const char* s, size_t n)
+{
+  static const char kHex[] = "0123456789abcdef";
+  out.push_back('"');
+  for (size_t i = 0; i < n; ++i) {
+    const unsigned char c = (unsigned char)s[i];
+    switch (c) {
+      case '"':  out += "\\\""; break;
+      case '\\': out += "\\\\"; break;
+      case '\n': out += "\\n"; break;
+      case '\r': out += "\\r"; break;
+      case '\t': out += "\\t"; break;
+      default:
+        if (c < 0x20) { out += "\\u00"; out.push_back(kHex[c >> 4]); out.push_back(kHex[c & 15]); }
+        else out.push_back((char)c);
+    }
+  }
+  out.push_back('"');
+}
+
+bool JsonIsTruthy(const JsonValue& v)
+{
+  switch (v.type) {
+    case JsonType::True:   return true;
+    case JsonType::Number: { for (size_t i=0;i<v.len;++i) if (v.ptr[i]>='1' && v.ptr[i]<='9') return true; return false; }
+    case JsonType::String:
+      if (!v.len) return false;
+      if (v.len==1 && v.ptr[0]=='0') return false;
+      if (v.len==5 && !memcmp(v.ptr,"false",5)) return false;
+      return true;
+    default: return false;
+  }
+}
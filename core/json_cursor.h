@@ -0,0 +1,67 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// core/json_cursor.h
+// Minimal forward-only JSON reader over a caller-owned buffer. No allocation: strings are returned as
+// spans into the input and unescaped on demand into caller buffers. Nested values the caller does not
+// care about are skipped. Used for WEBVIEW_* option strings (small, flat, hot path from defer loops).
+#pragma once
+
+#include <stddef.h>
+#include <string>
+
+enum class JsonType { None, String, Number, True, False, Null, Object, Array };
+
+struct JsonValue
+{
+  JsonType    type = JsonType::None;
+  const char* ptr  = nullptr; // String: between quotes (raw, escapes intact); Number: digits; Object/Array: at '{'/'['
+  size_t      len  = 0;
+  bool        escaped = false; // String contains backslash escapes
+};
+
+class JsonCursor
+{
+public:
+  JsonCursor(const char* s, size_t n) : m_p(s), m_end(s + n) {}
+  explicit JsonCursor(const char* s);
+
+  // Object traversal:  if (c.EnterObject()) while (c.NextKey(k)) { c.ReadValue(v) / c.SkipValue(); }
+  bool EnterObject();
+  bool NextKey(JsonValue& key);   // false at '}' (consumed) or on error
+  // Array traversal:   if (c.EnterArray()) while (c.NextElement()) { c.ReadValue(v) ... }
+  bool EnterArray();
+  bool NextElement();             // false at ']' (consumed) or on error
+
+  // Scalars are consumed completely. Object/Array are NOT entered: v.ptr points at the bracket and the
+  // cursor stays there, so the caller either Enter*()s or calls SkipValue().
+  bool ReadValue(JsonValue& v);
+  bool SkipValue();
+
+  bool Failed() const { return m_failed; }
+  const char* Pos() const { return m_p; }
+
+private:
+  void SkipWs();
+  bool ScanString(JsonValue& v);
+  bool Fail() { m_failed = true; return false; }
+
+  const char* m_p;
+  const char* m_end;
+  bool  m_needComma = false;
+  bool  m_failed = false;
+};
+
+// Case-insensitive key compare (legacy option lookup was case-insensitive)
+bool JsonKeyEquals(const JsonValue& key, const char* name);
+
+// Unescape a String value into out (NUL-terminated, truncated to cap-1 bytes on a UTF-8 boundary).
+// Numbers/true/false are copied verbatim. Returns bytes written (excluding NUL).
+size_t JsonCopyString(const JsonValue& v, char* out, size_t cap);
+
+// Truthiness used by boolean options: true, non-zero number, non-empty string other than "0"/"false"
+bool JsonIsTruthy(const JsonValue& v);
+
+// Writer side: appends s as a quoted JSON string (", \\ and control chars escaped; UTF-8 passes through)
+void JsonAppendQuoted(std::string& out, const char* s, size_t n);
+inline void JsonAppendQuoted(std::string& out, const std::string& s) { JsonAppendQuoted(out, s.data(), s.size()); }
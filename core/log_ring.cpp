@@ -0,0 +1,280 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// core/log_ring.cpp
+
+#include "core/log_ring.h"
+
+#include <chrono>
+#include <string.h>
+#include <time.h>
+
+#ifdef _WIN32
+  #ifndef WIN32_LEAN_AND_MEAN
+    #define WIN32_LEAN_AND_MEAN
+  #endif
+  #include <windows.h>
+#endif
+
+static bool EqualsNoCase(const char* a, const char* b)
+{
+  for (; *a && *b; ++a, ++b) if ((*a | 0x20) != (*b | 0x20)) return false;
+  return *a == *b;
+}
+
+LogLevel ParseLogLevel(const char* s, LogLevel def)
+{
+  if (!s || !*s) return def;
+  if (s[0] >= '0' && s[0] <= '4' && !s[1]) return (LogLevel)(s[0] - '0');
+  static const char* names[] = { "debug", "info", "warn", "error", "off" };
+  for (int i = 0; i < 5; ++i) if (EqualsNoCase(s, names[i])) return (LogLevel)i;
+  return def;
+}
+
+// ---------------------------------------------------------------- filter
+LogFilter::LogFilter() : m_level((uint8_t)kLogDebug), m_rules(nullptr) {}
+
+void LogFilter::SetTags(const std::string& spec)
+{
+  if (spec == m_spec && (m_rules.load() || spec.empty())) return;
+  m_spec = spec;
+  std::unique_ptr<Rules> r(new Rules());
+  size_t i = 0;
+  while (i <= spec.size()) {
+    size_t e = spec.find(',', i); if (e == std::string::npos) e = spec.size();
+    size_t b = i; while (b < e && (spec[b] == ' ' || spec[b] == '[')) ++b;
+    size_t z = e; while (z > b && (spec[z - 1] == ' ' || spec[z - 1] == ']')) --z;
+    if (b < z) {
+      if (spec[b] == '-') { if (b + 1 < z) r->mute.push_back(spec.substr(b + 1, z - b - 1)); }
+      else r->only.push_back(spec.substr(b, z - b));
+    }
+    i = e + 1;
+  }
+  if (r->only.empty() && r->mute.empty()) { m_rules.store(nullptr, std::memory_order_release); return; }
+  m_rules.store(r.get(), std::memory_order_release);
+  m_retired.push_back(std::move(r));
+}
+
+bool LogFilter::Allows(uint8_t level, const char* text) const
+{
+  if (level < m_level.load(std::memory_order_relaxed)) return false;
+  const Rules* r = m_rules.load(std::memory_order_acquire);
+  if (!r || !text || text[0] != '[') return true;
+  const char* tag = text + 1;
+  auto hit = [tag](const std::vector<std::string>& list) {
+    for (const std::string& p : list) if (!strncmp(tag, p.c_str(), p.size())) return true;
+    return false;
+  };
+  if (hit(r->mute)) return false;
+  return r->only.empty() || hit(r->only);
+}
+
+// ---------------------------------------------------------------- writer
+static int64_t UnixUs()
+{
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+void LogWriter::Start(const LogWriterOptions& o)
+{
+  std::lock_guard<std::mutex> lk(m_syncMx);
+  if (m_running.load()) return;
+  uint32_t n = 64; while (n < o.ringSlots && n < (1u << 20)) n <<= 1;
+  m_slots.reset(new Slot[n]);
+  for (uint32_t i = 0; i < n; ++i) m_slots[i].seq.store(i, std::memory_order_relaxed);
+  m_mask = n - 1;
+  m_head.store(0, std::memory_order_relaxed); m_tail = 0;
+  if (m_file && o.path != m_opts.path) { fclose(m_file); m_file = nullptr; }
+  m_opts = o;
+  m_maxBytes.store(o.maxBytes, std::memory_order_relaxed);
+  m_stop.store(false);
+  m_hold.store(false, std::memory_order_release);
+  m_running.store(true, std::memory_order_release);
+  m_thread = std::thread(&LogWriter::Run, this);
+}
+
+void LogWriter::Stop()
+{
+  std::lock_guard<std::mutex> lk(m_syncMx); // producers switching to the synchronous path wait for the join
+  m_hold.store(false, std::memory_order_release);
+  if (!m_running.load()) { // never started: held lines go out now
+    if (!m_held.empty()) { WriteBatch(m_held); std::string().swap(m_held); }
+    return;
+  }
+  m_running.store(false, std::memory_order_release);
+  { std::lock_guard<std::mutex> wl(m_wakeMx); m_stop.store(true); }
+  m_wake.notify_one();
+  if (m_thread.joinable()) m_thread.join();
+  Drain(); // lines claimed by producers that saw the writer running just before the switch
+  if (m_file) { fclose(m_file); m_file = nullptr; }
+}
+
+bool LogWriter::Push(uint8_t level, const char* text, size_t len)
+{
+  if (!text) return false;
+  if (len > kLogTextMax) len = kLogTextMax;
+  const int64_t now = UnixUs();
+  if (!m_running.load(std::memory_order_acquire)) {
+    std::unique_lock<std::mutex> lk(m_syncMx);
+    if (!m_running.load(std::memory_order_acquire)) { // re-checked: Start may have won the lock
+      if (m_hold.load(std::memory_order_acquire)) {
+        if (m_held.size() + len + 64 > kHoldMaxBytes) { m_dropped.fetch_add(1, std::memory_order_relaxed); return false; }
+        AppendLine(m_held, level, now, text, len);
+        m_lines.fetch_add(1, std::memory_order_relaxed);
+        return true;
+      }
+      std::string line; AppendLine(line, level, now, text, len);
+      WriteBatch(line);
+      m_lines.fetch_add(1, std::memory_order_relaxed);
+      return true;
+    }
+  }
+  uint32_t pos = m_head.load(std::memory_order_relaxed);
+  Slot* s;
+  for (;;) {
+    s = &m_slots[pos & m_mask];
+    const int32_t dif = (int32_t)(s->seq.load(std::memory_order_acquire) - pos);
+    if (dif == 0) { if (m_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break; }
+    else if (dif < 0) { m_dropped.fetch_add(1, std::memory_order_relaxed); return false; } // full: the writer is behind
+    else pos = m_head.load(std::memory_order_relaxed);
+  }
+  s->level = level; s->len = (uint16_t)len; s->unixUs = now;
+  memcpy(s->text, text, len);
+  s->seq.store(pos + 1, std::memory_order_release);
+  if (((pos + 1) & (m_mask >> 1)) == 0) { m_kick.store(true, std::memory_order_relaxed); m_wake.notify_one(); } // every half ring: a burst need not wait for the poll
+  return true;
+}
+
+void LogWriter::AppendLine(std::string& out, uint8_t level, int64_t unixUs, const char* text, size_t len)
+{
+  const int64_t sec = unixUs / 1000000;
+  if (sec != m_stampSec) { // "YYYY-MM-DD HH:MM:SS." once per second
+    const time_t t = (time_t)sec;
+    struct tm tmv;
+#ifdef _WIN32
+    localtime_s(&tmv, &t);
+#else
+    localtime_r(&t, &tmv);
+#endif
+    const int n = snprintf(m_stamp, sizeof(m_stamp), "%04d-%02d-%02d %02d:%02d:%02d.", tmv.tm_year + 1900, tmv.tm_mon + 1,
+                           tmv.tm_mday, tmv.tm_hour, tmv.tm_min, tmv.tm_sec);
+    m_stampLen = n > 0 ? (size_t)n : 0;
+    m_stampSec = sec;
+  }
+  static const char* kLevel[] = { "DEBUG ", "", "WARN ", "ERROR ", "" };
+  const int ms = (int)((unixUs / 1000) % 1000);
+  const char ms3[4] = { (char)('0' + ms / 100), (char)('0' + ms / 10 % 10), (char)('0' + ms % 10), ' ' };
+  out.append(m_stamp, m_stampLen);
+  out.append(ms3, 4);
+  out += kLevel[level < 5 ? level : 1];
+  out.append(text, len);
+  out += '\n';
+}
+
+size_t LogWriter::Drain()
+{
+  size_t count = 0;
+  m_batch.clear();
+  if (m_slots) {
+    for (;;) {
+      Slot& s = m_slots[m_tail & m_mask];
+      if ((int32_t)(s.seq.load(std::memory_order_acquire) - (m_tail + 1)) < 0) break; // not published yet
+      AppendLine(m_batch, s.level, s.unixUs, s.text, s.len);
+      s.seq.store(m_tail + m_mask + 1, std::memory_order_release); // free for the producer one lap later
+      ++m_tail; ++count;
+    }
+  }
+  if (!count) return 0;
+  WriteBatch(m_batch);
+  m_lines.fetch_add(count, std::memory_order_relaxed);
+  ++m_batches; if (count > m_maxBatch) m_maxBatch = count;
+  return count;
+}
+
+void LogWriter::Run()
+{
+  if (!m_held.empty()) { WriteBatch(m_held); std::string().swap(m_held); } // lines kept before Start go first
+  while (!m_stop.load()) {
+    if (Drain()) continue;
+    std::unique_lock<std::mutex> lk(m_wakeMx);
+    m_wake.wait_for(lk, std::chrono::milliseconds(25), [this] { return m_stop.load() || m_kick.exchange(false); });
+  }
+  Drain();
+}
+
+void LogWriter::OpenFile()
+{
+  if (m_file || m_opts.path.empty()) return;
+  m_file = fopen(m_opts.path.c_str(), "ab");
+  if (!m_file) return;
+  fseek(m_file, 0, SEEK_END);
+  const long pos = ftell(m_file);
+  m_fileBytes = pos > 0 ? (uint64_t)pos : 0;
+}
+
+// name.ext -> name.1.ext -> ... -> name.N.ext (oldest removed)
+void LogWriter::Rotate()
+{
+  if (m_file) { fclose(m_file); m_file = nullptr; }
+  const std::string& p = m_opts.path;
+  const size_t slash = p.find_last_of("/\\"), dot = p.rfind('.');
+  const bool hasExt = dot != std::string::npos && (slash == std::string::npos || dot > slash);
+  auto numbered = [&](int i) {
+    return hasExt ? p.substr(0, dot) + "." + std::to_string(i) + p.substr(dot) : p + "." + std::to_string(i);
+  };
+  const int keep = m_opts.keepFiles > 0 ? m_opts.keepFiles : 0;
+  if (keep) {
+    remove(numbered(keep).c_str());
+    for (int i = keep - 1; i >= 1; --i) rename(numbered(i).c_str(), numbered(i + 1).c_str());
+    rename(p.c_str(), numbered(1).c_str());
+  } else {
+    remove(p.c_str());
+  }
+  ++m_rotations;
+  OpenFile();
+}
+
+void LogWriter::WriteBatch(const std::string& batch)
+{
+  const auto t0 = std::chrono::steady_clock::now();
+  if (m_opts.toStderr) {
+#ifdef _WIN32
+    OutputDebugStringA(batch.c_str());
+#else
+    fwrite(batch.data(), 1, batch.size(), stderr);
+#endif
+  }
+  if (!m_opts.path.empty()) {
+    OpenFile();
+    const uint64_t maxBytes = m_maxBytes.load(std::memory_order_relaxed);
+    size_t at = 0;
+    while (m_file && at < batch.size()) {
+      size_t n = batch.size() - at;
+      if (maxBytes && m_fileBytes + n > maxBytes) { // cut at the last whole line that still fits, then rotate
+        const size_t room = m_fileBytes < maxBytes ? (size_t)(maxBytes - m_fileBytes) : 0;
+        const size_t nl = room ? batch.rfind('\n', at + room - 1) : std::string::npos;
+        if (nl != std::string::npos && nl >= at) n = nl + 1 - at;
+        else if (m_fileBytes) { Rotate(); continue; }
+        else n = batch.find('\n', at) + 1 - at; // a single line longer than the limit
+      }
+      fwrite(batch.data() + at, 1, n, m_file);
+      m_fileBytes += n; at += n;
+      if (at < batch.size()) Rotate();
+    }
+    if (m_file) fflush(m_file); // one flush per batch: a crash loses at most the lines still in the ring
+  }
+  if (m_console.load(std::memory_order_relaxed)) {
+    std::lock_guard<std::mutex> lk(m_consoleMx);
+    if (m_consoleText.size() < (256u << 10)) m_consoleText += batch; // the console is slow: cap what waits for it
+  }
+  m_writeMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
+
+bool LogWriter::TakeConsole(std::string& out)
+{
+  std::lock_guard<std::mutex> lk(m_consoleMx);
+  if (m_consoleText.empty()) return false;
+  out.swap(m_consoleText);
+  m_consoleText.clear();
+  return true;
+}
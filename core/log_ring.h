@@ -0,0 +1,137 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// core/log_ring.h
+// Asynchronous log pipeline behind log.h. Any thread copies its formatted line into a fixed-size slot of
+// a bounded MPSC ring (per-slot sequence numbers: one CAS per line, no lock, no allocation; a full ring
+// drops the line and counts it). One writer thread drains the ring in batches, prefixes timestamps and
+// appends each batch to the log file with a single write, rotating the file by size. Level and tag
+// filters run before the caller formats anything.
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+enum LogLevel : uint8_t { kLogDebug = 0, kLogInfo = 1, kLogWarn = 2, kLogError = 3, kLogOff = 4 };
+
+static const size_t kLogTextMax = 496; // bytes of text per record (longer lines are truncated)
+
+// "debug" | "info" | "warn" | "error" | "off" or 0..4 (case-insensitive); def for anything else
+LogLevel ParseLogLevel(const char* s, LogLevel def);
+
+class LogFilter
+{
+public:
+  LogFilter();
+  void SetLevel(LogLevel l) { m_level.store((uint8_t)l, std::memory_order_relaxed); }
+  LogLevel Level() const { return (LogLevel)m_level.load(std::memory_order_relaxed); }
+  // Comma-separated tag prefixes: "Find,Focus" keeps only lines tagged [Find...] or [Focus...];
+  // "-Find,-FocusTick" keeps everything else; "" keeps all. Untagged lines only obey the level.
+  void SetTags(const std::string& spec);
+  const std::string& Tags() const { return m_spec; } // last spec set (main thread)
+  // text: the line or its format string, checked for a leading "[Tag]"
+  bool Allows(uint8_t level, const char* text) const;
+
+private:
+  struct Rules { std::vector<std::string> only, mute; };
+  std::atomic<uint8_t> m_level;
+  std::atomic<const Rules*> m_rules;
+  std::vector<std::unique_ptr<Rules>> m_retired; // rule sets stay alive: a reader may still hold one
+  std::string m_spec;
+};
+
+struct LogWriterOptions
+{
+  std::string path;               // "" = no file
+  uint64_t maxBytes = 4u << 20;   // rotate before the file would grow past this (0 = never)
+  int      keepFiles = 3;         // rotated copies: name.1.ext (newest) .. name.N.ext
+  bool     toStderr = true;       // stderr, OutputDebugString on Windows
+  uint32_t ringSlots = 4096;      // rounded up to a power of two
+};
+
+class LogWriter
+{
+public:
+  LogWriter() = default;
+  ~LogWriter() { Stop(); }
+  LogWriter(const LogWriter&) = delete;
+  LogWriter& operator=(const LogWriter&) = delete;
+
+  // Starts the writer thread (no-op if running). Lines pushed before Start or after Stop are written
+  // synchronously under a lock, so nothing is lost around the plugin's load/unload.
+  void Start(const LogWriterOptions& o);
+  void Stop(); // drains the ring, joins the thread, closes the file
+  bool Running() const { return m_running.load(std::memory_order_acquire); }
+  // While held (and not running), lines pushed are kept in memory instead of written synchronously: no file
+  // is opened on the plugin's entry path. Start writes them first from the writer thread; Stop without a
+  // Start writes them synchronously. Held lines past kHoldMaxBytes are dropped (and counted).
+  static const size_t kHoldMaxBytes = 256u << 10;
+  void Hold(bool on) { m_hold.store(on, std::memory_order_release); }
+  bool Held() const { return m_hold.load(std::memory_order_acquire); }
+
+  bool Push(uint8_t level, const char* text, size_t len); // any thread; false if dropped
+
+  // Copy of the written lines for the REAPER console (collected only while enabled; main thread takes them)
+  void SetConsole(bool on) { m_console.store(on, std::memory_order_relaxed); }
+  bool TakeConsole(std::string& out);
+
+  void SetMaxBytes(uint64_t n) { m_maxBytes.store(n, std::memory_order_relaxed); }
+
+  unsigned long long Lines() const { return m_lines.load(std::memory_order_relaxed); }
+  unsigned long long Dropped() const { return m_dropped.load(std::memory_order_relaxed); }
+  unsigned long long Batches() const { return m_batches; }
+  unsigned long long Rotations() const { return m_rotations; }
+  unsigned long long MaxBatch() const { return m_maxBatch; }
+  double WriteMs() const { return m_writeMs; }
+
+private:
+  struct Slot
+  {
+    std::atomic<uint32_t> seq;
+    uint8_t  level;
+    uint16_t len;
+    int64_t  unixUs;
+    char     text[kLogTextMax];
+  };
+
+  void Run();
+  size_t Drain();
+  void AppendLine(std::string& out, uint8_t level, int64_t unixUs, const char* text, size_t len);
+  void WriteBatch(const std::string& batch);
+  void OpenFile();
+  void Rotate();
+
+  std::unique_ptr<Slot[]> m_slots;
+  uint32_t m_mask = 0;
+  alignas(64) std::atomic<uint32_t> m_head{0}; // next slot a producer claims
+  alignas(64) uint32_t m_tail = 0;             // next slot the writer reads (writer thread only)
+
+  LogWriterOptions m_opts;
+  std::atomic<uint64_t> m_maxBytes{0};
+  std::atomic<bool> m_running{false}, m_stop{false}, m_console{false}, m_kick{false}, m_hold{false};
+  std::thread m_thread;
+  std::mutex m_wakeMx;
+  std::condition_variable m_wake;
+  std::mutex m_syncMx;         // file access outside the writer thread (before Start / after Stop)
+  std::string m_held;           // formatted lines pushed while held (under m_syncMx; the writer thread's after Start)
+  FILE* m_file = nullptr;
+  uint64_t m_fileBytes = 0;
+  std::string m_batch;
+  char m_stamp[32] = {0};      // cached date/time prefix of m_stampSec
+  size_t m_stampLen = 0;
+  int64_t m_stampSec = -1;
+  std::mutex m_consoleMx;
+  std::string m_consoleText;
+
+  std::atomic<unsigned long long> m_lines{0}, m_dropped{0};
+  unsigned long long m_batches = 0, m_rotations = 0, m_maxBatch = 0;
+  double m_writeMs = 0;
+};
@@ -0,0 +1,79 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// core/nav_options.cpp
+
+#include "core/nav_options.h"
+
+#include <string.h>
+
+static bool EqualsNoCase(const char* s, size_t len, const char* lit)
+{
+  size_t i = 0;
+  for (; i < len; ++i) {
+    char a = s[i], b = lit[i]; if (!b) return false;
+    if (a>='A' && a<='Z') a = (char)(a - 'A' + 'a');
+    if (a != b) return false;
+  }
+  return lit[i] == 0;
+}
+
+ShowPanelMode ParseShowPanel(const char* s, size_t len)
+{
+  if (!s || !len) return ShowPanelMode::Unset;
+  if (EqualsNoCase(s, len, "hide"))   return ShowPanelMode::Hide;
+  if (EqualsNoCase(s, len, "docker")) return ShowPanelMode::Docker;
+  if (EqualsNoCase(s, len, "always")) return ShowPanelMode::Always;
+  return ShowPanelMode::Unset;
+}
+
+bool ParseNavigateOptions(const char* opts, NavigateOptions& out)
+{
+  return ParseNavigateOptions(opts, opts ? strlen(opts) : 0, out);
+}
+
+bool ParseNavigateOptions(const char* opts, size_t len, NavigateOptions& out)
+{
+  out = NavigateOptions();
+  if (!opts || !len || (len == 1 && opts[0] == '0')) return true; // "no options"
+
+  JsonCursor c(opts, len);
+  if (!c.EnterObject()) return false;
+  JsonValue k, v;
+  while (c.NextKey(k)) {
+    if (JsonKeyEquals(k, "SetTitle")) {
+      if (!c.ReadValue(v)) break;
+      if (v.type == JsonType::Object || v.type == JsonType::Array) { c.SkipValue(); continue; }
+      if (v.type == JsonType::Null) continue;
+      JsonCopyString(v, out.setTitle, sizeof(out.setTitle)); out.hasSetTitle = true;
+    } else if (JsonKeyEquals(k, "InstanceId")) {
+      if (!c.ReadValue(v)) break;
+      if (v.type == JsonType::Object || v.type == JsonType::Array) { c.SkipValue(); continue; }
+      if (v.type == JsonType::Null) continue;
+      JsonCopyString(v, out.instanceId, sizeof(out.instanceId)); out.hasInstanceId = true;
+    } else if (JsonKeyEquals(k, "ShowPanel")) {
+      if (!c.ReadValue(v)) break;
+      if (v.type == JsonType::Object || v.type == JsonType::Array) { c.SkipValue(); continue; }
+      if (v.type == JsonType::String) out.showPanel = ParseShowPanel(v.ptr, v.len);
+    } else if (JsonKeyEquals(k, "BasicCtxMenu")) {
+      if (!c.ReadValue(v)) break;
+      if (v.type == JsonType::Object || v.type == JsonType::Array) { c.SkipValue(); continue; }
+      if (v.type != JsonType::Null) out.basicCtxMenu = JsonIsTruthy(v) ? 1 : 0;
+    } else if (JsonKeyEquals(k, "ContentFilter")) {
+      if (!c.ReadValue(v)) break;
+      if (v.type == JsonType::Object || v.type == JsonType::Array) { c.SkipValue(); continue; }
+      if (v.type == JsonType::Null) continue;
+      if (v.type == JsonType::String) JsonCopyString(v, out.contentFilter, sizeof(out.contentFilter));
+      else strcpy(out.contentFilter, JsonIsTruthy(v) ? "default" : "");
+      out.hasContentFilter = true;
+    } else if (JsonKeyEquals(k, "Url")) {
+      if (!c.ReadValue(v)) break;
+      if (v.type == JsonType::Object || v.type == JsonType::Array) { c.SkipValue(); continue; }
+      if (v.type == JsonType::String) out.url = v;
+    } else {
+      ++out.unknownKeys;
+      if (!c.SkipValue()) break;
+    }
+  }
+  return !c.Failed();
+}
@@ -0,0 +1,35 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// core/nav_options.h
+// Typed WEBVIEW_Navigate options filled by one pass over the opts JSON (no heap allocation).
+#pragma once
+
+#include <stddef.h>
+
+#include "core/panel_mode.h"
+#include "core/json_cursor.h"
+
+struct NavigateOptions
+{
+  // Values are unescaped UTF-8, NUL-terminated; has* tells whether the key was present at all
+  char setTitle[512]   = {0};
+  char instanceId[128] = {0};
+  bool hasSetTitle     = false;
+  bool hasInstanceId   = false;
+  ShowPanelMode showPanel = ShowPanelMode::Unset;
+  int  basicCtxMenu    = -1;    // -1 absent, 0 false, 1 true
+  char contentFilter[128] = {0}; // request filter list: true -> "default", false/"" -> "" (off), string -> list name
+  bool hasContentFilter = false;
+  int  unknownKeys     = 0;     // ignored silently (counted for logging)
+  JsonValue url;                // "Url" key (WEBVIEW_Batch ops); span into the parsed buffer, type None if absent
+};
+
+// "hide" | "docker" | "always" (case-insensitive), anything else -> Unset
+ShowPanelMode ParseShowPanel(const char* s, size_t len);
+
+// opts: JSON object text or "0"/NULL/"" for none. Keys are case-insensitive, unknown keys and nested
+// values are skipped. Returns false on malformed input; fields parsed before the error are kept.
+bool ParseNavigateOptions(const char* opts, NavigateOptions& out);
+// Same over an explicit span (e.g. an object nested inside a WEBVIEW_Batch command)
+bool ParseNavigateOptions(const char* opts, size_t len, NavigateOptions& out);
@@ -0,0 +1,215 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// core/panel_capture.cpp
+#include "panel_capture.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "WDL/lice/lice.h"
+#include "json_cursor.h"
+#include "perf_stats.h"
+
+// Wraps the capture buffer for the LICE writers (no copy)
+class CaptureBitmap : public LICE_IBitmap
+{
+public:
+  explicit CaptureBitmap(CapturePixels& p) : m_p(p) {}
+  LICE_pixel* getBits() override { return (LICE_pixel*)m_p.px.data(); }
+  int getWidth() override { return m_p.w; }
+  int getHeight() override { return m_p.h; }
+  int getRowSpan() override { return m_p.rowBytes / 4; }
+  bool resize(int, int) override { return false; }
+private:
+  CapturePixels& m_p;
+};
+
+static FILE* OpenForWrite(const std::string& path)
+{
+#ifdef _WIN32
+  WCHAR wf[2048];
+  if (MultiByteToWideChar(CP_UTF8, MB_ERR_INVALID_CHARS, path.c_str(), -1, wf, 2048)) return _wfopen(wf, L"wb");
+#endif
+  return fopen(path.c_str(), "wb");
+}
+
+bool CaptureDownsample(const CapturePixels& in, int maxWidth, CapturePixels& out)
+{
+  if (maxWidth <= 0 || in.w <= maxWidth || in.h <= 0 || in.px.empty()) return false;
+  const int ow = maxWidth;
+  int oh = (int)(((int64_t)in.h * ow + in.w / 2) / in.w); if (oh < 1) oh = 1;
+  out.w = ow; out.h = oh; out.rowBytes = ow * 4; out.premultiplied = in.premultiplied;
+  out.px.assign((size_t)out.rowBytes * oh, 0);
+  out.encoded.clear();
+  std::vector<uint32_t> acc((size_t)ow * 4);
+  for (int oy = 0; oy < oh; ++oy) {
+    const int y0 = (int)((int64_t)oy * in.h / oh), y1 = (int)((int64_t)(oy + 1) * in.h / oh);
+    std::fill(acc.begin(), acc.end(), 0u);
+    for (int y = y0; y < y1; ++y) {
+      const uint8_t* row = in.px.data() + (size_t)y * in.rowBytes;
+      for (int ox = 0; ox < ow; ++ox) {
+        const int x0 = (int)((int64_t)ox * in.w / ow), x1 = (int)((int64_t)(ox + 1) * in.w / ow);
+        uint32_t* a = &acc[(size_t)ox * 4];
+        for (const uint8_t* p = row + x0 * 4, *e = row + x1 * 4; p < e; p += 4) { a[0] += p[0]; a[1] += p[1]; a[2] += p[2]; a[3] += p[3]; }
+      }
+    }
+    uint8_t* dst = out.px.data() + (size_t)oy * out.rowBytes;
+    for (int ox = 0; ox < ow; ++ox) {
+      const int x0 = (int)((int64_t)ox * in.w / ow), x1 = (int)((int64_t)(ox + 1) * in.w / ow);
+      const uint32_t n = (uint32_t)((x1 - x0) * (y1 - y0)), half = n / 2;
+      const uint32_t* a = &acc[(size_t)ox * 4];
+      for (int c = 0; c < 4; ++c) dst[ox * 4 + c] = (uint8_t)((a[c] + half) / n);
+    }
+  }
+  return true;
+}
+
+bool CaptureWriteFile(CapturePixels& px, const std::string& path, const CaptureOptions& opt, std::string& err)
+{
+  if (px.w <= 0 || px.h <= 0 || px.rowBytes < px.w * 4 || px.px.size() < (size_t)px.rowBytes * px.h) { err = "empty snapshot"; return false; }
+  CaptureBitmap bmp(px);
+  if (opt.format == CaptureFormat::Jpg) {
+    const int q = opt.quality < 1 ? 1 : (opt.quality > 100 ? 100 : opt.quality);
+    if (!LICE_WriteJPG(path.c_str(), &bmp, q, true)) { err = "cannot write " + path; return false; }
+    return true;
+  }
+  if (opt.alpha && px.premultiplied) { // PNG stores straight alpha
+    for (int y = 0; y < px.h; ++y) {
+      uint8_t* p = px.px.data() + (size_t)y * px.rowBytes;
+      for (int x = 0; x < px.w; ++x, p += 4) {
+        const unsigned a = p[3];
+        if (a && a != 255) for (int c = 0; c < 3; ++c) { const unsigned v = (p[c] * 255u + a / 2) / a; p[c] = (uint8_t)(v > 255 ? 255 : v); }
+      }
+    }
+    px.premultiplied = false;
+  }
+  if (!LICE_WritePNG(path.c_str(), &bmp, opt.alpha)) { err = "cannot write " + path; return false; }
+  return true;
+}
+
+int PanelCapture::Begin(int parts, uint64_t nowUs)
+{
+  if (parts <= 0) return -1;
+  std::lock_guard<std::mutex> lk(m_mx);
+  int pending = 0;
+  for (const auto& kv : m_results) if (kv.second.done < kv.second.parts) ++pending;
+  if (pending >= kMaxPending) return -1;
+  if (m_nextHandle <= 0) m_nextHandle = 1;
+  while (m_results.count(m_nextHandle)) if (++m_nextHandle <= 0) m_nextHandle = 1;
+  const int h = m_nextHandle++;
+  Result& r = m_results[h];
+  r.parts = parts; r.startUs = nowUs;
+  return h;
+}
+
+void PanelCapture::Submit(int handle, const std::string& instanceId, const std::string& path, const CaptureOptions& opt, CapturePixels&& px)
+{
+  std::lock_guard<std::mutex> lk(m_mx);
+  if (!m_results.count(handle)) return;
+  m_tasks.push_back(Task{ handle, instanceId, path, opt, std::move(px) });
+  if (!m_worker.joinable()) { m_stop = false; m_worker = std::thread([this]() { Run(); }); }
+  m_cv.notify_one();
+}
+
+void PanelCapture::Fail(int handle, const std::string& instanceId, const std::string& error)
+{
+  std::string item = "{\"id\":"; JsonAppendQuoted(item, instanceId);
+  item += ",\"error\":"; JsonAppendQuoted(item, error); item += '}';
+  std::lock_guard<std::mutex> lk(m_mx);
+  Complete(handle, item, false);
+}
+
+void PanelCapture::Complete(int handle, const std::string& item, bool ok)
+{
+  auto it = m_results.find(handle);
+  if (it == m_results.end()) return;
+  Result& r = it->second;
+  if (!r.items.empty()) r.items += ',';
+  r.items += item;
+  ++r.done;
+  if (!ok) { ++r.failed; m_failed.fetch_add(1, std::memory_order_relaxed); }
+  if (r.done < r.parts) return;
+  r.finishSeq = ++m_finishSeq;
+  // keep at most kMaxKept finished results nobody read
+  size_t finished = 0; auto oldest = m_results.end();
+  for (auto i = m_results.begin(); i != m_results.end(); ++i) {
+    if (i->second.done < i->second.parts) continue;
+    ++finished;
+    if (oldest == m_results.end() || i->second.finishSeq < oldest->second.finishSeq) oldest = i;
+  }
+  if (finished > (size_t)kMaxKept && oldest != m_results.end()) m_results.erase(oldest);
+}
+
+int PanelCapture::Get(int handle, std::string& json, bool consume)
+{
+  std::lock_guard<std::mutex> lk(m_mx);
+  auto it = m_results.find(handle);
+  if (it == m_results.end()) return -4;
+  const Result& r = it->second;
+  if (r.done < r.parts) return 0;
+  json = "{\"captures\":[" + r.items + "]}";
+  const int st = r.failed ? -1 : 1;
+  if (consume) m_results.erase(it);
+  return st;
+}
+
+void PanelCapture::Run()
+{
+  for (;;) {
+    Task t;
+    {
+      std::unique_lock<std::mutex> lk(m_mx);
+      m_cv.wait(lk, [this]() { return m_stop || !m_tasks.empty(); });
+      if (m_stop) return;
+      t = std::move(m_tasks.front());
+      m_tasks.pop_front();
+    }
+    const uint64_t t0 = PerfNowUs();
+    std::string err;
+    bool ok = true;
+    CapturePixels* src = &t.px;
+    const bool passThrough = !t.px.encoded.empty() && t.opt.format == CaptureFormat::Png && t.opt.maxWidth <= 0;
+    if (passThrough) {
+      FILE* f = OpenForWrite(t.path);
+      ok = f && fwrite(t.px.encoded.data(), 1, t.px.encoded.size(), f) == t.px.encoded.size();
+      if (f && fclose(f) != 0) ok = false;
+      if (!ok) err = "cannot write " + t.path;
+    } else if (!t.px.encoded.empty()) {
+      ok = m_decode && m_decode(t.px.encoded.data(), t.px.encoded.size(), t.px);
+      if (!ok) err = "cannot decode snapshot";
+      std::vector<uint8_t>().swap(t.px.encoded);
+    }
+    CapturePixels scaled;
+    if (ok && !passThrough) {
+      if (CaptureDownsample(t.px, t.opt.maxWidth, scaled)) { std::vector<uint8_t>().swap(t.px.px); src = &scaled; }
+      ok = CaptureWriteFile(*src, t.path, t.opt, err);
+    }
+    const uint64_t t1 = PerfNowUs();
+
+    std::string item = "{\"id\":"; JsonAppendQuoted(item, t.instanceId);
+    if (ok) {
+      char num[160];
+      item += ",\"path\":"; JsonAppendQuoted(item, t.path);
+      std::lock_guard<std::mutex> lk(m_mx);
+      auto r = m_results.find(t.handle);
+      const double totalMs = r != m_results.end() ? (double)(t1 - r->second.startUs) / 1000.0 : 0.0;
+      snprintf(num, sizeof(num), ",\"w\":%d,\"h\":%d,\"ms\":%.1f,\"encodeMs\":%.1f}", src->w, src->h, totalMs, (double)(t1 - t0) / 1000.0);
+      item += num;
+      m_written.fetch_add(1, std::memory_order_relaxed);
+      m_encodeUs.fetch_add(t1 - t0, std::memory_order_relaxed);
+      Complete(t.handle, item, true);
+    } else {
+      item += ",\"error\":"; JsonAppendQuoted(item, err); item += '}';
+      std::lock_guard<std::mutex> lk(m_mx);
+      Complete(t.handle, item, false);
+    }
+  }
+}
+
+void PanelCapture::Stop()
+{
+  { std::lock_guard<std::mutex> lk(m_mx); m_stop = true; m_tasks.clear(); }
+  m_cv.notify_all();
+  if (m_worker.joinable()) m_worker.join();
+}
@@ -0,0 +1,92 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// core/panel_capture.h
+// WEBVIEW_Capture: the backends only take the snapshot (CapturePreview / takeSnapshot / WebKitGTK snapshot)
+// and copy its pixels out on the main thread; a worker thread downsamples (box filter) and encodes with the
+// vendored LICE writers (LICE_WritePNG / LICE_WriteJPG). One handle covers every panel of a request
+// ("*" = all of them); its result is a JSON list of the files written, polled without blocking.
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <stdint.h>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+enum class CaptureFormat { Png, Jpg };
+
+struct CaptureOptions
+{
+  CaptureFormat format = CaptureFormat::Png;
+  int quality = 90;     // JPEG 1..100
+  int maxWidth = 0;     // 0 = full size, otherwise downsampled keeping the aspect ratio
+  bool alpha = false;   // PNG with alpha channel (pages are usually opaque)
+};
+
+// BGRA (LICE_pixel order on little-endian), top-down. A backend that only gets an encoded image
+// (WebView2 CapturePreview writes PNG) fills `encoded` instead; the worker writes it through untouched when
+// the request asks for full-size PNG, and decodes it with the backend's decoder otherwise.
+struct CapturePixels
+{
+  std::vector<uint8_t> px;
+  int w = 0, h = 0, rowBytes = 0;
+  bool premultiplied = true;
+  std::vector<uint8_t> encoded;
+};
+
+// Decodes an encoded snapshot on the worker thread (null: encoded snapshots are only written through)
+typedef bool (*CaptureDecodeFn)(const uint8_t* data, size_t len, CapturePixels& out);
+
+// Box-filter downsample to at most maxWidth wide (never upscales); false if there is nothing to do
+bool CaptureDownsample(const CapturePixels& in, int maxWidth, CapturePixels& out);
+// Encodes px to path (un-premultiplies for alpha PNG); error text on failure
+bool CaptureWriteFile(CapturePixels& px, const std::string& path, const CaptureOptions& opt, std::string& err);
+
+class PanelCapture
+{
+public:
+  static const int kMaxPending = 16;      // handles not finished yet
+  static const int kMaxKept = 64;         // finished handles nobody read (oldest dropped first)
+
+  ~PanelCapture() { Stop(); }
+  void SetDecoder(CaptureDecodeFn fn) { m_decode = fn; }
+
+  // ---- main thread
+  // New handle expecting `parts` snapshots, or -1 with kMaxPending handles still running
+  int Begin(int parts, uint64_t nowUs);
+  // Hands one snapshot to the worker (started on first use); path is the output file
+  void Submit(int handle, const std::string& instanceId, const std::string& path, const CaptureOptions& opt, CapturePixels&& px);
+  // The backend could not take the snapshot
+  void Fail(int handle, const std::string& instanceId, const std::string& error);
+  // 0 pending, 1 every part written, -1 finished with failures, -4 unknown handle. json (when finished):
+  // {"captures":[{"id","path","w","h","ms","encodeMs"} | {"id","error"}...]}. consume releases the handle.
+  int Get(int handle, std::string& json, bool consume);
+  void Stop();
+
+  unsigned long long Written() const { return m_written.load(std::memory_order_relaxed); }
+  unsigned long long Failed() const { return m_failed.load(std::memory_order_relaxed); }
+  double AvgEncodeMs() const { const unsigned long long n = Written(); return n ? m_encodeUs.load(std::memory_order_relaxed) / 1000.0 / (double)n : 0.0; }
+
+private:
+  struct Task { int handle; std::string instanceId, path; CaptureOptions opt; CapturePixels px; };
+  struct Result { int parts = 0, done = 0, failed = 0; uint64_t startUs = 0, finishSeq = 0; std::string items; };
+
+  void Run();
+  void Complete(int handle, const std::string& item, bool ok); // under m_mx
+
+  CaptureDecodeFn m_decode = nullptr;
+  std::mutex m_mx;
+  std::condition_variable m_cv;
+  std::deque<Task> m_tasks;
+  std::unordered_map<int, Result> m_results;
+  std::thread m_worker;
+  bool m_stop = false;
+  int m_nextHandle = 1;
+  uint64_t m_finishSeq = 0;
+  std::atomic<unsigned long long> m_written{0}, m_failed{0}, m_encodeUs{0};
+};
@@ -0,0 +1,8 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// core/panel_mode.h
+// ShowPanel option values (shared by API parsing, title policy and persistence)
+#pragma once
+
+enum class ShowPanelMode { Unset, Hide, Docker, Always };
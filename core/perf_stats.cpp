@@ -0,0 +1,139 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// core/perf_stats.cpp
+#include "perf_stats.h"
+
+#include <chrono>
+#include <stdio.h>
+
+uint64_t PerfNowUs()
+{
+  return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static double UsToMs(uint64_t us) { return (double)us / 1000.0; }
+
+// ---------------------------------------------------------------- LatencyHistogram
+
+void LatencyHistogram::Add(double ms)
+{
+  if (ms < 0) ms = 0;
+  int b = 0;
+  while (b < kBuckets - 1 && ms >= BucketUpperMs(b)) ++b;
+  ++m_buckets[b]; ++m_count;
+  m_sumMs += ms; m_lastMs = ms;
+  if (ms > m_maxMs) m_maxMs = ms;
+}
+
+double LatencyHistogram::PercentileMs(double p) const
+{
+  if (!m_count) return 0.0;
+  if (p < 0) p = 0; else if (p > 1) p = 1;
+  unsigned long long rank = (unsigned long long)(p * (double)m_count + 0.999999);
+  if (rank < 1) rank = 1;
+  unsigned long long seen = 0;
+  for (int i = 0; i < kBuckets; ++i) {
+    seen += m_buckets[i];
+    if (seen >= rank) { const double up = BucketUpperMs(i); return up < m_maxMs ? up : m_maxMs; }
+  }
+  return m_maxMs;
+}
+
+void LatencyHistogram::AppendJson(std::string& out) const
+{
+  char buf[192];
+  snprintf(buf, sizeof(buf), "{\"count\":%llu,\"avgMs\":%.1f,\"p50Ms\":%.1f,\"p95Ms\":%.1f,\"maxMs\":%.1f,\"lastMs\":%.1f,\"buckets\":[",
+           m_count, AvgMs(), PercentileMs(0.5), PercentileMs(0.95), m_maxMs, m_lastMs);
+  out += buf;
+  for (int i = 0; i < kBuckets; ++i) { snprintf(buf, sizeof(buf), i ? ",%llu" : "%llu", m_buckets[i]); out += buf; }
+  out += "]}";
+}
+
+// ---------------------------------------------------------------- InstanceStats
+
+void InstanceStats::CreateStarted(uint64_t nowUs)
+{
+  if (!m_bornUs) m_bornUs = nowUs;
+  m_createStartUs = nowUs;
+  m_firstLoadPending = true;
+  m_navStartUs = 0; // a navigation of the previous browser never completes
+  ++m_creates;
+}
+
+void InstanceStats::ViewCreated(uint64_t nowUs)
+{
+  if (m_createStartUs && nowUs >= m_createStartUs) m_createMs = UsToMs(nowUs - m_createStartUs);
+}
+
+void InstanceStats::NavStarted(uint64_t nowUs)
+{
+  if (m_navStartUs && nowUs - m_navStartUs < 60000000ull) return;
+  m_navStartUs = nowUs ? nowUs : 1;
+  ++m_navStarted;
+}
+
+void InstanceStats::NavFinished(uint64_t nowUs, bool ok)
+{
+  if (ok && m_firstLoadPending && m_createStartUs && nowUs >= m_createStartUs) {
+    m_firstLoadMs = UsToMs(nowUs - m_createStartUs);
+    m_firstLoadPending = false;
+  }
+  if (!m_navStartUs) return; // completion without a start we saw (e.g. history navigation on WebKit)
+  if (ok) m_nav.Add(nowUs >= m_navStartUs ? UsToMs(nowUs - m_navStartUs) : 0.0);
+  else ++m_navFailed;
+  m_navStartUs = 0;
+}
+
+void InstanceStats::FindCounted(uint64_t nowUs, int matches)
+{
+  m_findMatches = matches > 0 ? matches : 0;
+  if (!m_findStartUs) return; // current-match updates after the rebuild
+  m_find.Add(nowUs >= m_findStartUs ? nowUs - m_findStartUs : 0);
+  m_findStartUs = 0;
+}
+
+void InstanceStats::AppendJson(std::string& out, uint64_t nowUs) const
+{
+  char buf[512];
+  snprintf(buf, sizeof(buf), "{\"createMs\":%.1f,\"firstLoadMs\":%.1f,\"creates\":%d,\"uptimeSec\":%.1f,\"nav\":",
+           m_createMs, m_firstLoadMs, m_creates, (m_bornUs && nowUs > m_bornUs) ? (double)(nowUs - m_bornUs) / 1e6 : 0.0);
+  out += buf;
+  m_nav.AppendJson(out);
+  out.pop_back(); // reopen the histogram object for the start/fail counters
+  snprintf(buf, sizeof(buf), ",\"started\":%llu,\"failed\":%llu,\"pending\":%s},"
+           "\"title\":{\"count\":%llu,\"avgUs\":%.1f,\"maxUs\":%llu,\"lastUs\":%llu},"
+           "\"find\":{\"rebuilds\":%llu,\"avgMs\":%.2f,\"maxMs\":%.2f,\"lastMs\":%.2f,\"matches\":%d},"
+           "\"bridge\":{\"msgsIn\":%llu,\"bytesIn\":%llu,\"msgsOut\":%llu,\"bytesOut\":%llu}}",
+           m_navStarted, m_navFailed, m_navStartUs ? "true" : "false",
+           m_title.count, m_title.AvgUs(), (unsigned long long)m_title.maxUs, (unsigned long long)m_title.lastUs,
+           m_find.count, m_find.AvgUs() / 1000.0, UsToMs(m_find.maxUs), UsToMs(m_find.lastUs), m_findMatches,
+           m_msgsIn, m_bytesIn, m_msgsOut, m_bytesOut);
+  out += buf;
+}
+
+const char* InstanceStats::CsvHeader()
+{
+  return "time,id,creates,createMs,firstLoadMs,uptimeSec,navCount,navFailed,navAvgMs,navP50Ms,navP95Ms,navMaxMs,"
+         "titleCount,titleAvgUs,titleMaxUs,findRebuilds,findAvgMs,findMaxMs,findMatches,msgsIn,bytesIn,msgsOut,bytesOut";
+}
+
+void InstanceStats::AppendCsv(std::string& out, const std::string& id, long long unixSec, uint64_t nowUs) const
+{
+  char buf[512];
+  snprintf(buf, sizeof(buf), "%lld,", unixSec);
+  out += buf;
+  if (id.find_first_of(",\"\r\n") == std::string::npos) out += id;
+  else {
+    out += '"';
+    for (char c : id) { if (c == '"') out += '"'; out += c; }
+    out += '"';
+  }
+  snprintf(buf, sizeof(buf), ",%d,%.1f,%.1f,%.1f,%llu,%llu,%.1f,%.1f,%.1f,%.1f,%llu,%.1f,%llu,%llu,%.2f,%.2f,%d,%llu,%llu,%llu,%llu",
+           m_creates, m_createMs, m_firstLoadMs, (m_bornUs && nowUs > m_bornUs) ? (double)(nowUs - m_bornUs) / 1e6 : 0.0,
+           m_nav.Count(), m_navFailed, m_nav.AvgMs(), m_nav.PercentileMs(0.5), m_nav.PercentileMs(0.95), m_nav.MaxMs(),
+           m_title.count, m_title.AvgUs(), (unsigned long long)m_title.maxUs,
+           m_find.count, m_find.AvgUs() / 1000.0, UsToMs(m_find.maxUs), m_findMatches,
+           m_msgsIn, m_bytesIn, m_msgsOut, m_bytesOut);
+  out += buf;
+}
@@ -0,0 +1,102 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// core/perf_stats.h
+// Per-instance performance counters (WebViewInstanceRecord::stats): navigation latency histogram, title
+// refresh cost, find rebuild time and match count, page bridge traffic and creation time. Recording is a
+// handful of integer updates on the main thread; WEBVIEW_GetStats reads them as JSON, WEBVIEW_DumpStats as
+// CSV rows. Timestamps are PerfNowUs() (steady clock, microseconds).
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+uint64_t PerfNowUs();
+
+// Log2 buckets in milliseconds: bucket 0 holds < 1 ms, bucket i holds [2^(i-1), 2^i) ms, the last one
+// everything from 2^(kBuckets-2) ms up
+class LatencyHistogram
+{
+public:
+  static const int kBuckets = 16;
+
+  void Add(double ms);
+  unsigned long long Count() const { return m_count; }
+  double AvgMs() const { return m_count ? m_sumMs / (double)m_count : 0.0; }
+  double MaxMs() const { return m_maxMs; }
+  double LastMs() const { return m_lastMs; }
+  // Upper edge of the bucket holding the p-th sample (p in 0..1), capped at the maximum seen
+  double PercentileMs(double p) const;
+  unsigned long long Bucket(int i) const { return (i >= 0 && i < kBuckets) ? m_buckets[i] : 0; }
+  static double BucketUpperMs(int i) { return i < kBuckets - 1 ? (double)(1ull << i) : 1e300; }
+
+  void AppendJson(std::string& out) const; // {"count":..,"avgMs":..,"p50Ms":..,"p95Ms":..,"maxMs":..,"lastMs":..,"buckets":[..]}
+
+private:
+  unsigned long long m_buckets[kBuckets] = {};
+  unsigned long long m_count = 0;
+  double m_sumMs = 0, m_maxMs = 0, m_lastMs = 0;
+};
+
+struct DurationStat
+{
+  unsigned long long count = 0;
+  uint64_t totalUs = 0, maxUs = 0, lastUs = 0;
+  void Add(uint64_t us) { ++count; totalUs += us; lastUs = us; if (us > maxUs) maxUs = us; }
+  double AvgUs() const { return count ? (double)totalUs / (double)count : 0.0; }
+};
+
+class InstanceStats
+{
+public:
+  // Browser lifetime: StartWebView called, view attached to the host, first page loaded after that
+  void CreateStarted(uint64_t nowUs);
+  void ViewCreated(uint64_t nowUs);
+
+  // A redirect or a second start while one is pending keeps the first start (latency as the user sees it);
+  // a start pending for more than a minute is treated as lost
+  void NavStarted(uint64_t nowUs);
+  void NavFinished(uint64_t nowUs, bool ok);
+
+  void TitleRefreshed(uint64_t us) { m_title.Add(us); }
+
+  // Query (re)started; the next reported match count closes the rebuild
+  void FindStarted(uint64_t nowUs) { m_findStartUs = nowUs ? nowUs : 1; }
+  void FindCounted(uint64_t nowUs, int matches);
+
+  void BridgeIn(size_t bytes) { ++m_msgsIn; m_bytesIn += bytes; }
+  void BridgeOut(size_t bytes) { ++m_msgsOut; m_bytesOut += bytes; }
+
+  const LatencyHistogram& Nav() const { return m_nav; }
+  unsigned long long NavFailed() const { return m_navFailed; }
+  const DurationStat& Title() const { return m_title; }
+  const DurationStat& Find() const { return m_find; }
+  int  FindMatches() const { return m_findMatches; }
+  unsigned long long MsgsIn() const { return m_msgsIn; }
+  unsigned long long MsgsOut() const { return m_msgsOut; }
+  unsigned long long BytesIn() const { return m_bytesIn; }
+  unsigned long long BytesOut() const { return m_bytesOut; }
+  double CreateMs() const { return m_createMs; }       // -1 until the view exists
+  double FirstLoadMs() const { return m_firstLoadMs; } // -1 until the first page loaded
+  int  Creates() const { return m_creates; }
+
+  // {"createMs":..,"firstLoadMs":..,"creates":..,"uptimeSec":..,"nav":{..},"title":{..},"find":{..},"bridge":{..}}
+  void AppendJson(std::string& out, uint64_t nowUs) const;
+  // One CSV row (no newline); columns as in CsvHeader. Fields are quoted only where needed.
+  static const char* CsvHeader();
+  void AppendCsv(std::string& out, const std::string& id, long long unixSec, uint64_t nowUs) const;
+
+private:
+  LatencyHistogram m_nav;
+  unsigned long long m_navStarted = 0, m_navFailed = 0;
+  uint64_t m_navStartUs = 0;   // 0 = none pending
+  DurationStat m_title, m_find;
+  uint64_t m_findStartUs = 0;
+  int m_findMatches = 0;
+  unsigned long long m_msgsIn = 0, m_msgsOut = 0, m_bytesIn = 0, m_bytesOut = 0;
+  uint64_t m_bornUs = 0, m_createStartUs = 0;
+  double m_createMs = -1, m_firstLoadMs = -1;
+  bool m_firstLoadPending = false;
+  int m_creates = 0;
+};
@@ -0,0 +1,23 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// core/refresh_scheduler.cpp
+
+#include "core/refresh_scheduler.h"
+
+bool RefreshScheduler::Request(void* key)
+{
+  ++m_requested;
+  if (!key) return false;
+  if (!m_dirty.insert(key).second) { ++m_coalesced; return false; }
+  m_queue.push_back(key);
+  return true;
+}
+
+bool RefreshScheduler::Cancel(void* key, bool countAsExecuted)
+{
+  if (!m_dirty.erase(key)) return false;
+  if (countAsExecuted) ++m_executed;
+  // the stale queue slot is skipped by Flush (m_dirty no longer holds it)
+  return true;
+}
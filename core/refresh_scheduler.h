@@ -0,0 +1,54 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// core/refresh_scheduler.h
+// Per-key dirty-flag queue: bursts of Request(key) between two Flush() calls collapse into one
+// execution per key. Keys are opaque (host HWND in the plugin). Main-thread only, no locking.
+#pragma once
+
+#include <stddef.h>
+#include <unordered_set>
+#include <vector>
+
+class RefreshScheduler
+{
+public:
+  // Marks key dirty. Returns true when newly queued, false when folded into an already pending request.
+  bool Request(void* key);
+  // Drops a pending request (window destroyed, or refreshed synchronously meanwhile).
+  // countAsExecuted: the caller performed the refresh itself, so the request is accounted as served.
+  bool Cancel(void* key, bool countAsExecuted = false);
+  bool Pending(void* key) const { return m_dirty.count(key) != 0; }
+  size_t PendingCount() const { return m_dirty.size(); }
+
+  // Runs fn(key) once per dirty key in first-request order. Keys re-requested from inside fn are
+  // queued for the next Flush (no unbounded loops when a refresh triggers another title change).
+  template <class Fn>
+  size_t Flush(Fn fn)
+  {
+    if (m_queue.empty()) return 0;
+    m_flushing.swap(m_queue); // m_queue is now empty and collects re-requests
+    size_t n = 0;
+    for (void* key : m_flushing) {
+      if (!m_dirty.erase(key)) continue; // cancelled meanwhile
+      ++m_executed; ++n;
+      fn(key);
+      // re-requested from inside fn while it was not marked dirty -> stays queued for next Flush
+    }
+    m_flushing.clear();
+    ++m_flushes;
+    return n;
+  }
+
+  unsigned long long Requested() const { return m_requested; }  // every Request() call
+  unsigned long long Executed()  const { return m_executed; }   // refreshes actually run (Flush + synchronous)
+  unsigned long long Coalesced() const { return m_coalesced; }  // requests folded into a pending one
+  unsigned long long Flushes()   const { return m_flushes; }    // non-empty Flush() passes
+  void ResetCounters() { m_requested = m_executed = m_coalesced = m_flushes = 0; }
+
+private:
+  std::vector<void*> m_queue;     // first-request order
+  std::vector<void*> m_flushing;  // batch being executed
+  std::unordered_set<void*> m_dirty;
+  unsigned long long m_requested = 0, m_executed = 0, m_coalesced = 0, m_flushes = 0;
+};
@@ -0,0 +1,188 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// core/script_queue.cpp
+#include "script_queue.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "json_cursor.h"
+
+static uint32_t Clamp(uint32_t v, uint32_t def, uint32_t hi) { return v == 0 ? def : (v > hi ? hi : v); }
+
+int ScriptQueue::Enqueue(const std::string& instanceId, const std::string& js, ScriptLimits limits, uint64_t nowMs)
+{
+  Lane& lane = m_lanes[instanceId];
+  if (lane.outstanding >= kMaxOutstanding) return -1;
+  limits.timeoutMs = Clamp(limits.timeoutMs, ScriptLimits().timeoutMs, kMaxTimeoutMs);
+  limits.maxResultBytes = Clamp(limits.maxResultBytes, ScriptLimits().maxResultBytes, kMaxResultBytes);
+  if (m_nextHandle <= 0) m_nextHandle = 1;
+  while (m_jobs.count(m_nextHandle)) if (++m_nextHandle <= 0) m_nextHandle = 1;
+  const int h = m_nextHandle++;
+  Job& j = m_jobs[h];
+  j.instanceId = instanceId; j.js = js; j.limits = limits;
+  j.deadlineMs = nowMs + limits.timeoutMs;
+  lane.queued.push_back(h);
+  ++lane.outstanding; ++m_enqueued;
+  return h;
+}
+
+void ScriptQueue::ReadyInstances(std::vector<std::string>& out) const
+{
+  out.clear();
+  for (const auto& kv : m_lanes) if (!kv.second.queued.empty() && !kv.second.inflightSeq) out.push_back(kv.first);
+}
+
+bool ScriptQueue::BuildBatch(const std::string& instanceId, uint64_t, std::string& js)
+{
+  auto it = m_lanes.find(instanceId);
+  if (it == m_lanes.end() || it->second.inflightSeq || it->second.queued.empty()) return false;
+  Lane& lane = it->second;
+  js.assign("(function(){var R=[],s,v;");
+  char num[48];
+  for (int h : lane.queued) {
+    auto j = m_jobs.find(h);
+    if (j == m_jobs.end() || j->second.state != ScriptState::Pending) continue; // timed out while queued
+    js += "try{v=(0,eval)(";
+    JsonAppendQuoted(js, j->second.js);
+    snprintf(num, sizeof(num), "%u", j->second.limits.maxResultBytes);
+    js += ");s=JSON.stringify(v);if(s===undefined)s='null';R.push(s.length>"; js += num;
+    js += "?[2,s.length]:[1,s]);}catch(e){R.push([0,String(e&&e.message!==undefined?e.message:e)]);}";
+    lane.inflight.push_back(h);
+  }
+  lane.queued.clear();
+  if (lane.inflight.empty()) return false;
+  if (!m_nextSeq) m_nextSeq = 1;
+  lane.inflightSeq = m_nextSeq++;
+  snprintf(num, sizeof(num), "%u", lane.inflightSeq);
+  js += "return JSON.stringify({b:"; js += num; js += ",r:R});})()";
+  ++m_batches;
+  if (lane.inflight.size() > m_maxBatch) m_maxBatch = lane.inflight.size();
+  return true;
+}
+
+void ScriptQueue::Finish(Job& j, ScriptState st, std::string text, uint64_t nowMs)
+{
+  j.state = st; j.result = std::move(text); j.finishedMs = nowMs;
+  std::string().swap(j.js);
+  if (st == ScriptState::Timeout) ++m_timeouts;
+  else if (st == ScriptState::TooLarge) ++m_tooLarge;
+}
+
+static long ReadInt(const JsonValue& v)
+{
+  if (v.type != JsonType::Number || v.len >= 32) return -1;
+  char buf[32]; memcpy(buf, v.ptr, v.len); buf[v.len] = 0;
+  return strtol(buf, nullptr, 10);
+}
+
+static std::string ReadString(const JsonValue& v)
+{
+  if (v.type != JsonType::String) return std::string();
+  std::string s(v.len + 1, '\0');
+  s.resize(JsonCopyString(v, &s[0], s.size()));
+  return s;
+}
+
+void ScriptQueue::OnBatchResult(const std::string& instanceId, const std::string& result, uint64_t nowMs)
+{
+  auto it = m_lanes.find(instanceId);
+  if (it == m_lanes.end() || !it->second.inflightSeq) { ++m_late; return; }
+  Lane& lane = it->second;
+
+  JsonCursor c(result.data(), result.size());
+  JsonValue k, v;
+  long seq = -1;
+  bool haveResults = false;
+  size_t i = 0;
+  if (!result.empty() && c.EnterObject()) {
+    while (c.NextKey(k)) {
+      if (JsonKeyEquals(k, "b") && c.ReadValue(v)) { seq = ReadInt(v); continue; }
+      if (!JsonKeyEquals(k, "r") || seq != (long)lane.inflightSeq || !c.EnterArray()) { c.SkipValue(); continue; }
+      haveResults = true;
+      while (c.NextElement()) {
+        JsonValue e, t, val; long type = -1; std::string text;
+        if (!c.ReadValue(e)) break;
+        if (e.type == JsonType::Object) c.SkipValue();
+        else if (e.type == JsonType::Array && c.EnterArray()) { // [type, value]
+          for (int n = 0; c.NextElement(); ++n) {
+            JsonValue& dst = n == 0 ? t : val;
+            if (n > 1 || !c.ReadValue(dst)) { c.SkipValue(); continue; }
+            if (dst.type == JsonType::Object || dst.type == JsonType::Array) c.SkipValue();
+          }
+          type = ReadInt(t);
+          if (val.type == JsonType::String) text = ReadString(val);
+        }
+        if (c.Failed()) break;
+        auto j = i < lane.inflight.size() ? m_jobs.find(lane.inflight[i]) : m_jobs.end();
+        ++i;
+        if (j == m_jobs.end() || j->second.state != ScriptState::Pending) continue;
+        if (type == 1 && text.size() <= j->second.limits.maxResultBytes) Finish(j->second, ScriptState::Done, std::move(text), nowMs);
+        else if (type == 1 || type == 2) Finish(j->second, ScriptState::TooLarge, "result exceeds " + std::to_string(j->second.limits.maxResultBytes) + " bytes", nowMs);
+        else Finish(j->second, ScriptState::Error, text.empty() ? std::string("script error") : std::move(text), nowMs);
+      }
+    }
+  }
+  if (seq >= 0 && seq != (long)lane.inflightSeq) { ++m_late; return; } // answer of an abandoned batch
+  for (int h : lane.inflight) {
+    auto j = m_jobs.find(h);
+    if (j != m_jobs.end() && j->second.state == ScriptState::Pending)
+      Finish(j->second, ScriptState::Error, haveResults ? "no result" : "evaluation failed", nowMs);
+  }
+  lane.inflight.clear();
+  lane.inflightSeq = 0;
+}
+
+void ScriptQueue::Expire(uint64_t nowMs)
+{
+  for (auto it = m_jobs.begin(); it != m_jobs.end();) {
+    Job& j = it->second;
+    if (j.state == ScriptState::Pending && nowMs >= j.deadlineMs) Finish(j, ScriptState::Timeout, "timed out", nowMs);
+    if (j.state != ScriptState::Pending && nowMs - j.finishedMs >= kUnreadKeepMs) {
+      auto l = m_lanes.find(j.instanceId);
+      if (l != m_lanes.end() && l->second.outstanding) --l->second.outstanding;
+      it = m_jobs.erase(it);
+      continue;
+    }
+    ++it;
+  }
+  for (auto l = m_lanes.begin(); l != m_lanes.end();) {
+    Lane& lane = l->second;
+    if (lane.inflightSeq) { // abandon a batch once none of its scripts waits for it
+      bool waiting = false;
+      for (int h : lane.inflight) { auto j = m_jobs.find(h); if (j != m_jobs.end() && j->second.state == ScriptState::Pending) { waiting = true; break; } }
+      if (!waiting) { lane.inflight.clear(); lane.inflightSeq = 0; }
+    }
+    if (!lane.outstanding && lane.queued.empty() && !lane.inflightSeq) l = m_lanes.erase(l);
+    else ++l;
+  }
+}
+
+void ScriptQueue::DropInstance(const std::string& instanceId, uint64_t nowMs)
+{
+  auto l = m_lanes.find(instanceId);
+  if (l == m_lanes.end()) return;
+  for (auto& kv : m_jobs)
+    if (kv.second.instanceId == instanceId && kv.second.state == ScriptState::Pending)
+      Finish(kv.second, ScriptState::Error, "instance closed", nowMs);
+  l->second.queued.clear();
+  l->second.inflight.clear();
+  l->second.inflightSeq = 0;
+}
+
+ScriptState ScriptQueue::Get(int handle, std::string& out, bool consume)
+{
+  auto it = m_jobs.find(handle);
+  if (it == m_jobs.end()) return ScriptState::Unknown;
+  const ScriptState st = it->second.state;
+  if (st == ScriptState::Pending) return st;
+  out = it->second.result;
+  if (consume) {
+    auto l = m_lanes.find(it->second.instanceId);
+    if (l != m_lanes.end() && l->second.outstanding) --l->second.outstanding;
+    m_jobs.erase(it);
+  }
+  return st;
+}
@@ -0,0 +1,88 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// core/script_queue.h
+// WEBVIEW_ExecuteScript: scripts are queued per instance and answered through integer handles. Once per
+// timer tick every instance with queued scripts and no batch in flight gets all of them as one page script
+// (one evaluate round trip); each snippet runs in its own try/catch through indirect eval, its value is
+// JSON.stringify'd and checked against its size limit in the page, and the batch answers
+//
+//   {"b":batchSeq,"r":[[1,"<json>"],[0,"error text"],[2,byteLength]]}     1 ok, 0 threw, 2 result too large
+//
+// Timeouts run from Enqueue (queue wait included); a late answer for a timed-out batch is dropped.
+// Finished results are kept until read (Get with consume) or kUnreadKeepMs. Main thread only.
+#pragma once
+
+#include <deque>
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+enum class ScriptState : int { Pending = 0, Done = 1, Error = -1, Timeout = -2, TooLarge = -3, Unknown = -4 };
+
+struct ScriptLimits
+{
+  uint32_t timeoutMs = 5000;
+  uint32_t maxResultBytes = 1u << 20;
+};
+
+class ScriptQueue
+{
+public:
+  static const uint32_t kMaxTimeoutMs = 10u * 60u * 1000u;
+  static const uint32_t kMaxResultBytes = 64u << 20;
+  static const size_t   kMaxOutstanding = 256;      // per instance: queued + in flight + unread
+  static const uint64_t kUnreadKeepMs = 60000;
+
+  // Handle > 0, or -1 when the instance already has kMaxOutstanding scripts (limits are clamped)
+  int Enqueue(const std::string& instanceId, const std::string& js, ScriptLimits limits, uint64_t nowMs);
+
+  // Instances that have queued scripts and nothing in flight (candidates for BuildBatch)
+  void ReadyInstances(std::vector<std::string>& out) const;
+  // Moves every queued script of the instance into one batch; false if none queued or a batch is in flight
+  bool BuildBatch(const std::string& instanceId, uint64_t nowMs, std::string& js);
+  // Page answer of the instance's batch ("" = the evaluation failed, e.g. the page navigated away)
+  void OnBatchResult(const std::string& instanceId, const std::string& result, uint64_t nowMs);
+  // Times out expired scripts (an in-flight batch is abandoned once all of its scripts expired) and drops
+  // results nobody read
+  void Expire(uint64_t nowMs);
+  // Instance closed: its scripts finish as errors
+  void DropInstance(const std::string& instanceId, uint64_t nowMs);
+
+  // State of the handle; Done/Error copy the result/error text into out. consume releases a finished handle.
+  ScriptState Get(int handle, std::string& out, bool consume);
+
+  size_t Outstanding() const { return m_jobs.size(); }
+  unsigned long long Enqueued() const { return m_enqueued; }
+  unsigned long long Batches() const { return m_batches; }
+  unsigned long long MaxBatch() const { return m_maxBatch; }
+  unsigned long long Timeouts() const { return m_timeouts; }
+  unsigned long long TooLarge() const { return m_tooLarge; }
+  unsigned long long LateAnswers() const { return m_late; }
+
+private:
+  struct Job
+  {
+    std::string instanceId, js, result;
+    ScriptLimits limits;
+    ScriptState state = ScriptState::Pending;
+    uint64_t deadlineMs = 0, finishedMs = 0;
+  };
+  struct Lane
+  {
+    std::deque<int> queued;
+    std::vector<int> inflight;
+    uint32_t inflightSeq = 0;  // 0 = nothing in flight
+    size_t outstanding = 0;
+  };
+
+  void Finish(Job& j, ScriptState st, std::string text, uint64_t nowMs);
+
+  std::unordered_map<int, Job> m_jobs;
+  std::unordered_map<std::string, Lane> m_lanes;
+  int m_nextHandle = 1;
+  uint32_t m_nextSeq = 1;
+  unsigned long long m_enqueued = 0, m_batches = 0, m_maxBatch = 0, m_timeouts = 0, m_tooLarge = 0, m_late = 0;
+};
@@ -0,0 +1,100 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// core/shared_buffer.cpp
+
+#include "core/shared_buffer.h"
+
+#include <atomic>
+#include <stdio.h>
+#include <string.h>
+
+static inline volatile uint32_t* Hdr(uint8_t* mem) { return (volatile uint32_t*)mem; }
+
+void SharedBufferSlot::AllocHeap(uint32_t capacity)
+{
+  const uint32_t seq = Seq(), count = Count();
+  const size_t keep = mem ? BytesFor(count < capacity ? count : capacity) : 0;
+  std::vector<uint8_t> fresh(BytesFor(capacity), 0);
+  if (keep) memcpy(fresh.data(), mem, keep);
+  heap.swap(fresh);
+  mem = heap.data(); native = nullptr; mapped = false; attached = false;
+  Hdr(mem)[0] = seq & ~1u; Hdr(mem)[1] = count < capacity ? count : capacity; Hdr(mem)[2] = capacity; Hdr(mem)[3] = 0;
+}
+
+void SharedBufferSlot::AdoptMapped(uint8_t* memory, uint32_t capacity, void* handle)
+{
+  const uint32_t seq = Seq();
+  memset(memory, 0, kSharedBufferHeaderBytes);
+  Hdr(memory)[0] = seq & ~1u; Hdr(memory)[2] = capacity;
+  heap.clear(); heap.shrink_to_fit();
+  mem = memory; native = handle; mapped = true; attached = false;
+}
+
+float* SharedBufferSlot::BeginWrite()
+{
+  if (!mem) return nullptr;
+  if (!writing) {
+    Hdr(mem)[0] = Hdr(mem)[0] | 1u; // odd: readers skip this version
+    std::atomic_thread_fence(std::memory_order_release);
+    writing = true;
+  }
+  return Data();
+}
+
+void SharedBufferSlot::EndWrite(uint32_t count)
+{
+  if (!mem) return;
+  if (!writing) BeginWrite();
+  const uint32_t cap = Hdr(mem)[2];
+  Hdr(mem)[1] = count < cap ? count : cap;
+  std::atomic_thread_fence(std::memory_order_release);
+  Hdr(mem)[0] = (Hdr(mem)[0] | 1u) + 1u; // next even value
+  writing = false;
+  if (dirty) ++superseded; // the page never saw the previous version
+  dirty = true;
+  ++writes;
+}
+
+bool IsValidSharedBufferName(const char* name)
+{
+  if (!name || !*name) return false;
+  size_t n = 0;
+  for (const char* p = name; *p; ++p, ++n) {
+    const char c = *p;
+    if (n >= 64) return false;
+    if (!((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' || c == '.' || c == '-')) return false;
+  }
+  return true;
+}
+
+void Base64Append(const void* data, size_t n, std::string& out)
+{
+  static const char kAlphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  const uint8_t* s = (const uint8_t*)data;
+  const size_t at = out.size();
+  out.resize(at + (n + 2) / 3 * 4);
+  char* d = &out[at];
+  size_t i = 0;
+  for (; i + 3 <= n; i += 3, d += 4) {
+    const uint32_t v = (uint32_t)s[i] << 16 | (uint32_t)s[i + 1] << 8 | s[i + 2];
+    d[0] = kAlphabet[v >> 18]; d[1] = kAlphabet[(v >> 12) & 63]; d[2] = kAlphabet[(v >> 6) & 63]; d[3] = kAlphabet[v & 63];
+  }
+  if (i < n) {
+    const uint32_t v = (uint32_t)s[i] << 16 | (i + 1 < n ? (uint32_t)s[i + 1] << 8 : 0u);
+    d[0] = kAlphabet[v >> 18]; d[1] = kAlphabet[(v >> 12) & 63];
+    d[2] = i + 1 < n ? kAlphabet[(v >> 6) & 63] : '='; d[3] = '=';
+  }
+}
+
+std::string SharedBufferPutScript(const SharedBufferSlot& slot)
+{
+  const uint32_t count = slot.Count();
+  std::string js; js.reserve(96 + slot.name.size() + ((size_t)count * 4 + 2) / 3 * 4);
+  char head[64];
+  js = "window.__rwvBuffers&&window.__rwvBuffers._put(\""; js += slot.name;
+  snprintf(head, sizeof(head), "\",%u,%u,\"", slot.Seq(), count); js += head;
+  if (slot.mem) Base64Append(slot.mem + kSharedBufferHeaderBytes, (size_t)count * sizeof(float), js);
+  js += "\")";
+  return js;
+}
@@ -0,0 +1,63 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// core/shared_buffer.h
+// Named float32 buffers shared between native code and one page (WEBVIEW_SharedBuffer* API).
+// Memory layout, identical on both sides:
+//
+//   uint32 seq       odd while native code is writing, even when stable (seqlock)
+//   uint32 count     valid floats
+//   uint32 capacity  floats the data area can hold
+//   uint32 reserved
+//   float  data[capacity]
+//
+// Where the engine can map memory into the page (WebView2 shared buffers) the page reads `data` in place
+// and is only told that seq changed. Elsewhere the slot owns heap memory and each publish ships
+// count floats base64-encoded into a typed array the page reuses. Only the latest write is published:
+// writes between two publishes are counted as superseded. Main-thread only.
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+static const size_t kSharedBufferHeaderBytes = 16;
+
+struct SharedBufferSlot
+{
+  std::string name;
+  uint8_t* mem = nullptr;          // header + data; backend memory when mapped, heap.data() otherwise
+  std::vector<uint8_t> heap;
+  void*    native = nullptr;       // backend handle (ICoreWebView2SharedBuffer*)
+  bool     mapped = false;         // page reads mem directly
+  bool     attached = false;       // page holds the current mapping (re-sent after reload/resize)
+  bool     dirty = false;          // committed since the last publish
+  bool     writing = false;        // between Lock and Commit
+
+  unsigned long long writes = 0, publishes = 0, superseded = 0, bytesShipped = 0;
+
+  uint32_t Capacity() const { return mem ? Header()[2] : 0; }
+  uint32_t Count() const { return mem ? Header()[1] : 0; }
+  uint32_t Seq() const { return mem ? Header()[0] : 0; }
+  float*   Data() { return mem ? (float*)(mem + kSharedBufferHeaderBytes) : nullptr; }
+  const uint32_t* Header() const { return (const uint32_t*)mem; }
+
+  static size_t BytesFor(uint32_t capacity) { return kSharedBufferHeaderBytes + (size_t)capacity * sizeof(float); }
+  // Heap-backed storage (no mapping); keeps seq and contents when growing
+  void AllocHeap(uint32_t capacity);
+  // Adopts fresh backend memory of BytesFor(capacity) bytes, carrying seq over
+  void AdoptMapped(uint8_t* memory, uint32_t capacity, void* handle);
+
+  float* BeginWrite();             // seq -> odd; returns the data area
+  void   EndWrite(uint32_t count); // count clamped to capacity, seq -> even, marks dirty
+};
+
+// "Name" must be 1..64 chars of [A-Za-z0-9_.-] (it ends up in JSON/script text unescaped)
+bool IsValidSharedBufferName(const char* name);
+
+// Standard base64 (with padding) appended to out
+void Base64Append(const void* data, size_t n, std::string& out);
+
+// Unmapped publish: window.__rwvBuffers._put(name, seq, count, base64 of the count floats)
+std::string SharedBufferPutScript(const SharedBufferSlot& slot);
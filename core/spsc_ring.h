@@ -0,0 +1,67 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// core/spsc_ring.h
+// Single-producer / single-consumer ring of trivially copyable items. Wait-free on both sides, no
+// allocation after construction (the producer may be a real-time audio thread). Capacity is rounded up
+// to a power of two. Writes are all-or-nothing: the producer reserves n contiguous-or-wrapped slots,
+// fills the two spans and publishes them with Commit.
+#pragma once
+
+#include <atomic>
+#include <stddef.h>
+#include <string.h>
+#include <vector>
+
+template <class T>
+class SpscRing
+{
+public:
+  explicit SpscRing(size_t capacity)
+  {
+    size_t c = 16; while (c < capacity) c <<= 1;
+    m_buf.resize(c); m_mask = c - 1;
+  }
+  size_t Capacity() const { return m_mask + 1; }
+
+  // ---- producer
+  size_t FreeSpace() const { return Capacity() - (m_head.load(std::memory_order_relaxed) - m_tail.load(std::memory_order_acquire)); }
+  // Two spans covering n free slots (b/nb empty unless the reservation wraps); false if not enough room
+  bool Reserve(size_t n, T*& a, size_t& na, T*& b, size_t& nb)
+  {
+    if (n > FreeSpace()) return false;
+    const size_t h = m_head.load(std::memory_order_relaxed) & m_mask;
+    na = n < Capacity() - h ? n : Capacity() - h; nb = n - na;
+    a = &m_buf[h]; b = &m_buf[0];
+    return true;
+  }
+  void Commit(size_t n) { m_head.store(m_head.load(std::memory_order_relaxed) + n, std::memory_order_release); }
+  bool Write(const T* src, size_t n)
+  {
+    T* a; T* b; size_t na, nb;
+    if (!Reserve(n, a, na, b, nb)) return false;
+    memcpy(a, src, na * sizeof(T)); if (nb) memcpy(b, src + na, nb * sizeof(T));
+    Commit(n);
+    return true;
+  }
+
+  // ---- consumer
+  size_t Available() const { return m_head.load(std::memory_order_acquire) - m_tail.load(std::memory_order_relaxed); }
+  // Copies n items without consuming them; false if fewer are available
+  bool Peek(T* dst, size_t n) const
+  {
+    if (n > Available()) return false;
+    const size_t t = m_tail.load(std::memory_order_relaxed) & m_mask;
+    const size_t na = n < Capacity() - t ? n : Capacity() - t;
+    memcpy(dst, &m_buf[t], na * sizeof(T)); if (n > na) memcpy(dst + na, &m_buf[0], (n - na) * sizeof(T));
+    return true;
+  }
+  bool Read(T* dst, size_t n) { if (!Peek(dst, n)) return false; Skip(n); return true; }
+  void Skip(size_t n) { m_tail.store(m_tail.load(std::memory_order_relaxed) + n, std::memory_order_release); }
+
+private:
+  std::vector<T> m_buf;
+  size_t m_mask = 0;
+  alignas(64) std::atomic<size_t> m_head{0}; // written by the producer only
+  alignas(64) std::atomic<size_t> m_tail{0}; // written by the consumer only
+};
@@ -0,0 +1,73 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// core/startup_timeline.cpp
+#include "startup_timeline.h"
+
+#include <stdio.h>
+
+static const char* const kMarkNames[(int)StartupMark::Count] = {
+  "entryBegin", "apiLoaded", "commandsRegistered", "apiRegistered", "stateLoaded", "entryEnd",
+  "firstTick", "restoreDone", "firstWebViewStart", "firstPanelShown", "firstPageLoaded",
+};
+
+void StartupTimeline::Mark(StartupMark m, uint64_t nowUs)
+{
+  const int i = (int)m;
+  if (i < 0 || i >= (int)StartupMark::Count || m_us[i]) return;
+  m_us[i] = nowUs ? nowUs : 1;
+}
+
+int64_t StartupTimeline::SinceEntryUs(StartupMark m) const
+{
+  const int i = (int)m;
+  if (i < 0 || i >= (int)StartupMark::Count || !m_us[i] || !Has(StartupMark::EntryBegin)) return -1;
+  const uint64_t t0 = m_us[(int)StartupMark::EntryBegin];
+  return m_us[i] >= t0 ? (int64_t)(m_us[i] - t0) : 0;
+}
+
+int64_t StartupTimeline::EntryUs() const
+{
+  return SinceEntryUs(StartupMark::EntryEnd);
+}
+
+const char* StartupTimeline::Name(StartupMark m)
+{
+  const int i = (int)m;
+  return (i >= 0 && i < (int)StartupMark::Count) ? kMarkNames[i] : "";
+}
+
+static double UsToMs(int64_t us) { return us < 0 ? -1.0 : (double)us / 1000.0; }
+
+void StartupTimeline::AppendJson(std::string& out) const
+{
+  char buf[96];
+  snprintf(buf, sizeof(buf), "{\"entryMs\":%.3f", UsToMs(EntryUs()));
+  out += buf;
+  for (int i = (int)StartupMark::ApiLoaded; i < (int)StartupMark::Count; ++i) {
+    if (i == (int)StartupMark::EntryEnd) continue; // entryMs
+    snprintf(buf, sizeof(buf), ",\"%sMs\":%.3f", kMarkNames[i], UsToMs(SinceEntryUs((StartupMark)i)));
+    out += buf;
+  }
+  out += '}';
+}
+
+std::string StartupTimeline::EntrySummary() const
+{
+  std::string s;
+  char buf[96];
+  snprintf(buf, sizeof(buf), "entry %.3f ms (", UsToMs(EntryUs()));
+  s += buf;
+  // phase lengths inside the entry point, each from the previous mark reached
+  int64_t prev = 0;
+  bool first = true;
+  for (int i = (int)StartupMark::ApiLoaded; i < (int)StartupMark::EntryEnd; ++i) {
+    const int64_t at = SinceEntryUs((StartupMark)i);
+    if (at < 0) continue;
+    snprintf(buf, sizeof(buf), "%s%s %.3f", first ? "" : ", ", kMarkNames[i], UsToMs(at - prev));
+    s += buf;
+    prev = at; first = false;
+  }
+  s += ')';
+  return s;
+}
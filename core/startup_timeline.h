@@ -0,0 +1,48 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// core/startup_timeline.h
+// Cold-start timeline: one PerfNowUs() mark per startup milestone, from the module entry point to the first
+// page shown in a panel. The entry point's own span (EntryBegin -> EntryEnd) is what the plugin adds to REAPER's
+// launch; the later marks run from the timer, after REAPER is up. Each mark is kept the first time only.
+#pragma once
+
+#include <stdint.h>
+#include <string>
+
+enum class StartupMark : int
+{
+  EntryBegin = 0,      // REAPER_PLUGIN_ENTRYPOINT called
+  ApiLoaded,           // REAPERAPI_LoadAPI done
+  CommandsRegistered,  // actions + accelerators
+  ApiRegistered,       // ReaScript/native API entries
+  StateLoaded,         // persisted instance records parsed
+  EntryEnd,            // entry point returns to REAPER
+  FirstTick,           // first plugin timer tick (REAPER is up)
+  RestoreDone,         // panels open at the last exit reopened (hidden dock tabs stay deferred)
+  FirstWebViewStart,   // first StartWebView (WebView2 loader/COM, WKWebView, WebKitGTK set up here)
+  FirstPanelShown,     // first panel host window visible
+  FirstPageLoaded,     // first page finished loading in a panel
+  Count
+};
+
+class StartupTimeline
+{
+public:
+  void Mark(StartupMark m, uint64_t nowUs);
+  bool Has(StartupMark m) const { return m_us[(int)m] != 0; }
+  // Microseconds from EntryBegin, -1 if not reached (or EntryBegin never marked)
+  int64_t SinceEntryUs(StartupMark m) const;
+  // EntryBegin -> EntryEnd: the plugin's share of REAPER's launch time
+  int64_t EntryUs() const;
+
+  static const char* Name(StartupMark m); // "apiLoaded", ...
+  // {"entryMs":..,"apiLoadedMs":..,...,"firstPageLoadedMs":..}: ms since EntryBegin, -1 = not reached
+  void AppendJson(std::string& out) const;
+  // One line for the log: "entry 1.234 ms (apiLoaded 0.400, commandsRegistered 0.300, ...)", each phase
+  // measured from the previous mark
+  std::string EntrySummary() const;
+
+private:
+  uint64_t m_us[(int)StartupMark::Count] = {};
+};
@@ -0,0 +1,181 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// core/state_stream.cpp
+
+#include "core/state_stream.h"
+#include "core/json_cursor.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+static const int16_t kMeterFloorDb10 = -600; // -60 dB and below report as silence
+
+static bool TopicIs(const char* p, size_t n, const char* name) { return strlen(name) == n && !strncmp(p, name, n); }
+
+unsigned ParseStreamTopics(const char* csv, size_t n)
+{
+  unsigned topics = 0;
+  size_t i = 0;
+  while (i < n) {
+    while (i < n && (csv[i] == ',' || csv[i] == ' ')) ++i;
+    const size_t b = i;
+    while (i < n && csv[i] != ',' && csv[i] != ' ') ++i;
+    const char* p = csv + b; const size_t len = i - b;
+    if (!len) continue;
+    if (TopicIs(p, len, "*")) topics |= kStreamAllTopics;
+    else if (TopicIs(p, len, "transport")) topics |= kStreamTransport;
+    else if (TopicIs(p, len, "tracks")) topics |= kStreamTracks;
+    else if (TopicIs(p, len, "meters")) topics |= kStreamMeters;
+  }
+  return topics;
+}
+
+std::string StreamTopicsToString(unsigned topics)
+{
+  std::string s;
+  if (topics & kStreamTransport) s += "transport";
+  if (topics & kStreamTracks) { if (!s.empty()) s += ','; s += "tracks"; }
+  if (topics & kStreamMeters) { if (!s.empty()) s += ','; s += "meters"; }
+  return s;
+}
+
+static inline int64_t Milli(double v) { return (int64_t)llround(v * 1000.0); }
+
+static inline int16_t PeakDb10(float lin)
+{
+  if (!(lin > 0.001f)) return kMeterFloorDb10; // also catches NaN
+  int v = (int)lrintf(200.0f * log10f(lin));
+  if (v < kMeterFloorDb10) v = kMeterFloorDb10; else if (v > 240) v = 240;
+  return (int16_t)v;
+}
+
+// ---------------------------------------------------------------- StateStream
+void StateStream::Subscribe(unsigned topics, int hz)
+{
+  m_topics = topics & kStreamAllTopics;
+  m_hz = hz <= 0 ? kDefaultHz : (hz > kMaxHz ? kMaxHz : hz);
+  m_needFull = true;
+  m_sentOnce = false;
+}
+
+void StateStream::Unsubscribe()
+{
+  m_topics = 0;
+  m_needFull = true;
+  m_tracks.clear(); m_meters.clear();
+}
+
+bool StateStream::Due(uint32_t nowMs) const
+{
+  if (!m_topics) return false;
+  if (!m_sentOnce) return true;
+  const uint32_t interval = 1000u / (uint32_t)m_hz;
+  return nowMs - m_lastSendMs + interval / 4 >= interval; // timer jitter: a tick slightly early still counts
+}
+
+void StateStream::AppendTransport(const StreamTransport& t, bool full, std::string& out, bool& any)
+{
+  const int64_t pos = Milli(t.position), cur = Milli(t.cursor), bpm = Milli(t.bpm);
+  std::string body; char num[48];
+  auto field = [&body](const char* key, const char* val) {
+    body += body.empty() ? "\"" : ",\""; body += key; body += "\":"; body += val;
+  };
+  if (full || t.playState != m_transport.playState) { snprintf(num, sizeof(num), "%d", t.playState); field("play", num); }
+  if (full || pos != m_posMs) { snprintf(num, sizeof(num), "%.3f", pos / 1000.0); field("pos", num); }
+  if (full || cur != m_cursorMs) { snprintf(num, sizeof(num), "%.3f", cur / 1000.0); field("cursor", num); }
+  if (full || bpm != m_bpmMilli) { snprintf(num, sizeof(num), "%.3f", bpm / 1000.0); field("bpm", num); }
+  if (full || t.repeat != m_transport.repeat) field("repeat", t.repeat ? "true" : "false");
+  m_transport = t; m_posMs = pos; m_cursorMs = cur; m_bpmMilli = bpm;
+  if (body.empty()) return;
+  out += ",\"transport\":{"; out += body; out += '}';
+  any = true;
+}
+
+static void AppendTrackFields(std::string& out, const StreamTrack& t, const StreamTrack* prev)
+{
+  char num[32]; bool first = out.back() == '{';
+  auto sep = [&out, &first]() { if (!first) out += ','; first = false; };
+  if (!prev) { sep(); out += "\"guid\":"; JsonAppendQuoted(out, t.guid); }
+  if (!prev || prev->name != t.name) { sep(); out += "\"name\":"; JsonAppendQuoted(out, t.name); }
+  if (!prev || prev->flags != t.flags) { sep(); snprintf(num, sizeof(num), "\"flags\":%d", t.flags); out += num; }
+  if (!prev || prev->color != t.color) { sep(); snprintf(num, sizeof(num), "\"color\":%d", t.color); out += num; }
+}
+
+void StateStream::AppendTracks(const std::vector<StreamTrack>& tracks, bool full, std::string& out, bool& any)
+{
+  bool sameList = !full && tracks.size() == m_tracks.size();
+  for (size_t i = 0; sameList && i < tracks.size(); ++i) sameList = tracks[i].guid == m_tracks[i].guid;
+  if (!sameList) {
+    out += ",\"tracks\":[";
+    for (size_t i = 0; i < tracks.size(); ++i) { out += i ? ",{" : "{"; AppendTrackFields(out, tracks[i], nullptr); out += '}'; }
+    out += ']';
+    any = true;
+  } else {
+    size_t changes = 0;
+    for (size_t i = 0; i < tracks.size(); ++i) {
+      const StreamTrack& t = tracks[i]; const StreamTrack& p = m_tracks[i];
+      if (t.name == p.name && t.flags == p.flags && t.color == p.color) continue;
+      char head[40]; snprintf(head, sizeof(head), "%s{\"i\":%u", changes ? "," : ",\"trackDelta\":[", (unsigned)i);
+      out += head; AppendTrackFields(out, t, &p); out += '}';
+      ++changes;
+    }
+    if (!changes) return;
+    out += ']';
+    any = true;
+  }
+  m_tracks = tracks;
+}
+
+void StateStream::AppendMeters(const std::vector<float>& peaks, bool full, std::string& out, bool& any)
+{
+  const size_t strips = peaks.size() / 2;
+  const bool resized = full || m_meters.size() != strips * 2;
+  if (resized) m_meters.assign(strips * 2, kMeterFloorDb10);
+  std::string body; char num[40];
+  for (size_t s = 0; s < strips; ++s) {
+    const int16_t l = PeakDb10(peaks[s * 2]), r = PeakDb10(peaks[s * 2 + 1]);
+    if (!resized && l == m_meters[s * 2] && r == m_meters[s * 2 + 1]) continue;
+    m_meters[s * 2] = l; m_meters[s * 2 + 1] = r;
+    snprintf(num, sizeof(num), "%s%u,%d,%d", body.empty() ? "" : ",", (unsigned)s, l, r);
+    body += num;
+  }
+  if (resized) { snprintf(num, sizeof(num), ",\"meterCount\":%u", (unsigned)strips); out += num; any = true; }
+  if (body.empty()) return;
+  out += ",\"meters\":["; out += body; out += ']';
+  any = true;
+}
+
+bool StateStream::Encode(const StreamFrame& f, uint32_t nowMs, std::string& out)
+{
+  const unsigned topics = m_topics & f.topics;
+  if (!topics) return false;
+  const bool full = m_needFull;
+  std::string msg; msg.reserve(256);
+  char head[64]; snprintf(head, sizeof(head), "{\"seq\":%llu%s", m_seq + 1, full ? ",\"full\":true" : "");
+  msg = head;
+  bool any = full;
+  if (topics & kStreamTransport) AppendTransport(f.transport, full, msg, any);
+  if (topics & kStreamTracks) AppendTracks(f.tracks, full, msg, any);
+  if (topics & kStreamMeters) AppendMeters(f.peaks, full, msg, any);
+  if (!any) return false;
+  msg += '}';
+
+  ++m_seq; m_needFull = false;
+  m_lastSendMs = nowMs; m_sentOnce = true;
+  ++m_messages; m_bytes += msg.size();
+  if (nowMs - m_winStartMs >= 1000u) {
+    const uint32_t span = nowMs - m_winStartMs;
+    m_rate = (m_winStartMs && span < 2000u) ? m_winCount * 1000.0 / span : 0.0;
+    m_winStartMs = nowMs; m_winCount = 0;
+  }
+  ++m_winCount;
+  out.swap(msg);
+  return true;
+}
+
+double StateStream::MessagesPerSec(uint32_t nowMs) const
+{
+  return (m_winStartMs && nowMs - m_winStartMs < 2000u) ? m_rate : 0.0;
+}
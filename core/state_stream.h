@@ -0,0 +1,99 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// core/state_stream.h
+// REAPER state streaming into pages. A page subscribes to topics (window.__rwvState.subscribe, see
+// core/stream_script.h); once per timer tick the plugin samples the union of subscribed topics and each
+// due instance gets one message holding only what changed since its previous message:
+//
+//   {"seq":n,"full":true?,                       full: first message after (re)subscribe, everything present
+//    "transport":{"play":1,"pos":1.234,...},     changed fields only
+//    "tracks":[{"guid":..,"name":..,"flags":..,"color":..},...]  when the track list itself changed
+//    "trackDelta":[{"i":2,"name":..},...],       same list: changed fields of changed tracks only
+//    "meterCount":n, "meters":[i,l,r, ...]}      peaks in 0.1 dB (-600 = silence), master is strip 0
+//
+// Main-thread only, no locking.
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+enum : unsigned { kStreamTransport = 1u, kStreamTracks = 2u, kStreamMeters = 4u, kStreamAllTopics = 7u };
+enum : int { kStreamTrackSelected = 1, kStreamTrackMuted = 2, kStreamTrackSoloed = 4 };
+
+// "transport,tracks,meters" or "*"; unknown names are ignored
+unsigned ParseStreamTopics(const char* csv, size_t n);
+std::string StreamTopicsToString(unsigned topics);
+
+struct StreamTransport
+{
+  int    playState = 0;   // GetPlayState bits: 1 playing, 2 paused, 4 recording
+  double position = 0;    // play position while playing, edit cursor otherwise (seconds)
+  double cursor = 0;      // edit cursor (seconds)
+  double bpm = 0;
+  bool   repeat = false;
+};
+
+struct StreamTrack
+{
+  std::string guid, name;
+  int flags = 0;          // kStreamTrack* bits
+  int color = 0;          // I_CUSTOMCOLOR (0 = default)
+};
+
+struct StreamFrame
+{
+  unsigned topics = 0;             // parts below that were sampled
+  StreamTransport transport;
+  std::vector<StreamTrack> tracks;
+  std::vector<float> peaks;        // linear peaks, 2 per strip: master first, then tracks in order
+};
+
+class StateStream
+{
+public:
+  static const int kDefaultHz = 30, kMaxHz = 60;
+
+  // Resets the baseline: the next message is full
+  void Subscribe(unsigned topics, int hz);
+  void Unsubscribe();
+  unsigned Topics() const { return m_topics; }
+  int Hz() const { return m_hz; }
+  // Rate limit: true once 1/hz has (nearly) elapsed since the last message
+  bool Due(uint32_t nowMs) const;
+
+  // Writes the delta for the subscribed topics into out. False (out untouched) when nothing changed;
+  // the page's view is unchanged then and Due() stays true.
+  bool Encode(const StreamFrame& f, uint32_t nowMs, std::string& out);
+  void AddCost(double us) { m_costUs += us; if (us > m_maxCostUs) m_maxCostUs = us; ++m_costSamples; }
+
+  unsigned long long Messages() const { return m_messages; }
+  unsigned long long Bytes() const { return m_bytes; }
+  double MessagesPerSec(uint32_t nowMs) const; // over the last complete second
+  double AvgCostUs() const { return m_costSamples ? m_costUs / (double)m_costSamples : 0.0; }
+  double MaxCostUs() const { return m_maxCostUs; }
+
+private:
+  void AppendTransport(const StreamTransport& t, bool full, std::string& out, bool& any);
+  void AppendTracks(const std::vector<StreamTrack>& tracks, bool full, std::string& out, bool& any);
+  void AppendMeters(const std::vector<float>& peaks, bool full, std::string& out, bool& any);
+
+  unsigned m_topics = 0;
+  int      m_hz = kDefaultHz;
+  bool     m_needFull = true;
+  uint32_t m_lastSendMs = 0;
+  bool     m_sentOnce = false;
+  unsigned long long m_seq = 0;
+
+  // what the page has
+  StreamTransport m_transport;
+  int64_t m_posMs = -1, m_cursorMs = -1, m_bpmMilli = -1;
+  std::vector<StreamTrack> m_tracks;
+  std::vector<int16_t> m_meters;   // 0.1 dB
+
+  unsigned long long m_messages = 0, m_bytes = 0;
+  uint32_t m_winStartMs = 0; unsigned m_winCount = 0; double m_rate = 0;
+  double m_costUs = 0, m_maxCostUs = 0; unsigned long long m_costSamples = 0;
+};
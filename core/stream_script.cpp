@@ -0,0 +1,124 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// core/stream_script.cpp
+
+#include "core/stream_script.h"
+
+const char* const kStateStreamJS = R"JS((function(){
+if (window.top !== window || window.__rwvState) return;
+var post = function(s) {
+  try {
+    if (window.chrome && window.chrome.webview) window.chrome.webview.postMessage(s);
+    else window.webkit.messageHandlers.frzCtx.postMessage(s);
+  } catch (_) {}
+};
+var S = window.__rwvState = {
+  seq: 0, synced: false, onchange: null,
+  state: { transport: {}, tracks: [], meters: [] },
+  subscribe: function(topics, hz) {
+    var t = Array.isArray(topics) ? topics.join(',') : String(topics || '*');
+    this.synced = false; // deltas are relative to the full message that answers this
+    post('SUB|' + t + '|' + (hz > 0 ? Math.round(hz) : 30));
+  },
+  unsubscribe: function() { this.synced = false; post('SUB|'); },
+  // Hardware audio tap: channels like ['o1','o2'] (outputs) / ['i1'] (inputs), mono or stereo, ~rate Hz
+  subscribeAudio: function(o) {
+    o = o || {};
+    var ch = o.channels || ['o1', 'o2'];
+    post('AUD|' + (Array.isArray(ch) ? ch.join(',') : String(ch)) + '|' + (o.mono ? 1 : 2) + '|' + (o.rate > 0 ? Math.round(o.rate) : 11025));
+  },
+  unsubscribeAudio: function() { post('AUD|'); },
+  // Video frames (RGBA) scaled to at most maxWidth, at most fps per second
+  subscribeVideo: function(o) {
+    o = o || {};
+    post('VID|' + (o.maxWidth > 0 ? Math.round(o.maxWidth) : 480) + '|' + (o.fps > 0 ? Math.round(o.fps) : 30));
+  },
+  unsubscribeVideo: function() { post('VID|'); },
+  push: function(d) {
+    if (!d || (!this.synced && !d.full)) return; // late batch for an older subscription
+    this.synced = true;
+    var st = this.state, k, i;
+    if (d.full) st.transport = {};
+    if (d.transport) for (k in d.transport) st.transport[k] = d.transport[k];
+    if (d.tracks) st.tracks = d.tracks;
+    if (d.trackDelta) for (i = 0; i < d.trackDelta.length; i++) {
+      var c = d.trackDelta[i], t = st.tracks[c.i]; if (!t) continue;
+      for (k in c) if (k !== 'i') t[k] = c[k];
+    }
+    if (d.meterCount !== undefined) { st.meters = new Array(d.meterCount); for (i = 0; i < d.meterCount; i++) st.meters[i] = [-60, -60]; }
+    if (d.meters) for (i = 0; i + 2 < d.meters.length; i += 3) {
+      var m = st.meters[d.meters[i]]; if (m) { m[0] = d.meters[i + 1] / 10; m[1] = d.meters[i + 2] / 10; }
+    }
+    this.seq = d.seq;
+    if (typeof this.onchange === 'function') { try { this.onchange(d, st); } catch (e) { console.error(e); } }
+    try { window.dispatchEvent(new CustomEvent('rwvstate', { detail: { delta: d, state: st } })); } catch (_) {}
+  }
+};
+if (window.chrome && window.chrome.webview)
+  window.chrome.webview.addEventListener('message', function(e) { if (e.data && e.data.rwvState) S.push(e.data.rwvState); });
+// audio blocks arrive in the "audio" shared buffer: [rate, channels, frames, interleaved samples...]
+// video frames in the "video" shared buffer: [w, h, seq (u32), 0, RGBA pixels...]; every handled frame is
+// acknowledged so the next one is sent (a page that falls behind skips frames instead of queueing them)
+window.addEventListener('rwvbuffer', function(e) {
+  var d = e.detail; if (!d || d.name !== 'video' || d.count < 4) return;
+  var a = d.data, w = a[0], h = a[1], seq = new Uint32Array(a.buffer, a.byteOffset + 8, 1)[0];
+  if (w * h > d.count - 4) return;
+  try { window.dispatchEvent(new CustomEvent('rwvvideo', { detail: { width: w, height: h, seq: seq, pixels: new Uint8ClampedArray(a.buffer, a.byteOffset + 16, w * h * 4) } })); } catch (_) {}
+  post('VID|ack|' + seq);
+});
+window.addEventListener('rwvbuffer', function(e) {
+  var d = e.detail; if (!d || d.name !== 'audio' || d.count < 3) return;
+  var a = d.data, ch = a[1] || 1, frames = Math.min(a[2], Math.floor((d.count - 3) / ch));
+  try { window.dispatchEvent(new CustomEvent('rwvaudio', { detail: { rate: a[0], channels: ch, frames: frames, seq: d.seq, samples: a.subarray(3, 3 + frames * ch) } })); } catch (_) {}
+});
+post('SUB|'); // new document: drop whatever the previous one subscribed to
+post('AUD|');
+post('VID|');
+})();)JS";
+
+const char* const kSharedBufferJS = R"JS((function(){
+if (window.top !== window || window.__rwvBuffers) return;
+var B = window.__rwvBuffers = {
+  slots: {},
+  attach: function(name, ab) {
+    var old = this.slots[name];
+    if (old && old.shared && window.chrome && window.chrome.webview && window.chrome.webview.releaseBuffer) {
+      try { window.chrome.webview.releaseBuffer(old.buf); } catch (_) {}
+    }
+    return this.slots[name] = { buf: ab, hdr: new Uint32Array(ab, 0, 4), data: new Float32Array(ab, 16), seq: -1, count: 0, shared: true };
+  },
+  get: function(name) { var s = this.slots[name]; return s ? s.data.subarray(0, s.count) : null; },
+  stable: function(name) { var s = this.slots[name]; return !!s && s.hdr[0] === s.seq; },
+  publish: function(name) {
+    var s = this.slots[name]; if (!s) return;
+    var seq = s.hdr[0]; if (seq & 1) return; // writer active: its own notification follows
+    var count = Math.min(s.hdr[1], s.data.length);
+    if (s.hdr[0] !== seq || seq === s.seq) return;
+    s.seq = seq; s.count = count;
+    try { window.dispatchEvent(new CustomEvent('rwvbuffer', { detail: { name: name, seq: seq, count: count, data: s.data.subarray(0, count) } })); } catch (_) {}
+  },
+  // WebKit: no mapping, the update is decoded into a buffer reused while it is large enough
+  _put: function(name, seq, count, b64) {
+    var s = this.slots[name], need = 16 + count * 4;
+    if (!s || s.buf.byteLength < need) {
+      var cap = Math.max(count, s ? s.data.length * 2 : 0);
+      var ab = new ArrayBuffer(16 + cap * 4);
+      s = this.slots[name] = { buf: ab, hdr: new Uint32Array(ab, 0, 4), data: new Float32Array(ab, 16), seq: -1, count: 0, shared: false };
+      s.hdr[2] = cap;
+    }
+    var u8 = new Uint8Array(s.buf, 16, count * 4);
+    if (Uint8Array.fromBase64) u8.set(Uint8Array.fromBase64(b64).subarray(0, count * 4));
+    else { var bin = atob(b64), n = Math.min(bin.length, u8.length); for (var i = 0; i < n; i++) u8[i] = bin.charCodeAt(i); }
+    s.hdr[1] = count; s.hdr[0] = seq;
+    this.publish(name);
+  }
+};
+if (window.chrome && window.chrome.webview) {
+  window.chrome.webview.addEventListener('sharedbufferreceived', function(e) {
+    var d = e.additionalData; if (!d || !d.rwvBuffer) return;
+    B.attach(d.rwvBuffer, e.getBuffer()); B.publish(d.rwvBuffer);
+  });
+  window.chrome.webview.addEventListener('message', function(e) { if (e.data && e.data.rwvBuffer) B.publish(e.data.rwvBuffer); });
+}
+})();)JS";
@@ -0,0 +1,33 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// core/stream_script.h
+// Page-side half of the state stream (core/state_stream.h): window.__rwvState, injected at document start
+// into the top frame of every panel.
+//
+//   __rwvState.subscribe(['transport','tracks','meters'], hz) -> posts "SUB|transport,tracks,meters|hz"
+//   __rwvState.unsubscribe()                                  -> posts "SUB|" (also sent on every new document)
+//   __rwvState.subscribeAudio({channels:['o1','o2'], mono, rate}) -> posts "AUD|o1,o2|2|11025"
+//   __rwvState.unsubscribeAudio()                             -> posts "AUD|" (also sent on every new document)
+//   'rwvaudio' event on window       detail {rate, channels, frames, seq, samples} (interleaved Float32Array)
+//   __rwvState.subscribeVideo({maxWidth, fps}) -> posts "VID|480|30"; unsubscribeVideo() -> "VID|"
+//   'rwvvideo' event on window       detail {width, height, seq, pixels} (RGBA Uint8ClampedArray, valid during
+//                                    the event); the helper then posts "VID|ack|seq" to ask for the next frame
+//   __rwvState.state       merged view: {transport:{}, tracks:[], meters:[[l,r],...]} (dB, strip 0 = master)
+//   __rwvState.onchange    optional function(delta, state); a 'rwvstate' event with detail {delta, state}
+//                          is dispatched on window as well
+//
+// Batches arrive through chrome.webview 'message' events ({rwvState: delta}) on WebView2 and through
+// __rwvState.push(delta) on WebKit.
+//
+// window.__rwvBuffers: named float32 buffers written by native code (core/shared_buffer.h)
+//   __rwvBuffers.get(name)          -> Float32Array of the valid floats (a live view on WebView2), or null
+//   __rwvBuffers.stable(name)       -> false once native code has started another write since the last
+//                                      'rwvbuffer' event (re-read on the next event)
+//   'rwvbuffer' event on window      detail {name, seq, count, data}
+// WebView2 maps the memory ('sharedbufferreceived', then {rwvBuffer: name} messages per update);
+// WebKit ships each update through __rwvBuffers._put(name, seq, count, base64).
+#pragma once
+
+extern const char* const kStateStreamJS;
+extern const char* const kSharedBufferJS;
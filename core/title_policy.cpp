@@ -0,0 +1,46 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// core/title_policy.cpp
+
+#include "core/title_policy.h"
+
+bool IsDefaultTitle(const std::string& effectiveTitle, const char* baseTitle)
+{
+  return effectiveTitle.empty() || (baseTitle && effectiveTitle == baseTitle);
+}
+
+bool PanelVisibleFor(ShowPanelMode mode, bool inDock, bool defaultTitle)
+{
+  switch (mode)
+  {
+    case ShowPanelMode::Hide:   return false;
+    case ShowPanelMode::Docker: return inDock;  // только в докере
+    case ShowPanelMode::Always: return true;    // всегда
+    case ShowPanelMode::Unset:  default: return defaultTitle && inDock; // старое поведение
+  }
+}
+
+std::string ComposePanelText(const std::string& domain, const std::string& pageTitle)
+{
+  std::string s = domain.empty() ? "…" : domain;
+  if (!pageTitle.empty()) { s += " - "; s += pageTitle; }
+  return s;
+}
+
+TitleDecision DecideTitles(const std::string& effectiveTitle, const char* baseTitle, ShowPanelMode mode, bool inDock,
+                           const std::string& domain, const std::string& pageTitle)
+{
+  TitleDecision d;
+  d.defaultMode  = IsDefaultTitle(effectiveTitle, baseTitle);
+  d.panelVisible = PanelVisibleFor(mode, inDock, d.defaultMode);
+  d.panelText    = ComposePanelText(domain, pageTitle);
+  if (d.defaultMode) {
+    d.tabCaption = baseTitle ? baseTitle : "";
+    d.wndCaption = d.panelText;
+  } else {
+    d.tabCaption = effectiveTitle;
+    d.wndCaption = effectiveTitle;
+  }
+  return d;
+}
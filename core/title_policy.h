@@ -0,0 +1,36 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// core/title_policy.h
+// Title / panel decision table. One place for the rules previously duplicated in
+// UpdateTitlesExtractAndApply and SizeWebViewToClient.
+#pragma once
+
+#include <string>
+
+#include "core/panel_mode.h"
+
+// Default title = no override (or override equal to the base caption)
+bool IsDefaultTitle(const std::string& effectiveTitle, const char* baseTitle);
+
+// Panel visibility:
+//   Hide   -> never
+//   Docker -> only while docked
+//   Always -> always
+//   Unset  -> legacy: docked AND default title
+bool PanelVisibleFor(ShowPanelMode mode, bool inDock, bool defaultTitle);
+
+// Panel text never shows the override: domain [+ " - " + pageTitle], "…" when the domain is unknown
+std::string ComposePanelText(const std::string& domain, const std::string& pageTitle);
+
+struct TitleDecision
+{
+  bool defaultMode  = true;
+  bool panelVisible = false;
+  std::string tabCaption;  // docker tab text (used when inDock)
+  std::string wndCaption;  // floating window caption (used when !inDock)
+  std::string panelText;   // in-panel title strip
+};
+
+TitleDecision DecideTitles(const std::string& effectiveTitle, const char* baseTitle, ShowPanelMode mode, bool inDock,
+                           const std::string& domain, const std::string& pageTitle);
@@ -0,0 +1,26 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// core/url_utils.h
+// URL helpers shared by all platforms (implementation in core/url_utils.cpp)
+#pragma once
+
+#include <string>
+
+// host[:port] of a URL; "www." stripped, default http/https ports hidden
+std::string ExtractDomainFromUrl(const std::string& url);
+
+// ================= URL normalization =================
+// Normalize a user-entered URL:
+//  - Trim spaces.
+//  - If it has an http/https/file/about/data scheme, returns as-is.
+//  - If it has another explicit scheme (e.g. spotify:, steam://), returns empty in outNormalized
+//    and sets outExternal to original (caller should open externally via ShellExecute / NSWorkspace).
+//  - If it has no scheme, prefix with "https://".
+// Returns true if navigation should proceed in embedded webview (outNormalized valid),
+// false if should dispatch externally (outExternal filled) or input invalid.
+// outReason may contain brief diagnostic for logging.
+bool NormalizeOrDispatchURL(const std::string& input,
+                            std::string& outNormalized,
+                            std::string& outExternal,
+                            std::string& outReason);
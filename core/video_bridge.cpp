@@ -0,0 +1,92 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// core/video_bridge.cpp
+
+#include "core/video_bridge.h"
+
+#include <chrono>
+#include <string.h>
+
+int64_t VideoClockUs()
+{
+  return (int64_t)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool VideoMailbox::Publish(const uint8_t* rgba, int w, int h, int rowspan)
+{
+  const int maxW = MaxWidth();
+  if (!maxW || !rgba || w <= 0 || h <= 0) return false;
+  const int64_t t0 = VideoClockUs();
+  const int dw = w > maxW ? maxW : w;
+  int dh = (int)((int64_t)h * dw / w); if (dh < 1) dh = 1;
+  VideoFrameBuf& b = m_buf[m_back];
+  b.px.resize((size_t)dw * dh * 4); // grows once per size change, never on the steady path
+  b.w = dw; b.h = dh;
+  if (dw == w) {
+    for (int y = 0; y < h; ++y) memcpy(&b.px[(size_t)y * dw * 4], rgba + (size_t)y * rowspan, (size_t)dw * 4);
+  } else {
+    const uint32_t stepX = (uint32_t)(((uint64_t)w << 16) / dw), stepY = (uint32_t)(((uint64_t)h << 16) / dh);
+    uint32_t* dst = (uint32_t*)b.px.data();
+    for (int y = 0; y < dh; ++y) {
+      const uint32_t* row = (const uint32_t*)(rgba + (size_t)((y * (uint64_t)stepY) >> 16) * rowspan);
+      uint32_t sx = 0;
+      for (int x = 0; x < dw; ++x, sx += stepX) *dst++ = row[sx >> 16];
+    }
+  }
+  b.seq = m_seq.fetch_add(1, std::memory_order_relaxed) + 1;
+  b.captureUs = t0;
+  const int prev = m_middle.exchange(m_back | kFresh, std::memory_order_acq_rel);
+  if (prev & kFresh) m_overwritten.fetch_add(1, std::memory_order_relaxed);
+  m_back = prev & 3;
+  m_produced.fetch_add(1, std::memory_order_relaxed);
+  m_copyUs.fetch_add((unsigned long long)(VideoClockUs() - t0), std::memory_order_relaxed);
+  return true;
+}
+
+const VideoFrameBuf* VideoMailbox::Take()
+{
+  if (!(m_middle.load(std::memory_order_acquire) & kFresh)) return nullptr;
+  m_front = m_middle.exchange(m_front, std::memory_order_acq_rel) & 3;
+  return &m_buf[m_front];
+}
+
+void VideoLink::Subscribe(int maxWidth, int fps)
+{
+  m_on = true;
+  m_maxWidth = maxWidth < 16 ? 16 : maxWidth > 4096 ? 4096 : maxWidth;
+  m_fps = fps < 1 ? 1 : fps > 60 ? 60 : fps;
+  m_inFlight = 0;
+}
+
+bool VideoLink::Ready(int64_t nowUs)
+{
+  if (!m_on) return false;
+  const bool waiting = m_inFlight && nowUs - m_sentUs < kAckTimeoutUs;
+  const bool early = m_lastSendUs && nowUs - m_lastSendUs < 1000000 / m_fps - 2000; // 2 ms slack for timer jitter
+  if (waiting || early) { ++m_skipped; return false; }
+  return true;
+}
+
+void VideoLink::OnSent(const VideoFrameBuf& f, int64_t nowUs)
+{
+  m_inFlight = f.seq ? f.seq : 1;
+  m_inFlightCaptureUs = f.captureUs;
+  m_sentUs = m_lastSendUs = nowUs;
+  ++m_sent;
+}
+
+void VideoLink::OnAck(uint32_t seq, int64_t nowUs)
+{
+  if (!m_inFlight || seq != m_inFlight) return; // stale ack (timed out, or a previous subscription)
+  m_inFlight = 0;
+  ++m_acked;
+  const double lat = (double)(nowUs - m_inFlightCaptureUs);
+  m_latencySumUs += lat; if (lat > m_latencyMaxUs) m_latencyMaxUs = lat;
+  if (!m_fpsWindowUs) m_fpsWindowUs = nowUs;
+  ++m_fpsCount;
+  if (nowUs - m_fpsWindowUs >= 1000000) {
+    m_shownFps = m_fpsCount * 1e6 / (double)(nowUs - m_fpsWindowUs);
+    m_fpsWindowUs = nowUs; m_fpsCount = 0;
+  }
+}
@@ -0,0 +1,83 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// core/video_bridge.h
+// Video frames into panels. The producer (REAPER's video thread, through an IREAPERVideoProcessor, or a
+// native caller) hands each RGBA frame to a VideoMailbox: a triple buffer whose single copy also scales
+// the frame down to the widest size any panel asked for, so no full-size copy outlives the producer's
+// call. Latest frame wins; a frame replaced before the main thread took it is counted as dropped.
+// VideoLink is the per-panel side: one frame in flight until the page acknowledges it (a page that falls
+// behind skips frames instead of queueing them), an fps cap, and fps / capture-to-page latency counters.
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+#include <vector>
+
+struct VideoFrameBuf
+{
+  std::vector<uint8_t> px; // RGBA, w * 4 bytes per row
+  int w = 0, h = 0;
+  uint32_t seq = 0;
+  int64_t captureUs = 0;   // VideoClockUs() when the producer handed it over
+};
+
+int64_t VideoClockUs();    // steady clock shared by producer, main thread and the counters
+
+class VideoMailbox
+{
+public:
+  // 0 = nobody listens (Publish returns at once); otherwise frames are scaled to at most this width
+  void SetMaxWidth(int w) { m_maxWidth.store(w < 0 ? 0 : w, std::memory_order_relaxed); }
+  int MaxWidth() const { return m_maxWidth.load(std::memory_order_relaxed); }
+
+  // ---- producer (one thread at a time). rowspan in bytes; nearest-neighbour scaling keeps the aspect ratio
+  bool Publish(const uint8_t* rgba, int w, int h, int rowspan);
+  // ---- main thread: newest unseen frame or null; valid until the next Take
+  const VideoFrameBuf* Take();
+
+  unsigned long long Produced() const { return m_produced.load(std::memory_order_relaxed); }
+  unsigned long long Overwritten() const { return m_overwritten.load(std::memory_order_relaxed); }
+  double AvgCopyUs() const { const unsigned long long n = Produced(); return n ? m_copyUs.load(std::memory_order_relaxed) / (double)n : 0.0; }
+
+private:
+  static const int kFresh = 4;
+  VideoFrameBuf m_buf[3];
+  int m_back = 0, m_front = 1;           // owned by producer / consumer
+  std::atomic<int> m_middle{2};          // index | kFresh when it holds an unseen frame
+  std::atomic<int> m_maxWidth{0};
+  std::atomic<uint32_t> m_seq{0};
+  std::atomic<unsigned long long> m_produced{0}, m_overwritten{0}, m_copyUs{0};
+};
+
+class VideoLink
+{
+public:
+  void Subscribe(int maxWidth, int fps);
+  void Unsubscribe() { m_on = false; m_inFlight = 0; }
+  bool Subscribed() const { return m_on; }
+  int MaxWidth() const { return m_maxWidth; }
+
+  // true if a new frame may be sent now; otherwise the frame is skipped for this panel (counted)
+  bool Ready(int64_t nowUs);
+  void OnSent(const VideoFrameBuf& f, int64_t nowUs);
+  void OnAck(uint32_t seq, int64_t nowUs);
+
+  unsigned long long Sent() const { return m_sent; }
+  unsigned long long Shown() const { return m_acked; }
+  unsigned long long Skipped() const { return m_skipped; }
+  double Fps() const { return m_shownFps; } // frames shown per second, over ~1 s windows
+  double AvgLatencyMs() const { return m_acked ? m_latencySumUs / 1000.0 / (double)m_acked : 0.0; }
+  double MaxLatencyMs() const { return m_latencyMaxUs / 1000.0; }
+
+  static const int64_t kAckTimeoutUs = 500000; // a page that never acks (busy/reloading) gets the next frame after this
+
+private:
+  bool m_on = false;
+  int m_maxWidth = 480, m_fps = 30;
+  uint32_t m_inFlight = 0;                   // seq awaiting the page's ack (0 = none)
+  int64_t m_inFlightCaptureUs = 0, m_sentUs = 0, m_lastSendUs = 0;
+  unsigned long long m_sent = 0, m_acked = 0, m_skipped = 0;
+  double m_latencySumUs = 0, m_latencyMaxUs = 0;
+  int64_t m_fpsWindowUs = 0; unsigned m_fpsCount = 0; double m_shownFps = 0;
+};
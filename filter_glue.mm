@@ -0,0 +1,106 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// filter_glue.mm
+#include "predef.h"
+#include "globals.h"
+#include "helpers.h"
+#include "log.h"
+#include "webview.h"
+#include "core/json_cursor.h"
+
+#include <chrono>
+
+// ============================== request filter ==============================
+// Block lists compiled once per file (core/host_filter.h) and shared by every instance that names them.
+// WebView2 checks each request here (WebResourceRequested); WebKit backends load the same rules as a
+// content blocker and only report navigations (decidePolicy) through ContentFilterBlocks.
+static std::unordered_map<std::string, std::unique_ptr<ContentFilterList>> g_filterLists;
+
+static std::string ContentFilterPath(const std::string& name)
+{
+  const char* res = GetResourcePath ? GetResourcePath() : nullptr;
+  if (!res || !*res || name.empty()) return std::string();
+#ifdef _WIN32
+  const char* sep = "\\";
+#else
+  const char* sep = "/";
+#endif
+  if (name == "default") return std::string(res) + sep + "reaper_webview_filter.txt";
+  if (name.find_first_of("/\\:") != std::string::npos || name.find("..") != std::string::npos) return std::string();
+  return std::string(res) + sep + "reaper_webview_filters" + sep + name;
+}
+
+static ContentFilterList* LoadContentFilterList(const std::string& name, bool reload)
+{
+  std::unique_ptr<ContentFilterList>& slot = g_filterLists[name];
+  if (slot && !reload) return slot.get();
+  static unsigned s_gen = 0;
+  std::unique_ptr<ContentFilterList> list(new ContentFilterList());
+  list->name = name; list->path = ContentFilterPath(name); list->gen = ++s_gen;
+  std::string text;
+#ifdef _WIN32
+  FILE* f = list->path.empty() ? nullptr : _wfopen(Widen(list->path).c_str(), L"rb");
+#else
+  FILE* f = list->path.empty() ? nullptr : fopen(list->path.c_str(), "rb");
+#endif
+  if (f) {
+    char buf[16384]; size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) text.append(buf, n);
+    fclose(f);
+  }
+  const auto t0 = std::chrono::steady_clock::now();
+  const size_t rules = list->filter.Load(text.data(), text.size());
+  if (f) LogF("[Filter] list '%s' (%s): %zu rules (hosts %zu, exceptions %zu, patterns %zu) in %.1f ms", name.c_str(),
+              list->path.c_str(), rules, list->filter.HostRules(), list->filter.ExceptionRules(), list->filter.PatternRules(),
+              std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count());
+  slot = std::move(list);
+  return slot.get();
+}
+
+ContentFilterList* ContentFilterFor(WebViewInstanceRecord* rec)
+{
+  if (!rec || rec->contentFilter.empty()) return nullptr;
+  ContentFilterList* list = LoadContentFilterList(rec->contentFilter, false);
+  return list->filter.Empty() ? nullptr : list;
+}
+
+const std::string& ContentFilterRulesJson(ContentFilterList* list)
+{
+  if (list->rulesJson.empty()) list->rulesJson = list->filter.ContentRulesJson();
+  return list->rulesJson;
+}
+
+void SetInstanceContentFilter(WebViewInstanceRecord* rec, const std::string& list)
+{
+  if (!rec) return;
+  if (!list.empty()) LoadContentFilterList(list, true);
+  if (rec->contentFilter != list) { rec->contentFilter = list; MarkInstanceStateDirty(); }
+  WebViewApplyContentFilter(rec);
+}
+
+bool ContentFilterBlocks(WebViewInstanceRecord* rec, const char* url, size_t len)
+{
+  ContentFilterList* list = ContentFilterFor(rec);
+  if (!list) return false;
+  const auto t0 = std::chrono::steady_clock::now();
+  const FilterVerdict v = list->filter.Check(url, len);
+  rec->filterNs += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+  ++rec->filterChecked;
+  if (v == FilterVerdict::Allow) return false;
+  ++rec->filterBlocked;
+  LogDebugF("[Filter] id='%s' blocked (%s) %.*s", rec->id.c_str(), v == FilterVerdict::BlockHost ? "host" : "pattern", (int)len, url);
+  return true;
+}
+
+void ContentFilterAppendInstanceJson(WebViewInstanceRecord* rec, std::string& out)
+{
+  ContentFilterList* fl = ContentFilterFor(rec);
+  if (!fl) return;
+  out += ",\"filter\":{\"list\":"; JsonAppendQuoted(out, fl->name);
+  char buf[160];
+  snprintf(buf, sizeof(buf), ",\"rules\":%zu,\"checked\":%llu,\"blocked\":%llu,\"avgNs\":%.0f}",
+           fl->filter.HostRules() + fl->filter.ExceptionRules() + fl->filter.PatternRules(), rec->filterChecked,
+           rec->filterBlocked, rec->filterChecked ? rec->filterNs / (double)rec->filterChecked : 0.0);
+  out += buf;
+}
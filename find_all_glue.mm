@@ -0,0 +1,137 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// find_all_glue.mm
+#include "predef.h"
+#include "globals.h"
+#include "helpers.h"
+#include "log.h"
+#include "webview.h"
+
+// ============================== Find in all panels ==============================
+// core/find_all.h: the count script goes to every live panel in the same call (the pages search
+// concurrently), answers are aggregated under one handle. WEBVIEW_FindAll polls it; the action shows the
+// hits as a menu once the slowest panel has answered or timed out.
+static FindAllSearches g_findAll;
+static int g_findAllMenuHandle = 0; // search started by the action
+
+static void OnFindAllAnswer(const std::string& id, const std::string& result)
+{
+  g_findAll.OnPanelResult(id, result, ScriptNowMs());
+}
+
+static std::string FindAllPanelTitle(WebViewInstanceRecord* rec)
+{
+  if (!rec->lastTabTitle.empty()) return rec->lastTabTitle;
+  if (!rec->lastWndText.empty()) return rec->lastWndText;
+  return rec->id;
+}
+
+int FindAllStart(const std::string& query, const FindAllOptions& opt)
+{
+  std::vector<WebViewInstanceRecord*> recs;
+  std::vector<std::pair<std::string, std::string>> panels;
+  for (auto& kv : g_instances) {
+    WebViewInstanceRecord* rec = kv.second.get();
+    if (!rec || !rec->hwnd) continue;
+    recs.push_back(rec);
+    panels.emplace_back(rec->id, FindAllPanelTitle(rec));
+  }
+  const uint64_t now = ScriptNowMs();
+  const int h = g_findAll.Begin(query, opt, panels, now);
+  if (h < 0) { LogF("[FindAll] not started query='%s' panels=%d pending=%d", query.c_str(), (int)panels.size(), g_findAll.Pending()); return -1; }
+  const std::string js = FindAllCountScript(h, query, opt);
+  for (WebViewInstanceRecord* rec : recs) {
+    // hibernated / not created yet: reported rather than woken for a search
+    if (rec->hibernate != HibernateState::Active || !WebViewHasView(rec)) { g_findAll.Fail(h, rec->id, "no live view", now); continue; }
+    WebViewEvalScript(rec, js, OnFindAllAnswer);
+  }
+  LogF("[FindAll] handle=%d query='%s' panels=%d", h, query.c_str(), (int)panels.size());
+  return h;
+}
+
+int FindAllGetResult(int handle, std::string& json) { return g_findAll.Get(handle, json); }
+
+bool FindAllJump(int handle, const std::string& id, int index)
+{
+  const FindAllSearches::Search* s = g_findAll.Find(handle);
+  WebViewInstanceRecord* rec = GetInstanceById(id);
+  if (!s || !rec || index < 1 || rec->hibernate != HibernateState::Active || !WebViewHasView(rec)) return false;
+  OpenOrActivateInstance(id, std::string(), false); // bring the dock tab / window to front
+  WebViewEvalScript(rec, FindAllJumpScript(s->query, s->opt.caseSensitive, index), nullptr);
+  LogF("[FindAll] jump handle=%d id='%s' hit=%d", handle, id.c_str(), index);
+  return true;
+}
+
+static void AppendMenuUtf8(HMENU m, UINT flags, UINT_PTR cmd, const std::string& text)
+{
+  std::string t;
+  for (char c : text) { if (c == '&') t += '&'; t += c; } // no mnemonics in page text
+#ifdef _WIN32
+  AppendMenuW(m, flags, cmd, Widen(t).c_str());
+#else
+  AppendMenuA(m, flags, cmd, t.c_str()); // SWELL menus take UTF-8
+#endif
+}
+
+static void ShowFindAllMenu(int handle)
+{
+  const FindAllSearches::Search* s = g_findAll.Find(handle);
+  if (!s) return;
+  HMENU m = CreatePopupMenu();
+  std::vector<std::pair<std::string, int>> targets; // command - 1 -> (instance, hit)
+  char num[96];
+  bool first = true;
+  for (const FindAllSearches::Panel& p : s->panels) {
+    if (!first) AppendMenuA(m, MF_SEPARATOR, 0, NULL);
+    first = false;
+    if (!p.error.empty()) snprintf(num, sizeof(num), " (%s)", p.error.c_str());
+    else snprintf(num, sizeof(num), " (%d match%s, %llu ms)", p.matches, p.matches == 1 ? "" : "es", (unsigned long long)p.answeredMs);
+    AppendMenuUtf8(m, MF_STRING | MF_DISABLED | MF_GRAYED, 0, p.title + num);
+    for (size_t i = 0; i < p.hits.size(); ++i) {
+      targets.emplace_back(p.id, (int)i + 1);
+      AppendMenuUtf8(m, MF_STRING, (UINT_PTR)targets.size(), "    " + p.hits[i]);
+    }
+    if (p.matches > (int)p.hits.size()) {
+      snprintf(num, sizeof(num), "    ... %d more", p.matches - (int)p.hits.size());
+      AppendMenuA(m, MF_STRING | MF_DISABLED | MF_GRAYED, 0, num);
+    }
+  }
+  POINT pt{}; GetCursorPos(&pt);
+  HWND owner = g_hwndParent ? g_hwndParent : GetForegroundWindow();
+  const int cmd = TrackPopupMenu(m, TPM_RETURNCMD | TPM_NONOTIFY, pt.x, pt.y, 0, owner, NULL);
+  DestroyMenu(m);
+  if (cmd > 0 && cmd <= (int)targets.size()) FindAllJump(handle, targets[cmd - 1].first, targets[cmd - 1].second);
+}
+
+void FindAllTick()
+{
+  if (!g_findAll.Pending() && !g_findAllMenuHandle) return;
+  g_findAll.Expire(ScriptNowMs());
+  if (!g_findAllMenuHandle) return;
+  std::string json;
+  const int st = g_findAll.Get(g_findAllMenuHandle, json);
+  if (st == 0) return;
+  const int h = g_findAllMenuHandle;
+  g_findAllMenuHandle = 0; // the menu runs a modal loop: ticks keep coming
+  if (st != -4) ShowFindAllMenu(h);
+}
+
+void FindAllShowMenuWhenDone(int handle)
+{
+  g_findAllMenuHandle = handle;
+}
+
+// Instance closed: its count script may never answer, the searches waiting for it finish without it
+void FindAllRelease(WebViewInstanceRecord* rec)
+{
+  if (rec && g_findAll.Pending()) g_findAll.DropInstance(rec->id, "instance closed", ScriptNowMs());
+}
+
+void FindAllAppendStatsJson(std::string& out)
+{
+  char buf[192];
+  snprintf(buf, sizeof(buf), "{\"searches\":%llu,\"panels\":%llu,\"timeouts\":%llu,\"avgMs\":%.1f,\"maxMs\":%llu,\"avgSequentialMs\":%.1f}",
+           g_findAll.Searches(), g_findAll.PanelsQueried(), g_findAll.Timeouts(), g_findAll.AvgTotalMs(), g_findAll.MaxTotalMs(), g_findAll.AvgPanelSumMs());
+  out += buf;
+}
@@ -26,11 +26,29 @@ extern const char* kDefaultURL;
 extern const char* kTitleBase;
 
 // STL headers required here because many translation units include only globals.h
+#include <string.h>
 #include <string>
 #include <unordered_map>
 #include <memory>
 #include <vector>
 
+// platform-neutral core (registry template, panel modes)
+#include "core/panel_mode.h"
+#include "core/instance_registry.h"
+#include "core/focus_chain.h"
+#include "core/hibernate_policy.h"
+#include "core/find_index.h"
+#include "core/state_stream.h"
+#include "core/video_bridge.h"
+#include "core/asset_bundle.h"
+#include "core/host_filter.h"
+#include "core/perf_stats.h"
+#include "core/shared_buffer.h"
+#include "core/script_queue.h"
+#include "core/panel_capture.h"
+#include "core/find_all.h"
+#include "core/startup_timeline.h"
+
 #ifdef _WIN32
   // Forward declare WebView2 interfaces (headers included elsewhere). We avoid including heavy WIL headers here
   // to keep this header lightweight and prevent duplicate symbol template issues. Implementation files that need
@@ -43,7 +61,7 @@ extern const char* kTitleBase;
     // extern wil::com_ptr<ICoreWebView2>           g_webview;
   extern HMODULE g_hWebView2Loader;
   extern bool   g_com_initialized;
-#else
+#elif defined(__APPLE__)
   // macOS: Objective-C forward declaration (используем @class чтобы не конфликтовать с фреймворком)
   #ifdef __OBJC__
     @class WKWebView;
@@ -52,6 +70,10 @@ extern const char* kTitleBase;
   #endif
   // Функция очистки наблюдателя заголовка (реализована в webview_darwin.mm)
   extern "C" void FRZ_RemoveTitleObserverFor(WKWebView* wv);
+#else
+  // Linux: opaque GTK/WebKitGTK types (full headers only in webview_gtk.cpp)
+  struct _GtkWidget;
+  struct _WebKitWebView;
 #endif
 
 // (deprecated globals for title caching removed; caching now per-instance)
@@ -64,7 +86,6 @@ extern std::string g_instanceId; // текущий активный id (для 
 extern std::string g_activeInstanceId;
 extern std::string g_lastFocusedInstanceId;
 extern std::string g_focusPrimaryInstanceId; // последний инстанс с реальным пользовательским фокусом (edit/webview)
-enum class ShowPanelMode { Unset, Hide, Docker, Always };
 
 // ================= Multi-instance support =================
 struct WebViewInstanceRecord {
@@ -73,6 +94,7 @@ struct WebViewInstanceRecord {
   // Monotonic timestamp (GetTickCount on Win / mach_absolute_time mapped on mac) of last real focus
   // Updated in UpdateFocusChain; used to resolve search target across multiple docks
   unsigned long lastFocusTick = 0;
+  bool hostVisible = false;       // macOS/Linux: kept current by show/hide notifications (OnInstanceHostVisibility), never polled
   std::string titleOverride;      // per-instance title override (defaults kTitleBase)
   ShowPanelMode panelMode = ShowPanelMode::Unset;
   std::string lastUrl;
@@ -81,6 +103,26 @@ struct WebViewInstanceRecord {
   int  wantDockOnCreate = -1;     // -1 unknown, 0 undock, 1 dock
   int  lastDockIdx = -1;
   bool lastDockFloat = false;
+  bool webViewDeferred = false;   // restored into a hidden dock tab: StartWebView runs on first show
+  // Hibernation of hidden panels (hibernate_glue.mm)
+  HibernateState hibernate = HibernateState::Active;
+  DWORD hiddenSinceTick = 0;      // 0 while visible
+  DWORD resumeStartTick = 0;      // set on resume, cleared once the page is back
+  int   lastResumeMs = -1;
+  int   suspendCount = 0, discardCount = 0, resumeCount = 0;
+  long long jsHeapBytes = -1;     // performance.memory.usedJSHeapSize (Chromium only), -1 unknown
+  DWORD jsHeapTick = 0;
+  int   restoreScrollX = -1, restoreScrollY = -1; // scroll snapshot, applied after a discarded page reloads
+  HibernateAction hibernatePending = HibernateAction::None; // probe script in flight (cleared on show)
+  StateStream stream;             // REAPER state subscription of the page (stream_glue.mm)
+  std::vector<std::unique_ptr<SharedBufferSlot>> sharedBuffers; // WEBVIEW_SharedBuffer*, published per timer tick
+  VideoLink video;                // video frame subscription of the page (video_glue.mm)
+  // Request filter (ContentFilter option, ContentFilterFor in filter_glue.mm)
+  std::string contentFilter = "default"; // list name, "" = off
+  bool contentFilterInstalled = false;   // the backend currently filters this view
+  unsigned long long filterChecked = 0, filterBlocked = 0;
+  double filterNs = 0;                   // total time spent in HostFilter::Check
+  InstanceStats stats;            // navigation/title/find/bridge counters (WEBVIEW_GetStats)
 #ifdef _WIN32
   ICoreWebView2Controller* controller = nullptr; // stored raw; lifetime managed in webview_win.cpp
   ICoreWebView2*           webview    = nullptr;
@@ -103,7 +145,7 @@ struct WebViewInstanceRecord {
   HBRUSH   titleBrush     = nullptr;
   COLORREF titleTextColor = RGB(0,0,0);
   COLORREF titleBkColor   = GetSysColor(COLOR_BTNFACE);
-#else
+#elif defined(__APPLE__)
   WKWebView* webView = nil;
   // Per-instance title bar (macOS)
   NSView*      titleBarView = nil;
@@ -113,6 +155,16 @@ struct WebViewInstanceRecord {
   int          titleTextColor = -1;
   int          titleBkColor   = -1;
   std::string  panelTitleString; // current displayed panel text (domain - pageTitle)
+#else
+  // Linux: WebKitWebView lives in a GtkPlug embedded into a SWELL X bridge child of hwnd
+  struct _WebKitWebView* webView = nullptr;
+  struct _GtkWidget*     gtkPlug = nullptr;
+  HWND         bridgeWnd = nullptr;
+  // Title bar is painted by the host dialog itself (no child window), same colors as mac
+  int          titleTextColor = -1;
+  int          titleBkColor   = -1;
+  bool         titleVisible   = false;
+  std::string  panelTitleString;
 #endif
   // Per-instance cached captions
   std::string lastTabTitle;
@@ -145,7 +197,7 @@ struct WebViewInstanceRecord {
   int bmpNextW = 0, bmpNextH = 0;
   bool prevHot=false, prevDown=false;
   bool nextHot=false, nextDown=false;
-#else
+#elif defined(__APPLE__)
   NSView* findBarView = nil;         // container view
   NSTextField* findEdit = nil;       // text input
   NSButton* findBtnPrev = nil;       // prev
@@ -154,10 +206,20 @@ struct WebViewInstanceRecord {
   NSButton* findChkHighlight = nil;  // highlight all checkbox
   NSTextField* findCounterLabel = nil; // n/N label
   NSButton* findBtnClose = nil;      // close button
+  FindIndex findIndex;               // page text snapshot for the JS highlight path (core/find_index.h)
+#else
+  // Linux: SWELL controls created directly on the host dialog (WM_COMMAND lands in WebViewDlgProc)
+  HWND findEdit = nullptr;
+  HWND findBtnPrev = nullptr;
+  HWND findBtnNext = nullptr;
+  HWND findChkCase = nullptr;
+  HWND findCounterStatic = nullptr;
+  HWND findBtnClose = nullptr;
+  int  findPendingSteps = 0;         // search_next (+1) / search_previous (-1) calls not yet answered by "found-text"
 #endif
 };
 
-extern std::unordered_map<std::string, std::unique_ptr<WebViewInstanceRecord>> g_instances; // id -> record
+extern InstanceRegistry<WebViewInstanceRecord> g_instances; // id -> record
 extern int g_randomInstanceCounter; // for random ids
 // Exported find navigation state (shared between main.mm and webview_win.cpp)
 #ifdef _WIN32
@@ -169,9 +231,16 @@ WebViewInstanceRecord* EnsureInstanceAndMaybeNavigate(const std::string& id, con
 std::string NormalizeInstanceId(const std::string& raw, bool* outWasRandom=nullptr);
 WebViewInstanceRecord* GetInstanceByHwnd(HWND hwnd);
 void PurgeDeadInstances();
-// Persistence stubs (no file IO yet)
+// Persistence: reaper_webview_state.bin in the resource dir (format in core/instance_state.h).
+// Changes only mark the snapshot dirty; the timer writes it once things settle (FlushInstanceStateIfDirty).
 void SaveInstanceStateAll();
 void LoadInstanceStateAll();
+void MarkInstanceStateDirty();
+void FlushInstanceStateIfDirty();
+void SnapshotInstanceState(WebViewInstanceRecord* rec); // re-encode one record now (before it is purged)
+void ForgetInstanceState(WebViewInstanceRecord* rec);   // drop its saved record (user closed a "random" panel)
+bool TakeRestorableInstanceIds(std::vector<std::string>& out); // instances open at last save, once per session
+extern bool g_restoringInstances; // set while restored windows are created: no activation, lazy StartWebView
 
 // dock-состояние (для инфо/refresh)
 extern int   g_last_dock_idx;
@@ -179,7 +248,7 @@ extern bool  g_last_dock_float;
 extern int   g_want_dock_on_create; // -1 unknown(first run), 0 undock, 1 dock (active instance hint)
 
 // Общие размеры панели (константы, не per-instance)
-#ifdef _WIN32
+#ifndef __APPLE__
 extern int      g_titleBarH;
 extern int      g_titlePadX;
 extern int      g_findBarH;
@@ -196,10 +265,125 @@ extern std::vector<std::unique_ptr<gaccel_register_t>> g_gaccels;
 
 // ====== функции, используемые из разных TU ======
 void UpdateTitlesExtractAndApply(HWND hwnd);
+// Deferred, coalesced variant: marks hwnd dirty, refreshed once on the next REAPER timer tick
+void RequestTitlesRefresh(HWND hwnd);
 void LayoutTitleBarAndWebView(HWND hwnd, bool titleVisible);
 void NavigateExisting(const std::string& url); // legacy single active instance navigation
 void NavigateExistingInstance(const std::string& instanceId, const std::string& url);
 // per-instance open/activate (creates window if missing)
-void OpenOrActivateInstance(const std::string& instanceId, const std::string& url);
+// refreshTitles=false skips the trailing title refresh request (caller refreshes once, e.g. WEBVIEW_Batch)
+void OpenOrActivateInstance(const std::string& instanceId, const std::string& url, bool refreshTitles = true);
+// Startup timeline (core/startup_timeline.h), kept in main.mm: each mark is taken the first time only
+void MarkStartup(StartupMark m);
+void StartupAppendJson(std::string& out);
+// Restored/discarded instance shown: creates its webview now (no-op unless rec->webViewDeferred)
+void StartDeferredWebView(HWND hwnd);
+
+// ====== subsystem glue (<name>_glue.mm) ======
+// Each subsystem runs from the REAPER timer (XxxTick, TitleRefreshTimer in main.mm) and drops the state of a
+// closing instance (XxxRelease, WM_DESTROY); XxxShutdown runs once at unload.
+
+// Hibernation (hibernate_glue.mm, core/hibernate_policy.h)
+void HibernateTick();
+void HibernateRelease(WebViewInstanceRecord* rec);
+void HibernateOnHostShown(HWND hwnd); // WM_SHOWWINDOW / WM_SIZE while visible
+// Page finished loading (backend navigation callbacks): restores the discard scroll snapshot, records resume latency
+void OnInstancePageLoaded(WebViewInstanceRecord* rec);
+
+// State stream (stream_glue.mm, core/state_stream.h)
+void StateStreamTick();
+void StateStreamRelease(WebViewInstanceRecord* rec);
+// Page -> plugin bridge messages other than the context menu ("SUB|topics|hz" state subscriptions,
+// "AUD|channels|outCh|rate" audio tap subscriptions, "VID|maxWidth|fps" / "VID|ack|seq" video frames)
+void OnPageBridgeMessage(WebViewInstanceRecord* rec, const std::string& msg);
+inline bool IsPageBridgeMessage(const char* s) { return s && (!strncmp(s, "SUB|", 4) || !strncmp(s, "AUD|", 4) || !strncmp(s, "VID|", 4)); }
+
+// Named float buffers shared with the page (shared_buffer_glue.mm, core/shared_buffer.h). Lock returns the data
+// area (capacity floats, grown on demand) or null; Commit publishes count floats on the next timer tick and
+// returns the new seq.
+float* SharedBufferLock(const std::string& id, const char* name, uint32_t capacity);
+int    SharedBufferCommit(const std::string& id, const char* name, uint32_t count);
+void   SharedBufferTick();
+void   SharedBufferRelease(WebViewInstanceRecord* rec);
+
+// WEBVIEW_ExecuteScript queue (script_queue_glue.mm, core/script_queue.h). Enqueue returns a handle or -1
+// (unknown instance, queue full); scripts of a closed instance finish as errors.
+int         ScriptEnqueue(const std::string& id, const std::string& js, const ScriptLimits& limits);
+ScriptState ScriptGetResult(int handle, std::string& out, bool consume);
+void        ScriptQueueTick();
+void        ScriptQueueRelease(WebViewInstanceRecord* rec);
+void        ScriptQueueAppendStatsJson(std::string& out);
+uint64_t    ScriptNowMs(); // clock of the script queue and find-all deadlines
+
+// WEBVIEW_Capture (capture_glue.mm, core/panel_capture.h). id or "*"; path is the file for one panel, the
+// directory for "*" (empty: <resource>/reaper_webview_captures). Returns a handle, -1 nothing to capture,
+// -2 too many in flight. Encoding runs on the capture worker: no tick.
+int         CaptureInstances(const std::string& id, const std::string& path, const CaptureOptions& opt);
+int         CaptureGetResult(int handle, std::string& json, bool consume);
+void        CaptureRelease(WebViewInstanceRecord* rec);
+void        CaptureShutdown(); // joins the encoder worker
+void        CaptureAppendStatsJson(std::string& out);
+
+// Find in all panels (find_all_glue.mm, core/find_all.h). Start returns a handle or -1 (no panel, too many
+// searches running); Jump activates the panel and selects hit `index` (1-based) of that search's query.
+int         FindAllStart(const std::string& query, const FindAllOptions& opt);
+int         FindAllGetResult(int handle, std::string& json);
+bool        FindAllJump(int handle, const std::string& id, int index);
+void        FindAllShowMenuWhenDone(int handle); // the action: hits menu once the search has finished
+void        FindAllTick();
+void        FindAllRelease(WebViewInstanceRecord* rec);
+void        FindAllAppendStatsJson(std::string& out);
+
+// Audio tap (audio_tap_glue.mm, core/audio_tap.h)
+void OnAudioTapMessage(WebViewInstanceRecord* rec, const std::string& msg); // "AUD|..."
+void AudioTapTick();
+void AudioTapRelease(WebViewInstanceRecord* rec);
+void AudioTapShutdown(); // before any window goes: no audio callback may outlive the tap
+void AudioTapAppendInstanceJson(WebViewInstanceRecord* rec, std::string& out);
+
+// Video source for subscribed panels (video_glue.mm, core/video_bridge.h): an IREAPERVideoProcessor*'s
+// process_frame is wrapped so its output also reaches the panels (null detaches), or frames are pushed directly (one
+// producer at a time). The processor is not owned: its creator must detach (nullptr) before destroying it.
+bool VideoAttachProcessor(void* videoProcessor);
+bool VideoPushFrame(const void* rgba, int w, int h, int rowspan);
+void OnVideoMessage(WebViewInstanceRecord* rec, const std::string& msg); // "VID|..."
+void VideoTick();
+void VideoRelease(WebViewInstanceRecord* rec);
+void VideoShutdown();
+void VideoAppendInstanceJson(WebViewInstanceRecord* rec, std::string& out);
+
+// rwv:// scheme handlers of every backend (asset_glue.mm, core/asset_bundle.h); main thread only
+void ServeAppAsset(const std::string& url, const char* ifNoneMatch, AssetReply& out);
+void AppAssetsShutdown(); // logs the serving counters
+// Request filter lists (filter_glue.mm, core/host_filter.h) under the REAPER resource path, compiled once and shared.
+// "default" is reaper_webview_filter.txt, other names are files in reaper_webview_filters/.
+struct ContentFilterList
+{
+  std::string name, path;
+  unsigned gen = 0;          // bumped on every (re)load; keys backend caches of compiled rule lists
+  HostFilter filter;
+  std::string rulesJson;     // WebKit content blocker JSON, built on first use (ContentFilterRulesJson)
+};
+// List in effect for the instance; null when off, or when the file is missing or has no rules
+ContentFilterList* ContentFilterFor(WebViewInstanceRecord* rec);
+const std::string& ContentFilterRulesJson(ContentFilterList* list);
+// "" off, "default" or a list name; reloads the file and re-applies it to a live view
+void SetInstanceContentFilter(WebViewInstanceRecord* rec, const std::string& list);
+// Checks one request URL for the instance (counted per instance); true = block it
+bool ContentFilterBlocks(WebViewInstanceRecord* rec, const char* url, size_t len);
+void ContentFilterAppendInstanceJson(WebViewInstanceRecord* rec, std::string& out);
+// Instance info and counters (stats_glue.mm)
+// One instance as a JSON object (state, hibernation counters, memory, resume latency); false if unknown id
+bool DescribeInstanceJson(const std::string& id, std::string& out);
+// Performance counters (core/perf_stats.h) of one instance, or {"instances":[...]} of all when id is empty
+bool DescribeInstanceStatsJson(const std::string& id, std::string& out);
+// Appends one CSV row per instance (header first when the file is new); rows written or -1
+int  DumpInstanceStatsCsv(const std::string& path);
 // focus chain updater
 void UpdateFocusChain(const std::string& inst);
+// Focus/visibility notifications of the backends (no polling). A focus event moves the instance to the head of
+// the focus chain and makes it active; a visibility event updates rec->hostVisible and re-resolves the active
+// instance (ResolveActiveOnVisibility in core/focus_chain.h).
+void OnInstanceFocusEvent(WebViewInstanceRecord* rec, const char* reason);
+void OnInstanceHostVisibility(WebViewInstanceRecord* rec, bool visible, const char* reason);
+extern FocusEventCounters g_focusEvents;
@@ -8,6 +8,10 @@
 #include "globals.h"
 #include "helpers.h"
 #include "log.h"
+#include "core/instance_ids.h"
+#include "core/instance_state.h"
+
+#include <map>
 
 REAPER_PLUGIN_HINSTANCE g_hInst = nullptr;
 HWND   g_hwndParent = nullptr;
@@ -34,10 +38,10 @@ int  g_last_dock_idx        = -1;
 bool g_last_dock_float      = false;
 int  g_want_dock_on_create  = -1;
 
-#ifdef _WIN32
+#ifndef __APPLE__
 int      g_titleBarH       = 24;  // фикс, без привязки к DPI
 int      g_titlePadX       = 8;
-int      g_findBarH        = 30;  // find bar height (Windows)
+int      g_findBarH        = 30;  // find bar height (Windows / Linux)
 #else
 CGFloat      g_titleBarH    = 24.0;
 CGFloat      g_titlePadX    = 8.0;
@@ -49,39 +53,25 @@ std::unordered_map<int, CommandHandler>  g_cmd_handlers;
 std::vector<std::unique_ptr<gaccel_register_t>> g_gaccels;
 
 // ================= Multi-instance runtime storage =================
-std::unordered_map<std::string, std::unique_ptr<WebViewInstanceRecord>> g_instances;
+InstanceRegistry<WebViewInstanceRecord> g_instances;
 int g_randomInstanceCounter = 0;
 
 WebViewInstanceRecord* GetInstanceById(const std::string& id)
 {
-	auto it = g_instances.find(id);
-	return it == g_instances.end() ? nullptr : it->second.get();
+	return g_instances.Find(id);
 }
 
 WebViewInstanceRecord* GetInstanceByHwnd(HWND hwnd)
 {
-	if (!hwnd) return nullptr;
-	for (auto &kv : g_instances) {
-		if (kv.second && kv.second->hwnd == hwnd) return kv.second.get();
-	}
-	return nullptr;
+	return g_instances.FindByHwnd(hwnd);
 }
 
 std::string NormalizeInstanceId(const std::string& raw, bool* outWasRandom)
 {
-	if (outWasRandom) *outWasRandom = false;
-	if (raw.empty()) return "wv_default";
-
-	if (raw == "random") {
-		if (outWasRandom) *outWasRandom = true;
-		++g_randomInstanceCounter;
-		char buf[64]; snprintf(buf, sizeof(buf), "wv_%d", g_randomInstanceCounter);
-		return buf;
-	}
-
-	// Правило: пользователь обязан передать id, начинающийся с wv_. Если не так — игнор и default.
-	if (raw.rfind("wv_", 0) != 0) return "wv_default";
-	return raw;
+	std::string id = NormalizeInstanceIdWith(raw, g_randomInstanceCounter, outWasRandom);
+	// "random" must give a new panel: skip ids still held by a record (restored, or passed explicitly)
+	while (raw == "random" && GetInstanceById(id)) id = NormalizeInstanceIdWith(raw, g_randomInstanceCounter);
+	return id;
 }
 
 WebViewInstanceRecord* EnsureInstanceAndMaybeNavigate(const std::string& id, const std::string& url, bool navigate, const std::string& newTitle, ShowPanelMode newMode)
@@ -107,51 +97,174 @@ WebViewInstanceRecord* EnsureInstanceAndMaybeNavigate(const std::string& id, con
 		} else {
 			ptr->titleOverride = kTitleBase;
 		}
-		rec = ptr.get();
-		g_instances[id] = std::move(ptr);
+		rec = g_instances.Insert(id, std::move(ptr));
+		MarkInstanceStateDirty();
 	}
 	// Apply changes
 	// Не сбрасываем кастомный заголовок обратно на kTitleBase если SetTitle не пришёл.
 	if (!newTitle.empty()) rec->titleOverride = newTitle;
 	if (newMode != ShowPanelMode::Unset) rec->panelMode = newMode;
 	if (navigate && !url.empty()) rec->lastUrl = url; // actual navigation performed elsewhere for now
+	if (!newTitle.empty() || newMode != ShowPanelMode::Unset || (navigate && !url.empty())) MarkInstanceStateDirty();
 	return rec;
 }
 
 void PurgeDeadInstances()
 {
-	for (auto it = g_instances.begin(); it != g_instances.end(); ) {
-		WebViewInstanceRecord* r = it->second.get();
+	g_instances.PurgeIf(
+		[](WebViewInstanceRecord* r) {
 #ifdef _WIN32
-		const bool dead = (!r->hwnd || !IsWindow(r->hwnd)) && r->controller==nullptr && r->webview==nullptr;
+			return (!r->hwnd || !IsWindow(r->hwnd)) && r->controller==nullptr && r->webview==nullptr;
+#elif defined(__APPLE__)
+			return (!r->hwnd) && r->webView==nil;
 #else
-		const bool dead = (!r->hwnd) && r->webView==nil;
+			return (!r->hwnd) && r->webView==nullptr;
 #endif
-		if (dead) {
-			LogF("[InstancePurge] removing dead record id='%s'", it->first.c_str());
-#ifndef _WIN32
+		},
+		[](WebViewInstanceRecord* r) {
+			LogF("[InstancePurge] removing dead record id='%s'", r->id.c_str());
+#ifdef __APPLE__
 			// Снятие KVO наблюдателя теперь инкапсулировано
 			if (r->webView) FRZ_RemoveTitleObserverFor(r->webView);
 #endif
-			it = g_instances.erase(it);
-		} else ++it;
-	}
+		});
+}
+
+// ================= Persistence =================
+// id -> encoded record. Outlives the records themselves: an instance purged because REAPER destroyed its
+// dock on shutdown keeps its last "open" snapshot, while a user close re-encodes it first (wasOpen=false).
+// A "random" panel (wv_<N>) closed by the user is forgotten instead: nothing can ask for that id again.
+static std::map<std::string, std::string> g_stateBlobs;
+static bool  g_stateDirty = false;
+static DWORD g_stateDirtyTick = 0;
+static bool  g_stateFileCurrent = false; // file on disk matches g_stateBlobs
+static std::vector<std::string> g_restoreIds;
+bool g_restoringInstances = false;
+
+static const DWORD kStateFlushDelayMs = 1500; // settle time after the last change
+
+static std::string StateFilePath()
+{
+	const char* res = GetResourcePath ? GetResourcePath() : nullptr;
+	if (!res || !*res) return std::string();
+#ifdef _WIN32
+	return std::string(res) + "\\reaper_webview_state.bin";
+#else
+	return std::string(res) + "/reaper_webview_state.bin";
+#endif
+}
+
+static FILE* OpenStateFile(const std::string& path, const char* mode)
+{
+#ifdef _WIN32
+	return _wfopen(Widen(path).c_str(), Widen(mode).c_str());
+#else
+	return fopen(path.c_str(), mode);
+#endif
+}
+
+static bool EncodeIntoBlobs(WebViewInstanceRecord* r)
+{
+	PersistedInstance pi;
+	pi.id = r->id; pi.lastUrl = r->lastUrl; pi.titleOverride = r->titleOverride; pi.findQuery = r->findQuery;
+	pi.panelMode = (int)r->panelMode; pi.wantDockOnCreate = r->wantDockOnCreate; pi.lastDockIdx = r->lastDockIdx;
+	pi.lastDockFloat = r->lastDockFloat; pi.basicCtxMenu = r->basicCtxMenu; pi.findCaseSensitive = r->findCaseSensitive;
+	pi.contentFilter = r->contentFilter;
+	pi.wasOpen = r->hwnd && IsWindow(r->hwnd);
+	std::string enc; EncodeInstanceRecord(pi, enc);
+	std::string& slot = g_stateBlobs[r->id];
+	if (slot == enc) return false;
+	slot.swap(enc);
+	return true;
+}
+
+void MarkInstanceStateDirty()
+{
+	if (!g_stateDirty) g_stateDirtyTick = GetTickCount();
+	g_stateDirty = true;
+}
+
+void SnapshotInstanceState(WebViewInstanceRecord* rec)
+{
+	if (rec && EncodeIntoBlobs(rec)) { g_stateFileCurrent = false; MarkInstanceStateDirty(); }
+}
+
+void ForgetInstanceState(WebViewInstanceRecord* rec)
+{
+	if (rec && g_stateBlobs.erase(rec->id)) { g_stateFileCurrent = false; MarkInstanceStateDirty(); }
+}
+
+void FlushInstanceStateIfDirty()
+{
+	if (!g_stateDirty || (DWORD)(GetTickCount() - g_stateDirtyTick) < kStateFlushDelayMs) return;
+	SaveInstanceStateAll();
 }
 
 void SaveInstanceStateAll()
 {
-	LogRaw("[PersistStub] SaveInstanceStateAll begin");
-	for (auto &kv : g_instances) {
-		WebViewInstanceRecord* r = kv.second.get();
-		if (!r) continue;
-		LogF("[PersistStub] id='%s' hwnd=%p title='%s' panelMode=%d wantDock=%d lastUrl='%s' dockIdx=%d float=%d",
-			kv.first.c_str(), (void*)r->hwnd, r->titleOverride.c_str(), (int)r->panelMode, r->wantDockOnCreate,
-			r->lastUrl.c_str(), r->lastDockIdx, (int)r->lastDockFloat);
-	}
-	LogRaw("[PersistStub] SaveInstanceStateAll end");
+	g_stateDirty = false;
+	size_t changed = 0;
+	for (auto &kv : g_instances) if (kv.second && EncodeIntoBlobs(kv.second.get())) ++changed;
+	if (!changed && g_stateFileCurrent) return; // nothing new since the last write
+
+	const std::string path = StateFilePath();
+	if (path.empty()) { LogRaw("[Persist] no resource path, state not saved"); return; }
+	std::vector<const std::string*> recs; recs.reserve(g_stateBlobs.size());
+	for (auto &kv : g_stateBlobs) recs.push_back(&kv.second);
+	std::string snap; BuildStateSnapshot(recs, snap);
+
+	// write-then-rename so a crash mid-write never leaves a truncated snapshot behind
+	const std::string tmp = path + ".tmp";
+	FILE* f = OpenStateFile(tmp, "wb");
+	if (!f) { LogF("[Persist] cannot open '%s' for writing", tmp.c_str()); return; }
+	const bool ok = fwrite(snap.data(), 1, snap.size(), f) == snap.size();
+	fclose(f);
+#ifdef _WIN32
+	const bool moved = ok && MoveFileExW(Widen(tmp).c_str(), Widen(path).c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+	const bool moved = ok && rename(tmp.c_str(), path.c_str()) == 0;
+#endif
+	if (!moved) { LogF("[Persist] write failed for '%s'", path.c_str()); return; }
+	g_stateFileCurrent = true;
+	LogF("[Persist] saved %zu record(s) (%zu changed) %zu bytes", recs.size(), changed, snap.size());
 }
 
 void LoadInstanceStateAll()
 {
-	LogRaw("[PersistStub] LoadInstanceStateAll (noop stub)");
+	const std::string path = StateFilePath();
+	FILE* f = path.empty() ? nullptr : OpenStateFile(path, "rb");
+	if (!f) { LogRaw("[Persist] no saved state"); return; }
+	std::string data;
+	char buf[16384]; size_t n;
+	while ((n = fread(buf, 1, sizeof(buf), f)) > 0) data.append(buf, n);
+	fclose(f);
+
+	std::vector<PersistedInstance> list;
+	const bool ok = ParseStateSnapshot(data.data(), data.size(), list);
+	if (!ok) LogF("[Persist] state file damaged, %zu record(s) recovered", list.size());
+	size_t dropped = 0;
+	for (const PersistedInstance& pi : list) {
+		if (pi.id.rfind("wv_", 0) != 0 || GetInstanceById(pi.id)) continue;
+		if (!pi.wasOpen && RandomInstanceNumber(pi.id)) { ++dropped; continue; } // closed random panel (older files kept them)
+		auto ptr = std::make_unique<WebViewInstanceRecord>();
+		ptr->id = pi.id; ptr->lastUrl = pi.lastUrl; ptr->titleOverride = pi.titleOverride.empty() ? kTitleBase : pi.titleOverride;
+		ptr->findQuery = pi.findQuery; ptr->findCaseSensitive = pi.findCaseSensitive;
+		ptr->panelMode = (pi.panelMode >= 0 && pi.panelMode <= (int)ShowPanelMode::Always) ? (ShowPanelMode)pi.panelMode : ShowPanelMode::Unset;
+		ptr->wantDockOnCreate = pi.wantDockOnCreate; ptr->lastDockIdx = pi.lastDockIdx; ptr->lastDockFloat = pi.lastDockFloat;
+		ptr->basicCtxMenu = pi.basicCtxMenu; ptr->contentFilter = pi.contentFilter;
+		WebViewInstanceRecord* rec = g_instances.Insert(pi.id, std::move(ptr));
+		EncodeIntoBlobs(rec); // seeds the cache: an unchanged session does not rewrite the file
+		const int n = RandomInstanceNumber(pi.id);
+		if (n > g_randomInstanceCounter) g_randomInstanceCounter = n; // next "random" id is past every restored one
+		if (pi.wasOpen) g_restoreIds.push_back(pi.id);
+	}
+	g_stateFileCurrent = ok && !dropped;
+	LogF("[Persist] loaded %zu record(s), %zu to reopen, %zu closed random dropped", list.size(), g_restoreIds.size(), dropped);
+}
+
+bool TakeRestorableInstanceIds(std::vector<std::string>& out)
+{
+	if (g_restoreIds.empty()) return false;
+	out.swap(g_restoreIds); g_restoreIds.clear();
+	return true;
 }
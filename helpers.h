@@ -13,7 +13,6 @@ std::wstring Widen(const std::string& s);
 std::string  Narrow(const std::wstring& w);
 #endif
 
-std::string ExtractDomainFromUrl(const std::string& url);
 void SetWndText(HWND hwnd, const std::string& s);
 void SaveDockState(HWND hwnd);
 void SetTabTitleInplace(HWND hwnd, const std::string& tabCaption);
@@ -25,25 +24,19 @@ void SafePluginRegisterNull(const char* name);
 
 void PlatformMakeTopLevel(HWND hwnd);
 
-// tiny JSON helpers (реализация в helpers.mm)
+// "0"/""/NULL -> false (opts placeholder); option values are parsed by core/nav_options
 bool is_truthy(const char* s);
-std::string GetJsonString(const char* json, const char* key);
-ShowPanelMode ParseShowPanel(const std::string& v);
-
-// ================= URL normalization =================
-// Normalize a user-entered URL:
-//  - Trim spaces.
-//  - If it has an http/https/file/about/data/mailto/... scheme, returns as-is.
-//  - If it has another explicit scheme (e.g. spotify:, steam://), returns empty in outNormalized
-//    and sets *outExternal to original (caller should open externally via ShellExecute / NSWorkspace).
-//  - If it has no scheme, prefix with "https://".
-// Returns true if navigation should proceed in embedded webview (outNormalized valid),
-// false if should dispatch externally (outExternal filled) or input invalid.
-// outReason may contain brief diagnostic for logging.
-bool NormalizeOrDispatchURL(const std::string& input,
-							std::string& outNormalized,
-							std::string& outExternal,
-							std::string& outReason);
+
+// Hidden browsers kept pre-created for new instances (Windows controllers / Linux web views).
+// REAPER ext-state reaper_webview/WebViewPool, 0..4 (0 disables), default 1; read once per session.
+int GetWebViewPoolTarget();
+
+// Idle policy for hidden panels, ext-state reaper_webview/HibernateSuspendSec (default 60) and
+// HibernateDiscardSec (default 0 on Windows, 600 elsewhere); 0 disables the stage. Read once per session.
+HibernatePolicy GetHibernatePolicy();
+
+// URL normalization / domain extraction live in the platform-neutral core
+#include "core/url_utils.h"
 
 // ================= Theme color helpers for panels =================
 #ifdef _WIN32
@@ -9,6 +9,7 @@
 #include "predef.h"
 #include "helpers.h"
 #include "log.h"
+#include "webview.h" // WebViewCanSuspend
 
 #ifdef _WIN32
 void GetPanelThemeColors(HWND panelHwnd, HDC dc, COLORREF* outBk, COLORREF* outTx)
@@ -133,48 +134,6 @@ static const char* strcasestr(const char* haystack, const char* needle)
   #include <strings.h>
 #endif
 
-static inline std::string ToLower(std::string s)
-{
-  for (auto& c : s) c = (char)std::tolower((unsigned char)c);
-  return s;
-}
-
-// host[:port] (порт скрыть если http:80 / https:443)
-std::string ExtractDomainFromUrl(const std::string& url)
-{
-  if (url.empty()) return {};
-  size_t scheme_end = url.find("://");
-  std::string scheme; size_t host_start = 0;
-  if (scheme_end != std::string::npos) { scheme = url.substr(0, scheme_end); host_start = scheme_end + 3; }
-  std::string scheme_l = ToLower(scheme);
-
-  size_t end = url.find_first_of("/?#", host_start);
-  std::string hostport = url.substr(host_start, (end == std::string::npos) ? std::string::npos : (end - host_start));
-
-  size_t at = hostport.rfind('@');
-  if (at != std::string::npos) hostport = hostport.substr(at + 1);
-
-  std::string host = hostport, port_str;
-  if (!hostport.empty() && hostport[0] == '[') {
-    size_t rb = hostport.find(']');
-    if (rb != std::string::npos) {
-      host = hostport.substr(0, rb + 1);
-      if (rb + 1 < hostport.size() && hostport[rb + 1] == ':') port_str = hostport.substr(rb + 2);
-    }
-  } else {
-    size_t colon = hostport.rfind(':');
-    if (colon != std::string::npos) { host = hostport.substr(0, colon); port_str = hostport.substr(colon + 1); }
-  }
-  if (!host.empty() && host[0] != '[' && host.rfind("www.", 0) == 0) host = host.substr(4);
-
-  bool drop_port = false;
-  if (!port_str.empty()) {
-    int p = 0; for (char c : port_str) { if (c < '0' || c > '9') { p = -1; break; } p = p * 10 + (c - '0'); }
-    if (p > 0 && ((scheme_l == "http" && p == 80) || (scheme_l == "https" && p == 443))) drop_port = true;
-  }
-  return drop_port || port_str.empty() ? host : (host + ":" + port_str);
-}
-
 void SetWndText(HWND hwnd, const std::string& s)
 {
   WebViewInstanceRecord* rec = GetInstanceByHwnd(hwnd);
@@ -288,92 +247,43 @@ void PlatformMakeTopLevel(HWND hwnd)
 #endif
 }
 
-// --- tiny helpers for JSON-ish opts (string values only)
+// --- opts placeholder check ("0" / empty means "no options")
 bool is_truthy(const char* s) { return s && *s && !(s[0] == '0' && s[1] == '\0'); }
 
-// Extracts "Key":"Value" from a flat JSON object string, tolerant to spaces.
-// Returns empty string if key not found.
-std::string GetJsonString(const char* json, const char* key)
+int GetWebViewPoolTarget()
 {
-  if (!json || !*json) return {};
-  const char* p = json;
-  std::string pat = "\""; pat += key; pat += "\"";
-  const char* k = strcasestr(p, pat.c_str());
-  if (!k) return {};
-  const char* c = std::strchr(k, ':'); if (!c) return {};
-  while (*c && (*c == ':' || *c == ' ' || *c == '\t')) ++c;
-
-  std::string out;
-  if (*c == '\"') {
-    ++c;
-    while (*c && *c != '\"') { out.push_back(*c); ++c; }
-  } else {
-    while (*c && *c != ',' && *c != '}') { out.push_back(*c); ++c; }
-    while (!out.empty() && std::isspace((unsigned char)out.back())) out.pop_back();
+  static int s_target = -1;
+  if (s_target < 0) {
+    const char* v = GetExtState ? GetExtState("reaper_webview", "WebViewPool") : nullptr;
+    s_target = (v && *v) ? atoi(v) : 1;
+    if (s_target < 0) s_target = 0; else if (s_target > 4) s_target = 4;
+    LogF("[Pool] target=%d", s_target);
   }
-  size_t i = 0; while (i < out.size() && std::isspace((unsigned char)out[i])) ++i;
-  return out.substr(i);
+  return s_target;
 }
 
-ShowPanelMode ParseShowPanel(const std::string& v)
+static unsigned ReadSecondsExtState(const char* key, unsigned defSec)
 {
-  if (v.empty()) return ShowPanelMode::Unset;
-  #ifdef _WIN32
-    if (!_stricmp(v.c_str(), "hide"))   return ShowPanelMode::Hide;
-    if (!_stricmp(v.c_str(), "docker")) return ShowPanelMode::Docker;
-    if (!_stricmp(v.c_str(), "always")) return ShowPanelMode::Always;
-  #else
-    if (!strcasecmp(v.c_str(), "hide"))   return ShowPanelMode::Hide;
-    if (!strcasecmp(v.c_str(), "docker")) return ShowPanelMode::Docker;
-    if (!strcasecmp(v.c_str(), "always")) return ShowPanelMode::Always;
-  #endif
-  return ShowPanelMode::Unset;
+  const char* v = GetExtState ? GetExtState("reaper_webview", key) : nullptr;
+  if (!v || !*v) return defSec;
+  const int n = atoi(v);
+  return n > 0 ? (unsigned)n : 0;
 }
 
-// -----------------------------------------------------
-// URL normalization / external dispatch decision
-// -----------------------------------------------------
-static inline bool HasScheme(const std::string& s)
+HibernatePolicy GetHibernatePolicy()
 {
-  // scheme = ALPHA *( ALPHA / DIGIT / "+" / "-" / "." ) ':'
-  size_t i=0; if (s.empty() || !std::isalpha((unsigned char)s[0])) return false;
-  for (i=1;i<s.size();++i) {
-    char c=s[i];
-    if (c==':') return i>0; // found scheme
-    if (!(std::isalnum((unsigned char)c) || c=='+' || c=='-' || c=='.')) return false;
-  }
-  return false;
-}
-
-bool NormalizeOrDispatchURL(const std::string& input,
-                            std::string& outNormalized,
-                            std::string& outExternal,
-                            std::string& outReason)
-{
-  outNormalized.clear(); outExternal.clear(); outReason.clear();
-  if (input.empty()) { outReason="empty"; return false; }
-  // Trim spaces
-  size_t a=0,b=input.size(); while(a<b && std::isspace((unsigned char)input[a])) ++a; while(b>a && std::isspace((unsigned char)input[b-1])) --b; std::string s=input.substr(a,b-a);
-  if (s.empty()) { outReason="all_whitespace"; return false; }
-  // Quick reject of lone placeholder
-  if (s=="https://" || s=="http://") { outReason="placeholder_only"; return false; }
-
-  // Detect scheme
-  if (HasScheme(s)) {
-    // Lowercase scheme portion for comparison
-    size_t colon = s.find(':');
-    std::string scheme; scheme.reserve(colon);
-    for (size_t i=0;i<colon;i++) scheme.push_back((char)std::tolower((unsigned char)s[i]));
-    // Schemes we allow to embed
-    static const char* kEmbedSchemes[] = { "http", "https", "file", "about", "data" };
-    bool embed=false; for (auto ks : kEmbedSchemes) { if (scheme == ks) { embed=true; break; } }
-    if (embed) { outNormalized = s; outReason="embed_scheme"; return true; }
-    // mailto and others -> external
-    outExternal = s; outReason = "external_scheme:" + scheme; return false;
+  static bool s_read = false; static HibernatePolicy s_p;
+  if (!s_read) {
+    s_read = true;
+#ifdef _WIN32
+    const unsigned defDiscard = 0;   // TrySuspend keeps the page; discard only on request
+#else
+    const unsigned defDiscard = 600; // no suspend API on WKWebView/WebKitGTK
+#endif
+    s_p.suspendAfterMs = ReadSecondsExtState("HibernateSuspendSec", 60) * 1000u;
+    s_p.discardAfterMs = ReadSecondsExtState("HibernateDiscardSec", defDiscard) * 1000u;
+    s_p.canSuspend = WebViewCanSuspend();
+    LogF("[Hibernate] policy suspend=%us discard=%us canSuspend=%d", s_p.suspendAfterMs / 1000u, s_p.discardAfterMs / 1000u, (int)s_p.canSuspend);
   }
-
-  // No scheme: treat as host/path; simple heuristic: if contains space -> invalid
-  if (s.find(' ') != std::string::npos) { outReason="space_in_url"; return false; }
-  // Prefix https://
-  outNormalized = std::string("https://") + s; outReason="prefixed_https"; return true;
+  return s_p;
 }
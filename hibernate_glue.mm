@@ -0,0 +1,163 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// hibernate_glue.mm
+#include "predef.h"
+#include "globals.h"
+#include "helpers.h"
+#include "log.h"
+#include "webview.h"
+#include "core/json_cursor.h"
+
+// ============================== Hibernation ==============================
+// Hidden panels are suspended (WebView2 TrySuspend) and, after a longer idle, discarded: the browser is
+// dropped with URL + scroll kept, and the page reloads on the next show. Policy: GetHibernatePolicy().
+static const DWORD kHibernateTickMs = 1000;
+static const DWORD kHeapSampleMs = 10000;
+
+// Current URL/scroll and whether any media element is audible; run before each suspend/discard
+static const char* kHibernateProbeJS =
+  "(function(){var p=false;try{var m=document.querySelectorAll('audio,video');"
+  "for(var i=0;i<m.length;i++){if(!m[i].paused&&!m[i].muted&&m[i].volume>0){p=true;break;}}}catch(_){}"
+  "return JSON.stringify({x:Math.round(window.scrollX||0),y:Math.round(window.scrollY||0),playing:p,url:location.href});})()";
+static const char* kHeapProbeJS =
+  "(function(){try{return String(performance.memory.usedJSHeapSize);}catch(_){return '-1';}})()";
+
+static void DiscardInstanceView(WebViewInstanceRecord* rec)
+{
+  WebViewDestroyView(rec);
+  rec->hibernate = HibernateState::Discarded;
+  rec->webViewDeferred = true; // StartDeferredWebView recreates it on show
+  rec->jsHeapBytes = 0;
+  rec->discardCount++;
+  LogF("[Hibernate] id='%s' discarded url='%s' scroll=%d,%d", rec->id.c_str(), rec->lastUrl.c_str(), rec->restoreScrollX, rec->restoreScrollY);
+}
+
+static void OnHibernateProbe(const std::string& id, const std::string& result)
+{
+  WebViewInstanceRecord* rec = GetInstanceById(id);
+  if (!rec) return;
+  const HibernateAction act = rec->hibernatePending;
+  rec->hibernatePending = HibernateAction::None;
+  if (act == HibernateAction::None || !rec->hwnd || !IsWindow(rec->hwnd) || IsWindowVisible(rec->hwnd)) return; // shown meanwhile
+
+  int x = 0, y = 0; bool playing = false; std::string url;
+  JsonCursor c(result.data(), result.size()); JsonValue k, v;
+  if (c.EnterObject()) while (c.NextKey(k)) {
+    if (!c.ReadValue(v)) break;
+    if (v.type == JsonType::Object || v.type == JsonType::Array) { c.SkipValue(); continue; }
+    std::vector<char> buf(v.len + 1); JsonCopyString(v, buf.data(), buf.size());
+    if (JsonKeyEquals(k, "x")) x = atoi(buf.data());
+    else if (JsonKeyEquals(k, "y")) y = atoi(buf.data());
+    else if (JsonKeyEquals(k, "playing")) playing = JsonIsTruthy(v);
+    else if (JsonKeyEquals(k, "url")) url = buf.data();
+  }
+  if (playing) { rec->hiddenSinceTick = GetTickCount(); LogF("[Hibernate] id='%s' playing media, postponed", rec->id.c_str()); return; }
+  rec->restoreScrollX = x; rec->restoreScrollY = y;
+  if (!url.empty() && url != "about:blank" && url != rec->lastUrl) { rec->lastUrl = url; MarkInstanceStateDirty(); }
+
+  if (act == HibernateAction::Discard) { DiscardInstanceView(rec); return; }
+  if (WebViewSuspend(rec)) {
+    rec->hibernate = HibernateState::Suspended; rec->suspendCount++;
+    LogF("[Hibernate] id='%s' suspended", rec->id.c_str());
+  } else {
+    rec->hiddenSinceTick = GetTickCount(); // backend refused: retry after another full idle period
+  }
+}
+
+static void OnHeapSample(const std::string& id, const std::string& result)
+{
+  if (WebViewInstanceRecord* rec = GetInstanceById(id))
+    if (rec->hibernate == HibernateState::Active) rec->jsHeapBytes = result.empty() ? -1 : strtoll(result.c_str(), nullptr, 10);
+}
+
+static void OnResumeRoundTrip(const std::string& id, const std::string&)
+{
+  WebViewInstanceRecord* rec = GetInstanceById(id);
+  if (!rec || !rec->resumeStartTick) return;
+  rec->lastResumeMs = (int)(GetTickCount() - rec->resumeStartTick); rec->resumeStartTick = 0;
+  LogF("[Hibernate] id='%s' resumed in %d ms", rec->id.c_str(), rec->lastResumeMs);
+}
+
+static void ResumeHibernatedInstance(WebViewInstanceRecord* rec)
+{
+  const HibernateState was = rec->hibernate;
+  rec->hibernate = HibernateState::Active;
+  rec->resumeCount++;
+  rec->resumeStartTick = GetTickCount(); if (!rec->resumeStartTick) rec->resumeStartTick = 1;
+  rec->jsHeapTick = 0; // resample soon
+  if (was == HibernateState::Suspended) {
+    rec->restoreScrollX = rec->restoreScrollY = -1; // page was kept, nothing to restore
+    WebViewResume(rec);
+    WebViewEvalScript(rec, "1", OnResumeRoundTrip); // first script answered = page is live again
+  } else if (rec->hwnd) {
+    LogF("[Hibernate] id='%s' reloading discarded page", rec->id.c_str());
+    StartDeferredWebView(rec->hwnd); // latency recorded in OnInstancePageLoaded
+  }
+}
+
+void HibernateOnHostShown(HWND hwnd)
+{
+  WebViewInstanceRecord* rec = GetInstanceByHwnd(hwnd);
+  if (!rec) return;
+  MarkStartup(StartupMark::FirstPanelShown);
+  rec->hiddenSinceTick = 0;
+  rec->hibernatePending = HibernateAction::None; // a probe in flight is void now
+  if (rec->hibernate != HibernateState::Active) ResumeHibernatedInstance(rec);
+  else StartDeferredWebView(hwnd);
+}
+
+void OnInstancePageLoaded(WebViewInstanceRecord* rec)
+{
+  if (!rec) return;
+  MarkStartup(StartupMark::FirstPageLoaded);
+  rec->stats.NavFinished(PerfNowUs(), true);
+  if (rec->restoreScrollX > 0 || rec->restoreScrollY > 0) {
+    char js[96]; snprintf(js, sizeof(js), "window.scrollTo(%d,%d);", rec->restoreScrollX > 0 ? rec->restoreScrollX : 0, rec->restoreScrollY > 0 ? rec->restoreScrollY : 0);
+    WebViewEvalScript(rec, js, nullptr);
+  }
+  rec->restoreScrollX = rec->restoreScrollY = -1;
+  for (auto& s : rec->sharedBuffers) { s->attached = false; s->dirty = s->Count() > 0; } // new document: re-send
+  if (rec->resumeStartTick) {
+    rec->lastResumeMs = (int)(GetTickCount() - rec->resumeStartTick); rec->resumeStartTick = 0;
+    LogF("[Hibernate] id='%s' reloaded in %d ms", rec->id.c_str(), rec->lastResumeMs);
+  }
+}
+
+void HibernateTick()
+{
+  static DWORD s_last = 0;
+  const DWORD now = GetTickCount();
+  if (s_last && now - s_last < kHibernateTickMs) return;
+  s_last = now;
+  const HibernatePolicy pol = GetHibernatePolicy();
+  for (auto& kv : g_instances) {
+    WebViewInstanceRecord* rec = kv.second.get();
+    if (!rec || !rec->hwnd || !IsWindow(rec->hwnd)) continue;
+    const bool visible = IsWindowVisible(rec->hwnd) != 0;
+    if (visible) rec->hiddenSinceTick = 0;
+    else if (!rec->hiddenSinceTick) rec->hiddenSinceTick = now ? now : 1;
+    if (rec->hibernatePending != HibernateAction::None) continue;
+    if (rec->hibernate == HibernateState::Active && !WebViewHasView(rec)) continue; // deferred restore / still creating
+
+    const unsigned hiddenMs = visible ? 0u : (unsigned)(now - rec->hiddenSinceTick);
+    const HibernateAction act = DecideHibernate(rec->hibernate, visible, hiddenMs, WebViewIsPlayingAudio(rec), pol);
+    if (act == HibernateAction::Resume) ResumeHibernatedInstance(rec); // shown without WM_SHOWWINDOW (reparent)
+    else if (act == HibernateAction::Discard && rec->hibernate == HibernateState::Suspended) DiscardInstanceView(rec); // snapshot taken at suspend
+    else if (act != HibernateAction::None) { rec->hibernatePending = act; WebViewEvalScript(rec, kHibernateProbeJS, OnHibernateProbe); }
+    else if (visible && rec->hibernate == HibernateState::Active && now - rec->jsHeapTick >= kHeapSampleMs) {
+      rec->jsHeapTick = now; WebViewEvalScript(rec, kHeapProbeJS, OnHeapSample);
+    }
+  }
+}
+
+// Instance closed: a reopened window starts its page in WM_INITDIALOG, it is not a resume of a discarded one
+void HibernateRelease(WebViewInstanceRecord* rec)
+{
+  if (!rec) return;
+  rec->hibernate = HibernateState::Active;
+  rec->webViewDeferred = false;
+  rec->hibernatePending = HibernateAction::None;
+  rec->hiddenSinceTick = rec->resumeStartTick = 0;
+  rec->jsHeapBytes = -1; rec->jsHeapTick = 0;
+}
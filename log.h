@@ -2,86 +2,143 @@
 // (c) Andrew "SadFrozz" Brodsky
 // 2025 and later
 // log.h — единый кроссплатформенный логгер (header-only)
+// Lines go through core/log_ring: the caller only filters, formats into a stack buffer and claims a ring
+// slot; a writer thread stamps, batches and appends them to reaper_webview_log.txt (rotated by size).
+// Run-time settings (ext-state reaper_webview, re-read by LogTick): LogLevel debug|info|warn|error|off,
+// LogTags "Find,Focus" / "-FocusTick", LogMaxKB (default 4096, 0 = no rotation), LogConsole 1 = mirror to
+// the REAPER console. Compile time: RWV_LOG_MIN_LEVEL drops LogDebugF/LogF/LogWarnF below that level.
 #pragma once
 
 #include "predef.h"
 
 #ifdef ENABLE_LOG
 
-static inline void frz_log_write_line(const char* s)
-{
-  if (!s) return;
+#include "core/log_ring.h"
 
-  // Build timestamp prefix: YYYY-MM-DD HH:MM:SS.mmm
-  char linebuf[4600];
-  linebuf[0] = '\0';
-#ifdef _WIN32
-  SYSTEMTIME st; GetLocalTime(&st);
-  int n = _snprintf_s(linebuf, sizeof(linebuf), _TRUNCATE,
-                      "%04d-%02d-%02d %02d:%02d:%02d.%03d %s",
-                      (int)st.wYear,(int)st.wMonth,(int)st.wDay,
-                      (int)st.wHour,(int)st.wMinute,(int)st.wSecond,(int)st.wMilliseconds,
-                      s);
-  if (n < 0) return;
-#else
-  struct timeval tv; gettimeofday(&tv, NULL);
-  struct tm tmv; localtime_r(&tv.tv_sec, &tmv);
-  int n = snprintf(linebuf, sizeof(linebuf),
-                   "%04d-%02d-%02d %02d:%02d:%02d.%03ld %s",
-                   tmv.tm_year+1900, tmv.tm_mon+1, tmv.tm_mday,
-                   tmv.tm_hour, tmv.tm_min, tmv.tm_sec, (long)(tv.tv_usec/1000), s);
-  if (n < 0) return;
+#ifndef RWV_LOG_MIN_LEVEL
+  #define RWV_LOG_MIN_LEVEL 0 // kLogDebug
 #endif
-  const char* out = linebuf;
 
+// Shared by every translation unit; never destroyed (the writer is stopped explicitly by LogShutdown,
+// not from a static destructor running under the loader lock)
+inline LogFilter& FrzLogFilter() { static LogFilter* f = new LogFilter(); return *f; }
+inline LogWriter& FrzLogWriter() { static LogWriter* w = new LogWriter(); return *w; }
+
+inline void frz_log_start()
+{
+  static std::once_flag s_once;
+  std::call_once(s_once, [] {
+    const char* res = GetResourcePath ? GetResourcePath() : nullptr;
+    LogWriterOptions o;
 #ifdef _WIN32
-  ::OutputDebugStringA(out);
-  ::OutputDebugStringA("\r\n");
+    o.path = (res && *res) ? (std::string(res) + "\\reaper_webview_log.txt") : std::string("reaper_webview_log.txt");
 #else
-  std::fputs(out, stderr);
-  std::fputc('\n', stderr);
+    o.path = (res && *res) ? (std::string(res) + "/reaper_webview_log.txt") : std::string("reaper_webview_log.txt");
 #endif
+    FrzLogWriter().Start(o);
+  });
+}
+
+static inline void frz_log_write_line(uint8_t level, const char* s, size_t len)
+{
+  if (!FrzLogWriter().Held()) frz_log_start();
+  FrzLogWriter().Push(level, s, len);
+}
 
-  if (ShowConsoleMsg) { ShowConsoleMsg(out); ShowConsoleMsg("\n"); }
+// Plugin entry: lines are held in memory until the first LogTick starts the writer, so REAPER's launch path
+// opens no log file and starts no thread (and the resource path is known by then)
+static inline void LogDeferStart() { FrzLogWriter().Hold(true); }
 
-  const char* res = GetResourcePath ? GetResourcePath() : nullptr;
-  std::string path;
-#ifdef _WIN32
-  path = (res && *res) ? (std::string(res) + "\\reaper_webview_log.txt")
-                       : std::string("reaper_webview_log.txt");
-#else
-  path = (res && *res) ? (std::string(res) + "/reaper_webview_log.txt")
-                       : std::string("reaper_webview_log.txt");
-#endif
+static inline void frz_log_vf(uint8_t level, const char* fmt, va_list ap)
+{
+  if (!fmt || !FrzLogFilter().Allows(level, fmt)) return; // tag + level checked on the format string, before formatting
+  char buf[kLogTextMax + 1];
+  int n = vsnprintf(buf, sizeof(buf), fmt, ap);
+  if (n < 0) return;
+  frz_log_write_line(level, buf, (size_t)n < sizeof(buf) ? (size_t)n : sizeof(buf) - 1);
+}
 
-  FILE* f = nullptr;
-#ifdef _WIN32
-  fopen_s(&f, path.c_str(), "ab");
+static inline void frz_log_f(uint8_t level, const char* fmt, ...)
+{
+  va_list ap; va_start(ap, fmt);
+  frz_log_vf(level, fmt, ap);
+  va_end(ap);
+}
+
+static inline void LogRaw(const char* s)
+{
+#if RWV_LOG_MIN_LEVEL <= 1 // kLogInfo
+  if (!s || !FrzLogFilter().Allows(kLogInfo, s)) return;
+  frz_log_write_line(kLogInfo, s, strlen(s));
 #else
-  f = std::fopen(path.c_str(), "ab");
+  (void)s;
 #endif
-  if (f) { std::fputs(out, f); std::fputc('\n', f); std::fclose(f); }
 }
 
-static inline void LogRaw(const char* s) { frz_log_write_line(s); }
-
 static inline void LogF(const char* fmt, ...)
 {
-  if (!fmt) return;
-  char buf[4096]; buf[0] = '\0';
+#if RWV_LOG_MIN_LEVEL <= 1 // kLogInfo
   va_list ap; va_start(ap, fmt);
-#ifdef _WIN32
-  _vsnprintf(buf, sizeof(buf)-1, fmt, ap);
+  frz_log_vf(kLogInfo, fmt, ap);
+  va_end(ap);
 #else
-  vsnprintf(buf, sizeof(buf)-1, fmt, ap);
+  (void)fmt;
 #endif
-  va_end(ap);
-  buf[sizeof(buf)-1] = '\0';
-  frz_log_write_line(buf);
+}
+
+#if RWV_LOG_MIN_LEVEL <= 0
+  #define LogDebugF(...) frz_log_f(kLogDebug, __VA_ARGS__)
+#else
+  #define LogDebugF(...) ((void)0)
+#endif
+#if RWV_LOG_MIN_LEVEL <= 2
+  #define LogWarnF(...) frz_log_f(kLogWarn, __VA_ARGS__)
+#else
+  #define LogWarnF(...) ((void)0)
+#endif
+#define LogErrorF(...) frz_log_f(kLogError, __VA_ARGS__)
+
+// Main thread, from the plugin timer: applies the ext-state settings (every ~2 s) and hands mirrored
+// lines to the REAPER console
+static inline void LogTick()
+{
+  frz_log_start(); // releases the lines held since the entry point
+  static DWORD s_lastRead = 0;
+  const DWORD now = GetTickCount();
+  if (!s_lastRead || now - s_lastRead >= 2000) {
+    s_lastRead = now ? now : 1;
+    const char* lvl  = GetExtState ? GetExtState("reaper_webview", "LogLevel") : nullptr;
+    const char* tags = GetExtState ? GetExtState("reaper_webview", "LogTags") : nullptr;
+    const char* kb   = GetExtState ? GetExtState("reaper_webview", "LogMaxKB") : nullptr;
+    const char* con  = GetExtState ? GetExtState("reaper_webview", "LogConsole") : nullptr;
+    FrzLogFilter().SetLevel(ParseLogLevel(lvl, kLogDebug));
+    FrzLogFilter().SetTags(tags ? tags : "");
+    FrzLogWriter().SetMaxBytes((kb && *kb) ? (uint64_t)(atoi(kb) > 0 ? atoi(kb) : 0) << 10 : (uint64_t)4096 << 10);
+    FrzLogWriter().SetConsole(con && atoi(con) > 0);
+  }
+  std::string text;
+  if (ShowConsoleMsg && FrzLogWriter().TakeConsole(text)) ShowConsoleMsg(text.c_str());
+}
+
+// Plugin unload: drains the ring and joins the writer; later lines are written synchronously
+static inline void LogShutdown()
+{
+  LogWriter& w = FrzLogWriter();
+  if (w.Held()) frz_log_start(); // unloaded before the first tick: held lines still reach the file
+  if (w.Lines() || w.Dropped())
+    frz_log_f(kLogInfo, "[Log] lines=%llu dropped=%llu batches=%llu maxBatch=%llu rotations=%llu writeMs=%.1f",
+              w.Lines(), w.Dropped(), w.Batches(), w.MaxBatch(), w.Rotations(), w.WriteMs());
+  w.Stop();
 }
 
 #else
 // Без ENABLE_LOG — no-op
 static inline void LogRaw(const char*) {}
 static inline void LogF(const char*, ...) {}
-#endif
\ No newline at end of file
+#define LogDebugF(...) ((void)0)
+#define LogWarnF(...) ((void)0)
+#define LogErrorF(...) ((void)0)
+static inline void LogDeferStart() {}
+static inline void LogTick() {}
+static inline void LogShutdown() {}
+#endif
@@ -4,7 +4,8 @@
 // main.mm
 // Notes:
 //  - Legacy global g_dlg removed; all window handles resolved via instance records (GetInstanceById / GetInstanceByHwnd).
-//  - Persistence stubs SaveInstanceStateAll/LoadInstanceStateAll currently just log state (no disk IO).
+//  - Instance state persists to reaper_webview_state.bin (globals.mm); windows open at the last save are
+//    recreated on the first timer tick, hidden dock tabs start their webview on first show.
 
 // init section
 
@@ -25,6 +26,10 @@
 #include "api.h"
 #include "globals.h"   // extern-глобалы/прототипы
 #include "helpers.h"
+#include "core/title_policy.h"
+#include "core/instance_ids.h"
+#include "core/focus_chain.h"
+#include "core/refresh_scheduler.h"
 
 #include <algorithm>
 
@@ -183,11 +188,7 @@ static LRESULT CALLBACK RWVHostSubclassProc(HWND h, UINT m, WPARAM w, LPARAM l)
     case WM_NCRBUTTONDOWN:
     case WM_WINDOWPOSCHANGED: // 0x0047 - layout/visibility changes (docker tab activation)
     {
-      if(rec){
-        UpdateFocusChain(rec->id);
-        if (g_activeInstanceId != rec->id){ if(!g_activeInstanceId.empty()) g_lastFocusedInstanceId = g_activeInstanceId; g_activeInstanceId = rec->id; }
-        LogF("[FocusTick] hostMsg=%u id='%s' tick=%lu", (unsigned)m, rec->id.c_str(), (unsigned long)rec->lastFocusTick);
-      }
+      if(rec) OnInstanceFocusEvent(rec, "hostMsg");
       break;
     }
   }
@@ -546,7 +547,7 @@ void LayoutTitleBarAndWebView(HWND hwnd, bool titleVisible)
   if(rec && rec->controller) rec->controller->put_Bounds(brc);
 }
 static void SetTitleBarText(HWND hwnd, const std::string& s){ WebViewInstanceRecord* rec=GetInstanceByHwnd(hwnd); if(rec && rec->titleBar) SetWindowTextW(rec->titleBar,Widen(s).c_str()); }
-#else
+#elif defined(__APPLE__)
 static void DestroyTitleBarResources(WebViewInstanceRecord* rec)
 { if(!rec) return; if(rec->titleBarView){ [rec->titleBarView removeFromSuperview]; rec->titleBarView=nil;} }
 
@@ -704,7 +705,7 @@ static void SetTitleBarText(HWND hwnd, const std::string& s){ WebViewInstanceRec
 {
   WebViewInstanceRecord* rec = GetInstanceByHwnd(self.rwvHostHWND); if(!rec) return;
   rec->findQuery = self.txtField.stringValue ? [self.txtField.stringValue UTF8String] : "";
-  rec->findCurrentIndex = 0; rec->findTotalMatches = 0;
+  rec->findCurrentIndex = 0; rec->findTotalMatches = 0; MarkInstanceStateDirty();
   LogF("[Find] query change '%s' (mac)", rec->findQuery.c_str());
   MacFindStartOrUpdate(rec);
   int cur=rec->findCurrentIndex, tot=rec->findTotalMatches; self.lblCounter.stringValue=[NSString stringWithFormat:@"%d/%d",cur,tot];
@@ -725,7 +726,7 @@ static void SetTitleBarText(HWND hwnd, const std::string& s){ WebViewInstanceRec
   } else if (sender == self.btnPrev || sender == self.btnNext) {
   bool fwd = (sender == self.btnNext); LogF("[Find] nav %s (mac) query='%s'", fwd?"next":"prev", rec->findQuery.c_str()); MacFindNavigate(rec, fwd);
   } else if (sender == self.chkCase) {
-  rec->findCaseSensitive = (self.chkCase.state == NSControlStateValueOn); LogF("[Find] case=%d (mac)", (int)rec->findCaseSensitive); MacFindStartOrUpdate(rec);
+  rec->findCaseSensitive = (self.chkCase.state == NSControlStateValueOn); MarkInstanceStateDirty(); LogF("[Find] case=%d (mac)", (int)rec->findCaseSensitive); MacFindStartOrUpdate(rec);
   }
   [self updateCounter];
 }
@@ -869,28 +870,198 @@ static void MacLayoutFindBar(WebViewInstanceRecord* rec)
   if(rec->findBtnClose){ [(NSView*)rec->findBtnClose setFrame:NSMakeRect(rightX, centerY-innerH/2,closeW,innerH)]; }
   LogF("[Find][mac] layout w=%g curX_end=%g rightX=%g", (double)w, (double)curX, (double)rightX);
 }
+#else
+// ============================= Linux (SWELL-generic) =============================
+// Title bar is painted by the host dialog (WM_PAINT below), find bar controls are plain SWELL
+// children of the host so their WM_COMMAND goes straight to WebViewDlgProc.
+#include "webview.h"
+static void DestroyTitleBarResources(WebViewInstanceRecord* rec) { (void)rec; }
+
+static void LinuxInitOrRefreshPanelColors(WebViewInstanceRecord* rec)
+{
+  if (!rec) return;
+  int bg=-1, tx=-1; GetPanelThemeColorsMac(&bg,&tx);
+  if (rec->titleBkColor!=bg || rec->titleTextColor!=tx) LogF("[GtkPanelColorApply] inst=%s bg=0x%06X tx=0x%06X", rec->id.c_str(), bg, tx);
+  rec->titleBkColor=bg; rec->titleTextColor=tx;
+}
+
+static void EnsureTitleBarCreated(HWND hwnd)
+{
+  WebViewInstanceRecord* rec = GetInstanceByHwnd(hwnd); if(!rec) return;
+  if (rec->titleBkColor < 0) LinuxInitOrRefreshPanelColors(rec);
+}
+
+static void LinuxPaintTitleBar(HWND hwnd)
+{
+  PAINTSTRUCT ps; HDC dc = BeginPaint(hwnd, &ps);
+  WebViewInstanceRecord* rec = GetInstanceByHwnd(hwnd);
+  if (dc && rec && rec->titleVisible) {
+    RECT rc; GetClientRect(hwnd, &rc); rc.bottom = rc.top + g_titleBarH;
+    const int bg = rec->titleBkColor >= 0 ? rec->titleBkColor : 0xC0C0C0, tx = rec->titleTextColor >= 0 ? rec->titleTextColor : 0;
+    HBRUSH br = CreateSolidBrush(RGB((bg>>16)&0xFF,(bg>>8)&0xFF,bg&0xFF)); FillRect(dc, &rc, br); DeleteObject(br);
+    SetBkMode(dc, TRANSPARENT); SetTextColor(dc, RGB((tx>>16)&0xFF,(tx>>8)&0xFF,tx&0xFF));
+    RECT tr = rc; tr.left += g_titlePadX; tr.right -= g_titlePadX;
+    DrawText(dc, rec->panelTitleString.c_str(), -1, &tr, DT_SINGLELINE|DT_VCENTER|DT_LEFT|DT_NOPREFIX|DT_END_ELLIPSIS);
+  }
+  EndPaint(hwnd, &ps);
+}
+
+static void EnsureFindBarCreated(HWND hwnd)
+{
+  WebViewInstanceRecord* rec = GetInstanceByHwnd(hwnd); if(!rec || rec->findEdit) return;
+  SWELL_MakeSetCurParms(1.0f, 1.0f, 0, 0, hwnd, false, false);
+  rec->findEdit = SWELL_MakeEditField(IDC_FIND_EDIT, 0, 0, 180, 20, WS_TABSTOP|ES_AUTOHSCROLL);
+  rec->findBtnPrev = SWELL_MakeButton(0, "<", IDC_FIND_PREV, 0, 0, 24, 20, 0);
+  rec->findBtnNext = SWELL_MakeButton(0, ">", IDC_FIND_NEXT, 0, 0, 24, 20, 0);
+  rec->findChkCase = SWELL_MakeCheckBox("Case Sensitive", IDC_FIND_CASE, 0, 0, 110, 20, BS_AUTOCHECKBOX);
+  rec->findCounterStatic = SWELL_MakeLabel(0, "0/0", IDC_FIND_COUNTER, 0, 0, 60, 20, 0);
+  rec->findBtnClose = SWELL_MakeButton(0, "X", IDC_FIND_CLOSE, 0, 0, 24, 20, 0);
+  SWELL_MakeSetCurParms(1.0f, 1.0f, 0, 0, NULL, false, false);
+  rec->findHighlightAll = true; // WebKitFindController always highlights all
+  HWND ctrls[] = { rec->findEdit, rec->findBtnPrev, rec->findBtnNext, rec->findChkCase, rec->findCounterStatic, rec->findBtnClose };
+  for (HWND c : ctrls) if (c) ShowWindow(c, SW_HIDE);
+  LogRaw("[Find][gtk] created SWELL find bar controls");
+}
+
+void UpdateFindCounter(WebViewInstanceRecord* rec)
+{
+  if (!rec || !rec->findCounterStatic) return;
+  int cur = rec->findCurrentIndex, tot = rec->findTotalMatches; if (cur<0) cur=0; if (tot<0) tot=0; if (cur>tot) cur=tot;
+  char buf[64]; snprintf(buf, sizeof(buf), "%d/%d", cur, tot); SetWindowText(rec->findCounterStatic, buf);
+}
+
+void LayoutTitleBarAndWebView(HWND hwnd, bool titleVisible)
+{
+  WebViewInstanceRecord* rec = GetInstanceByHwnd(hwnd); if(!rec) return;
+  RECT rc; GetClientRect(hwnd, &rc);
+  const int w = rc.right-rc.left, h = rc.bottom-rc.top;
+  if (titleVisible) LinuxInitOrRefreshPanelColors(rec);
+  if (rec->titleVisible != titleVisible) { rec->titleVisible = titleVisible; InvalidateRect(hwnd, NULL, FALSE); }
+  const int top = titleVisible ? g_titleBarH : 0; int bottom = 0;
+  HWND ctrls[] = { rec->findEdit, rec->findBtnPrev, rec->findBtnNext, rec->findChkCase, rec->findCounterStatic, rec->findBtnClose };
+  if (rec->showFindBar) {
+    EnsureFindBarCreated(hwnd);
+    const int pad=20, innerH=g_findBarH-8, y=h-g_findBarH+4; int curX=pad;
+    auto place=[&](HWND c, int cw, int gap){ if(!c) return; SetWindowPos(c, NULL, curX, y, cw, innerH, SWP_NOZORDER|SWP_NOACTIVATE); ShowWindow(c, SW_SHOWNA); curX += cw + gap; };
+    place(rec->findEdit, 180, 8); place(rec->findBtnPrev, 24, 8); place(rec->findBtnNext, 24, 10);
+    place(rec->findChkCase, 116, 8); place(rec->findCounterStatic, 60, 6);
+    if (rec->findBtnClose) { SetWindowPos(rec->findBtnClose, NULL, w-pad-24, y, 24, innerH, SWP_NOZORDER|SWP_NOACTIVATE); ShowWindow(rec->findBtnClose, SW_SHOWNA); }
+    bottom = g_findBarH;
+    UpdateFindCounter(rec);
+  } else {
+    for (HWND c : ctrls) if (c) ShowWindow(c, SW_HIDE);
+  }
+  RECT wr = { 0, top, w, h - bottom }; if (wr.bottom < wr.top) wr.bottom = wr.top;
+  GtkLayoutWebView(rec, wr);
+}
+static void SetTitleBarText(HWND hwnd, const std::string& s){ WebViewInstanceRecord* rec=GetInstanceByHwnd(hwnd); if(!rec || rec->panelTitleString==s) return; rec->panelTitleString=s; if(rec->titleVisible){ RECT r; GetClientRect(hwnd,&r); r.bottom=r.top+g_titleBarH; InvalidateRect(hwnd,&r,FALSE); } }
 #endif
 
 // показать/скрыть панель + текст
-static void UpdateTitleBarUI(HWND hwnd, const std::string& domain, const std::string& pageTitle, const std::string& effectiveTitle,
-                             bool inDock, bool finalPanelVisible, ShowPanelMode mode)
+static void UpdateTitleBarUI(HWND hwnd, const std::string& panelText, bool inDock, bool finalPanelVisible, ShowPanelMode mode)
 {
   EnsureTitleBarCreated(hwnd);
   const bool wantVisible = finalPanelVisible; // уже рассчитано выше с учётом режима
-  // Формирование текста панели:
-  // Требование: панель НИКОГДА не показывает кастомный (override) заголовок.
-  // Всегда используется fallback: домен [+ " - " + pageTitle].
-  // (Кастомный заголовок по-прежнему может использоваться для таба докера или окна, но не для панели.)
-  std::string panelText = domain.empty() ? "…" : domain;
-  if (!pageTitle.empty()) panelText += " - " + pageTitle;
+  // Текст панели (DecideTitles): никогда не кастомный заголовок, всегда домен [+ " - " + pageTitle].
   SetTitleBarText(hwnd, panelText);
   LayoutTitleBarAndWebView(hwnd, wantVisible);
   LogF("[Panel] inDock=%d mode=%d visible=%d title='%s' (fallback only)", (int)inDock, (int)mode, (int)wantVisible, panelText.c_str());
 }
 
+// ============================== Startup timeline ==============================
+// Marks from REAPER_PLUGIN_ENTRYPOINT to the first page in a panel (core/startup_timeline.h). The entry point
+// does only what must exist before REAPER finishes loading (API pointers, actions, ReaScript API, the saved
+// records the API may be asked about); the log writer starts, panels reopen and browsers are created later.
+static StartupTimeline g_startup;
+
+void MarkStartup(StartupMark m)
+{
+  if (g_startup.Has(m)) return;
+  g_startup.Mark(m, PerfNowUs());
+  if (m == StartupMark::FirstTick)
+    LogF("[Startup] %s, first tick +%.1f ms", g_startup.EntrySummary().c_str(), g_startup.SinceEntryUs(m) / 1000.0);
+  else if (m != StartupMark::EntryEnd && (int)m > (int)StartupMark::FirstTick)
+    LogF("[Startup] %s +%.1f ms after entry", StartupTimeline::Name(m), g_startup.SinceEntryUs(m) / 1000.0);
+}
+
+void StartupAppendJson(std::string& out)
+{
+  g_startup.AppendJson(out);
+}
+
+// ============================== Deferred title refresh ==============================
+// Event sources (title/navigation callbacks, API) only mark the host dirty; the REAPER timer tick
+// runs at most one UpdateTitlesExtractAndApply per host, so title churn (timers, SPA routers) no
+// longer re-docks/relayouts on every change.
+static RefreshScheduler g_titleRefresh;
+
+void RequestTitlesRefresh(HWND hwnd)
+{
+  if (hwnd) g_titleRefresh.Request((void*)hwnd);
+}
+
+// Recreate windows that were open at the last save. Runs from the first timer tick: dockers are ready
+// by then, and g_restoringInstances keeps hidden tabs from creating their webview until shown.
+static void RestoreOpenInstances()
+{
+  std::vector<std::string> ids;
+  if (!TakeRestorableInstanceIds(ids)) return;
+  const std::string prevActive = g_activeInstanceId;
+  g_restoringInstances = true;
+  for (const std::string& id : ids) {
+    WebViewInstanceRecord* rec = GetInstanceById(id);
+    if (!rec || (rec->hwnd && IsWindow(rec->hwnd))) continue;
+    OpenOrActivateInstance(id, rec->lastUrl.empty() ? std::string(kDefaultURL) : rec->lastUrl, false);
+    LogF("[Restore] id='%s' reopened deferred=%d", id.c_str(), (int)rec->webViewDeferred);
+  }
+  g_restoringInstances = false;
+  if (!prevActive.empty()) g_activeInstanceId = prevActive;
+}
+
+// Restored instance whose dock tab was hidden at creation: bring up the webview now that it is shown
+void StartDeferredWebView(HWND hwnd)
+{
+  WebViewInstanceRecord* rec = GetInstanceByHwnd(hwnd);
+  if (!rec || !rec->webViewDeferred) return;
+  rec->webViewDeferred = false;
+  g_instanceId = rec->id; // StartWebView binds the controller/view to g_instanceId
+  LogF("[Restore] id='%s' first show -> StartWebView", rec->id.c_str());
+  MarkStartup(StartupMark::FirstWebViewStart);
+  rec->stats.CreateStarted(PerfNowUs());
+  StartWebView(hwnd, rec->lastUrl.empty() ? std::string(kDefaultURL) : rec->lastUrl);
+  RequestTitlesRefresh(hwnd);
+}
+
+static void TitleRefreshTimer()
+{
+  static bool s_restoreDone = false;
+  if (!s_restoreDone) {
+    s_restoreDone = true;
+    LogTick(); // starts the log writer: the lines held since the entry point go out first
+    MarkStartup(StartupMark::FirstTick);
+    RestoreOpenInstances();
+    MarkStartup(StartupMark::RestoreDone);
+  }
+  LogTick();
+  g_titleRefresh.Flush([](void* key){
+    HWND h = (HWND)key;
+    if (IsWindow(h) && GetInstanceByHwnd(h)) UpdateTitlesExtractAndApply(h);
+  });
+  StateStreamTick();
+  AudioTapTick();
+  VideoTick();
+  SharedBufferTick();
+  ScriptQueueTick();
+  FindAllTick();
+  FlushInstanceStateIfDirty();
+  HibernateTick();
+}
+
 // ============================== Titles (common) ==============================
 void UpdateTitlesExtractAndApply(HWND hwnd)
 {
+  g_titleRefresh.Cancel((void*)hwnd, true); // synchronous refresh serves a pending deferred one
+  const uint64_t statT0 = PerfNowUs();
   // Выбор текущей записи инстанса (active id определяется по hwnd -> ищем запись с таким hwnd)
     WebViewInstanceRecord* rec = GetInstanceByHwnd(hwnd);
   if (!rec) { // fallback на активный id
@@ -908,46 +1079,40 @@ void UpdateTitlesExtractAndApply(HWND hwnd)
   if (SUCCEEDED(rec->webview->get_Source(&wsrc))  && wsrc)  domain    = ExtractDomainFromUrl(Narrow(std::wstring(wsrc.get())));
   if (SUCCEEDED(rec->webview->get_DocumentTitle(&wtitle)) && wtitle) pageTitle = Narrow(std::wstring(wtitle.get()));
     }
-  #else
+  #elif defined(__APPLE__)
     if (rec && rec->webView)
     {
       NSURL* u = rec->webView.URL; if (u) domain = ExtractDomainFromUrl([[u absoluteString] UTF8String]);
       NSString* t = rec->webView.title; if (t) pageTitle = [t UTF8String];
     }
+  #else
+    if (rec && rec->webView)
+    {
+      std::string u; if (GtkWebViewQuery(rec, &u, &pageTitle) && !u.empty()) domain = ExtractDomainFromUrl(u);
+    }
   #endif
   SaveDockState(hwnd);
   const bool inDock = (g_last_dock_idx >= 0);
 
-  const bool defaultMode = (effectiveTitle.empty() || effectiveTitle == kTitleBase);
-  auto panelVisible = [&](bool inDockLocal, bool defaultTitle){
-    switch (effectivePanelMode)
-    {
-      case ShowPanelMode::Hide:   return false;
-      case ShowPanelMode::Docker: return inDockLocal; // только в докере
-      case ShowPanelMode::Always: return true;        // всегда
-      case ShowPanelMode::Unset:  default:            return defaultTitle && inDockLocal; // старое поведение
-    }
-  };
+  const TitleDecision td = DecideTitles(effectiveTitle, kTitleBase, effectivePanelMode, inDock, domain, pageTitle);
+  const bool defaultMode = td.defaultMode;
 
   if (defaultMode)
   {
     if (inDock)
     {
-      const std::string tabCaption = kTitleBase;
       WebViewInstanceRecord* rLocal = GetInstanceByHwnd(hwnd);
-      if (rLocal && rLocal->lastTabTitle != tabCaption) {
-        LogF("[TabTitle] in-dock (idx=%d float=%d) -> '%s'", g_last_dock_idx, (int)g_last_dock_float, tabCaption.c_str());
+      if (rLocal && rLocal->lastTabTitle != td.tabCaption) {
+        LogF("[TabTitle] in-dock (idx=%d float=%d) -> '%s'", g_last_dock_idx, (int)g_last_dock_float, td.tabCaption.c_str());
       }
-      SetTabTitleInplace(hwnd, tabCaption);
-  UpdateTitleBarUI(hwnd, domain, pageTitle, effectiveTitle, true, panelVisible(true, true), effectivePanelMode);
+      SetTabTitleInplace(hwnd, td.tabCaption);
+      UpdateTitleBarUI(hwnd, td.panelText, true, td.panelVisible, effectivePanelMode);
     }
     else
     {
-      std::string wndCaption = domain.empty() ? "…" : domain;
-      if (!pageTitle.empty()) wndCaption += " - " + pageTitle;
-  SetWndText(hwnd, wndCaption);
-  UpdateTitleBarUI(hwnd, domain, pageTitle, effectiveTitle, false, panelVisible(false, true), effectivePanelMode);
-      LogF("[TitleUpdate] undock caption='%s'", wndCaption.c_str());
+      SetWndText(hwnd, td.wndCaption);
+      UpdateTitleBarUI(hwnd, td.panelText, false, td.panelVisible, effectivePanelMode);
+      LogF("[TitleUpdate] undock caption='%s'", td.wndCaption.c_str());
     }
   }
   else
@@ -966,13 +1131,13 @@ void UpdateTitlesExtractAndApply(HWND hwnd)
           if (DockWindowRefresh) DockWindowRefresh();
         }
       }
-      SetTabTitleInplace(hwnd, effectiveTitle);
-  UpdateTitleBarUI(hwnd, domain, pageTitle, effectiveTitle, true, panelVisible(true, false), effectivePanelMode);
+      SetTabTitleInplace(hwnd, td.tabCaption);
+      UpdateTitleBarUI(hwnd, td.panelText, true, td.panelVisible, effectivePanelMode);
     }
     else
     {
-  SetWndText(hwnd, effectiveTitle);
-  UpdateTitleBarUI(hwnd, domain, pageTitle, effectiveTitle, false, panelVisible(false, false), effectivePanelMode);
+      SetWndText(hwnd, td.wndCaption);
+      UpdateTitleBarUI(hwnd, td.panelText, false, td.panelVisible, effectivePanelMode);
     LogF("[TitleUpdate] undock custom='%s'", effectiveTitle.c_str());
     }
   }
@@ -990,6 +1155,7 @@ void UpdateTitlesExtractAndApply(HWND hwnd)
       SetTabTitleInplace(hwnd, effectiveTitle);
     }
   }
+  if (rec && rec->hwnd == hwnd) rec->stats.TitleRefreshed(PerfNowUs() - statT0);
 }
 
 // ============================== dlg/docker ==============================
@@ -1017,17 +1183,7 @@ static void SizeWebViewToClient(HWND hwnd)
   WebViewInstanceRecord* rec = GetInstanceByHwnd(hwnd);
   const std::string effectiveTitle = (rec && !rec->titleOverride.empty()) ? rec->titleOverride : kTitleBase;
   const ShowPanelMode effectivePanelMode = rec ? rec->panelMode : ShowPanelMode::Unset;
-  const bool defaultMode = (effectiveTitle.empty() || effectiveTitle == kTitleBase);
-
-  auto panelVisible = [&](bool inDockLocal, bool defaultTitle){
-    switch (effectivePanelMode) {
-      case ShowPanelMode::Hide:   return false;
-      case ShowPanelMode::Docker: return inDockLocal;
-      case ShowPanelMode::Always: return true;
-      case ShowPanelMode::Unset: default: return defaultTitle && inDockLocal; }
-  };
-
-  bool wantPanel = panelVisible(inDock, defaultMode);
+  bool wantPanel = PanelVisibleFor(effectivePanelMode, inDock, IsDefaultTitle(effectiveTitle, kTitleBase));
   LayoutTitleBarAndWebView(hwnd, wantPanel);
   s_inSizing = false;
 }
@@ -1038,7 +1194,7 @@ static void SizeWebViewToClient(HWND hwnd)
   #include "webview.h"
   #ifdef _WIN32
   #include <shellapi.h>
-  #else
+  #elif defined(__APPLE__)
   #import <AppKit/AppKit.h>
   #endif
 #endif
@@ -1082,6 +1238,7 @@ static void RememberWantDock(HWND hwnd)
   if (rec) {
     rec->wantDockOnCreate = g_want_dock_on_create;
     if (detected) { rec->lastDockIdx = idx; rec->lastDockFloat = isFloat; }
+    MarkInstanceStateDirty();
   }
   LogF("[DockRemember] stored want_dock=%d (detected=%d idx=%d float=%d inst=%s)", g_want_dock_on_create, (int)detected, idx, (int)isFloat, rec?rec->id.c_str():"<none>");
 }
@@ -1109,9 +1266,12 @@ static void ShowLocalDockMenu(HWND hwnd, int x, int y)
       if (SUCCEEDED(rec->webview->QueryInterface(IID_PPV_ARGS(&wv2))) && wv2) {
         BOOL cb=FALSE, cf=FALSE; wv2->get_CanGoBack(&cb); wv2->get_CanGoForward(&cf); canBack = cb; canFwd = cf; }
     }
-#else
+#elif defined(__APPLE__)
     bool canBack = (rec && rec->webView && rec->webView.canGoBack);
     bool canFwd  = (rec && rec->webView && rec->webView.canGoForward);
+#else
+    bool canBack = GtkWebViewCanGo(rec, false);
+    bool canFwd  = GtkWebViewCanGo(rec, true);
 #endif
     AppendMenuA(m, MF_STRING | (canBack?0:MF_DISABLED|MF_GRAYED),   10111, "Back");
     AppendMenuA(m, MF_STRING | (canFwd?0:MF_DISABLED|MF_GRAYED),    10112, "Forward");
@@ -1157,24 +1317,30 @@ static void ShowLocalDockMenu(HWND hwnd, int x, int y)
     WebViewInstanceRecord* r = GetInstanceByHwnd(hwnd);
 #ifdef _WIN32
     if (r && r->webview) r->webview->Reload();
-#else
+#elif defined(__APPLE__)
     if (r && r->webView) [r->webView reload];
+#else
+    GtkWebViewGo(r, 0);
 #endif
   }
   else if (cmd == 10111) { // Back
     WebViewInstanceRecord* r = GetInstanceByHwnd(hwnd);
 #ifdef _WIN32
     if (r && r->webview) { wil::com_ptr<ICoreWebView2_2> wv2; if (SUCCEEDED(r->webview->QueryInterface(IID_PPV_ARGS(&wv2))) && wv2) { BOOL cb=FALSE; wv2->get_CanGoBack(&cb); if (cb) wv2->GoBack(); } }
-#else
+#elif defined(__APPLE__)
     if (r && r->webView && r->webView.canGoBack) [r->webView goBack];
+#else
+    GtkWebViewGo(r, -1);
 #endif
   }
   else if (cmd == 10112) { // Forward
     WebViewInstanceRecord* r = GetInstanceByHwnd(hwnd);
 #ifdef _WIN32
     if (r && r->webview) { wil::com_ptr<ICoreWebView2_2> wv2; if (SUCCEEDED(r->webview->QueryInterface(IID_PPV_ARGS(&wv2))) && wv2) { BOOL cf=FALSE; wv2->get_CanGoForward(&cf); if (cf) wv2->GoForward(); } }
-#else
+#elif defined(__APPLE__)
     if (r && r->webView && r->webView.canGoForward) [r->webView goForward];
+#else
+    GtkWebViewGo(r, +1);
 #endif
   }
   else if (cmd == 10113) {
@@ -1184,14 +1350,19 @@ static void ShowLocalDockMenu(HWND hwnd, int x, int y)
   LogF("[Find] toggle show=%d", (int)r->showFindBar);
 #ifdef _WIN32
   bool titleVisible = (r->titleBar && IsWindow(r->titleBar) && IsWindowVisible(r->titleBar));
-#else
+#elif defined(__APPLE__)
   bool titleVisible = (r->titleBarView && ![r->titleBarView isHidden]);
+#else
+  bool titleVisible = r->titleVisible;
 #endif
   LayoutTitleBarAndWebView(hwnd, titleVisible);
-#ifdef _WIN32
-  if (r->showFindBar && r->findEdit) { SetFocus(r->findEdit); SendMessage(r->findEdit, EM_SETSEL, 0, -1); }
-#else
+#ifdef __APPLE__
   if (r->showFindBar && r->findEdit) { [((NSTextField*)r->findEdit) selectText:nil]; [[r->findEdit window] makeFirstResponder:((NSTextField*)r->findEdit)]; }
+#else
+  if (r->showFindBar && r->findEdit) { SetFocus(r->findEdit); SendMessage(r->findEdit, EM_SETSEL, 0, -1); }
+#endif
+#if !defined(_WIN32) && !defined(__APPLE__)
+  if (!r->showFindBar) GtkFindClose(r);
 #endif
     } else { LogRaw("[Find] toggle requested but instance not found"); }
   }
@@ -1211,7 +1382,11 @@ static INT_PTR WINAPI WebViewDlgProc(HWND hwnd, UINT msg, WPARAM wp, LPARAM lp)
     }
     case WM_SHOWWINDOW:
     {
+    #ifndef _WIN32
+      OnInstanceHostVisibility(GetInstanceByHwnd(hwnd), wp != 0, "showWindow");
+    #endif
       if (wp) { // becoming visible
+        HibernateOnHostShown(hwnd);
         WebViewInstanceRecord* r = GetInstanceByHwnd(hwnd);
         if (r) {
           // Не перезаписываем primary если пользователь недавно переключился на другой таб (primary-stable лог сохранит)
@@ -1310,33 +1485,45 @@ static INT_PTR WINAPI WebViewDlgProc(HWND hwnd, UINT msg, WPARAM wp, LPARAM lp)
         if (recInit && !recInit->titleOverride.empty() && recInit->titleOverride != kTitleBase)
           initTitle = recInit->titleOverride.c_str();
         DockWindowAddEx(hwnd, initTitle, kDockIdent, true);
-        if (DockWindowActivate) DockWindowActivate(hwnd);
+        if (DockWindowActivate && !g_restoringInstances) DockWindowActivate(hwnd); // restore keeps the saved tab order/selection
         if (DockWindowRefreshForHWND) DockWindowRefreshForHWND(hwnd);
         if (DockWindowRefresh) DockWindowRefresh();
       } else {
         PlatformMakeTopLevel(hwnd);
       }
       if (recInit) {
-        recInit->hwnd = hwnd; // bind window to instance (single-window model for now)
+        g_instances.SetHwnd(recInit, hwnd); // bind window to instance (single-window model for now)
         if (recInit->wantDockOnCreate < 0) recInit->wantDockOnCreate = wantDock?1:0; // initialize inheritance
       }
 
       SaveDockState(hwnd);
 
-      StartWebView(hwnd, url);
+      if (g_restoringInstances && recInit && !IsWindowVisible(hwnd)) {
+        recInit->lastUrl = url; recInit->webViewDeferred = true; // created on first WM_SHOWWINDOW/WM_SIZE
+      } else {
+        MarkStartup(StartupMark::FirstWebViewStart);
+        if (recInit) recInit->stats.CreateStarted(PerfNowUs());
+        StartWebView(hwnd, url);
+      }
       UpdateTitlesExtractAndApply(hwnd);
       return 1;
     }
 
     // WM_CTLCOLORSTATIC no longer needed; custom class repaints itself.
+#if !defined(_WIN32) && !defined(__APPLE__)
+    case WM_PAINT:
+      LinuxPaintTitleBar(hwnd);
+      return 0;
+#endif
 
     case WM_SIZE:
+      if (IsWindowVisible(hwnd)) HibernateOnHostShown(hwnd);
       SizeWebViewToClient(hwnd);
       return 0;
 
     case WM_SWELL_POST_UNDOCK_FIXSTYLE:
     {
-    #ifndef _WIN32
+    #ifdef __APPLE__
       NSView* host = (NSView*)hwnd;
       NSWindow* win = [host window];
       if (win)
@@ -1365,11 +1552,15 @@ static INT_PTR WINAPI WebViewDlgProc(HWND hwnd, UINT msg, WPARAM wp, LPARAM lp)
           WebViewInstanceRecord* r = GetInstanceByHwnd(hwnd); if (r && r->showFindBar){ r->showFindBar=false; LogRaw("[Find] close");
 #ifdef _WIN32
             WinFindClose(r);
+#elif !defined(__APPLE__)
+            GtkFindClose(r);
 #endif
         #ifdef _WIN32
             bool titleVisible = (r->titleBar && IsWindow(r->titleBar) && IsWindowVisible(r->titleBar));
-        #else
+        #elif defined(__APPLE__)
             bool titleVisible = (r->titleBarView && ![r->titleBarView isHidden]);
+        #else
+            bool titleVisible = r->titleVisible;
         #endif
             LayoutTitleBarAndWebView(hwnd, titleVisible);
           }
@@ -1381,6 +1572,8 @@ static INT_PTR WINAPI WebViewDlgProc(HWND hwnd, UINT msg, WPARAM wp, LPARAM lp)
           WebViewInstanceRecord* r = GetInstanceByHwnd(hwnd); if (r){ bool fwd = (LOWORD(wp)==IDC_FIND_NEXT); LogF("[Find] nav %s query='%s'", fwd?"next":"prev", r->findQuery.c_str());
 #ifdef _WIN32
             WinFindNavigate(r, fwd);
+#elif !defined(__APPLE__)
+            GtkFindNavigate(r, fwd);
 #endif
           }
           return 0;
@@ -1388,9 +1581,11 @@ static INT_PTR WINAPI WebViewDlgProc(HWND hwnd, UINT msg, WPARAM wp, LPARAM lp)
         case IDC_FIND_CASE:
         case IDC_FIND_HILITE:
         {
-          WebViewInstanceRecord* r = GetInstanceByHwnd(hwnd); if (r){ if (LOWORD(wp)==IDC_FIND_CASE){ r->findCaseSensitive = (SendMessage((HWND)lp, BM_GETCHECK,0,0)==BST_CHECKED); LogF("[Find] case=%d", (int)r->findCaseSensitive);} else { r->findHighlightAll = (SendMessage((HWND)lp, BM_GETCHECK,0,0)==BST_CHECKED); LogF("[Find] highlight=%d", (int)r->findHighlightAll);} 
+          WebViewInstanceRecord* r = GetInstanceByHwnd(hwnd); if (r){ if (LOWORD(wp)==IDC_FIND_CASE){ r->findCaseSensitive = (SendMessage((HWND)lp, BM_GETCHECK,0,0)==BST_CHECKED); LogF("[Find] case=%d", (int)r->findCaseSensitive);} else { r->findHighlightAll = (SendMessage((HWND)lp, BM_GETCHECK,0,0)==BST_CHECKED); LogF("[Find] highlight=%d", (int)r->findHighlightAll);} MarkInstanceStateDirty(); 
 #ifdef _WIN32
             WinFindStartOrUpdate(r);
+#elif !defined(__APPLE__)
+            GtkFindStartOrUpdate(r);
 #endif
           }
           return 0;
@@ -1409,13 +1604,17 @@ static INT_PTR WINAPI WebViewDlgProc(HWND hwnd, UINT msg, WPARAM wp, LPARAM lp)
               int need = WideCharToMultiByte(CP_UTF8,0,wbuf,-1,nullptr,0,nullptr,nullptr);
               std::string utf8;
               if (need>0){ utf8.resize(need-1); WideCharToMultiByte(CP_UTF8,0,wbuf,-1,(LPSTR)utf8.data(),need,nullptr,nullptr); }
-              r->findQuery = utf8;
+              r->findQuery = utf8; MarkInstanceStateDirty();
               r->findCurrentIndex=0; r->findTotalMatches=0; LogF("[Find] query change '%s'", r->findQuery.c_str()); UpdateFindCounter(r);
               WinFindStartOrUpdate(r);
+            #elif !defined(__APPLE__)
+              char buf[512]; buf[0]=0; GetWindowText(r->findEdit, buf, sizeof(buf)); r->findQuery = buf; MarkInstanceStateDirty();
+              r->findCurrentIndex=0; r->findTotalMatches=0; LogF("[Find] query change '%s' (gtk)", r->findQuery.c_str()); UpdateFindCounter(r);
+              GtkFindStartOrUpdate(r);
             #else
               // NSTextField* stored in r->findEdit; safely bridge and read stringValue
               NSString* s = [(NSTextField*)r->findEdit stringValue];
-              const char* cstr = s? [s UTF8String] : ""; r->findQuery = cstr? cstr : "";
+              const char* cstr = s? [s UTF8String] : ""; r->findQuery = cstr? cstr : ""; MarkInstanceStateDirty();
               r->findCurrentIndex=0; r->findTotalMatches=0; LogF("[Find] query change '%s' (mac)", r->findQuery.c_str()); MacUpdateFindCounter(r);
             #endif
             }
@@ -1424,6 +1623,16 @@ static INT_PTR WINAPI WebViewDlgProc(HWND hwnd, UINT msg, WPARAM wp, LPARAM lp)
         }
         case IDOK:
         case IDCANCEL:
+#if !defined(_WIN32) && !defined(__APPLE__)
+          { // SWELL routes Enter/Escape in the find edit to the dialog: treat as find navigation / close
+            WebViewInstanceRecord* r = GetInstanceByHwnd(hwnd);
+            if (r && r->showFindBar && r->findEdit && GetFocus()==r->findEdit) {
+              if (LOWORD(wp)==IDOK) GtkFindNavigate(r, !(GetAsyncKeyState(VK_SHIFT)&0x8000));
+              else SendMessage(hwnd, WM_COMMAND, IDC_FIND_CLOSE, 0);
+              return 0;
+            }
+          }
+#endif
           SendMessage(hwnd, WM_CLOSE, 0, 0);
           return 0;
       }
@@ -1444,16 +1653,21 @@ static INT_PTR WINAPI WebViewDlgProc(HWND hwnd, UINT msg, WPARAM wp, LPARAM lp)
           if (closedWasPrimary) g_focusPrimaryInstanceId.clear();
           if (closedWasActive)  g_activeInstanceId.clear();
           if (closedWasLast)    g_lastFocusedInstanceId.clear();
-          kv.second->hwnd = nullptr;
+          g_instances.SetHwnd(kv.second.get(), nullptr);
 #ifdef _WIN32
           if (kv.second->bmpPrev){ DeleteObject(kv.second->bmpPrev); kv.second->bmpPrev=nullptr; }
           if (kv.second->bmpNext){ DeleteObject(kv.second->bmpNext); kv.second->bmpNext=nullptr; }
           if (kv.second->controller) { kv.second->controller->Release(); kv.second->controller = nullptr; }
           if (kv.second->webview)    { kv.second->webview->Release();    kv.second->webview = nullptr; }
+          g_instances.SetNativeView(kv.second.get(), nullptr);
+#elif defined(__APPLE__)
+          kv.second->webView = nil; g_instances.SetNativeView(kv.second.get(), nullptr);
 #else
-          kv.second->webView = nil;
+          GtkWebViewDestroy(kv.second.get());
 #endif
           LogF("[InstanceCleanup] id='%s' cleared on WM_CLOSE", kv.first.c_str());
+          if (RandomInstanceNumber(kv.first)) ForgetInstanceState(kv.second.get()); // nobody can ask for this id again
+          else SnapshotInstanceState(kv.second.get()); // user close: do not reopen on next start
           break;
         }
       }
@@ -1500,6 +1714,20 @@ static INT_PTR WINAPI WebViewDlgProc(HWND hwnd, UINT msg, WPARAM wp, LPARAM lp)
 
     case WM_DESTROY:
       LogRaw("[WM_DESTROY]");
+      g_titleRefresh.Cancel((void*)hwnd);
+      if (WebViewInstanceRecord* r = GetInstanceByHwnd(hwnd)) {
+        AudioTapRelease(r); // before its "audio" shared buffer goes
+        VideoRelease(r);
+        StateStreamRelease(r);
+        SharedBufferRelease(r);
+        ScriptQueueRelease(r);
+        CaptureRelease(r);
+        FindAllRelease(r);
+        HibernateRelease(r);
+#if !defined(_WIN32) && !defined(__APPLE__)
+        GtkWebViewDestroy(r); // plug is not a SWELL child: a window destroyed without WM_CLOSE would leak it
+#endif
+      }
     #ifdef _WIN32
       if (g_rwvMsgHook){ UnhookWindowsHookEx(g_rwvMsgHook); g_rwvMsgHook=nullptr; LogRaw("[FindHook] removed WH_GETMESSAGE"); }
     #endif
@@ -1510,19 +1738,20 @@ static INT_PTR WINAPI WebViewDlgProc(HWND hwnd, UINT msg, WPARAM wp, LPARAM lp)
 #ifdef _WIN32
       for (auto &kv : g_instances) {
         if (kv.second && kv.second->hwnd == hwnd) {
-          kv.second->hwnd = nullptr; 
+          g_instances.SetHwnd(kv.second.get(), nullptr);
           if (kv.second->bmpPrev){ DeleteObject(kv.second->bmpPrev); kv.second->bmpPrev=nullptr; }
           if (kv.second->bmpNext){ DeleteObject(kv.second->bmpNext); kv.second->bmpNext=nullptr; }
           if (kv.second->controller) { kv.second->controller->Release(); kv.second->controller = nullptr; }
           if (kv.second->webview)    { kv.second->webview->Release();    kv.second->webview = nullptr; }
+          g_instances.SetNativeView(kv.second.get(), nullptr);
           LogF("[InstanceCleanup] id='%s' cleared on WM_DESTROY", kv.first.c_str());
         }
       }
       PurgeDeadInstances();
-#else
+#elif defined(__APPLE__)
       for (auto &kv : g_instances) {
         if (kv.second && kv.second->hwnd == hwnd) {
-          kv.second->hwnd = nullptr; kv.second->webView = nil;
+          g_instances.SetHwnd(kv.second.get(), nullptr); kv.second->webView = nil; g_instances.SetNativeView(kv.second.get(), nullptr);
           LogF("[InstanceCleanup] id='%s' cleared on WM_DESTROY", kv.first.c_str());
         }
       }
@@ -1564,7 +1793,7 @@ static HWND CreateNewWebViewWindow(const std::string& url)
 }
 
 // ============================== per-instance open/activate ==============================
-void OpenOrActivateInstance(const std::string& instanceId, const std::string& url)
+void OpenOrActivateInstance(const std::string& instanceId, const std::string& url, bool refreshTitles)
 {
   WebViewInstanceRecord* rec = GetInstanceById(instanceId);
   if (!rec) {
@@ -1580,12 +1809,13 @@ void OpenOrActivateInstance(const std::string& instanceId, const std::string& ur
     if (g_activeInstanceId != instanceId) { if (!g_activeInstanceId.empty()) g_lastFocusedInstanceId = g_activeInstanceId; g_activeInstanceId = instanceId; }
     // Обновляем цепочку фокуса (пользователь активировал окно через команду)
     UpdateFocusChain(instanceId);
-    if (!url.empty()) NavigateExistingInstance(instanceId, url);
+    if (!url.empty() && rec->webViewDeferred) { rec->lastUrl = url; MarkInstanceStateDirty(); } // loads on first show
+    else if (!url.empty()) NavigateExistingInstance(instanceId, url);
     else if (!rec->lastUrl.empty()) LogF("[InstanceActivate] id='%s' reuse lastUrl='%s'", instanceId.c_str(), rec->lastUrl.c_str());
     bool floating=false; int dockId = DockIsChildOfDock ? DockIsChildOfDock(rec->hwnd,&floating) : -1;
     if (dockId >= 0) { if (DockWindowActivate) DockWindowActivate(rec->hwnd); }
     else PlatformMakeTopLevel(rec->hwnd);
-    UpdateTitlesExtractAndApply(rec->hwnd);
+    if (refreshTitles) RequestTitlesRefresh(rec->hwnd);
     return;
   }
 
@@ -1595,7 +1825,7 @@ void OpenOrActivateInstance(const std::string& instanceId, const std::string& ur
   HWND hwnd = CreateNewWebViewWindow(url);
   LogF("[InstanceCreate] created window %p for id='%s'", (void*)hwnd, instanceId.c_str());
   if (rec->hwnd == nullptr && hwnd) {
-    rec->hwnd = hwnd; rec->lastUrl = url; rec->wantDockOnCreate = g_want_dock_on_create; }
+    g_instances.SetHwnd(rec, hwnd); rec->lastUrl = url; rec->wantDockOnCreate = g_want_dock_on_create; }
 #ifdef _WIN32
   if (rec->hwnd && IsWindow(rec->hwnd) && !rec->origHostWndProc){
     rec->origHostWndProc = (WNDPROC)SetWindowLongPtr(rec->hwnd, GWLP_WNDPROC, (LONG_PTR)RWVHostSubclassProc);
@@ -1629,6 +1859,7 @@ static bool Act_OpenDefault(int /*flag*/)
 
 // Forward declarations for new handlers
 static bool Act_Search(int flag);
+static bool Act_FindAll(int flag);
 static bool Act_OpenUrlDialog(int flag); // forward (used also by context menu earlier in file)
 
 // ============================ structures =============================
@@ -1641,6 +1872,7 @@ struct CommandSpec {
 static const CommandSpec kCommandSpecs[] = {
   { "FRZZ_WEBVIEW_OPEN", "WebView: Open (default url)", &Act_OpenDefault },
   { "FRZZ_WEBVIEW_SEARCH", "WebView: Search (show or navigate)", &Act_Search },
+  { "FRZZ_WEBVIEW_FIND_ALL", "WebView: Find in all panels", &Act_FindAll },
   { "FRZZ_WEBVIEW_OPEN_URL", "WebView: Open URL", &Act_OpenUrlDialog },
 };
 
@@ -1649,6 +1881,8 @@ static void RegisterCommandId()
 {
   plugin_register("hookcommand", (void*)HookCommandProc);
 
+  int first = 0, last = 0, count = 0;
+  g_gaccels.reserve(sizeof(kCommandSpecs) / sizeof(kCommandSpecs[0]));
   for (const auto& spec : kCommandSpecs)
   {
     int id = (int)(intptr_t)plugin_register("command_id", (void*)spec.name);
@@ -1667,8 +1901,10 @@ static void RegisterCommandId()
     plugin_register("gaccel", acc.get());
     g_gaccels.push_back(std::move(acc));
 
-    LogF("Registered command '%s' id=%d", spec.name, id);
+    if (!first) first = id;
+    last = id; ++count;
   }
+  LogF("Registered %d command(s) ids %d..%d", count, first, last); // one line: entry-path logging is held in memory
 }
 
 static void UnregisterCommandId()
@@ -1691,6 +1927,8 @@ REAPER_PLUGIN_ENTRYPOINT(REAPER_PLUGIN_HINSTANCE hInstance, reaper_plugin_info_t
 
   if (rec)
   {
+    g_startup.Mark(StartupMark::EntryBegin, PerfNowUs());
+    LogDeferStart(); // no log file/thread on REAPER's launch path: the first timer tick starts the writer
     LogF("Plugin entry: caller=0x%08X plugin=0x%08X",
          rec->caller_version, (unsigned)REAPER_PLUGIN_VERSION);
 
@@ -1703,6 +1941,7 @@ REAPER_PLUGIN_ENTRYPOINT(REAPER_PLUGIN_HINSTANCE hInstance, reaper_plugin_info_t
     const int missing = REAPERAPI_LoadAPI(rec->GetFunc);
     if (missing)
       LogF("REAPERAPI_LoadAPI: missing=%d (продолжаем, используем доступные функции)", missing);
+    MarkStartup(StartupMark::ApiLoaded);
 
     if (!plugin_register)
     {
@@ -1715,7 +1954,13 @@ REAPER_PLUGIN_ENTRYPOINT(REAPER_PLUGIN_HINSTANCE hInstance, reaper_plugin_info_t
     LogRaw("=== Plugin init ===");
 
     RegisterCommandId();
+    MarkStartup(StartupMark::CommandsRegistered);
     RegisterAPI();
+    MarkStartup(StartupMark::ApiRegistered);
+    LoadInstanceStateAll(); // records only; windows are reopened from the first timer tick
+    MarkStartup(StartupMark::StateLoaded);
+    plugin_register("timer", (void*)TitleRefreshTimer);
+    MarkStartup(StartupMark::EntryEnd);
     return 1;
   }
   else
@@ -1723,8 +1968,18 @@ REAPER_PLUGIN_ENTRYPOINT(REAPER_PLUGIN_HINSTANCE hInstance, reaper_plugin_info_t
     LogRaw("=== Plugin unload ===");
     UnregisterCommandId();
   UnregisterAPI();
+    plugin_register("-timer", (void*)TitleRefreshTimer);
+    AudioTapShutdown(); // before any window goes: no audio callback may outlive the tap
+    CaptureShutdown(); // joins the encoder worker
+    VideoShutdown(); // detaches the processor: its owner may outlive this module
+    AppAssetsShutdown();
+    LogF("[TitleRefresh] requested=%llu executed=%llu coalesced=%llu flushes=%llu",
+         g_titleRefresh.Requested(), g_titleRefresh.Executed(), g_titleRefresh.Coalesced(), g_titleRefresh.Flushes());
+    LogF("[Focus] focusEvents=%llu visibilityEvents=%llu changes=%llu idleWakeups=%llu",
+         g_focusEvents.focusEvents, g_focusEvents.visibilityEvents, g_focusEvents.changes, g_focusEvents.idleWakeups);
+    SaveInstanceStateAll(); // while windows still exist, so wasOpen is recorded
 
-#ifndef _WIN32
+#ifdef __APPLE__
     // macOS: perform safe explicit cleanup of WKWebView observers prior to window destruction
     // Iterate instances and remove title observers + stop loading to avoid async callbacks after teardown.
     for (auto &kv : g_instances) {
@@ -1743,18 +1998,24 @@ REAPER_PLUGIN_ENTRYPOINT(REAPER_PLUGIN_HINSTANCE hInstance, reaper_plugin_info_t
         bool f=false; int idx=-1;
         bool inDock = DockIsChildOfDock ? (DockIsChildOfDock(kv.second->hwnd,&f) >= 0) : false;
         if (inDock && DockWindowRemove) DockWindowRemove(kv.second->hwnd);
+#if !defined(_WIN32) && !defined(__APPLE__)
+        GtkWebViewDestroy(kv.second.get()); // plug is not a SWELL child: tear down explicitly
+#endif
         DestroyWindow(kv.second->hwnd);
-        kv.second->hwnd = nullptr;
+        g_instances.SetHwnd(kv.second.get(), nullptr);
         LogF("[UnloadCleanup] destroyed hwnd for id='%s'", kv.first.c_str());
       }
     }
     PurgeDeadInstances();
+#ifndef __APPLE__
+    WebViewBackendShutdown(); // pooled browsers + shared environment/context
+#endif
 #ifdef _WIN32
   // Destroy resources for all instances
   for (auto &kv : g_instances) DestroyTitleBarResources(kv.second.get());
     if (g_hWebView2Loader) { FreeLibrary(g_hWebView2Loader); g_hWebView2Loader = nullptr; }
     if (g_com_initialized) { CoUninitialize(); g_com_initialized = false; }
-#else
+#elif defined(__APPLE__)
   // macOS: per-instance UI элементы уже освобождены при уничтожении окон (нет глобальных g_titleBarView/g_titleLabel)
   // Final safety pass (mac): ensure any lingering observers removed
   for (auto &kv : g_instances) {
@@ -1762,6 +2023,7 @@ REAPER_PLUGIN_ENTRYPOINT(REAPER_PLUGIN_HINSTANCE hInstance, reaper_plugin_info_t
     if (recInst->webView) FRZ_RemoveTitleObserverFor(recInst->webView);
   }
 #endif
+    LogShutdown(); // last: joins the log writer thread while the module is still mapped
   }
   return 0;
 }
@@ -1805,48 +2067,57 @@ static WebViewInstanceRecord* ResolveSearchTargetInstance()
     HWND hcur = WindowFromPoint(pt);
     if (hcur){ HWND p=hcur; for(int i=0;i<32 && p; ++i){ WebViewInstanceRecord* r=GetInstanceByHwnd(p); if(r && r->hwnd && IsWindow(r->hwnd) && IsWindowVisible(r->hwnd)) { LogF("[SearchDiag] underCursor id='%s' hwnd=%p", r->id.c_str(), (void*)r->hwnd); return r; } p=GetParent(p);} }
   }
-  // 1.5) Explicit primary
-  if(!g_focusPrimaryInstanceId.empty()){
-    WebViewInstanceRecord* r=GetInstanceById(g_focusPrimaryInstanceId); if(r && r->hwnd && IsWindow(r->hwnd)) return r; }
-  // 1.75) Last focused
-  if(!g_lastFocusedInstanceId.empty()){
-    WebViewInstanceRecord* r=GetInstanceById(g_lastFocusedInstanceId); if(r && r->hwnd && IsWindow(r->hwnd)) return r; }
-  // 2) Among visible windows pick most recent by lastFocusTick
-  WebViewInstanceRecord* best=nullptr; unsigned long bestTick=0; bool anyVisible=false;
-  for(auto &kv: g_instances){ WebViewInstanceRecord* r=kv.second.get(); if(!r||!r->hwnd||!IsWindow(r->hwnd)||!IsWindowVisible(r->hwnd)) continue; anyVisible=true; if(r->lastFocusTick && (!best || (DWORD)(r->lastFocusTick - bestTick) < 0x80000000UL)){ best=r; bestTick=r->lastFocusTick; } }
-  if(best) return best;
-  // 3) Fallback: first visible even if timestamp missing
-  if(anyVisible){ for(auto &kv: g_instances){ WebViewInstanceRecord* r=kv.second.get(); if(r&&r->hwnd&&IsWindow(r->hwnd)&&IsWindowVisible(r->hwnd)) return r; } }
-  // 4) Any instance
-  for(auto &kv: g_instances){ if(kv.second.get()) return kv.second.get(); }
-  return nullptr;
+  // 1.5) primary -> 1.75) last focused -> 2) most recent tick among visible -> 3) first visible -> 4) any
+  return ResolveFocusFallback(g_instances, g_focusPrimaryInstanceId, g_lastFocusedInstanceId,
+    [](WebViewInstanceRecord* r){ return r->hwnd && IsWindow(r->hwnd); },
+    [](WebViewInstanceRecord* r){ return IsWindowVisible(r->hwnd) != 0; });
 }
 
 void UpdateFocusChain(const std::string& inst)
 {
   if (inst.empty()) return; 
-  if (g_focusPrimaryInstanceId == inst) {
-    // Refresh timestamp for stability (user refocused same instance component)
-    WebViewInstanceRecord* rec = GetInstanceById(inst);
-    if (rec) rec->lastFocusTick = GetTickCount();
-    if (g_activeInstanceId != inst){ if(!g_activeInstanceId.empty()) g_lastFocusedInstanceId = g_activeInstanceId; g_activeInstanceId = inst; }
-    if (rec) LogF("[FocusTick] stable id='%s' tick=%lu", rec->id.c_str(), (unsigned long)rec->lastFocusTick);
+  std::string prevPrimary = g_focusPrimaryInstanceId;
+  const bool switched = AdvanceFocusChain(g_focusPrimaryInstanceId, g_activeInstanceId, g_lastFocusedInstanceId, inst);
+  // stamp focus time (also on refocus of the same instance component, for stability)
+  WebViewInstanceRecord* rec = GetInstanceById(inst); if (rec) rec->lastFocusTick = GetTickCount();
+  if (!switched) {
+    if (rec) LogDebugF("[FocusTick] stable id='%s' tick=%lu", rec->id.c_str(), (unsigned long)rec->lastFocusTick);
     LogF("[FocusChain] primary-stable='%s' last='%s'", inst.c_str(), g_lastFocusedInstanceId.c_str());
     return;
   }
-  std::string prevPrimary = g_focusPrimaryInstanceId;
-  if (!g_focusPrimaryInstanceId.empty() && g_focusPrimaryInstanceId != inst) {
-    if (g_lastFocusedInstanceId != g_focusPrimaryInstanceId) {
-      g_lastFocusedInstanceId = g_focusPrimaryInstanceId;
-    }
-  }
-  g_focusPrimaryInstanceId = inst;
-  // stamp focus time
-  WebViewInstanceRecord* rec = GetInstanceById(inst); if (rec) rec->lastFocusTick = GetTickCount();
-  if (g_activeInstanceId != inst){ if(!g_activeInstanceId.empty()) g_lastFocusedInstanceId = g_activeInstanceId; g_activeInstanceId = inst; }
-  if (rec) LogF("[FocusTick] primary-switch id='%s' tick=%lu", rec->id.c_str(), (unsigned long)rec->lastFocusTick);
+  if (rec) LogDebugF("[FocusTick] primary-switch id='%s' tick=%lu", rec->id.c_str(), (unsigned long)rec->lastFocusTick);
   LogF("[FocusChain] primary='%s' last='%s' (prevPrimary='%s')", g_focusPrimaryInstanceId.c_str(), g_lastFocusedInstanceId.c_str(), prevPrimary.c_str());
 }
+FocusEventCounters g_focusEvents;
+
+void OnInstanceFocusEvent(WebViewInstanceRecord* rec, const char* reason)
+{
+  (void)reason; // LogDebugF only
+  if (!rec) return;
+  ++g_focusEvents.focusEvents;
+  const bool idle = g_focusPrimaryInstanceId == rec->id && g_activeInstanceId == rec->id;
+  UpdateFocusChain(rec->id);
+  if (g_activeInstanceId != rec->id) { if (!g_activeInstanceId.empty()) g_lastFocusedInstanceId = g_activeInstanceId; g_activeInstanceId = rec->id; }
+  if (idle) ++g_focusEvents.idleWakeups; else ++g_focusEvents.changes;
+  LogDebugF("[FocusTick] activate id='%s' reason=%s tick=%lu", rec->id.c_str(), reason ? reason : "", (unsigned long)rec->lastFocusTick);
+}
+
+void OnInstanceHostVisibility(WebViewInstanceRecord* rec, bool visible, const char* reason)
+{
+  (void)reason; // LogDebugF only
+  ++g_focusEvents.visibilityEvents;
+  if (!rec || rec->hostVisible == visible) { ++g_focusEvents.idleWakeups; return; }
+  rec->hostVisible = visible;
+  ++g_focusEvents.changes;
+  bool demoted = false;
+  const std::string prevActive = g_activeInstanceId;
+  WebViewInstanceRecord* picked = ResolveActiveOnVisibility(g_instances, g_activeInstanceId, g_lastFocusedInstanceId,
+    [](WebViewInstanceRecord* r) { return r->hostVisible && r->hwnd; }, &demoted);
+  if (demoted) LogDebugF("[FocusTick] deactivate id='%s' reason=hidden", prevActive.c_str());
+  if (picked) { picked->lastFocusTick = GetTickCount(); LogDebugF("[FocusTick] auto-activate id='%s' reason=soleVisible", picked->id.c_str()); }
+  LogDebugF("[FocusTick] visibility id='%s' visible=%d reason=%s", rec->id.c_str(), (int)visible, reason ? reason : "");
+}
+
 static bool Act_Search(int /*flag*/)
 {
 #ifdef _WIN32
@@ -1880,6 +2151,20 @@ static bool Act_Search(int /*flag*/)
     if (rec->findEdit && IsWindow(rec->findEdit)) SendMessageW(rec->findEdit, EM_SETSEL, (WPARAM)-1, (LPARAM)-1);
   }
   return true;
+#elif !defined(__APPLE__)
+  WebViewInstanceRecord* rec = ResolveSearchTargetInstance(); if (!rec || !rec->hwnd) return false;
+  UpdateFocusChain(rec->id);
+  if (!rec->showFindBar) {
+    rec->showFindBar = true;
+    LayoutTitleBarAndWebView(rec->hwnd, rec->titleVisible);
+    if (rec->findEdit) { SetFocus(rec->findEdit); SendMessage(rec->findEdit, EM_SETSEL, 0, -1); }
+    LogRaw("[FindAction][gtk] show via action list");
+  } else {
+    if (rec->findEdit) SetFocus(rec->findEdit);
+    GtkFindNavigate(rec, true);
+    LogF("[FindAction][gtk] nav next query='%s'", rec->findQuery.c_str());
+  }
+  return true;
 #else
   WebViewInstanceRecord* rec = RWV_InternalGetActiveInstance(); if (!rec) return false;
   if (!rec->showFindBar) {
@@ -1898,6 +2183,37 @@ static bool Act_Search(int /*flag*/)
 #endif
 }
 
+// Query prefilled from the target panel's find bar (or the previous search); the hits come back as a menu
+static bool Act_FindAll(int /*flag*/)
+{
+  static std::string s_lastQuery;
+  static bool s_lastCase = false;
+  if (!GetUserInputs) return false;
+  WebViewInstanceRecord* target = ResolveSearchTargetInstance();
+  std::string query = target && !target->findQuery.empty() ? target->findQuery : s_lastQuery;
+  char buf[1024];
+  const bool cs = target && !target->findQuery.empty() ? target->findCaseSensitive : s_lastCase;
+  snprintf(buf, sizeof(buf), "%s\t%s", query.c_str(), cs ? "y" : "n"); // tab-separated: queries may contain commas
+  if (!GetUserInputs("WebView: Find in all panels", 2, "Find:,Match case (y/n):,separator=\t,extrawidth=200", buf, sizeof(buf))) return false;
+  if (const char* tab = strchr(buf, '\t')) {
+    query.assign(buf, tab - buf);
+    s_lastCase = tab[1] == 'y' || tab[1] == 'Y';
+  } else { query = buf; s_lastCase = false; }
+  if (query.empty()) return false;
+  s_lastQuery = query;
+  FindAllOptions opt; opt.caseSensitive = s_lastCase;
+  const int h = FindAllStart(query, opt);
+  if (h < 0) {
+    bool anyOpen = false;
+    for (auto& kv : g_instances) if (kv.second && kv.second->hwnd) anyOpen = true;
+    if (ShowMessageBox) ShowMessageBox(anyOpen ? "Too many searches running, try again in a moment." : "No WebView panels are open.",
+                                       "WebView: Find in all panels", 0);
+    return false;
+  }
+  FindAllShowMenuWhenDone(h);
+  return true;
+}
+
 #ifdef _WIN32
 static INT_PTR CALLBACK RWVUrlDlgProc(HWND h, UINT m, WPARAM w, LPARAM l)
 {
@@ -2048,6 +2364,23 @@ static bool Act_OpenUrlDialog(int /*flag*/)
   INT_PTR r = DialogBoxIndirectParamW((HINSTANCE)g_hInst, &pack.dt, g_hwndParent?g_hwndParent:GetForegroundWindow(), RWVUrlDlgProc, 0);
   LogF("[OpenUrl] dialog result=%lld", (long long)r);
   return r>0;
+#elif !defined(__APPLE__)
+  // Linux: REAPER's GetUserInputs instead of a custom dialog; second field picks the target tab
+  bool haveActive = !g_activeInstanceId.empty(); bool haveLast = !g_lastFocusedInstanceId.empty();
+  const char* defTarget = haveActive ? "current" : (haveLast ? "last" : "new");
+  if (!GetUserInputs) return false;
+  char buf[4096]; snprintf(buf, sizeof(buf), "https://,%s", defTarget);
+  if (!GetUserInputs("WebView: Open URL", 2, "URL:,Tab (current/last/new):,extrawidth=300", buf, sizeof(buf))) return false;
+  char* comma = strrchr(buf, ','); std::string target = comma ? comma+1 : defTarget; if (comma) *comma = 0;
+  std::string raw = buf; if (raw.empty() || raw=="https://") return false;
+  std::string token = (target=="current" || target=="last") ? target : std::string("random");
+  std::string norm, ext, reason; bool embed = NormalizeOrDispatchURL(raw, norm, ext, reason);
+  if (!embed && !ext.empty()) { LogF("[URL][DispatchExternal][DlgGtk] '%s' reason=%s", raw.c_str(), reason.c_str()); ShellExecute(NULL, "open", ext.c_str(), NULL, NULL, SW_SHOWNORMAL); return true; }
+  if (!embed || norm.empty()) { LogF("[URL][Ignore][DlgGtk] '%s' reason=%s", raw.c_str(), reason.c_str()); return false; }
+  char json[256]; snprintf(json, sizeof(json), "{\"InstanceId\":\"%s\"}", token.c_str());
+  LogF("[OpenURLDlg][gtk] submit token='%s' url='%s'", token.c_str(), norm.c_str());
+  API_WEBVIEW_Navigate(norm.c_str(), json);
+  return true;
 #else
   @autoreleasepool {
     bool haveActive = !g_activeInstanceId.empty(); bool haveLast = !g_lastFocusedInstanceId.empty();
@@ -28,11 +28,21 @@
     #include "deps/WebView2.h"
   #endif
 #else
+  #if !defined(__APPLE__) && !defined(WDL_NO_DEFINE_MINMAX)
+  #define WDL_NO_DEFINE_MINMAX // keep SWELL min/max macros away from <limits>/<algorithm> on Linux
+  #endif
   #include "WDL/swell/swell.h"
   #include "WDL/swell/swell-dlggen.h"
   #include "WDL/swell/swell-menugen.h"
-  #import <Cocoa/Cocoa.h>
-  #import <WebKit/WebKit.h>
+  #ifdef __APPLE__
+    #import <Cocoa/Cocoa.h>
+    #import <WebKit/WebKit.h>
+  #else
+    // Linux (SWELL-generic): GTK/WebKitGTK headers are included only by webview_gtk.cpp
+    #include <sys/time.h>
+    #include <strings.h>
+    #include <cstring>
+  #endif
   #ifndef AppendMenuA
   #define AppendMenuA(hMenu, uFlags, uIDNewItem, lpNewItem) InsertMenu(hMenu, -1, MF_BYPOSITION | (uFlags), uIDNewItem, lpNewItem)
   #endif
@@ -0,0 +1,61 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// script_queue_glue.mm
+#include "predef.h"
+#include "globals.h"
+#include "helpers.h"
+#include "log.h"
+#include "webview.h"
+
+// ============================== Script queue ==============================
+// WEBVIEW_ExecuteScript (core/script_queue.h): every tick each live instance with queued scripts gets one
+// batched evaluate; ReaScript polls the handles through WEBVIEW_GetScriptResult.
+static ScriptQueue g_scripts;
+
+uint64_t ScriptNowMs() { return PerfNowUs() / 1000; }
+
+static void OnScriptBatch(const std::string& id, const std::string& result)
+{
+  g_scripts.OnBatchResult(id, result, ScriptNowMs());
+}
+
+int ScriptEnqueue(const std::string& id, const std::string& js, const ScriptLimits& limits)
+{
+  if (!GetInstanceById(id)) return -1;
+  const int h = g_scripts.Enqueue(id, js, limits, ScriptNowMs());
+  if (h < 0) LogF("[Script] id='%s' queue full (%u outstanding)", id.c_str(), (unsigned)ScriptQueue::kMaxOutstanding);
+  return h;
+}
+
+ScriptState ScriptGetResult(int handle, std::string& out, bool consume) { return g_scripts.Get(handle, out, consume); }
+
+void ScriptQueueRelease(WebViewInstanceRecord* rec)
+{
+  if (rec) g_scripts.DropInstance(rec->id, ScriptNowMs());
+}
+
+void ScriptQueueTick()
+{
+  if (!g_scripts.Outstanding()) return;
+  const uint64_t now = ScriptNowMs();
+  g_scripts.Expire(now);
+  static std::vector<std::string> s_ready;
+  g_scripts.ReadyInstances(s_ready);
+  std::string js;
+  for (const std::string& id : s_ready) {
+    WebViewInstanceRecord* rec = GetInstanceById(id);
+    if (!rec) { g_scripts.DropInstance(id, now); continue; }
+    // hibernated / not yet created: scripts wait (and time out) until the page is live
+    if (rec->hibernate != HibernateState::Active || !WebViewHasView(rec)) continue;
+    if (g_scripts.BuildBatch(id, now, js)) WebViewEvalScript(rec, js, OnScriptBatch);
+  }
+}
+
+void ScriptQueueAppendStatsJson(std::string& out)
+{
+  char buf[256];
+  snprintf(buf, sizeof(buf), "{\"enqueued\":%llu,\"batches\":%llu,\"maxBatch\":%llu,\"outstanding\":%zu,\"timeouts\":%llu,\"tooLarge\":%llu,\"lateAnswers\":%llu}",
+           g_scripts.Enqueued(), g_scripts.Batches(), g_scripts.MaxBatch(), g_scripts.Outstanding(), g_scripts.Timeouts(), g_scripts.TooLarge(), g_scripts.LateAnswers());
+  out += buf;
+}
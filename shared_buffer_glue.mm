@@ -0,0 +1,70 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// shared_buffer_glue.mm
+#include "predef.h"
+#include "globals.h"
+#include "helpers.h"
+#include "log.h"
+#include "webview.h"
+
+// ============================== Shared buffers ==============================
+// Native writers fill a slot in place (Lock/Commit); the timer tick publishes the latest committed version
+// of each dirty slot to visible pages, so bursts of writes within one tick cost one publish.
+static const uint32_t kSharedBufferMaxFloats = 16u << 20; // 64 MB per buffer
+
+static SharedBufferSlot* FindSharedBuffer(WebViewInstanceRecord* rec, const char* name)
+{
+  for (auto& s : rec->sharedBuffers) if (s->name == name) return s.get();
+  return nullptr;
+}
+
+float* SharedBufferLock(const std::string& id, const char* name, uint32_t capacity)
+{
+  WebViewInstanceRecord* rec = GetInstanceById(id);
+  if (!rec || !IsValidSharedBufferName(name) || !capacity || capacity > kSharedBufferMaxFloats) return nullptr;
+  SharedBufferSlot* slot = FindSharedBuffer(rec, name);
+  if (!slot) {
+    rec->sharedBuffers.push_back(std::make_unique<SharedBufferSlot>());
+    slot = rec->sharedBuffers.back().get(); slot->name = name;
+  }
+  if (capacity > slot->Capacity()) {
+    if (slot->writing) return nullptr; // a pending Lock must be committed before growing
+    uint32_t cap = slot->Capacity() * 2; if (cap < capacity) cap = capacity; if (cap > kSharedBufferMaxFloats) cap = kSharedBufferMaxFloats;
+    WebViewSharedBufferAlloc(rec, *slot, cap);
+    LogF("[SharedBuf] id='%s' '%s' capacity=%u mapped=%d", rec->id.c_str(), name, cap, (int)slot->mapped);
+  }
+  return slot->BeginWrite();
+}
+
+int SharedBufferCommit(const std::string& id, const char* name, uint32_t count)
+{
+  WebViewInstanceRecord* rec = GetInstanceById(id);
+  SharedBufferSlot* slot = (rec && name) ? FindSharedBuffer(rec, name) : nullptr;
+  if (!slot || !slot->mem) return -1;
+  slot->EndWrite(count);
+  return (int)slot->Seq();
+}
+
+void SharedBufferRelease(WebViewInstanceRecord* rec)
+{
+  if (!rec) return;
+  for (auto& s : rec->sharedBuffers) WebViewSharedBufferFree(*s);
+  rec->sharedBuffers.clear();
+}
+
+void SharedBufferTick()
+{
+  for (auto& kv : g_instances) {
+    WebViewInstanceRecord* rec = kv.second.get();
+    if (!rec || rec->sharedBuffers.empty()) continue;
+    if (!rec->hwnd || !IsWindow(rec->hwnd) || !IsWindowVisible(rec->hwnd)) continue; // published when shown
+    if (rec->hibernate != HibernateState::Active || !WebViewHasView(rec)) continue;
+    for (auto& s : rec->sharedBuffers) {
+      if (!s->dirty || s->writing) continue;
+      WebViewSharedBufferPublish(rec, *s);
+      s->dirty = false; s->publishes++;
+    }
+  }
+}
+
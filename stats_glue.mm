@@ -0,0 +1,128 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// stats_glue.mm
+#include "predef.h"
+#include "globals.h"
+#include "helpers.h"
+#include "log.h"
+#include "webview.h"
+#include "core/json_cursor.h"
+
+#include <time.h>
+
+// ============================== instance info ==============================
+// WEBVIEW_GetInstanceInfo: state, hibernation counters and each subsystem's share (stream, audio, video, filter, buffers)
+bool DescribeInstanceJson(const std::string& id, std::string& out)
+{
+  WebViewInstanceRecord* rec = GetInstanceById(id);
+  if (!rec) return false;
+  const bool live = rec->hwnd && IsWindow(rec->hwnd);
+  const bool visible = live && IsWindowVisible(rec->hwnd);
+  const unsigned hiddenMs = (!visible && rec->hiddenSinceTick) ? (unsigned)(GetTickCount() - rec->hiddenSinceTick) : 0u;
+  const char* state = !live ? "closed" : (rec->hibernate == HibernateState::Active && rec->webViewDeferred) ? "deferred" : HibernateStateName(rec->hibernate);
+  char tail[512];
+  snprintf(tail, sizeof(tail), ",\"state\":\"%s\",\"visible\":%s,\"hiddenMs\":%u,\"jsHeapBytes\":%lld,\"lastResumeMs\":%d,"
+           "\"suspendCount\":%d,\"discardCount\":%d,\"resumeCount\":%d,\"url\":",
+           state, visible ? "true" : "false", hiddenMs, rec->jsHeapBytes, rec->lastResumeMs,
+           rec->suspendCount, rec->discardCount, rec->resumeCount);
+  out = "{\"id\":"; JsonAppendQuoted(out, rec->id);
+  out += tail; JsonAppendQuoted(out, rec->lastUrl);
+  const StateStream& st = rec->stream;
+  snprintf(tail, sizeof(tail), ",\"stream\":{\"topics\":\"%s\",\"hz\":%d,\"messages\":%llu,\"bytes\":%llu,\"msgPerSec\":%.1f,"
+           "\"avgTickUs\":%.1f,\"maxTickUs\":%.1f}",
+           StreamTopicsToString(st.Topics()).c_str(), st.Topics() ? st.Hz() : 0, st.Messages(), st.Bytes(),
+           st.MessagesPerSec(GetTickCount()), st.AvgCostUs(), st.MaxCostUs());
+  out += tail;
+  AudioTapAppendInstanceJson(rec, out);
+  VideoAppendInstanceJson(rec, out);
+  ContentFilterAppendInstanceJson(rec, out);
+  out += ",\"buffers\":[";
+  for (size_t i = 0; i < rec->sharedBuffers.size(); ++i) {
+    const SharedBufferSlot& s = *rec->sharedBuffers[i];
+    snprintf(tail, sizeof(tail), "%s{\"name\":\"%s\",\"capacity\":%u,\"count\":%u,\"seq\":%u,\"mapped\":%s,\"writes\":%llu,"
+             "\"publishes\":%llu,\"superseded\":%llu,\"bytesShipped\":%llu}",
+             i ? "," : "", s.name.c_str(), s.Capacity(), s.Count(), s.Seq(), s.mapped ? "true" : "false",
+             s.writes, s.publishes, s.superseded, s.bytesShipped);
+    out += tail;
+  }
+  out += "]}";
+  return true;
+}
+
+// ============================== performance counters ==============================
+// Recorded into rec->stats (core/perf_stats.h) by the backends and the glue files; read by WEBVIEW_GetStats / DumpStats.
+static void AppendInstanceStatsJson(WebViewInstanceRecord* rec, std::string& out, uint64_t now)
+{
+  out += "{\"id\":"; JsonAppendQuoted(out, rec->id);
+  out += ",\"url\":"; JsonAppendQuoted(out, rec->lastUrl);
+  out += ",\"stats\":";
+  rec->stats.AppendJson(out, now);
+  out += '}';
+}
+
+bool DescribeInstanceStatsJson(const std::string& id, std::string& out)
+{
+  const uint64_t now = PerfNowUs();
+  out.clear();
+  if (!id.empty()) {
+    WebViewInstanceRecord* rec = GetInstanceById(id);
+    if (!rec) return false;
+    AppendInstanceStatsJson(rec, out, now);
+    return true;
+  }
+  out = "{\"instances\":[";
+  bool first = true;
+  for (auto& kv : g_instances) {
+    if (!kv.second) continue;
+    if (!first) out += ',';
+    first = false;
+    AppendInstanceStatsJson(kv.second.get(), out, now);
+  }
+  char tail[160];
+  snprintf(tail, sizeof(tail), "],\"focus\":{\"focusEvents\":%llu,\"visibilityEvents\":%llu,\"changes\":%llu,\"idleWakeups\":%llu}",
+           g_focusEvents.focusEvents, g_focusEvents.visibilityEvents, g_focusEvents.changes, g_focusEvents.idleWakeups);
+  out += tail;
+  out += ",\"scripts\":"; ScriptQueueAppendStatsJson(out);
+  out += ",\"capture\":"; CaptureAppendStatsJson(out);
+  out += ",\"findAll\":"; FindAllAppendStatsJson(out);
+  out += ",\"startup\":"; StartupAppendJson(out);
+  out += '}';
+  return true;
+}
+
+int DumpInstanceStatsCsv(const std::string& path)
+{
+  std::string file = path;
+  if (file.empty()) {
+    const char* res = GetResourcePath ? GetResourcePath() : nullptr;
+    if (!res || !*res) return -1;
+#ifdef _WIN32
+    file = std::string(res) + "\\reaper_webview_stats.csv";
+#else
+    file = std::string(res) + "/reaper_webview_stats.csv";
+#endif
+  }
+#ifdef _WIN32
+  FILE* f = _wfopen(Widen(file).c_str(), L"ab");
+#else
+  FILE* f = fopen(file.c_str(), "ab");
+#endif
+  if (!f) { LogF("[Stats] cannot open '%s'", file.c_str()); return -1; }
+  fseek(f, 0, SEEK_END);
+  std::string text;
+  if (ftell(f) == 0) { text = InstanceStats::CsvHeader(); text += '\n'; }
+  const uint64_t now = PerfNowUs();
+  const long long unixSec = (long long)time(nullptr);
+  int rows = 0;
+  for (auto& kv : g_instances) {
+    if (!kv.second) continue;
+    kv.second->stats.AppendCsv(text, kv.second->id, unixSec, now);
+    text += '\n'; ++rows;
+  }
+  const bool ok = fwrite(text.data(), 1, text.size(), f) == text.size();
+  fclose(f);
+  LogF("[Stats] %d rows -> '%s'%s", rows, file.c_str(), ok ? "" : " (write failed)");
+  return ok ? rows : -1;
+}
+
@@ -0,0 +1,108 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// stream_glue.mm
+#include "predef.h"
+#include "globals.h"
+#include "helpers.h"
+#include "log.h"
+#include "webview.h"
+
+#include <chrono>
+
+// ============================== State stream ==============================
+// Pages subscribe through window.__rwvState ("SUB|topics|hz", core/stream_script.h). Each timer tick the
+// union of the topics that are due is sampled once, then every due instance gets its own delta
+// (core/state_stream.h). Hidden or hibernated panels are skipped and catch up with a delta when shown.
+typedef std::chrono::steady_clock StreamClock;
+static double StreamUsSince(StreamClock::time_point t) { return std::chrono::duration<double, std::micro>(StreamClock::now() - t).count(); }
+
+void OnPageBridgeMessage(WebViewInstanceRecord* rec, const std::string& msg)
+{
+  if (rec) rec->stats.BridgeIn(msg.size());
+  if (rec && msg.compare(0, 4, "AUD|") == 0) { OnAudioTapMessage(rec, msg); return; }
+  if (rec && msg.compare(0, 4, "VID|") == 0) { OnVideoMessage(rec, msg); return; }
+  if (!rec || msg.compare(0, 4, "SUB|") != 0) return;
+  const size_t bar = msg.find('|', 4);
+  const std::string names = msg.substr(4, bar == std::string::npos ? std::string::npos : bar - 4);
+  const int hz = bar == std::string::npos ? 0 : atoi(msg.c_str() + bar + 1);
+  const unsigned topics = ParseStreamTopics(names.data(), names.size());
+  if (!topics) {
+    if (rec->stream.Topics()) LogF("[Stream] id='%s' unsubscribed", rec->id.c_str());
+    rec->stream.Unsubscribe();
+    return;
+  }
+  rec->stream.Subscribe(topics, hz);
+  LogF("[Stream] id='%s' subscribed topics=%s hz=%d", rec->id.c_str(), StreamTopicsToString(topics).c_str(), rec->stream.Hz());
+}
+
+static void SampleStreamFrame(unsigned topics, StreamFrame& f)
+{
+  f.topics = topics;
+  if (topics & kStreamTransport) {
+    StreamTransport& t = f.transport;
+    t.playState = GetPlayState ? GetPlayState() : 0;
+    t.cursor = GetCursorPosition ? GetCursorPosition() : 0.0;
+    t.position = ((t.playState & 5) && GetPlayPosition) ? GetPlayPosition() : t.cursor;
+    t.bpm = Master_GetTempo ? Master_GetTempo() : 0.0;
+    t.repeat = GetSetRepeat ? GetSetRepeat(-1) != 0 : false;
+  }
+  const int n = (CountTracks && GetTrack) ? CountTracks(nullptr) : 0;
+  if (topics & kStreamTracks) {
+    f.tracks.resize(GetMediaTrackInfo_Value ? n : 0);
+    char buf[256];
+    for (int i = 0; i < (int)f.tracks.size(); ++i) {
+      MediaTrack* tr = GetTrack(nullptr, i); StreamTrack& t = f.tracks[i];
+      buf[0] = 0; if (GUID* g = (GetTrackGUID && guidToString) ? GetTrackGUID(tr) : nullptr) guidToString(g, buf); t.guid = buf;
+      buf[0] = 0; if (GetTrackName) GetTrackName(tr, buf, sizeof(buf)); t.name = buf;
+      t.flags = (GetMediaTrackInfo_Value(tr, "I_SELECTED") != 0 ? kStreamTrackSelected : 0) |
+                (GetMediaTrackInfo_Value(tr, "B_MUTE") != 0 ? kStreamTrackMuted : 0) |
+                (GetMediaTrackInfo_Value(tr, "I_SOLO") != 0 ? kStreamTrackSoloed : 0);
+      t.color = (int)GetMediaTrackInfo_Value(tr, "I_CUSTOMCOLOR");
+    }
+  }
+  if (topics & kStreamMeters) {
+    f.peaks.assign((size_t)(n + 1) * 2, 0.0f);
+    if (Track_GetPeakInfo) {
+      for (int s = 0; s <= n; ++s) {
+        MediaTrack* tr = s ? GetTrack(nullptr, s - 1) : (GetMasterTrack ? GetMasterTrack(nullptr) : nullptr);
+        if (!tr) continue;
+        f.peaks[s * 2] = (float)Track_GetPeakInfo(tr, 0);
+        f.peaks[s * 2 + 1] = (float)Track_GetPeakInfo(tr, 1);
+      }
+    }
+  }
+}
+
+void StateStreamTick()
+{
+  static std::vector<WebViewInstanceRecord*> s_due;
+  static StreamFrame s_frame;
+  static std::string s_msg;
+  const DWORD now = GetTickCount();
+  unsigned topics = 0;
+  s_due.clear();
+  for (auto& kv : g_instances) {
+    WebViewInstanceRecord* rec = kv.second.get();
+    if (!rec || !rec->stream.Due(now)) continue;
+    if (!rec->hwnd || !IsWindow(rec->hwnd) || !IsWindowVisible(rec->hwnd)) continue;
+    if (rec->hibernate != HibernateState::Active || !WebViewHasView(rec)) continue;
+    topics |= rec->stream.Topics();
+    s_due.push_back(rec);
+  }
+  if (s_due.empty()) return; // no subscriber: no REAPER calls at all
+
+  const StreamClock::time_point t0 = StreamClock::now();
+  SampleStreamFrame(topics, s_frame);
+  const double sampleShareUs = StreamUsSince(t0) / (double)s_due.size();
+  for (WebViewInstanceRecord* rec : s_due) {
+    const StreamClock::time_point t1 = StreamClock::now();
+    if (rec->stream.Encode(s_frame, now, s_msg)) WebViewPostState(rec, s_msg);
+    rec->stream.AddCost(StreamUsSince(t1) + sampleShareUs);
+  }
+}
+
+void StateStreamRelease(WebViewInstanceRecord* rec)
+{
+  if (rec) rec->stream.Unsubscribe();
+}
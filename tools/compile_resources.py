@@ -5,6 +5,69 @@ import glob
 from pathlib import Path
 
 # Usage: python compile_resources.py <input_dir> <output_h> <output_cpp>
+#        python compile_resources.py --bundle <input_dir> <output_cpp>   (rwv:// asset bundle, core/asset_bundle.h)
+
+MIME_TYPES = {
+    '.html': 'text/html; charset=utf-8', '.htm': 'text/html; charset=utf-8', '.js': 'text/javascript; charset=utf-8',
+    '.mjs': 'text/javascript; charset=utf-8', '.css': 'text/css; charset=utf-8', '.json': 'application/json',
+    '.svg': 'image/svg+xml', '.png': 'image/png', '.jpg': 'image/jpeg', '.jpeg': 'image/jpeg', '.gif': 'image/gif',
+    '.webp': 'image/webp', '.ico': 'image/x-icon', '.wasm': 'application/wasm', '.txt': 'text/plain; charset=utf-8',
+    '.woff': 'font/woff', '.woff2': 'font/woff2', '.ttf': 'font/ttf', '.map': 'application/json',
+}
+
+def c_string(s: str) -> str:
+    return '"' + s.replace('\\', '\\\\').replace('"', '\\"') + '"'
+
+def write_bundle(input_dir: Path, output_cpp: Path):
+    import zlib
+    files = []
+    if input_dir.is_dir():
+        files = [p for p in input_dir.rglob('*') if p.is_file() and not p.name.startswith('.')]
+    # byte order of the UTF-8 paths, as AssetServer::Find compares with strcmp
+    files.sort(key=lambda p: p.relative_to(input_dir).as_posix().encode('utf-8'))
+    blob = bytearray()
+    entries = []
+    raw_total = 0
+    for p in files:
+        data = p.read_bytes()
+        packed = zlib.compress(data, 9)
+        if len(packed) >= len(data):
+            packed = data  # stored: AssetServer copies instead of inflating
+        rel = p.relative_to(input_dir).as_posix()
+        etag = '"%08x-%x"' % (zlib.crc32(data) & 0xffffffff, len(data))
+        mime = MIME_TYPES.get(p.suffix.lower(), 'application/octet-stream')
+        entries.append((rel, mime, etag, len(data), len(blob), len(packed)))
+        blob += packed
+        raw_total += len(data)
+    cpp = ['// Auto-generated by compile_resources.py --bundle. DO NOT EDIT MANUALLY.',
+           '#include "core/asset_bundle.h"', '']
+    cpp.append('static const unsigned char kBlob[] = {')
+    for i in range(0, len(blob), 16):
+        cpp.append('  ' + ''.join(f'0x{b:02x},' for b in blob[i:i + 16]))
+    if not blob:
+        cpp.append('  0')
+    cpp.append('};')
+    cpp.append('')
+    cpp.append('static const AssetEntry kEntries[] = {')
+    for rel, mime, etag, size, offset, packed in entries:
+        cpp.append(f'  {{ {c_string(rel)}, {c_string(mime)}, {c_string(etag)}, {size}u, {offset}u, {packed}u }},')
+    if not entries:
+        cpp.append('  { "", "", "", 0u, 0u, 0u }')
+    cpp.append('};')
+    cpp.append('')
+    cpp.append(f'static const AssetBundleData kBundle = {{ kEntries, {len(entries)}u, kBlob }};')
+    cpp.append('const AssetBundleData* GetEmbeddedAssetBundle() { return &kBundle; }')
+    output_cpp.parent.mkdir(parents=True, exist_ok=True)
+    output_cpp.write_text('\n'.join(cpp) + '\n', encoding='utf-8')
+    print(f"Bundled {len(entries)} assets from {input_dir}: {raw_total} -> {len(blob)} bytes -> {output_cpp}")
+
+if len(sys.argv) >= 2 and sys.argv[1] == '--bundle':
+    if len(sys.argv) < 4:
+        print("Usage: python compile_resources.py --bundle <input_dir> <output_cpp>")
+        sys.exit(1)
+    write_bundle(Path(sys.argv[2]).resolve(), Path(sys.argv[3]))
+    sys.exit(0)
+
 if len(sys.argv) < 4:
     print("Usage: python compile_resources.py <input_dir> <output_h> <output_cpp>")
     sys.exit(1)
@@ -0,0 +1,153 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// video_glue.mm
+#include "predef.h"
+#include "globals.h"
+#include "helpers.h"
+#include "log.h"
+#include "webview.h"
+#include "video_processor.h"
+
+#include <atomic>
+
+// ============================== Video frames ==============================
+// Pages subscribe through __rwvState.subscribeVideo ("VID|maxWidth|fps") and acknowledge every frame they
+// handled ("VID|ack|seq"). The producer copies (and scales) each frame once into the mailbox; the timer tick
+// hands the newest one to every ready panel through its "video" shared buffer: [w, h, seq (u32 bits), 0,
+// RGBA pixels, one float slot per pixel]. A panel with a frame still in flight skips the newer ones.
+// The attached processor belongs to its creator (a video FX: video_CreateVideoProcessor needs an FX context,
+// so the plugin cannot create one itself). Contract: the owner detaches (VideoAttachProcessor(nullptr)) before
+// it destroys the processor. Attach wraps the owner's process_frame and leaves its userdata alone: the wrapper
+// calls the owner's callback, copies the frame it returns for the panels and hands that frame back to REAPER
+// unchanged; detach puts the owner's callback back. The field is written with release stores and the video
+// thread is only trusted for a processor that is still the attached one.
+static VideoMailbox g_videoMailbox;
+static IREAPERVideoProcessor* g_videoProc = nullptr; // main thread
+static std::atomic<IREAPERVideoProcessor*> g_videoProcLive{nullptr}; // read by the video thread
+static std::atomic<int> g_videoInCallback{0};
+typedef IVideoFrame* (*VideoProcessFrameFn)(IREAPERVideoProcessor*, const double*, int, double, double, int);
+static std::atomic<VideoProcessFrameFn> g_videoOwnerProcess{nullptr}; // set before the wrapper is installed
+
+template <class P> static void StorePtrRelease(P& slot, P v)
+{
+#ifdef _WIN32
+  InterlockedExchangePointer((PVOID volatile*)&slot, (PVOID)v);
+#else
+  __atomic_store_n(&slot, v, __ATOMIC_RELEASE);
+#endif
+}
+
+// Video thread: run the owner's process_frame and keep a copy of its output for the panels. Without an owner
+// callback (or when it returns something other than RGBA) the panels get the processor's first input instead.
+static IVideoFrame* OnVideoProcessFrame(IREAPERVideoProcessor* vproc, const double* parms, int nparms,
+                                        double project_time, double frate, int force_format)
+{
+  g_videoInCallback.fetch_add(1, std::memory_order_acq_rel);
+  const bool live = vproc == g_videoProcLive.load(std::memory_order_acquire);
+  VideoProcessFrameFn owner = g_videoOwnerProcess.load(std::memory_order_acquire); // cleared only after the wait in detach
+  IVideoFrame* out = owner ? owner(vproc, parms, nparms, project_time, frate, force_format)
+                           : (vproc->getNumInputs() > 0 ? vproc->renderInputVideoFrame(0, 'RGBA') : nullptr);
+  if (live && g_videoMailbox.MaxWidth()) {
+    IVideoFrame* shown = out;
+    if ((!shown || shown->get_fmt() != 'RGBA') && vproc->getNumInputs() > 0) shown = vproc->renderInputVideoFrame(0, 'RGBA');
+    if (shown && shown->get_fmt() == 'RGBA')
+      g_videoMailbox.Publish((const uint8_t*)shown->get_bits(), shown->get_w(), shown->get_h(), shown->get_rowspan());
+  }
+  g_videoInCallback.fetch_sub(1, std::memory_order_acq_rel);
+  return out; // the owner's frame as is (returned input frames are allowed as long as they are not modified)
+}
+
+static void VideoDetachCurrent()
+{
+  IREAPERVideoProcessor* old = g_videoProc;
+  if (!old) return;
+  g_videoProcLive.store(nullptr, std::memory_order_release);
+  StorePtrRelease(old->process_frame, g_videoOwnerProcess.load(std::memory_order_relaxed));
+  g_videoProc = nullptr;
+  // a frame already inside OnVideoProcessFrame finishes before this module may go away (bounded wait)
+  for (int i = 0; i < 200 && g_videoInCallback.load(std::memory_order_acquire); ++i) Sleep(1);
+  g_videoOwnerProcess.store(nullptr, std::memory_order_release);
+}
+
+bool VideoAttachProcessor(void* videoProcessor)
+{
+  IREAPERVideoProcessor* vp = (IREAPERVideoProcessor*)videoProcessor;
+  if (vp == g_videoProc) return true;
+  VideoDetachCurrent();
+  if (vp) {
+    g_videoOwnerProcess.store(vp->process_frame, std::memory_order_release);
+    g_videoProc = vp;
+    g_videoProcLive.store(vp, std::memory_order_release);
+    StorePtrRelease(vp->process_frame, (VideoProcessFrameFn)OnVideoProcessFrame); // last: the video thread may call it right away
+  }
+  LogF("[Video] processor %s", vp ? "attached" : "detached");
+  return true;
+}
+
+bool VideoPushFrame(const void* rgba, int w, int h, int rowspan)
+{
+  return g_videoMailbox.Publish((const uint8_t*)rgba, w, h, rowspan > 0 ? rowspan : w * 4);
+}
+
+void OnVideoMessage(WebViewInstanceRecord* rec, const std::string& msg)
+{
+  if (msg.compare(0, 8, "VID|ack|") == 0) { rec->video.OnAck((uint32_t)strtoul(msg.c_str() + 8, nullptr, 10), VideoClockUs()); return; }
+  const int width = atoi(msg.c_str() + 4);
+  const size_t bar = msg.find('|', 4);
+  if (width <= 0) {
+    if (rec->video.Subscribed()) LogF("[Video] id='%s' unsubscribed", rec->id.c_str());
+    rec->video.Unsubscribe();
+    return;
+  }
+  rec->video.Subscribe(width, bar == std::string::npos ? 30 : atoi(msg.c_str() + bar + 1));
+  LogF("[Video] id='%s' subscribed maxWidth=%d source=%s", rec->id.c_str(), rec->video.MaxWidth(), g_videoProc ? "processor" : "push");
+}
+
+void VideoTick()
+{
+  int maxW = 0; // widest subscriber sets the producer's scale; 0 makes Publish return before copying
+  for (auto& kv : g_instances)
+    if (kv.second && kv.second->video.Subscribed() && kv.second->video.MaxWidth() > maxW) maxW = kv.second->video.MaxWidth();
+  g_videoMailbox.SetMaxWidth(maxW);
+  const VideoFrameBuf* f = maxW ? g_videoMailbox.Take() : nullptr;
+  if (!f) return;
+  const int64_t now = VideoClockUs();
+  for (auto& kv : g_instances) {
+    WebViewInstanceRecord* rec = kv.second.get();
+    if (!rec || !rec->video.Subscribed()) continue;
+    if (!rec->hwnd || !IsWindow(rec->hwnd) || !IsWindowVisible(rec->hwnd)) continue;
+    if (rec->hibernate != HibernateState::Active || !WebViewHasView(rec)) continue;
+    if (!rec->video.Ready(now)) continue;
+    const uint32_t pixels = (uint32_t)f->w * (uint32_t)f->h;
+    float* d = SharedBufferLock(rec->id, "video", 4 + pixels);
+    if (!d) continue;
+    d[0] = (float)f->w; d[1] = (float)f->h; memcpy(&d[2], &f->seq, sizeof(uint32_t)); d[3] = 0;
+    memcpy(d + 4, f->px.data(), (size_t)pixels * 4);
+    SharedBufferCommit(rec->id, "video", 4 + pixels);
+    rec->video.OnSent(*f, now);
+  }
+}
+
+void VideoRelease(WebViewInstanceRecord* rec)
+{
+  if (rec) rec->video.Unsubscribe();
+}
+
+// The processor's owner may outlive this module
+void VideoShutdown()
+{
+  if (g_videoProc) VideoAttachProcessor(nullptr);
+}
+
+void VideoAppendInstanceJson(WebViewInstanceRecord* rec, std::string& out)
+{
+  if (!rec || !rec->video.Subscribed()) return;
+  const VideoLink& v = rec->video;
+  char buf[512];
+  snprintf(buf, sizeof(buf), ",\"video\":{\"maxWidth\":%d,\"sent\":%llu,\"shown\":%llu,\"skipped\":%llu,\"fps\":%.1f,"
+           "\"avgLatencyMs\":%.1f,\"maxLatencyMs\":%.1f,\"sourceFrames\":%llu,\"sourceDrops\":%llu,\"copyUs\":%.1f}",
+           v.MaxWidth(), v.Sent(), v.Shown(), v.Skipped(), v.Fps(), v.AvgLatencyMs(), v.MaxLatencyMs(),
+           g_videoMailbox.Produced(), g_videoMailbox.Overwritten(), g_videoMailbox.AvgCopyUs());
+  out += buf;
+}
@@ -4,10 +4,52 @@
 // webview.h
 #pragma once
 #include "predef.h"
+#include "core/shared_buffer.h"
+#include "core/panel_capture.h"
 
-// Platform-specific WebView initialization, implementations live in webview_win.cpp / webview_mac.mm
+// Platform-specific WebView initialization, implementations live in webview_win.cpp / webview_mac.mm / webview_gtk.cpp
 void StartWebView(HWND hwnd, const std::string& initial_url);
 
+// Script evaluation, result delivered as a plain string (fn may be null). The callback gets the instance
+// id rather than the record: the instance can be gone by the time the script completes.
+typedef void (*ScriptResultFn)(const std::string& instanceId, const std::string& result);
+void WebViewEvalScript(struct WebViewInstanceRecord* rec, const std::string& js, ScriptResultFn fn);
+
+// Panel snapshot for WEBVIEW_Capture (core/panel_capture.h): the backend copies the pixels out (or the encoded
+// image) on the main thread and never encodes; px is null on failure, error is then set. Like scripts, the
+// callback gets the instance id: the panel can be closed before the snapshot completes.
+typedef void (*SnapshotFn)(const std::string& instanceId, int token, CapturePixels* px, const char* error);
+void WebViewSnapshot(struct WebViewInstanceRecord* rec, int token, SnapshotFn fn);
+#ifdef _WIN32
+// WIC decoder for the PNG CapturePreview hands back (runs on the capture worker)
+bool WebViewDecodeSnapshot(const uint8_t* data, size_t len, CapturePixels& out);
+#endif
+
+// One state-stream batch (core/state_stream.h) into the page's window.__rwvState; no result, no callback
+void WebViewPostState(struct WebViewInstanceRecord* rec, const std::string& json);
+
+// Shared float buffers (core/shared_buffer.h): slot memory (mapped into the page where the engine can,
+// heap otherwise), per-tick publish to window.__rwvBuffers, and release of the backend handle
+void WebViewSharedBufferAlloc(struct WebViewInstanceRecord* rec, SharedBufferSlot& slot, uint32_t capacity);
+void WebViewSharedBufferPublish(struct WebViewInstanceRecord* rec, SharedBufferSlot& slot);
+void WebViewSharedBufferFree(SharedBufferSlot& slot);
+
+// Installs, swaps or removes the instance's request filter (ContentFilterFor in filter_glue.mm) on its live view
+void WebViewApplyContentFilter(struct WebViewInstanceRecord* rec);
+
+// Hibernation hooks (hibernate_glue.mm)
+bool WebViewCanSuspend();                                  // backend has a native suspend
+bool WebViewSuspend(struct WebViewInstanceRecord* rec);    // false if refused/unsupported
+void WebViewResume(struct WebViewInstanceRecord* rec);
+bool WebViewIsPlayingAudio(struct WebViewInstanceRecord* rec);
+bool WebViewHasView(struct WebViewInstanceRecord* rec);
+void WebViewDestroyView(struct WebViewInstanceRecord* rec); // drop the browser, keep the host window
+
+#if !defined(__APPLE__)
+// Releases the shared browser environment/context and any pooled hidden browsers (plugin unload)
+void WebViewBackendShutdown();
+#endif
+
 #ifdef _WIN32
 // Native Find API helpers (implemented in webview_win.cpp)
 void WinEnsureNativeFind(struct WebViewInstanceRecord* rec); // acquire ICoreWebView2Find and options if available
@@ -15,3 +57,15 @@ void WinFindStartOrUpdate(struct WebViewInstanceRecord* rec); // (re)start searc
 void WinFindNavigate(struct WebViewInstanceRecord* rec, bool forward); // navigate next/prev
 void WinFindClose(struct WebViewInstanceRecord* rec); // stop & release if needed
 #endif
+
+#if !defined(_WIN32) && !defined(__APPLE__)
+// Linux WebKitGTK helpers (implemented in webview_gtk.cpp); main.mm never includes GTK headers
+void GtkLayoutWebView(struct WebViewInstanceRecord* rec, const RECT& r); // move X bridge + resize plug
+bool GtkWebViewQuery(struct WebViewInstanceRecord* rec, std::string* outUrl, std::string* outTitle);
+bool GtkWebViewCanGo(struct WebViewInstanceRecord* rec, bool forward);
+void GtkWebViewGo(struct WebViewInstanceRecord* rec, int dir); // -1 back, +1 forward, 0 reload
+void GtkWebViewDestroy(struct WebViewInstanceRecord* rec);
+void GtkFindStartOrUpdate(struct WebViewInstanceRecord* rec);
+void GtkFindNavigate(struct WebViewInstanceRecord* rec, bool forward);
+void GtkFindClose(struct WebViewInstanceRecord* rec);
+#endif
@@ -11,6 +11,9 @@
 #include "webview.h"
 #include "log.h"
 #include <unordered_map> // for observer maps
+#include <algorithm>
+#include "core/find_script.h"
+#include "core/stream_script.h"
 
 // Forward decls for functions implemented in main.mm (mac UI helpers)
 extern "C" void MacFindNavigate(struct WebViewInstanceRecord* rec, bool forward);
@@ -22,6 +25,58 @@ extern "C" void MacFindNavigate(struct WebViewInstanceRecord* rec, bool forward)
 @interface FRZWebViewDelegate : NSObject <WKNavigationDelegate, WKScriptMessageHandler>
 @end
 
+// WKWebView that reports its own visibility and focus: viewDidHide/viewDidUnhide also fire when an ancestor
+// (the docker tab's host view) is hidden or shown, so no timer has to walk the view tree
+@interface FRZWebView : WKWebView
+@end
+
+@implementation FRZWebView
+- (void)rwvReportVisibility:(const char*)reason
+{
+  if (WebViewInstanceRecord* r = g_instances.FindByNativeView((__bridge const void*)self))
+    OnInstanceHostVisibility(r, self.window != nil && !self.isHiddenOrHasHiddenAncestor, reason);
+}
+- (void)viewDidHide { [super viewDidHide]; [self rwvReportVisibility:"viewDidHide"]; }
+- (void)viewDidUnhide { [super viewDidUnhide]; [self rwvReportVisibility:"viewDidUnhide"]; }
+- (void)viewDidMoveToWindow { [super viewDidMoveToWindow]; [self rwvReportVisibility:"moveToWindow"]; }
+- (void)mouseDown:(NSEvent*)e
+{
+  OnInstanceFocusEvent(g_instances.FindByNativeView((__bridge const void*)self), "mouseDown");
+  [super mouseDown:e];
+}
+- (BOOL)becomeFirstResponder
+{
+  const BOOL ok = [super becomeFirstResponder];
+  if (ok) OnInstanceFocusEvent(g_instances.FindByNativeView((__bridge const void*)self), "firstResponder");
+  return ok;
+}
+@end
+
+// rwv:// assets from the embedded bundle (ServeAppAsset in asset_glue.mm)
+@interface FRZAssetSchemeHandler : NSObject <WKURLSchemeHandler>
+@end
+
+@implementation FRZAssetSchemeHandler
+- (void)webView:(WKWebView *)webView startURLSchemeTask:(id<WKURLSchemeTask>)task
+{
+  NSURLRequest* req = task.request;
+  NSString* inm = [req valueForHTTPHeaderField:@"If-None-Match"];
+  AssetReply reply;
+  ServeAppAsset(req.URL.absoluteString ? [req.URL.absoluteString UTF8String] : "", inm ? [inm UTF8String] : nullptr, reply);
+  NSDictionary* headers = @{ @"Content-Type": [NSString stringWithUTF8String:reply.mime],
+                             @"ETag": [NSString stringWithUTF8String:reply.etag],
+                             @"Cache-Control": @"no-cache",
+                             @"Content-Length": [NSString stringWithFormat:@"%zu", reply.body ? reply.body->size() : (size_t)0] };
+  NSHTTPURLResponse* resp = [[[NSHTTPURLResponse alloc] initWithURL:req.URL statusCode:reply.status HTTPVersion:@"HTTP/1.1" headerFields:headers] autorelease];
+  [task didReceiveResponse:resp];
+  // cached bodies live as long as the module, so WebKit may read them without a copy
+  if (reply.body && !reply.body->empty())
+    [task didReceiveData:[NSData dataWithBytesNoCopy:(void*)reply.body->data() length:reply.body->size() freeWhenDone:NO]];
+  [task didFinish];
+}
+- (void)webView:(WKWebView *)webView stopURLSchemeTask:(id<WKURLSchemeTask>)task {}
+@end
+
 static HWND s_hostHwnd = NULL;
 static FRZWebViewDelegate* g_delegate = nil;
 static void ObserveTitleIfNeeded(WKWebView* wv, HWND hwnd);
@@ -29,13 +84,40 @@ static void ObserveTitleIfNeeded(WKWebView* wv, HWND hwnd);
 @implementation FRZWebViewDelegate
 - (void)webView:(WKWebView *)webView didFinishNavigation:(WKNavigation *)navigation
 {
-  if (s_hostHwnd) UpdateTitlesExtractAndApply(s_hostHwnd);
-  for(auto &kv: g_instances){ WebViewInstanceRecord* r=kv.second.get(); if(r && r->webView==webView){ r->findLastHighlightedQuery.clear(); r->findLastHighlightedCase=false; LogF("[Find][mac-fast] nav finish -> reset cache id='%s'", r->id.c_str()); break; } }
+  if (s_hostHwnd) RequestTitlesRefresh(s_hostHwnd);
+  if(WebViewInstanceRecord* r=g_instances.FindByNativeView((__bridge const void*)webView)){ r->findLastHighlightedQuery.clear(); r->findLastHighlightedCase=false; r->findIndex.Clear(); LogF("[Find][mac-fast] nav finish -> reset cache id='%s'", r->id.c_str()); OnInstancePageLoaded(r); }
+}
+- (void)webView:(WKWebView *)webView didStartProvisionalNavigation:(WKNavigation *)navigation
+{
+  if(WebViewInstanceRecord* r=g_instances.FindByNativeView((__bridge const void*)webView)) r->stats.NavStarted(PerfNowUs());
+}
+- (void)webView:(WKWebView *)webView didFailProvisionalNavigation:(WKNavigation *)navigation withError:(NSError *)error
+{
+  if(WebViewInstanceRecord* r=g_instances.FindByNativeView((__bridge const void*)webView)) r->stats.NavFinished(PerfNowUs(), false);
+}
+- (void)webView:(WKWebView *)webView didFailNavigation:(WKNavigation *)navigation withError:(NSError *)error
+{
+  if(WebViewInstanceRecord* r=g_instances.FindByNativeView((__bridge const void*)webView)) r->stats.NavFinished(PerfNowUs(), false);
+}
+// Subresources are blocked inside WebKit by the compiled content rule list (WebViewApplyContentFilter), which
+// reports nothing back; navigations (main frame and iframes) are checked here so they show up in the counters
+- (void)webView:(WKWebView *)webView decidePolicyForNavigationAction:(WKNavigationAction *)action
+decisionHandler:(void (^)(WKNavigationActionPolicy))decisionHandler
+{
+  NSString* s = action.request.URL.absoluteString;
+  const char* url = s ? [s UTF8String] : nullptr;
+  WebViewInstanceRecord* r = url ? g_instances.FindByNativeView((__bridge const void*)webView) : nullptr;
+  decisionHandler((r && ContentFilterBlocks(r, url, strlen(url))) ? WKNavigationActionPolicyCancel : WKNavigationActionPolicyAllow);
 }
 - (void)userContentController:(WKUserContentController *)userContentController
       didReceiveScriptMessage:(WKScriptMessage *)message
 {
   if (![message.name isEqualToString:@"frzCtx"]) return;
+  if ([message.body isKindOfClass:[NSString class]] && IsPageBridgeMessage([(NSString*)message.body UTF8String])) {
+    if (WebViewInstanceRecord* r = g_instances.FindByNativeView((__bridge const void*)message.webView))
+      OnPageBridgeMessage(r, [(NSString*)message.body UTF8String]);
+    return;
+  }
 
   // Global cursor coordinates (Cocoa: origin 0,0 is bottom-left)
   NSPoint p = [NSEvent mouseLocation];
@@ -56,6 +138,8 @@ void StartWebView(HWND hwnd, const std::string& initial_url)
   if (!host) return;
 
   WKWebViewConfiguration* cfg = [[WKWebViewConfiguration alloc] init];
+  static FRZAssetSchemeHandler* s_assetHandler = [[FRZAssetSchemeHandler alloc] init];
+  [cfg setURLSchemeHandler:s_assetHandler forURLScheme:@"rwv"];
 
   // JS hook for right-click (custom context menu) and disabling selection
   WKUserContentController* ucc = [[WKUserContentController alloc] init];
@@ -81,12 +165,20 @@ void StartWebView(HWND hwnd, const std::string& initial_url)
                                             injectionTime:WKUserScriptInjectionTimeAtDocumentStart
                                          forMainFrameOnly:NO];
   [ucc addUserScript:us];
+  WKUserScript* streamScript = [[WKUserScript alloc] initWithSource:[NSString stringWithUTF8String:kStateStreamJS]
+                                                      injectionTime:WKUserScriptInjectionTimeAtDocumentStart
+                                                   forMainFrameOnly:YES];
+  [ucc addUserScript:streamScript];
+  WKUserScript* bufferScript = [[WKUserScript alloc] initWithSource:[NSString stringWithUTF8String:kSharedBufferJS]
+                                                      injectionTime:WKUserScriptInjectionTimeAtDocumentStart
+                                                   forMainFrameOnly:YES];
+  [ucc addUserScript:bufferScript];
 
   if (!g_delegate) g_delegate = [[FRZWebViewDelegate alloc] init];
   [ucc addScriptMessageHandler:g_delegate name:@"frzCtx"];
 
   // Создаём и вставляем WKWebView
-  WKWebView* localWV = [[WKWebView alloc] initWithFrame:[host bounds] configuration:cfg];
+  WKWebView* localWV = [[FRZWebView alloc] initWithFrame:[host bounds] configuration:cfg];
   localWV.navigationDelegate = g_delegate;
   [localWV setAutoresizingMask:(NSViewWidthSizable|NSViewHeightSizable)];
   [host addSubview:localWV];
@@ -95,40 +187,32 @@ void StartWebView(HWND hwnd, const std::string& initial_url)
   ObserveTitleIfNeeded(localWV, hwnd);
 
   WebViewInstanceRecord* rec = GetInstanceById(activeId);
-  if (rec) { rec->webView = localWV; if (!rec->hwnd) rec->hwnd = hwnd; }
+  if (rec) { rec->webView = localWV; g_instances.SetNativeView(rec, (__bridge const void*)localWV); if (!rec->hwnd) g_instances.SetHwnd(rec, hwnd); rec->stats.ViewCreated(PerfNowUs()); }
+  if (rec) OnInstanceHostVisibility(rec, localWV.window != nil && !localWV.isHiddenOrHasHiddenAncestor, "create"); // attached before the record knew the view
+
+  if (rec) { rec->contentFilterInstalled = false; WebViewApplyContentFilter(rec); }
 
   // Навигация
   NSString* s = [NSString stringWithUTF8String:initial_url.c_str()];
   NSURL* u = [NSURL URLWithString:s];
   if (u) [localWV loadRequest:[NSURLRequest requestWithURL:u]];
 
-  UpdateTitlesExtractAndApply(hwnd);
+  RequestTitlesRefresh(hwnd);
 
   // ================= Focus tracking (mac) =================
   static bool s_focusHooksInstalled = false;
   if(!s_focusHooksInstalled){
     s_focusHooksInstalled = true;
-    // Helper to resolve webview -> instance
-    auto updateActiveForWebView = ^(WKWebView* target, const char* reason){
-      if(!target) return; WebViewInstanceRecord* recMatch=nullptr; for(auto &kv: g_instances){ WebViewInstanceRecord* r=kv.second.get(); if(r && r->webView == target){ recMatch = r; break; } }
-      if(!recMatch) return; unsigned long tick = (unsigned long)([NSDate timeIntervalSinceReferenceDate]*1000.0);
-      recMatch->lastFocusTick = tick; UpdateFocusChain(recMatch->id); if(g_activeInstanceId != recMatch->id){ if(!g_activeInstanceId.empty()) g_lastFocusedInstanceId = g_activeInstanceId; g_activeInstanceId = recMatch->id; }
-      LogF("[FocusTick][mac] activate id='%s' reason=%s tick=%lu", recMatch->id.c_str(), reason, (unsigned long)recMatch->lastFocusTick);
-    };
     // Window key notifications
     [[NSNotificationCenter defaultCenter] addObserverForName:NSWindowDidBecomeKeyNotification object:nil queue:[NSOperationQueue mainQueue] usingBlock:^(NSNotification* n){
       NSWindow* w = (NSWindow*)n.object; if(!w) return; NSResponder* fr = [w firstResponder]; if(!fr) return; // Walk up to WKWebView
-      NSView* v = nil; if([fr isKindOfClass:[NSView class]]) v=(NSView*)fr; while(v){ if([v isKindOfClass:[WKWebView class]]){ updateActiveForWebView((WKWebView*)v, "becomeKey"); break; } v=v.superview; }
+      NSView* v = nil; if([fr isKindOfClass:[NSView class]]) v=(NSView*)fr; while(v){ if([v isKindOfClass:[WKWebView class]]){ OnInstanceFocusEvent(g_instances.FindByNativeView((__bridge const void*)v), "becomeKey"); break; } v=v.superview; }
     }];
     [[NSNotificationCenter defaultCenter] addObserverForName:NSWindowDidResignKeyNotification object:nil queue:[NSOperationQueue mainQueue] usingBlock:^(NSNotification* n){
       // Log only; keep last-focused for fallback
-      if(!g_activeInstanceId.empty()){ LogF("[FocusTick][mac] resign window activeId='%s'", g_activeInstanceId.c_str()); }
-    }];
-    // Local mouse down monitor to catch clicks inside a webview even if window already key
-    [NSEvent addLocalMonitorForEventsMatchingMask:NSEventMaskLeftMouseDown handler:^NSEvent*(NSEvent* e){
-      NSWindow* w = e.window; if(!w) return e; NSPoint loc = [e locationInWindow]; NSView* hit = [w.contentView hitTest:loc]; NSView* cur = hit; while(cur){ if([cur isKindOfClass:[WKWebView class]]){ updateActiveForWebView((WKWebView*)cur, "mouseDown"); break; } cur=cur.superview; }
-      return e;
+      if(!g_activeInstanceId.empty()){ LogDebugF("[FocusTick][mac] resign window activeId='%s'", g_activeInstanceId.c_str()); }
     }];
+    // Clicks and first-responder changes inside a webview are reported by FRZWebView itself (no global monitor)
 
     // Cmd+F (find) key monitor similar to Windows Ctrl+F behavior.
     [NSEvent addLocalMonitorForEventsMatchingMask:NSEventMaskKeyDown handler:^NSEvent*(NSEvent* e){
@@ -163,35 +247,7 @@ void StartWebView(HWND hwnd, const std::string& initial_url)
       return e; // pass through
     }];
 
-    // ================= Visibility polling timer =================
-    static dispatch_source_t s_visTimer = nullptr;
-    auto isHostVisible = ^bool(WebViewInstanceRecord* r){ if(!r || !r->hwnd) return false; NSView* v=(NSView*)r->hwnd; if(![v window]) return false; if([v isHidden]) return false; if([v alphaValue] <= 0.01) return false; // primitive; could extend
-      // Also check any ancestor hidden
-      NSView* cur=v; while(cur){ if([cur isHidden]) return false; cur=cur.superview; } return true; };
-    if(!s_visTimer){
-      s_visTimer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER,0,0,dispatch_get_main_queue());
-      dispatch_source_set_timer(s_visTimer, dispatch_time(DISPATCH_TIME_NOW, 500ull*1000*1000), 500ull*1000*1000, 50ull*1000*1000);
-      dispatch_source_set_event_handler(s_visTimer, ^{
-        // If current active became invisible -> demote to last
-        if(!g_activeInstanceId.empty()){
-          WebViewInstanceRecord* active = GetInstanceById(g_activeInstanceId);
-            if(!isHostVisible(active)){
-              if(!g_activeInstanceId.empty()){
-                if(g_lastFocusedInstanceId != g_activeInstanceId) g_lastFocusedInstanceId = g_activeInstanceId;
-                LogF("[FocusTick][mac] deactivate id='%s' reason=hidden", g_activeInstanceId.c_str());
-                g_activeInstanceId.clear();
-              }
-            }
-        }
-        // If no active -> try pick a visible one (but do not overwrite if multiple visible)
-        if(g_activeInstanceId.empty()){
-          WebViewInstanceRecord* candidate=nullptr; int visibleCount=0;
-          for(auto &kv: g_instances){ WebViewInstanceRecord* r=kv.second.get(); if(isHostVisible(r)){ visibleCount++; if(!candidate) candidate=r; } }
-          if(visibleCount==1 && candidate){ candidate->lastFocusTick = (unsigned long)([NSDate timeIntervalSinceReferenceDate]*1000.0); g_activeInstanceId = candidate->id; LogF("[FocusTick][mac] auto-activate id='%s' reason=soleVisible", candidate->id.c_str()); }
-        }
-      });
-      dispatch_resume(s_visTimer);
-    }
+    // Visibility: FRZWebView hide/unhide/window notifications and WM_SHOWWINDOW (no polling timer)
   }
 }
 
@@ -236,7 +292,7 @@ extern "C" void FRZ_RemoveTitleObserverFor(WKWebView* wv)
 - (void)observeValueForKeyPath:(NSString *)keyPath ofObject:(id)object change:(NSDictionary<NSKeyValueChangeKey,id> *)change context:(void *)context
 {
   if (context == kTitleObservationContext) {
-    if (self.hwnd) UpdateTitlesExtractAndApply(self.hwnd);
+    if (self.hwnd) RequestTitlesRefresh(self.hwnd);
     return;
   }
   [super observeValueForKeyPath:keyPath ofObject:object change:change context:context];
@@ -271,16 +327,141 @@ void NavigateExistingInstance(const std::string& instanceId, const std::string&
   if (url.empty()) return;
   WebViewInstanceRecord* rec = GetInstanceById(instanceId);
   if (!rec || !rec->webView || url.empty()) return;
-  rec->lastUrl = url;
+  rec->lastUrl = url; MarkInstanceStateDirty();
   NSString* s = [NSString stringWithUTF8String:url.c_str()];
   NSURL* u = [NSURL URLWithString:s];
   if (u) [rec->webView loadRequest:[NSURLRequest requestWithURL:u]];
 }
 
+// ====================== Script / hibernation hooks ======================
+static void MacResetFindState(struct WebViewInstanceRecord* rec); // native find section below
+
+void WebViewEvalScript(WebViewInstanceRecord* rec, const std::string& js, ScriptResultFn fn)
+{
+  if (!rec || !rec->webView) { if (fn) fn(rec ? rec->id : std::string(), std::string()); return; }
+  NSString* src = [NSString stringWithUTF8String:js.c_str()];
+  if (!src) { if (fn) fn(rec->id, std::string()); return; }
+  rec->stats.BridgeOut(js.size());
+  if (!fn) { [rec->webView evaluateJavaScript:src completionHandler:nil]; return; }
+  const std::string instId = rec->id; // NB: not "id", that would shadow the ObjC type in the block signature
+  [rec->webView evaluateJavaScript:src completionHandler:^(id result, NSError* error){
+    std::string out;
+    if (!error && result && result != [NSNull null]) {
+      NSString* str = [result isKindOfClass:[NSString class]] ? (NSString*)result : [result description];
+      if (const char* u = [str UTF8String]) out = u;
+    }
+    fn(instId, out);
+  }];
+}
+
+void WebViewPostState(WebViewInstanceRecord* rec, const std::string& json)
+{
+  if (!rec || !rec->webView) return;
+  NSString* src = [NSString stringWithUTF8String:("window.__rwvState&&window.__rwvState.push(" + json + ")").c_str()];
+  rec->stats.BridgeOut(json.size());
+  if (src) [rec->webView evaluateJavaScript:src completionHandler:nil];
+}
+
+// takeSnapshot (macOS 10.13+) gives an NSImage in points; it is drawn once into a BGRA premultiplied bitmap
+// (LICE order) at the backing resolution, encoding is left to the capture worker
+void WebViewSnapshot(WebViewInstanceRecord* rec, int token, SnapshotFn fn)
+{
+  if (!rec || !rec->webView) { fn(rec ? rec->id : std::string(), token, nullptr, "no view"); return; }
+  const std::string instId = rec->id;
+  if (@available(macOS 10.13, *)) {
+    WKSnapshotConfiguration* cfg = [[[WKSnapshotConfiguration alloc] init] autorelease];
+    [rec->webView takeSnapshotWithConfiguration:cfg completionHandler:^(NSImage* img, NSError* error) {
+      CGImageRef cg = img ? [img CGImageForProposedRect:nullptr context:nil hints:nil] : nullptr;
+      if (!cg) { fn(instId, token, nullptr, error ? [[error localizedDescription] UTF8String] : "takeSnapshot failed"); return; }
+      CapturePixels px;
+      px.w = (int)CGImageGetWidth(cg); px.h = (int)CGImageGetHeight(cg); px.rowBytes = px.w * 4;
+      px.px.assign((size_t)px.rowBytes * px.h, 0);
+      CGColorSpaceRef cs = CGColorSpaceCreateDeviceRGB();
+      CGContextRef ctx = px.w > 0 && px.h > 0 ? CGBitmapContextCreate(px.px.data(), px.w, px.h, 8, px.rowBytes, cs,
+                                                                      kCGImageAlphaPremultipliedFirst | kCGBitmapByteOrder32Little) : nullptr;
+      CGColorSpaceRelease(cs);
+      if (!ctx) { fn(instId, token, nullptr, "cannot create bitmap context"); return; }
+      CGContextDrawImage(ctx, CGRectMake(0, 0, px.w, px.h), cg);
+      CGContextRelease(ctx);
+      fn(instId, token, &px, nullptr);
+    }];
+  } else fn(instId, token, nullptr, "snapshots need macOS 10.13");
+}
+
+// No way to map memory into a WebKit page: slots live on the heap and each publish ships the floats base64-encoded
+void WebViewSharedBufferAlloc(WebViewInstanceRecord*, SharedBufferSlot& slot, uint32_t capacity) { slot.AllocHeap(capacity); }
+
+void WebViewSharedBufferPublish(WebViewInstanceRecord* rec, SharedBufferSlot& slot)
+{
+  if (!rec || !rec->webView) return;
+  const std::string js = SharedBufferPutScript(slot);
+  slot.bytesShipped += js.size();
+  WebViewEvalScript(rec, js, nullptr);
+}
+
+void WebViewSharedBufferFree(SharedBufferSlot& slot) { slot.heap.clear(); slot.mem = nullptr; }
+
+// Request filter as a WKContentRuleList (macOS 10.13+). Compiling is asynchronous and done once per list
+// load (keyed by name + generation); until it completes the page loads unfiltered.
+void WebViewApplyContentFilter(WebViewInstanceRecord* rec)
+{
+  if (!rec || !rec->webView) return;
+  if (@available(macOS 10.13, *)) {
+    static NSMutableDictionary* s_compiled = [[NSMutableDictionary alloc] init]; // key -> WKContentRuleList
+    WKUserContentController* ucc = rec->webView.configuration.userContentController;
+    if (rec->contentFilterInstalled) { [ucc removeAllContentRuleLists]; rec->contentFilterInstalled = false; }
+    ContentFilterList* list = ContentFilterFor(rec);
+    if (!list) return;
+    NSString* key = [NSString stringWithFormat:@"rwv_filter_%u", list->gen];
+    if (WKContentRuleList* done = [s_compiled objectForKey:key]) { [ucc addContentRuleList:done]; rec->contentFilterInstalled = true; return; }
+    const std::string instId = rec->id;
+    const unsigned gen = list->gen;
+    const double t0 = [NSDate timeIntervalSinceReferenceDate];
+    [[WKContentRuleListStore defaultStore] compileContentRuleListForIdentifier:key
+        encodedContentRuleList:[NSString stringWithUTF8String:ContentFilterRulesJson(list).c_str()]
+        completionHandler:^(WKContentRuleList* compiled, NSError* err) {
+      LogF("[Filter][mac] compile gen=%u %s in %.0f ms", gen, compiled ? "ok" : (err ? [[err localizedDescription] UTF8String] : "failed"),
+           ([NSDate timeIntervalSinceReferenceDate] - t0) * 1000.0);
+      if (!compiled) return;
+      [s_compiled setObject:compiled forKey:key];
+      WebViewInstanceRecord* r = GetInstanceById(instId);
+      ContentFilterList* cur = r ? ContentFilterFor(r) : nullptr;
+      if (!r || !r->webView || r->contentFilterInstalled || !cur || cur->gen != gen) return; // switched meanwhile
+      [r->webView.configuration.userContentController addContentRuleList:compiled];
+      r->contentFilterInstalled = true;
+    }];
+  }
+}
+
+// WKWebView has no public suspend: hidden instances are only discarded (HibernateDiscardSec)
+bool WebViewCanSuspend() { return false; }
+bool WebViewSuspend(WebViewInstanceRecord*) { return false; }
+void WebViewResume(WebViewInstanceRecord*) {}
+bool WebViewIsPlayingAudio(WebViewInstanceRecord*) { return false; } // no public query; the probe script checks media elements
+bool WebViewHasView(WebViewInstanceRecord* rec) { return rec && rec->webView; }
+
+void WebViewDestroyView(WebViewInstanceRecord* rec)
+{
+  if (!rec || !rec->webView) return;
+  WKWebView* wv = rec->webView;
+  MacResetFindState(rec); rec->findIndex.Clear();
+  FRZ_RemoveTitleObserverFor(wv);
+  @try { [wv stopLoading:nil]; } @catch(...) {}
+  wv.navigationDelegate = nil;
+  [wv removeFromSuperview];
+#if !__has_feature(objc_arc)
+  [wv release];
+#endif
+  rec->webView = nil; rec->contentFilterInstalled = false;
+  g_instances.SetNativeView(rec, nullptr);
+}
+
 // ====================== Native Find (macOS WKWebView) ======================
 // Uses public API find:configuration:completionHandler: with WKFindConfiguration.
 // Behavior approximates Windows implementation: n/N counter and navigation via Enter/buttons.
-// Native highlight-all is not available – we supplement with JS highlight logic.
+// Native highlight-all is not available: page text is indexed natively (core/find_index) and the page only
+// renders the match ranges it is given (core/find_script): CSS Highlight API or an overlay layer, both
+// limited to the matches near the viewport, so the page DOM is never modified and there is no match cap.
 
 static void MacUpdateFindCounter(struct WebViewInstanceRecord* rec)
 {
@@ -290,118 +471,122 @@ static void MacUpdateFindCounter(struct WebViewInstanceRecord* rec)
 static void MacResetFindState(struct WebViewInstanceRecord* rec)
 {
   if(!rec) return; rec->findCurrentIndex=0; rec->findTotalMatches=0; MacUpdateFindCounter(rec);
-  // Remove current selection (visual reset) – safe via simple JS without altering structural DOM
-  if(rec->webView){ [rec->webView evaluateJavaScript:@"window.getSelection && window.getSelection().removeAllRanges();" completionHandler:nil]; }
-  // Remove all previously created highlight spans (span.__rwv_find)
-  if(rec->webView){ [rec->webView evaluateJavaScript:@"(function(){ var xs=document.querySelectorAll('span.__rwv_find'); for(var i=0;i<xs.length;i++){ var s=xs[i]; var p=s.parentNode; while(s.firstChild) p.insertBefore(s.firstChild,s); p.removeChild(s);} })();" completionHandler:nil]; }
+  // Selection + highlights; the text snapshot stays valid (apply/clear do not touch the DOM with range highlights)
+  if(rec->webView){ [rec->webView evaluateJavaScript:@"window.getSelection && window.getSelection().removeAllRanges(); if(window.__rwvFind) window.__rwvFind.clear();" completionHandler:nil]; }
   rec->findLastHighlightedQuery.clear(); rec->findLastHighlightedCase=false;
 }
 
-// Full JS-based highlight of all matches (independent of native current match)
-static void MacBuildHighlightAll(struct WebViewInstanceRecord* rec)
-{
-  if(!rec || !rec->webView) return; if(rec->findQuery.empty()){ return; }
-  // Diagnostics: check body presence and text length
-  [rec->webView evaluateJavaScript:@"(function(){ try { var b=document.body; if(!b) return 'NOBODY'; var t=b.innerText||b.textContent||''; return 'LEN:'+t.length; } catch(e){ return 'ERR:'+e; } })();" completionHandler:^(id r, NSError* e){ if(!e && [r isKindOfClass:[NSString class]]) { LogF("[Find][mac-fast] bodyCheck %s query='%s'", [(NSString*)r UTF8String], rec->findQuery.c_str()); } }];
-  bool same = (rec->findLastHighlightedQuery == rec->findQuery && rec->findLastHighlightedCase == rec->findCaseSensitive);
-  if(same){
-    __block bool hasSpans = true;
-    dispatch_semaphore_t sem = dispatch_semaphore_create(0);
-    [rec->webView evaluateJavaScript:@"(function(){return document.querySelectorAll('span.__rwv_find').length;})()" completionHandler:^(id r, NSError* e){
-      if(e){ hasSpans=false; }
-      else { long v=0; if([r isKindOfClass:[NSNumber class]]) v=[(NSNumber*)r longValue]; hasSpans=(v>0); }
-      dispatch_semaphore_signal(sem);
-    }];
-    long wr = dispatch_semaphore_wait(sem, dispatch_time(DISPATCH_TIME_NOW, 40*1000*1000));
-    if(hasSpans && wr==0){ LogF("[Find][mac-fast] skip rebuild (same+spans) query='%s'", rec->findQuery.c_str()); return; }
-    LogF("[Find][mac-fast] force rebuild (same query but spans missing) query='%s'", rec->findQuery.c_str());
-  }
-  LogF("[Find][mac-fast] start rebuild query='%s' case=%d prevQuery='%s'", rec->findQuery.c_str(), (int)rec->findCaseSensitive, rec->findLastHighlightedQuery.c_str());
-  std::string prevQuery = rec->findLastHighlightedQuery; __block int prevIndex = rec->findCurrentIndex;
-  // Быстрый helper внедряется один раз в документ (если не внедрён)
-  NSString* inject = @"(function(){if(window.__rwvFind&&window.__rwvFind.version===4)return;window.__rwvFind={version:4,MAX_MATCHES:5000,clear:function(){var xs=document.querySelectorAll('span.__rwv_find');for(var i=0;i<xs.length;i++){var s=xs[i];var p=s.parentNode;while(s.firstChild)p.insertBefore(s.firstChild,s);p.removeChild(s);}},collect:function(){if(!document.body)return [];var w=document.createTreeWalker(document.body,NodeFilter.SHOW_TEXT,null);var arr=[];while(w.nextNode()){var n=w.currentNode;if(!n||!n.nodeValue)continue;var pn=n.parentNode;if(!pn)continue;var tn=pn.nodeName; if(tn==='SCRIPT'||tn==='STYLE'||tn==='NOSCRIPT') continue;arr.push(n);}return arr;},fallbackCount:function(term,caseSensitive){try{if(!document.body)return 0;var cs=!!caseSensitive;var text=document.body.innerText||document.body.textContent||'';if(!cs){text=text.toLowerCase();term=term.toLowerCase();}var cnt=0,idx=0;while((idx=text.indexOf(term,idx))!==-1){cnt++;idx+=term.length||1;}return cnt;}catch(e){return -1;}},highlight:function(term,caseSensitive){if(!term){this.clear();return 0;}if(!document.body)return 0;this.clear();var cs=!!caseSensitive;var tRaw=term;var t=cs?term:term.toLowerCase();var nodes=this.collect();if(!nodes.length)return 0;var starts=new Array(nodes.length);var parts=new Array(nodes.length);var acc=0;for(var i=0;i<nodes.length;i++){starts[i]=acc;var d=nodes[i].data;parts[i]=d;acc+=d.length;}var big=parts.join('');var space=cs?big:big.toLowerCase();var matches=[];var step=t.length||1;var pos=0;while((pos=space.indexOf(t,pos))!==-1){matches.push(pos);pos+=step;if(matches.length>this.MAX_MATCHES)break;}var tooMany=matches.length>this.MAX_MATCHES; if(tooMany) matches.length=this.MAX_MATCHES; if(!matches.length) return 0;function findNode(p){var lo=0,hi=starts.length-1,res=0;while(lo<=hi){var mid=(lo+hi)>>1; if(starts[mid]<=p){res=mid;lo=mid+1;} else hi=mid-1;} return res;}var tLen=tRaw.length;for(var mi=matches.length-1;mi>=0;mi--){var gS=matches[mi];var gE=gS+tLen;var sIdx=findNode(gS);var eIdx=findNode(gE-1);var sN=nodes[sIdx];var eN=nodes[eIdx];if(!sN||!eN) continue;var sOff=gS - starts[sIdx];var eOff=gE - starts[eIdx]; if(eOff<0)eOff=0; if(eOff>eN.data.length)eOff=eN.data.length;try{var r=document.createRange();r.setStart(sN,sOff);r.setEnd(eN,eOff);var span=document.createElement('span');span.className='__rwv_find';span.style.background='rgba(255,230,128,0.9)';span.style.outline='1px solid rgba(255,180,0,0.4)';span.appendChild(r.extractContents());r.insertNode(span);}catch(ex){}}return tooMany?-2:matches.length;}}})();";
-  [rec->webView evaluateJavaScript:inject completionHandler:nil];
-  // Очистка старых + подсветка через helper
-  std::string q = rec->findQuery; 
-  // Расширенное экранирование для безопасности JS строки: \ " \n \r \t
-  std::string esc; esc.reserve(q.size()*2);
-  for(char c: q){
-    switch(c){
-      case '"': esc += "\\\""; break;
-      case '\\': esc += "\\\\"; break;
-      case '\n': esc += "\\n"; break;
-      case '\r': esc += "\\r"; break;
-      case '\t': esc += "\\t"; break;
-      default: esc.push_back(c); break;
-    }
-  }
-  // Оборачиваем в try/catch чтобы не получать generic JS Exception в NSError
-  std::string call = std::string("(function(){ try { if(!window.__rwvFind) return 0; return window.__rwvFind.highlight(\"") + esc + "\"," + (rec->findCaseSensitive?"true":"false") + "); } catch(e){ console.error('[rwv.find] runtime error', e); return -1; } })();";
-  NSString* njs = [NSString stringWithUTF8String:call.c_str()];
-  [rec->webView evaluateJavaScript:njs completionHandler:^(id r, NSError* e){ 
-    if(e){ 
-      LogF("[Find][mac-fast] js-eval error: %s", e.localizedDescription.UTF8String); 
-  // On error reset state to avoid desynchronization
-      rec->findCurrentIndex = 0; rec->findTotalMatches=0; rec->findLastHighlightedQuery.clear(); rec->findLastHighlightedCase=false; 
-      dispatch_async(dispatch_get_main_queue(), ^{ MacUpdateFindCounter(rec); });
-      return; 
-    }
-    int mCount=0; 
-    if([r isKindOfClass:[NSNumber class]]) mCount=[(NSNumber*)r intValue];
-    if(mCount == -1){
-      LogF("[Find][mac-fast] runtime exception inside highlight (query='%s')", rec->findQuery.c_str());
-      rec->findCurrentIndex = 0; rec->findTotalMatches=0; rec->findLastHighlightedQuery.clear(); rec->findLastHighlightedCase=false; 
-      dispatch_async(dispatch_get_main_queue(), ^{ MacUpdateFindCounter(rec); });
+static std::u16string MacToU16(NSString* s)
+{
+  std::u16string out; if(!s) return out;
+  out.resize((size_t)s.length);
+  if(!out.empty()) [s getCharacters:(unichar*)&out[0] range:NSMakeRange(0, s.length)];
+  return out;
+}
+
+// snapshot() result [gen, "len,len,...", text] -> rec->findIndex
+static bool MacLoadFindSnapshot(struct WebViewInstanceRecord* rec, NSArray* snap)
+{
+  if(snap.count != 3 || ![snap[0] isKindOfClass:[NSNumber class]] || ![snap[1] isKindOfClass:[NSString class]] || ![snap[2] isKindOfClass:[NSString class]]) return false;
+  std::vector<uint32_t> lens; lens.reserve(1024);
+  const char* p = [(NSString*)snap[1] UTF8String];
+  while(p && *p){ char* e=nullptr; lens.push_back((uint32_t)strtoul(p, &e, 10)); if(!e || e==p) break; p = (*e==',') ? e+1 : e; }
+  const double t0 = [NSDate timeIntervalSinceReferenceDate];
+  const bool ok = rec->findIndex.Load(MacToU16((NSString*)snap[2]), lens, [(NSNumber*)snap[0] unsignedIntValue]);
+  LogF("[Find][mac-index] gen=%u nodes=%zu chars=%zu load=%.2f ms ok=%d", rec->findIndex.Generation(), rec->findIndex.NodeCount(), rec->findIndex.TextLength(), ([NSDate timeIntervalSinceReferenceDate]-t0)*1000.0, (int)ok);
+  return ok;
+}
+
+// O(1) in the page (previous + new current match only); logs keypress-to-scroll latency
+static void MacSelectFindMatch(struct WebViewInstanceRecord* rec, int idx)
+{
+  if(!rec || !rec->webView) return;
+  const double t0 = [NSDate timeIntervalSinceReferenceDate];
+  [rec->webView evaluateJavaScript:[NSString stringWithFormat:@"window.__rwvFind ? window.__rwvFind.select(%d) : -1;", idx] completionHandler:^(id r, NSError* e){
+    const double pageMs = (!e && [r isKindOfClass:[NSNumber class]]) ? [(NSNumber*)r doubleValue] : -1.0;
+    LogF("[Find][mac-nav] select %d page=%.2f ms roundtrip=%.2f ms", idx, pageMs, ([NSDate timeIntervalSinceReferenceDate]-t0)*1000.0);
+  }];
+}
+
+static void MacBuildHighlightAll(struct WebViewInstanceRecord* rec, bool retried);
+
+// Runs the query against the native index and hands the match offsets to the page
+static void MacApplyFindQuery(struct WebViewInstanceRecord* rec, bool retried)
+{
+  if(!rec || !rec->webView) return;
+  const double t0 = [NSDate timeIntervalSinceReferenceDate];
+  NSString* nq = [NSString stringWithUTF8String:rec->findQuery.c_str()];
+  const std::u16string q = MacToU16(nq);
+  const std::vector<uint32_t>& hits = rec->findIndex.Search(q, rec->findCaseSensitive);
+  const size_t total = hits.size(); // no cap: the page paints only the matches near the viewport
+  const double searchMs = ([NSDate timeIntervalSinceReferenceDate]-t0)*1000.0;
+  std::string js; js.reserve(48 + total*8);
+  char head[64]; snprintf(head, sizeof(head), "window.__rwvFind ? window.__rwvFind.apply(%u,%u,[", rec->findIndex.Generation(), (unsigned)q.size()); js += head;
+  for(size_t i=0;i<total;++i){ char num[16]; snprintf(num, sizeof(num), i?",%u":"%u", hits[i]); js += num; }
+  js += "]) : -3;";
+  LogF("[Find][mac-index] query='%s' total=%zu refined=%d search=%.3f ms", rec->findQuery.c_str(), total, (int)rec->findIndex.LastSearchRefined(), searchMs);
+
+  const std::string instId = rec->id, prevQuery = rec->findLastHighlightedQuery; const int prevIndex = rec->findCurrentIndex;
+  [rec->webView evaluateJavaScript:[NSString stringWithUTF8String:js.c_str()] completionHandler:^(id r, NSError* e){
+    WebViewInstanceRecord* rr = GetInstanceById(instId); if(!rr) return;
+    int mCount = (!e && [r isKindOfClass:[NSNumber class]]) ? [(NSNumber*)r intValue] : -1;
+    if(mCount == -3 && !retried){ LogRaw("[Find][mac-index] page changed since snapshot -> re-snapshot"); MacBuildHighlightAll(rr, true); return; }
+    if(mCount < 0){
+      if(e) LogF("[Find][mac-index] apply error: %s", e.localizedDescription.UTF8String);
+      rr->findCurrentIndex=0; rr->findTotalMatches=0; rr->findLastHighlightedQuery.clear(); rr->findLastHighlightedCase=false; MacUpdateFindCounter(rr);
+      rr->stats.FindCounted(PerfNowUs(), 0);
       return;
     }
-    if(mCount == -2){
-  // Too many matches: highlight truncated; fallback count for approximate total and user refinement
-      NSString* fb2 = [NSString stringWithFormat:@"(function(){ try { if(!window.__rwvFind) return 'NO_HELPER'; return 'FB:'+window.__rwvFind.fallbackCount(\"%@\",%s); } catch(e){ return 'FBERR:'+e; } })();", [NSString stringWithUTF8String:esc.c_str()], rec->findCaseSensitive?"true":"false"];
-      [rec->webView evaluateJavaScript:fb2 completionHandler:^(id fr, NSError* fe){ if(!fe && [fr isKindOfClass:[NSString class]]){ LogF("[Find][mac-fast] too-many matches (limited) %s query='%s'", [(NSString*)fr UTF8String], rec->findQuery.c_str()); }}];
-      rec->findLastHighlightedQuery.clear(); rec->findLastHighlightedCase=false; mCount = 0; // treat as zero highlighted
-    }
-    if(mCount==0 && !rec->findQuery.empty()){
-  // Fallback (diagnostic only): count occurrences without DOM modification to confirm existence
-      NSString* fb = [NSString stringWithFormat:@"(function(){ try { if(!window.__rwvFind) return 'NO_HELPER'; return 'FB:'+window.__rwvFind.fallbackCount(\"%@\",%s); } catch(e){ return 'FBERR:'+e; } })();", [NSString stringWithUTF8String:esc.c_str()], rec->findCaseSensitive?"true":"false"];
-      [rec->webView evaluateJavaScript:fb completionHandler:^(id fr, NSError* fe){ if(!fe && [fr isKindOfClass:[NSString class]]){ LogF("[Find][mac-fast] fallback diag %s query='%s'", [(NSString*)fr UTF8String], rec->findQuery.c_str()); }}];
-  // Allow future rebuilds (do not cache zero-result state)
-      rec->findLastHighlightedQuery.clear(); rec->findLastHighlightedCase=false; LogF("[Find][mac-fast] zero matches -> clear lastHighlighted to allow rebuild query='%s'", rec->findQuery.c_str());
+    int cur = mCount>0 ? 1 : 0;
+    if(prevQuery == rr->findQuery && mCount>0) cur = std::max(1, std::min(prevIndex, mCount));
+    rr->findTotalMatches = mCount; rr->findCurrentIndex = cur;
+    rr->stats.FindCounted(PerfNowUs(), mCount);
+    // Zero results are not cached so the next keystroke rebuilds
+    if(mCount>0){ rr->findLastHighlightedQuery = rr->findQuery; rr->findLastHighlightedCase = rr->findCaseSensitive; }
+    else { rr->findLastHighlightedQuery.clear(); rr->findLastHighlightedCase=false; }
+    MacUpdateFindCounter(rr);
+    if(cur>=1) MacSelectFindMatch(rr, cur);
+  }];
+}
+
+// Snapshot (only when the DOM changed since the indexed generation), then query the index
+static void MacBuildHighlightAll(struct WebViewInstanceRecord* rec, bool retried)
+{
+  if(!rec || !rec->webView || rec->findQuery.empty()) return;
+  // helper install (idempotent, version check) and snapshot in one evaluate: one round trip per keystroke
+  char snap[96]; snprintf(snap, sizeof(snap), "\nwindow.__rwvFind ? window.__rwvFind.snapshot(%u) : null;", retried ? 0u : rec->findIndex.Generation());
+  NSString* snapJs = [NSString stringWithUTF8String:(std::string(kFindHelperJS) + snap).c_str()];
+  const std::string instId = rec->id;
+  [rec->webView evaluateJavaScript:snapJs completionHandler:^(id r, NSError* e){
+    WebViewInstanceRecord* rr = GetInstanceById(instId); if(!rr || !rr->webView) return;
+    if(e){ LogF("[Find][mac-index] snapshot error: %s", e.localizedDescription.UTF8String); return; }
+    if([r isKindOfClass:[NSArray class]]) { if(!MacLoadFindSnapshot(rr, (NSArray*)r)) { rr->findIndex.Clear(); return; } }
+    else if(rr->findLastHighlightedQuery == rr->findQuery && rr->findLastHighlightedCase == rr->findCaseSensitive){
+      LogF("[Find][mac-index] skip (same query, DOM unchanged) query='%s'", rr->findQuery.c_str()); rr->stats.FindCounted(PerfNowUs(), rr->findTotalMatches); return;
     }
-    if(prevQuery == rec->findQuery){ if(prevIndex<1) prevIndex=1; if(prevIndex>mCount) prevIndex=mCount; rec->findCurrentIndex = mCount?prevIndex:0; }
-    else { rec->findCurrentIndex = mCount>0?1:0; }
-    rec->findTotalMatches=mCount; rec->findLastHighlightedQuery=rec->findQuery; rec->findLastHighlightedCase=rec->findCaseSensitive; int cur = rec->findCurrentIndex; size_t qlen = rec->findQuery.size();
-    dispatch_async(dispatch_get_main_queue(), ^{ 
-      MacUpdateFindCounter(rec); 
-      LogF("[Find][mac-fast] rebuilt query='%s' len=%zu total=%d cur=%d", rec->findQuery.c_str(), qlen, mCount, cur);
-      if(rec && rec->webView && cur>=1 && mCount>0){
-        NSString* selJs = [NSString stringWithFormat:@"(function(){var L=document.querySelectorAll('span.__rwv_find'); for(var i=0;i<L.length;i++){L[i].classList.remove('__rwv_find_current'); L[i].style.background='rgba(255,230,128,0.9)'; L[i].style.outline='1px solid rgba(255,180,0,0.4)';} var i=%d; if(i>=1 && i<=L.length){var el=L[i-1]; el.classList.add('__rwv_find_current'); el.style.background='rgba(255,150,0,0.95)'; el.style.outline='2px solid rgba(255,90,0,0.9)'; el.scrollIntoView({block:'center'});} })();", cur];
-        [rec->webView evaluateJavaScript:selJs completionHandler:nil];
-      }
-    }); 
+    MacApplyFindQuery(rr, retried);
   }];
 }
 
 extern "C" void MacFindStartOrUpdate(struct WebViewInstanceRecord* rec)
 {
   if(!rec || !rec->webView) return; std::string q = rec->findQuery; if(q.empty()){ LogRaw("[Find][mac-native] empty query -> reset"); MacResetFindState(rec); return; }
-  // Полностью JS: highlight + подсчёт
-  MacBuildHighlightAll(rec);
+  // Native index + page-side highlight renderer
+  rec->stats.FindStarted(PerfNowUs()); // closed when the page reports the match count
+  MacBuildHighlightAll(rec, false);
 }
 
 extern "C" void MacFindNavigate(struct WebViewInstanceRecord* rec, bool forward)
 {
   if(!rec || !rec->webView) return; if(rec->findQuery.empty()){ MacResetFindState(rec); return; }
-  WKWebView* wv = rec->webView; // no rebuild here; navigation only
+  // no rebuild here; navigation only
   LogF("[Find][mac-native] nav %s query='%s'", forward?"forward":"backward", rec->findQuery.c_str());
   // Simple cyclic navigation without native matchIndex: use local counters
   if(rec->findTotalMatches<=0){ MacFindStartOrUpdate(rec); return; }
   if(forward){ if(rec->findCurrentIndex < rec->findTotalMatches) rec->findCurrentIndex++; else rec->findCurrentIndex=1; }
   else { if(rec->findCurrentIndex>1) rec->findCurrentIndex--; else rec->findCurrentIndex=rec->findTotalMatches; }
   MacUpdateFindCounter(rec);
-  int idx = rec->findCurrentIndex;
-  // Update current highlight: apply __rwv_find_current class
-  NSString* js = [NSString stringWithFormat:@"(function(){var L=document.querySelectorAll('span.__rwv_find'); for(var i=0;i<L.length;i++){L[i].classList.remove('__rwv_find_current'); L[i].style.background='rgba(255,230,128,0.9)'; L[i].style.outline='1px solid rgba(255,180,0,0.4)';} var i=%d; if(i>=1 && i<=L.length){var el=L[i-1]; el.classList.add('__rwv_find_current'); el.style.background='rgba(255,150,0,0.95)'; el.style.outline='2px solid rgba(255,90,0,0.9)'; el.scrollIntoView({block:'center'});} })();", idx];
-  [wv evaluateJavaScript:js completionHandler:nil];
+  MacSelectFindMatch(rec, rec->findCurrentIndex);
 }
 
 extern "C" void MacFindClose(struct WebViewInstanceRecord* rec)
@@ -0,0 +1,625 @@
+// Reaper WebView Plugin
+// (c) Andrew "SadFrozz" Brodsky
+// 2025 and later
+// webview_gtk.cpp
+// WebKitGTK for Linux implementation (SWELL-generic host, GtkPlug in an X bridge window)
+
+#if !defined(_WIN32) && !defined(__APPLE__)
+
+#include "predef.h"
+
+#include <gtk/gtk.h>
+#include <gtk/gtkx.h>
+#include <webkit2/webkit2.h>
+#include <stdlib.h>
+
+#include "log.h"
+#include "globals.h"
+#include "helpers.h"
+#include "webview.h"
+#include "core/stream_script.h"
+
+// implemented in main.mm
+void UpdateFindCounter(WebViewInstanceRecord* rec);
+
+// Same JS contract as mac/Windows: suppress page context menu, hand the click to the host menu
+static const char* kCtxHookJS =
+  "(function(){"
+    "window.addEventListener('contextmenu', function(e){ e.preventDefault(); "
+      "try{ window.webkit.messageHandlers.frzCtx.postMessage('CTX'); }catch(_){ }"
+    "}, true);"
+    "window.addEventListener('mousedown', function(e){ if(e.button===2){ e.preventDefault(); } }, true);"
+  "})();";
+
+static WebViewInstanceRecord* FindRecByWebView(WebKitWebView* wv)
+{
+  return g_instances.FindByNativeView(wv);
+}
+
+// Software rendering: avoid GL/compositing inside an X-embedded plug (black/blank panels with
+// some drivers, and REAPER's own GDK windows are not GL-aware). Must happen before the first context.
+static void EnsureSoftwareRendering()
+{
+  static bool s_done = false; if (s_done) return; s_done = true;
+  setenv("WEBKIT_DISABLE_COMPOSITING_MODE", "1", 0);
+  setenv("WEBKIT_DISABLE_DMABUF_RENDERER", "1", 0);
+  LogRaw("[GTK] software rendering (compositing disabled)");
+}
+
+static WebKitSettings* SharedSettings()
+{
+  static WebKitSettings* s = nullptr;
+  if (!s) {
+    s = webkit_settings_new();
+    webkit_settings_set_hardware_acceleration_policy(s, WEBKIT_HARDWARE_ACCELERATION_POLICY_NEVER);
+    webkit_settings_set_enable_developer_extras(s, FALSE);
+    webkit_settings_set_javascript_can_access_clipboard(s, TRUE);
+  }
+  return s;
+}
+
+// rwv:// assets from the embedded bundle (ServeAppAsset in asset_glue.mm). Bodies are cached for the module's
+// lifetime, so the stream wraps them without a copy. 304 needs the response API of WebKitGTK 2.36+.
+static void OnAssetScheme(WebKitURISchemeRequest* req, gpointer)
+{
+  const char* uri = webkit_uri_scheme_request_get_uri(req);
+  const char* inm = nullptr;
+#if WEBKIT_CHECK_VERSION(2, 36, 0)
+  if (SoupMessageHeaders* h = webkit_uri_scheme_request_get_http_headers(req)) inm = soup_message_headers_get_one(h, "If-None-Match");
+#endif
+  AssetReply reply;
+  ServeAppAsset(uri ? uri : "", inm, reply);
+  if (reply.status != 200 && reply.status != 304) {
+    GError* err = g_error_new(G_IO_ERROR, G_IO_ERROR_NOT_FOUND, "rwv: %d", reply.status);
+    webkit_uri_scheme_request_finish_error(req, err);
+    g_error_free(err);
+    return;
+  }
+  const gssize len = reply.body ? (gssize)reply.body->size() : 0;
+  GInputStream* stream = g_memory_input_stream_new_from_data(reply.body ? reply.body->data() : "", len, nullptr);
+#if WEBKIT_CHECK_VERSION(2, 36, 0)
+  WebKitURISchemeResponse* resp = webkit_uri_scheme_response_new(stream, len);
+  webkit_uri_scheme_response_set_status(resp, (guint)reply.status, nullptr);
+  webkit_uri_scheme_response_set_content_type(resp, reply.mime);
+  SoupMessageHeaders* headers = soup_message_headers_new(SOUP_MESSAGE_HEADERS_RESPONSE);
+  soup_message_headers_append(headers, "ETag", reply.etag);
+  soup_message_headers_append(headers, "Cache-Control", "no-cache");
+  webkit_uri_scheme_response_set_http_headers(resp, headers); // takes ownership
+  webkit_uri_scheme_request_finish_with_response(req, resp);
+  g_object_unref(resp);
+#else
+  webkit_uri_scheme_request_finish(req, stream, len, reply.mime);
+#endif
+  g_object_unref(stream);
+}
+
+// One WebKitWebContext for every instance (the WebView2 shared-environment equivalent): a single
+// network/storage process and cookie jar under <resource>/WebKitGTKData instead of per-view setup.
+static WebKitWebContext* SharedContext()
+{
+  static WebKitWebContext* s = nullptr;
+  if (!s) {
+    const char* res = GetResourcePath ? GetResourcePath() : nullptr;
+    const std::string data = std::string((res && *res) ? res : ".") + "/WebKitGTKData";
+    const std::string cache = data + "/cache";
+    WebKitWebsiteDataManager* dm = webkit_website_data_manager_new("base-data-directory", data.c_str(),
+                                                                   "base-cache-directory", cache.c_str(), nullptr);
+    s = webkit_web_context_new_with_website_data_manager(dm);
+    g_object_unref(dm);
+    webkit_web_context_set_cache_model(s, WEBKIT_CACHE_MODEL_WEB_BROWSER);
+    webkit_web_context_register_uri_scheme(s, "rwv", OnAssetScheme, nullptr, nullptr);
+    webkit_security_manager_register_uri_scheme_as_secure(webkit_web_context_get_security_manager(s), "rwv");
+    LogF("[GTK] shared web context data='%s'", data.c_str());
+  }
+  return s;
+}
+
+// Web view with the context-menu hook installed; the host-specific message handler is connected later
+static GtkWidget* NewConfiguredWebView()
+{
+  WebKitUserContentManager* ucm = webkit_user_content_manager_new();
+  WebKitUserScript* us = webkit_user_script_new(kCtxHookJS, WEBKIT_USER_CONTENT_INJECT_ALL_FRAMES,
+                                                WEBKIT_USER_SCRIPT_INJECT_AT_DOCUMENT_START, nullptr, nullptr);
+  webkit_user_content_manager_add_script(ucm, us); webkit_user_script_unref(us);
+  us = webkit_user_script_new(kStateStreamJS, WEBKIT_USER_CONTENT_INJECT_TOP_FRAME,
+                              WEBKIT_USER_SCRIPT_INJECT_AT_DOCUMENT_START, nullptr, nullptr);
+  webkit_user_content_manager_add_script(ucm, us); webkit_user_script_unref(us);
+  us = webkit_user_script_new(kSharedBufferJS, WEBKIT_USER_CONTENT_INJECT_TOP_FRAME,
+                              WEBKIT_USER_SCRIPT_INJECT_AT_DOCUMENT_START, nullptr, nullptr);
+  webkit_user_content_manager_add_script(ucm, us); webkit_user_script_unref(us);
+  webkit_user_content_manager_register_script_message_handler(ucm, "frzCtx");
+  GtkWidget* wv = GTK_WIDGET(g_object_new(WEBKIT_TYPE_WEB_VIEW, "web-context", SharedContext(),
+                                          "user-content-manager", ucm, "settings", SharedSettings(), nullptr));
+  g_object_unref(ucm);
+  return wv;
+}
+
+// Pre-created views (own reference, unparented, about:blank loaded so the web process is running).
+// Refilled from an idle callback after each StartWebView so the open itself never pays for it.
+static std::vector<GtkWidget*> g_viewPool;
+static guint g_poolRefillSource = 0; // pending idle source, removed on shutdown
+
+static gboolean RefillViewPool(gpointer)
+{
+  g_poolRefillSource = 0;
+  while ((int)g_viewPool.size() < GetWebViewPoolTarget()) {
+    GtkWidget* wv = NewConfiguredWebView();
+    g_object_ref_sink(wv);
+    webkit_web_view_load_uri(WEBKIT_WEB_VIEW(wv), "about:blank");
+    g_viewPool.push_back(wv);
+    LogF("[Pool][gtk] view parked (%zu ready)", g_viewPool.size());
+  }
+  return G_SOURCE_REMOVE;
+}
+
+static void QueueViewPoolRefill()
+{
+  if (g_poolRefillSource || GetWebViewPoolTarget() <= 0) return;
+  g_poolRefillSource = g_idle_add(RefillViewPool, nullptr);
+}
+
+void WebViewBackendShutdown()
+{
+  if (g_poolRefillSource) { g_source_remove(g_poolRefillSource); g_poolRefillSource = 0; } // must not run after unload
+  for (GtkWidget* wv : g_viewPool) { gtk_widget_destroy(wv); g_object_unref(wv); }
+  g_viewPool.clear();
+}
+
+// ---------------------------------------------------------------- signals
+static void OnScriptCtx(WebKitUserContentManager*, WebKitJavascriptResult* jr, gpointer user)
+{
+  HWND host = (HWND)user; if (!host) return;
+  JSCValue* v = jr ? webkit_javascript_result_get_js_value(jr) : nullptr;
+  if (v && jsc_value_is_string(v)) {
+    char* str = jsc_value_to_string(v);
+    const bool bridge = IsPageBridgeMessage(str);
+    if (bridge) OnPageBridgeMessage(GetInstanceByHwnd(host), str);
+    g_free(str);
+    if (bridge) return;
+  }
+  POINT p{}; GetCursorPos(&p);
+  PostMessage(host, WM_CONTEXTMENU, (WPARAM)host, MAKELPARAM(p.x, p.y));
+}
+
+static gboolean OnNativeContextMenu(WebKitWebView*, WebKitContextMenu*, GdkEvent*, WebKitHitTestResult*, gpointer)
+{
+  return TRUE; // never show WebKit's own menu; JS hook above routes to ShowLocalDockMenu
+}
+
+static void OnTitleChanged(GObject*, GParamSpec*, gpointer user)
+{
+  if (user) RequestTitlesRefresh((HWND)user);
+}
+
+static void OnLoadChanged(WebKitWebView* wv, WebKitLoadEvent ev, gpointer user)
+{
+  WebViewInstanceRecord* rec = FindRecByWebView(wv);
+  if (ev == WEBKIT_LOAD_STARTED && rec) rec->stats.NavStarted(PerfNowUs());
+  if (ev == WEBKIT_LOAD_COMMITTED && rec) {
+    const char* uri = webkit_web_view_get_uri(wv); if (uri) { rec->lastUrl = uri; MarkInstanceStateDirty(); }
+  }
+  if (ev == WEBKIT_LOAD_FINISHED && rec) {
+    rec->findLastHighlightedQuery.clear(); rec->findLastHighlightedCase = false;
+    OnInstancePageLoaded(rec);
+  }
+  if ((ev == WEBKIT_LOAD_COMMITTED || ev == WEBKIT_LOAD_FINISHED) && user) RequestTitlesRefresh((HWND)user);
+}
+
+static gboolean OnLoadFailed(WebKitWebView* wv, WebKitLoadEvent, gchar*, GError*, gpointer)
+{
+  if (WebViewInstanceRecord* rec = FindRecByWebView(wv)) rec->stats.NavFinished(PerfNowUs(), false);
+  return FALSE; // WebKit shows its error page
+}
+
+// Subresources are blocked inside WebKit by the content filter (WebViewApplyContentFilter), which reports
+// nothing back; navigations are checked here so they show up in the instance's counters
+static gboolean OnDecidePolicy(WebKitWebView* wv, WebKitPolicyDecision* d, WebKitPolicyDecisionType type, gpointer)
+{
+  if (type != WEBKIT_POLICY_DECISION_TYPE_NAVIGATION_ACTION) return FALSE;
+  WebKitNavigationAction* a = webkit_navigation_policy_decision_get_navigation_action(WEBKIT_NAVIGATION_POLICY_DECISION(d));
+  WebKitURIRequest* req = a ? webkit_navigation_action_get_request(a) : nullptr;
+  const char* uri = req ? webkit_uri_request_get_uri(req) : nullptr;
+  WebViewInstanceRecord* rec = uri ? FindRecByWebView(wv) : nullptr;
+  if (!rec || !ContentFilterBlocks(rec, uri, strlen(uri))) return FALSE;
+  webkit_policy_decision_ignore(d);
+  return TRUE;
+}
+
+static gboolean OnFocusIn(GtkWidget* w, GdkEvent*, gpointer)
+{
+  WebViewInstanceRecord* rec = FindRecByWebView(WEBKIT_WEB_VIEW(w));
+  if (rec) { OnInstanceFocusEvent(rec, "focus-in"); LogDebugF("[FocusEvt][gtk] focus-in id='%s'", rec->id.c_str()); }
+  return FALSE;
+}
+
+// map/unmap follow the plug when the host's X bridge is shown or hidden (docker tab switches); together
+// with WM_SHOWWINDOW in WebViewDlgProc they keep rec->hostVisible current without polling
+static void OnMapChanged(GtkWidget* w, gpointer user)
+{
+  WebViewInstanceRecord* rec = FindRecByWebView(WEBKIT_WEB_VIEW(w));
+  if (rec) OnInstanceHostVisibility(rec, gtk_widget_get_mapped(w) && user && IsWindowVisible((HWND)user), "map");
+}
+
+static gboolean OnKeyPress(GtkWidget* w, GdkEventKey* e, gpointer user)
+{
+  if (!(e->state & GDK_CONTROL_MASK)) return FALSE;
+  if (e->keyval != GDK_KEY_f && e->keyval != GDK_KEY_F) return FALSE;
+  WebViewInstanceRecord* rec = FindRecByWebView(WEBKIT_WEB_VIEW(w)); HWND host = (HWND)user;
+  if (!rec || !host) return FALSE;
+  if (!rec->showFindBar) {
+    rec->showFindBar = true; LogRaw("[FindCtrlF][gtk] show find bar (Ctrl+F)");
+    LayoutTitleBarAndWebView(host, rec->titleVisible);
+    if (rec->findEdit) { SetFocus(rec->findEdit); SendMessage(rec->findEdit, EM_SETSEL, 0, -1); }
+  } else {
+    const bool shift = (e->state & GDK_SHIFT_MASK) != 0;
+    GtkFindNavigate(rec, !shift);
+    LogF("[FindCtrlF][gtk] nav %s query='%s'", shift?"prev":"next", rec->findQuery.c_str());
+  }
+  return TRUE;
+}
+
+// ---------------------------------------------------------------- lifecycle
+void StartWebView(HWND hwnd, const std::string& initial_url)
+{
+  if (!hwnd) return;
+  std::string activeId = g_instanceId.empty()?std::string("wv_default"):g_instanceId;
+  WebViewInstanceRecord* rec = GetInstanceById(activeId);
+  if (!rec) { LogF("[GTK] StartWebView: instance '%s' not found", activeId.c_str()); return; }
+
+  EnsureSoftwareRendering();
+
+  RECT rc{}; GetClientRect(hwnd, &rc);
+  void* xwin = nullptr;
+  HWND bridge = SWELL_CreateXBridgeWindow(hwnd, &xwin, &rc);
+  if (!bridge || !xwin) { LogRaw("[GTK] FATAL: SWELL_CreateXBridgeWindow failed (X11 session required)"); if (bridge) DestroyWindow(bridge); return; }
+
+  const bool pooled = !g_viewPool.empty();
+  GtkWidget* wv = pooled ? g_viewPool.back() : NewConfiguredWebView();
+  if (pooled) g_viewPool.pop_back();
+  g_signal_connect(webkit_web_view_get_user_content_manager(WEBKIT_WEB_VIEW(wv)), "script-message-received::frzCtx",
+                   G_CALLBACK(OnScriptCtx), hwnd);
+
+  GtkWidget* plug = gtk_plug_new((Window)(INT_PTR)xwin);
+  gtk_container_add(GTK_CONTAINER(plug), wv);
+  if (pooled) g_object_unref(wv); // the plug holds it now
+
+  g_signal_connect(wv, "notify::title", G_CALLBACK(OnTitleChanged), hwnd);
+  g_signal_connect(wv, "load-changed", G_CALLBACK(OnLoadChanged), hwnd);
+  g_signal_connect(wv, "load-failed", G_CALLBACK(OnLoadFailed), nullptr);
+  g_signal_connect(wv, "context-menu", G_CALLBACK(OnNativeContextMenu), nullptr);
+  g_signal_connect(wv, "focus-in-event", G_CALLBACK(OnFocusIn), nullptr);
+  g_signal_connect(wv, "map", G_CALLBACK(OnMapChanged), hwnd);
+  g_signal_connect(wv, "unmap", G_CALLBACK(OnMapChanged), hwnd);
+  g_signal_connect(wv, "key-press-event", G_CALLBACK(OnKeyPress), hwnd);
+  g_signal_connect(wv, "decide-policy", G_CALLBACK(OnDecidePolicy), nullptr);
+
+  rec->webView = (struct _WebKitWebView*)wv;
+  g_instances.SetNativeView(rec, wv);
+  rec->gtkPlug = plug;
+  rec->bridgeWnd = bridge;
+  if (!rec->hwnd) g_instances.SetHwnd(rec, hwnd);
+  rec->stats.ViewCreated(PerfNowUs());
+  rec->contentFilterInstalled = false;
+  WebViewApplyContentFilter(rec);
+
+  gtk_widget_show_all(plug);
+  ShowWindow(bridge, SW_SHOWNA);
+  LayoutTitleBarAndWebView(hwnd, rec->titleVisible);
+  OnInstanceHostVisibility(rec, IsWindowVisible(hwnd) != 0, "create");
+
+  webkit_web_view_load_uri(WEBKIT_WEB_VIEW(wv), initial_url.c_str());
+  LogF("[GTK] StartWebView id='%s' xid=0x%lx pooled=%d url='%s'", rec->id.c_str(), (unsigned long)(INT_PTR)xwin, (int)pooled, initial_url.c_str());
+  RequestTitlesRefresh(hwnd);
+  QueueViewPoolRefill();
+}
+
+void GtkLayoutWebView(WebViewInstanceRecord* rec, const RECT& r)
+{
+  if (!rec || !rec->bridgeWnd) return;
+  const int w = r.right - r.left, h = r.bottom - r.top;
+  SetWindowPos(rec->bridgeWnd, NULL, r.left, r.top, w > 1 ? w : 1, h > 1 ? h : 1, SWP_NOZORDER|SWP_NOACTIVATE);
+  if (rec->gtkPlug) gtk_window_resize(GTK_WINDOW(rec->gtkPlug), w > 1 ? w : 1, h > 1 ? h : 1);
+}
+
+bool GtkWebViewQuery(WebViewInstanceRecord* rec, std::string* outUrl, std::string* outTitle)
+{
+  if (!rec || !rec->webView) return false;
+  WebKitWebView* wv = WEBKIT_WEB_VIEW(rec->webView);
+  if (outUrl)   { const char* u = webkit_web_view_get_uri(wv);   *outUrl = u ? u : ""; }
+  if (outTitle) { const char* t = webkit_web_view_get_title(wv); *outTitle = t ? t : ""; }
+  return true;
+}
+
+bool GtkWebViewCanGo(WebViewInstanceRecord* rec, bool forward)
+{
+  if (!rec || !rec->webView) return false;
+  WebKitWebView* wv = WEBKIT_WEB_VIEW(rec->webView);
+  return forward ? webkit_web_view_can_go_forward(wv) : webkit_web_view_can_go_back(wv);
+}
+
+void GtkWebViewGo(WebViewInstanceRecord* rec, int dir)
+{
+  if (!rec || !rec->webView) return;
+  WebKitWebView* wv = WEBKIT_WEB_VIEW(rec->webView);
+  if (dir < 0) { if (webkit_web_view_can_go_back(wv)) webkit_web_view_go_back(wv); }
+  else if (dir > 0) { if (webkit_web_view_can_go_forward(wv)) webkit_web_view_go_forward(wv); }
+  else webkit_web_view_reload(wv);
+}
+
+void GtkWebViewDestroy(WebViewInstanceRecord* rec)
+{
+  if (!rec) return;
+  if (rec->webView) webkit_web_view_stop_loading(WEBKIT_WEB_VIEW(rec->webView));
+  if (rec->gtkPlug) gtk_widget_destroy(rec->gtkPlug); // destroys the child web view as well
+  rec->gtkPlug = nullptr; rec->webView = nullptr; rec->contentFilterInstalled = false; g_instances.SetNativeView(rec, nullptr);
+  if (rec->bridgeWnd) { DestroyWindow(rec->bridgeWnd); rec->bridgeWnd = nullptr; }
+  LogF("[GTK] destroyed webview id='%s'", rec->id.c_str());
+}
+
+// ---------------------------------------------------------------- script / hibernation hooks
+struct ScriptCall { std::string id; ScriptResultFn fn; };
+
+static void OnScriptFinished(GObject* src, GAsyncResult* res, gpointer user)
+{
+  ScriptCall* call = (ScriptCall*)user;
+  std::string out;
+  if (WebKitJavascriptResult* jr = webkit_web_view_run_javascript_finish(WEBKIT_WEB_VIEW(src), res, nullptr)) {
+    JSCValue* v = webkit_javascript_result_get_js_value(jr);
+    if (v && !jsc_value_is_null(v) && !jsc_value_is_undefined(v)) {
+      if (char* str = jsc_value_to_string(v)) { out = str; g_free(str); }
+    }
+    webkit_javascript_result_unref(jr);
+  }
+  if (call->fn) call->fn(call->id, out);
+  delete call;
+}
+
+void WebViewEvalScript(WebViewInstanceRecord* rec, const std::string& js, ScriptResultFn fn)
+{
+  if (!rec || !rec->webView) { if (fn) fn(rec ? rec->id : std::string(), std::string()); return; }
+  rec->stats.BridgeOut(js.size());
+  webkit_web_view_run_javascript(WEBKIT_WEB_VIEW(rec->webView), js.c_str(), nullptr,
+                                 fn ? OnScriptFinished : nullptr, fn ? new ScriptCall{ rec->id, fn } : nullptr);
+}
+
+// ---------------------------------------------------------------- snapshots
+struct SnapshotCall { std::string id; int token; SnapshotFn fn; };
+
+// The cairo image surface is ARGB32 in native byte order (= BGRA premultiplied, LICE order on little-endian);
+// rows are copied out to drop the stride, encoding is left to the capture worker
+static void OnSnapshotReady(GObject* src, GAsyncResult* res, gpointer user)
+{
+  SnapshotCall* call = (SnapshotCall*)user;
+  GError* err = nullptr;
+  cairo_surface_t* surf = webkit_web_view_get_snapshot_finish(WEBKIT_WEB_VIEW(src), res, &err);
+  if (!surf || cairo_surface_get_type(surf) != CAIRO_SURFACE_TYPE_IMAGE) {
+    call->fn(call->id, call->token, nullptr, err ? err->message : "snapshot failed");
+    if (err) g_error_free(err);
+    if (surf) cairo_surface_destroy(surf);
+    delete call;
+    return;
+  }
+  cairo_surface_flush(surf);
+  CapturePixels px;
+  px.w = cairo_image_surface_get_width(surf); px.h = cairo_image_surface_get_height(surf); px.rowBytes = px.w * 4;
+  const int stride = cairo_image_surface_get_stride(surf);
+  const bool opaque = cairo_image_surface_get_format(surf) == CAIRO_FORMAT_RGB24; // alpha byte undefined
+  const unsigned char* data = cairo_image_surface_get_data(surf);
+  px.px.resize((size_t)px.rowBytes * px.h);
+  for (int y = 0; data && y < px.h; ++y) {
+    uint8_t* dst = px.px.data() + (size_t)y * px.rowBytes;
+    memcpy(dst, data + (size_t)y * stride, (size_t)px.rowBytes);
+    if (opaque) for (int x = 0; x < px.w; ++x) dst[x * 4 + 3] = 255;
+  }
+  cairo_surface_destroy(surf);
+  if (data) call->fn(call->id, call->token, &px, nullptr); else call->fn(call->id, call->token, nullptr, "snapshot failed");
+  delete call;
+}
+
+void WebViewSnapshot(WebViewInstanceRecord* rec, int token, SnapshotFn fn)
+{
+  if (!rec || !rec->webView) { fn(rec ? rec->id : std::string(), token, nullptr, "no view"); return; }
+  webkit_web_view_get_snapshot(WEBKIT_WEB_VIEW(rec->webView), WEBKIT_SNAPSHOT_REGION_VISIBLE, WEBKIT_SNAPSHOT_OPTIONS_NONE,
+                               nullptr, OnSnapshotReady, new SnapshotCall{ rec->id, token, fn });
+}
+
+void WebViewPostState(WebViewInstanceRecord* rec, const std::string& json)
+{
+  if (!rec || !rec->webView) return;
+  const std::string js = "window.__rwvState&&window.__rwvState.push(" + json + ")";
+  rec->stats.BridgeOut(json.size());
+  webkit_web_view_run_javascript(WEBKIT_WEB_VIEW(rec->webView), js.c_str(), nullptr, nullptr, nullptr);
+}
+
+// No way to map memory into a WebKit page: slots live on the heap and each publish ships the floats base64-encoded
+void WebViewSharedBufferAlloc(WebViewInstanceRecord*, SharedBufferSlot& slot, uint32_t capacity) { slot.AllocHeap(capacity); }
+
+void WebViewSharedBufferPublish(WebViewInstanceRecord* rec, SharedBufferSlot& slot)
+{
+  if (!rec || !rec->webView) return;
+  const std::string js = SharedBufferPutScript(slot);
+  slot.bytesShipped += js.size();
+  WebViewEvalScript(rec, js, nullptr);
+}
+
+void WebViewSharedBufferFree(SharedBufferSlot& slot) { slot.heap.clear(); slot.mem = nullptr; }
+
+// Request filter as a WebKitUserContentFilter (WebKitGTK 2.24+), compiled asynchronously into a store under
+// WebKitGTKData once per list load (keyed by generation); until it completes the page loads unfiltered.
+#if WEBKIT_CHECK_VERSION(2, 24, 0)
+struct FilterCompile { std::string id; unsigned gen; };
+static std::unordered_map<unsigned, WebKitUserContentFilter*> g_compiledFilters;
+
+static WebKitUserContentFilterStore* FilterStore()
+{
+  static WebKitUserContentFilterStore* s = nullptr;
+  if (!s) {
+    const char* res = GetResourcePath ? GetResourcePath() : nullptr;
+    s = webkit_user_content_filter_store_new((std::string((res && *res) ? res : ".") + "/WebKitGTKData/content-filters").c_str());
+  }
+  return s;
+}
+
+static void InstallFilter(WebViewInstanceRecord* rec, WebKitUserContentFilter* f)
+{
+  webkit_user_content_manager_add_filter(webkit_web_view_get_user_content_manager(WEBKIT_WEB_VIEW(rec->webView)), f);
+  rec->contentFilterInstalled = true;
+}
+
+static void OnFilterCompiled(GObject* store, GAsyncResult* res, gpointer user)
+{
+  FilterCompile* fc = (FilterCompile*)user;
+  GError* err = nullptr;
+  WebKitUserContentFilter* f = webkit_user_content_filter_store_save_finish(WEBKIT_USER_CONTENT_FILTER_STORE(store), res, &err);
+  LogF("[Filter][gtk] compile gen=%u %s", fc->gen, f ? "ok" : (err ? err->message : "failed"));
+  if (err) g_error_free(err);
+  if (f) {
+    g_compiledFilters[fc->gen] = f; // kept for later views using the same list
+    WebViewInstanceRecord* rec = GetInstanceById(fc->id);
+    ContentFilterList* cur = rec ? ContentFilterFor(rec) : nullptr;
+    if (rec && rec->webView && !rec->contentFilterInstalled && cur && cur->gen == fc->gen) InstallFilter(rec, f);
+  }
+  delete fc;
+}
+#endif
+
+void WebViewApplyContentFilter(WebViewInstanceRecord* rec)
+{
+  if (!rec || !rec->webView) return;
+#if WEBKIT_CHECK_VERSION(2, 24, 0)
+  if (rec->contentFilterInstalled) {
+    webkit_user_content_manager_remove_all_filters(webkit_web_view_get_user_content_manager(WEBKIT_WEB_VIEW(rec->webView)));
+    rec->contentFilterInstalled = false;
+  }
+  ContentFilterList* list = ContentFilterFor(rec);
+  if (!list) return;
+  auto it = g_compiledFilters.find(list->gen);
+  if (it != g_compiledFilters.end()) { InstallFilter(rec, it->second); return; }
+  const std::string& json = ContentFilterRulesJson(list);
+  GBytes* src = g_bytes_new(json.data(), json.size());
+  const std::string key = "rwv_filter_" + std::to_string(list->gen);
+  webkit_user_content_filter_store_save(FilterStore(), key.c_str(), src, nullptr, OnFilterCompiled, new FilterCompile{ rec->id, list->gen });
+  g_bytes_unref(src);
+#else
+  LogF("[Filter][gtk] id='%s' WebKitGTK < 2.24: subresources unfiltered, navigations only", rec->id.c_str());
+#endif
+}
+
+// WebKitGTK has no page suspend API: hidden instances are only discarded (HibernateDiscardSec)
+bool WebViewCanSuspend() { return false; }
+bool WebViewSuspend(WebViewInstanceRecord*) { return false; }
+void WebViewResume(WebViewInstanceRecord*) {}
+
+bool WebViewIsPlayingAudio(WebViewInstanceRecord* rec)
+{
+  return rec && rec->webView && webkit_web_view_is_playing_audio(WEBKIT_WEB_VIEW(rec->webView));
+}
+
+bool WebViewHasView(WebViewInstanceRecord* rec) { return rec && rec->webView; }
+
+void WebViewDestroyView(WebViewInstanceRecord* rec)
+{
+  if (!rec) return;
+  GtkFindClose(rec);
+  GtkWebViewDestroy(rec);
+}
+
+void NavigateExisting(const std::string& url)
+{
+  if (url.empty()) return;
+  std::string activeId = g_instanceId.empty()?std::string("wv_default"):g_instanceId;
+  WebViewInstanceRecord* rec = GetInstanceById(activeId);
+  if (!rec || !rec->webView) return;
+  webkit_web_view_load_uri(WEBKIT_WEB_VIEW(rec->webView), url.c_str());
+}
+
+void NavigateExistingInstance(const std::string& instanceId, const std::string& url)
+{
+  if (url.empty()) return;
+  WebViewInstanceRecord* rec = GetInstanceById(instanceId);
+  if (!rec || !rec->webView) return;
+  rec->lastUrl = url; MarkInstanceStateDirty();
+  webkit_web_view_load_uri(WEBKIT_WEB_VIEW(rec->webView), url.c_str());
+}
+
+// ====================== Native Find (WebKitFindController) ======================
+// WebKitGTK highlights all matches itself; we only track n/N. The controller reports the total via
+// "counted-matches"; search_next/search_previous are asynchronous, so the current hit only moves when
+// "found-text" answers them (wraps like Windows/mac).
+
+static void OnCountedMatches(WebKitFindController* fc, guint count, gpointer)
+{
+  WebViewInstanceRecord* rec = FindRecByWebView(webkit_find_controller_get_web_view(fc)); if (!rec) return;
+  rec->findTotalMatches = (int)count;
+  rec->stats.FindCounted(PerfNowUs(), rec->findTotalMatches);
+  if (rec->findCurrentIndex > rec->findTotalMatches) rec->findCurrentIndex = rec->findTotalMatches;
+  if (rec->findTotalMatches > 0 && rec->findCurrentIndex == 0) rec->findCurrentIndex = 1;
+  UpdateFindCounter(rec);
+}
+
+static void OnFoundText(WebKitFindController* fc, guint, gpointer)
+{
+  WebViewInstanceRecord* rec = FindRecByWebView(webkit_find_controller_get_web_view(fc)); if (!rec) return;
+  const int step = rec->findPendingSteps > 0 ? 1 : (rec->findPendingSteps < 0 ? -1 : 0);
+  rec->findPendingSteps -= step;
+  const int tot = rec->findTotalMatches;
+  if (step == 0) { if (rec->findCurrentIndex == 0) rec->findCurrentIndex = 1; } // first hit of a new search
+  else if (tot > 0) {
+    int cur = rec->findCurrentIndex + step;
+    if (cur > tot) cur = 1;
+    if (cur < 1) cur = tot;
+    rec->findCurrentIndex = cur;
+  }
+  UpdateFindCounter(rec);
+}
+
+static void OnFailedToFind(WebKitFindController* fc, gpointer)
+{
+  WebViewInstanceRecord* rec = FindRecByWebView(webkit_find_controller_get_web_view(fc)); if (!rec) return;
+  rec->findTotalMatches = 0; rec->findCurrentIndex = 0; rec->findPendingSteps = 0; UpdateFindCounter(rec);
+  rec->stats.FindCounted(PerfNowUs(), 0);
+}
+
+static WebKitFindController* EnsureFindController(WebViewInstanceRecord* rec)
+{
+  if (!rec || !rec->webView) return nullptr;
+  WebKitFindController* fc = webkit_web_view_get_find_controller(WEBKIT_WEB_VIEW(rec->webView));
+  if (fc && !g_object_get_data(G_OBJECT(fc), "rwv-hooked")) {
+    g_signal_connect(fc, "counted-matches", G_CALLBACK(OnCountedMatches), nullptr);
+    g_signal_connect(fc, "found-text", G_CALLBACK(OnFoundText), nullptr);
+    g_signal_connect(fc, "failed-to-find-text", G_CALLBACK(OnFailedToFind), nullptr);
+    g_object_set_data(G_OBJECT(fc), "rwv-hooked", (gpointer)1);
+  }
+  return fc;
+}
+
+void GtkFindStartOrUpdate(WebViewInstanceRecord* rec)
+{
+  WebKitFindController* fc = EnsureFindController(rec); if (!fc) return;
+  rec->findCurrentIndex = 0; rec->findTotalMatches = 0; rec->findPendingSteps = 0;
+  if (rec->findQuery.empty()) { webkit_find_controller_search_finish(fc); UpdateFindCounter(rec); return; }
+  guint32 opts = WEBKIT_FIND_OPTIONS_WRAP_AROUND | (rec->findCaseSensitive ? 0 : WEBKIT_FIND_OPTIONS_CASE_INSENSITIVE);
+  rec->stats.FindStarted(PerfNowUs()); // closed by counted-matches / failed-to-find-text
+  webkit_find_controller_count_matches(fc, rec->findQuery.c_str(), opts, G_MAXUINT);
+  webkit_find_controller_search(fc, rec->findQuery.c_str(), opts, G_MAXUINT);
+  rec->findLastHighlightedQuery = rec->findQuery; rec->findLastHighlightedCase = rec->findCaseSensitive;
+  LogF("[Find][gtk] start query='%s' case=%d", rec->findQuery.c_str(), (int)rec->findCaseSensitive);
+}
+
+void GtkFindNavigate(WebViewInstanceRecord* rec, bool forward)
+{
+  WebKitFindController* fc = EnsureFindController(rec); if (!fc || rec->findQuery.empty()) return;
+  if (rec->findLastHighlightedQuery != rec->findQuery || rec->findLastHighlightedCase != rec->findCaseSensitive) { GtkFindStartOrUpdate(rec); return; }
+  rec->findPendingSteps += forward ? 1 : -1; // the counter moves in OnFoundText
+  if (forward) webkit_find_controller_search_next(fc); else webkit_find_controller_search_previous(fc);
+}
+
+void GtkFindClose(WebViewInstanceRecord* rec)
+{
+  if (!rec || !rec->webView) return;
+  webkit_find_controller_search_finish(webkit_web_view_get_find_controller(WEBKIT_WEB_VIEW(rec->webView)));
+  rec->findCurrentIndex = 0; rec->findTotalMatches = 0; rec->findPendingSteps = 0;
+  rec->findLastHighlightedQuery.clear(); rec->findLastHighlightedCase = false;
+}
+
+#endif // Linux
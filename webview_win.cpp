@@ -10,13 +10,18 @@
 #include "predef.h"
 
 #include <shlwapi.h>
+#include <wincodec.h>
 #include <direct.h>
+#include "deps/WebView2EnvironmentOptions.h" // CoreWebView2EnvironmentOptions, custom scheme registrations
+#include <functional>
 #pragma comment(lib, "Shlwapi.lib")
 
 #include "log.h"
 #include "globals.h"
 #include "helpers.h"
 #include "webview.h"
+#include "core/json_cursor.h"
+#include "core/stream_script.h"
 
 // Additional forward declarations / externs required by accelerator handler logic
 extern void EnsureFindBarCreated(HWND hwnd); // defined in main.mm
@@ -84,8 +89,28 @@ static HMODULE LoadWebView2Loader()
   return NULL;
 }
 
-void StartWebView(HWND hwnd, const std::string& initial_url)
+// ================= Shared environment + controller pool =================
+// There is a single user-data folder (<resource>/WebView2Data), so one ICoreWebView2Environment serves
+// every instance: COM init, loader lookup, version probe and environment creation run once per session.
+// Requests arriving while the environment is still being created queue up and run on completion.
+// On top of that, GetWebViewPoolTarget() hidden controllers are kept parked on an invisible window so
+// the next instance attaches a live browser instead of waiting for CreateCoreWebView2Controller.
+typedef std::function<void(ICoreWebView2Environment*)> EnvWaiter;
+static wil::com_ptr<ICoreWebView2Environment> g_sharedEnv;
+static bool g_sharedEnvPending = false;
+static bool g_backendShutDown = false; // a late environment completion must not be kept after shutdown
+static std::vector<EnvWaiter> g_envWaiters;
+static std::vector<ICoreWebView2Controller*> g_controllerPool; // owned references, hidden
+static int  g_poolCreating = 0;
+static HWND g_poolParking = nullptr;
+
+static void WithSharedEnvironment(EnvWaiter fn)
 {
+  if (g_backendShutDown) return;
+  if (g_sharedEnv) { fn(g_sharedEnv.get()); return; }
+  g_envWaiters.push_back(std::move(fn));
+  if (g_sharedEnvPending) return;
+
   if (!g_com_initialized)
   {
     HRESULT hr = CoInitializeEx(nullptr, COINIT_APARTMENTTHREADED);
@@ -104,7 +129,7 @@ void StartWebView(HWND hwnd, const std::string& initial_url)
     g_hWebView2Loader = LoadWebView2Loader();
     LogF("LoadLibrary(WebView2Loader) -> %p", (void*)g_hWebView2Loader);
   }
-  if (!g_hWebView2Loader) { LogRaw("FATAL: missing WebView2Loader.dll"); return; }
+  if (!g_hWebView2Loader) { LogRaw("FATAL: missing WebView2Loader.dll"); g_envWaiters.clear(); return; }
 
   using PFN_GetVer = HRESULT (STDMETHODCALLTYPE *)(PCWSTR, LPWSTR*);
   if (auto pGetVer = (PFN_GetVer)GetProcAddress(g_hWebView2Loader, "GetAvailableCoreWebView2BrowserVersionString"))
@@ -118,218 +143,359 @@ void StartWebView(HWND hwnd, const std::string& initial_url)
     ICoreWebView2CreateCoreWebView2EnvironmentCompletedHandler*);
   auto pCreateEnv = (CreateEnv_t)GetProcAddress(g_hWebView2Loader, "CreateCoreWebView2EnvironmentWithOptions");
   LogF("GetProcAddress(CreateCoreWebView2EnvironmentWithOptions) -> %p", (void*)pCreateEnv);
-  if (!pCreateEnv) { LogRaw("FATAL: CreateCoreWebView2EnvironmentWithOptions not found"); return; }
+  if (!pCreateEnv) { LogRaw("FATAL: CreateCoreWebView2EnvironmentWithOptions not found"); g_envWaiters.clear(); return; }
 
-  std::wstring wurl(initial_url.begin(), initial_url.end());
-  // Determine current active instance id for association
-  std::string activeId = g_instanceId.empty()?std::string("wv_default"):g_instanceId;
   std::wstring wudf(udf.begin(), udf.end());
-
-  LogRaw("Start WebView2 environment...");
-  HRESULT hrEnv = pCreateEnv(nullptr, wudf.c_str(), nullptr,
+  // rwv:// must be registered before the environment exists; requests are answered in WebResourceRequested
+  auto envOptions = Microsoft::WRL::Make<CoreWebView2EnvironmentOptions>();
+  Microsoft::WRL::ComPtr<ICoreWebView2EnvironmentOptions4> envOptions4;
+  if (envOptions && SUCCEEDED(envOptions.As(&envOptions4))) {
+    auto rwvScheme = Microsoft::WRL::Make<CoreWebView2CustomSchemeRegistration>(L"rwv");
+    rwvScheme->put_TreatAsSecure(TRUE);
+    rwvScheme->put_HasAuthorityComponent(TRUE);
+    const WCHAR* origins[] = { L"*" };
+    rwvScheme->SetAllowedOrigins(1, origins);
+    ICoreWebView2CustomSchemeRegistration* schemes[] = { rwvScheme.Get() };
+    envOptions4->SetCustomSchemeRegistrations(1, schemes);
+  }
+  LogRaw("Start WebView2 environment (shared)...");
+  g_sharedEnvPending = true;
+  HRESULT hrEnv = pCreateEnv(nullptr, wudf.c_str(), envOptions.Get(),
     Callback<ICoreWebView2CreateCoreWebView2EnvironmentCompletedHandler>(
-  [hwnd, wurl, activeId](HRESULT result, ICoreWebView2Environment* env)->HRESULT
+      [](HRESULT result, ICoreWebView2Environment* env)->HRESULT
       {
-        LogF("[EnvCompleted] hr=0x%lX env=%p", (long)result, (void*)env);
-        if (FAILED(result) || !env) return S_OK;
-
-        env->CreateCoreWebView2Controller(hwnd,
-          Callback<ICoreWebView2CreateCoreWebView2ControllerCompletedHandler>(
-            [hwnd, wurl, activeId, env](HRESULT result, ICoreWebView2Controller* controller)->HRESULT
-            {
-              LogF("[ControllerCompleted] hr=0x%lX controller=%p", (long)result, (void*)controller);
-              if (!controller) return S_OK;
-              wil::com_ptr<ICoreWebView2> localWebView;
-              controller->get_CoreWebView2(&localWebView);
-
-              // Store into instance record
-              WebViewInstanceRecord* rec = GetInstanceById(activeId);
-              if (rec) {
-                // Release any previous pointers before overwriting (should normally be null for first creation)
-                if (rec->controller) { rec->controller->Release(); rec->controller = nullptr; }
-                if (rec->webview)    { rec->webview->Release();    rec->webview = nullptr; }
-                if (rec->environment) { rec->environment->Release(); rec->environment=nullptr; }
-                rec->controller = controller; if (rec->controller) rec->controller->AddRef();
-                rec->webview    = localWebView.get(); if (rec->webview) rec->webview->AddRef();
-                if (env) { env->AddRef(); rec->environment = env; }
-                if (!rec->hwnd) rec->hwnd = hwnd;
-              }
-              else {
-                LogF("[ControllerCompleted] instance '%s' not found, releasing controller immediately", activeId.c_str());
-                controller->Close();
-                return S_OK;
-              }
-
-              if (localWebView)
-              {
-                // Subscribe to controller focus events for more reliable multi-dock focus tracking
-                if (rec && rec->controller) {
-                  auto gotCb = Microsoft::WRL::Callback<ICoreWebView2FocusChangedEventHandler>(
-                    [rec](ICoreWebView2Controller* /*sender*/, IUnknown* /*args*/) -> HRESULT {
-                      UpdateFocusChain(rec->id);
-                      LogF("[FocusEvt] GotFocus id='%s' tick=%lu", rec->id.c_str(), (unsigned long)rec->lastFocusTick);
-                      return S_OK;
-                    });
-                  EventRegistrationToken tok1{}; if (SUCCEEDED(rec->controller->add_GotFocus(gotCb.Get(), (EventRegistrationToken*)&tok1))) rec->gotFocusToken = *(WebViewInstanceRecord::EventRegistrationToken*)&tok1;
-                  auto lostCb = Microsoft::WRL::Callback<ICoreWebView2FocusChangedEventHandler>(
-                    [rec](ICoreWebView2Controller* /*sender*/, IUnknown* /*args*/) -> HRESULT {
-                      // LostFocus not always essential, but we log for diagnostics (do NOT update lastFocusTick)
-                      LogF("[FocusEvt] LostFocus id='%s'", rec->id.c_str());
-                      return S_OK;
-                    });
-                  EventRegistrationToken tok2{}; rec->controller->add_LostFocus(lostCb.Get(), (EventRegistrationToken*)&tok2); rec->lostFocusToken = *(WebViewInstanceRecord::EventRegistrationToken*)&tok2;
-                }
-                // Intercept Ctrl+F via AcceleratorKeyPressed to suppress default WebView find dialog
-                if (rec && rec->controller) {
-                  EventRegistrationToken accelTok{};
-                  rec->controller->add_AcceleratorKeyPressed(Callback<ICoreWebView2AcceleratorKeyPressedEventHandler>(
-                    [rec](ICoreWebView2Controller* /*sender*/, ICoreWebView2AcceleratorKeyPressedEventArgs* args)->HRESULT {
-                      COREWEBVIEW2_KEY_EVENT_KIND kind; if (FAILED(args->get_KeyEventKind(&kind))) return S_OK;
-                      if (kind != COREWEBVIEW2_KEY_EVENT_KIND_KEY_DOWN && kind != COREWEBVIEW2_KEY_EVENT_KIND_SYSTEM_KEY_DOWN) return S_OK;
-                      UINT key=0; args->get_VirtualKey(&key);
-                      INT modifiers=0; args->get_KeyEventLParam(&modifiers); // modifiers not directly exposed; use GetKeyState as fallback
-                      bool ctrl = (GetKeyState(VK_CONTROL)&0x8000)!=0;
-                      bool shift = (GetKeyState(VK_SHIFT)&0x8000)!=0;
-                      if (ctrl && (key=='F' || key=='f')) {
-                        // Mark handled to suppress default dialog
-                        args->put_Handled(TRUE);
-                        // Show or navigate find bar
-                        if (!rec->showFindBar) {
-                          rec->showFindBar = true; LogRaw("[AccelCtrlF] show find bar");
-                          bool titleVisible = (rec->titleBar && IsWindow(rec->titleBar) && IsWindowVisible(rec->titleBar));
-                          LayoutTitleBarAndWebView(rec->hwnd, titleVisible);
-                          RWV_WinEnsureFindBarShim(rec->hwnd);
-                          if (rec->findEdit && IsWindow(rec->findEdit)) { SetFocus(rec->findEdit); SendMessageW(rec->findEdit, EM_SETSEL, 0, -1); }
-                        } else {
-                          RWV_WinEnsureFindBarShim(rec->hwnd);
-                          if (rec->findEdit && IsWindow(rec->findEdit)) SetFocus(rec->findEdit);
-                          g_findEnterActive = true; g_findLastEnterTick = GetTickCount();
-                          WinFindNavigate(rec, !shift);
-                          LogF("[AccelCtrlF] nav %s query='%s'", shift?"prev":"next", rec->findQuery.c_str());
-                          if (rec->findEdit && IsWindow(rec->findEdit)) SendMessageW(rec->findEdit, EM_SETSEL, (WPARAM)-1, (LPARAM)-1);
-                        }
-                        // Update focus chain explicitly (user intent is on this instance)
-                        UpdateFocusChain(rec->id);
-                      }
-                      return S_OK;
-                    }
-                  ).Get(), &accelTok);
-                }
-                // Try to acquire native Find interface once controller/webview ready
-                WebViewInstanceRecord* recAcquire = GetInstanceById(activeId);
-                if (recAcquire && recAcquire->webview) {
-                  // Query latest extended interface that exposes get_Find (ICoreWebView2_28 onwards). We use raw QueryInterface by IID.
-                  // The header might not expose symbolic name; use documented IID via __uuidof trick if available, else skip.
-                  // Simplified: attempt to QI for ICoreWebView2_28 by GUID (fallback: ignore if not found).
-                  // NOTE: If newer SDK not available in this header subset, this will safely fail.
-                  struct ICoreWebView2_28; // forward (avoid including heavy sections)
-                  // We cannot directly use __uuidof(ICoreWebView2_28) without full declaration; skip until WinEnsureNativeFind.
-                }
-                wil::com_ptr<ICoreWebView2Settings> settings;
-                if (SUCCEEDED(localWebView->get_Settings(&settings)) && settings)
-                  settings->put_AreDefaultContextMenusEnabled(FALSE);
-
-                // JS bridge: ПКМ из WebView2 -> локальное меню (без JS find fallback)
-                {
-                  static const wchar_t* kFRZCtxJS = LR"JS(
-                    window.addEventListener('contextmenu', function(e){
-                      e.preventDefault();
-                      var scale = window.devicePixelRatio || 1;
-                      var px = Math.round(e.screenX * scale);
-                      var py = Math.round(e.screenY * scale);
-                      var s = 'CTX|' + px + '|' + py;
-                      if (window.chrome && window.chrome.webview) window.chrome.webview.postMessage(s);
-                    }, true);
-                  )JS";
-                  localWebView->AddScriptToExecuteOnDocumentCreated(
-                    kFRZCtxJS,
-                    Callback<ICoreWebView2AddScriptToExecuteOnDocumentCreatedCompletedHandler>(
-                      [](HRESULT /*ec*/, PCWSTR /*id*/) -> HRESULT { return S_OK; }
-                    ).Get());
-                }
-
-                // Receive 'CTX|x|y' и показать локальное меню
-                localWebView->add_WebMessageReceived(
-                  Callback<ICoreWebView2WebMessageReceivedEventHandler>(
-                    [hwnd](ICoreWebView2*, ICoreWebView2WebMessageReceivedEventArgs* args)->HRESULT {
-                      wil::unique_cotaskmem_string json;
-                      if (SUCCEEDED(args->get_WebMessageAsJson(&json)) && json) {
-                        std::string s = Narrow(std::wstring(json.get()));
-                        if (!s.empty() && s.front()=='"' && s.back()=='"') s = s.substr(1, s.size()-2);
-                        if (s.rfind("CTX|", 0) == 0) {
-                          int sx=0, sy=0;
-                          #ifdef _WIN32
-                            sscanf_s(s.c_str()+4, "%d|%d", &sx, &sy);
-                          #else
-                            sscanf(s.c_str()+4, "%d|%d", &sx, &sy);
-                          #endif
-                          PostMessage(hwnd, WM_CONTEXTMENU, (WPARAM)hwnd, MAKELPARAM(sx, sy));
-                        }
-                      }
-                      return S_OK;
-                    }).Get(), nullptr);
-
-                // Глушим дефолтное контекстное меню Edge
-                Microsoft::WRL::ComPtr<ICoreWebView2_13> wv13;
-                if (localWebView && SUCCEEDED(localWebView.get()->QueryInterface(IID_PPV_ARGS(&wv13)))) {
-                  wv13->add_ContextMenuRequested(
-                    Callback<ICoreWebView2ContextMenuRequestedEventHandler>(
-                      [](ICoreWebView2*, ICoreWebView2ContextMenuRequestedEventArgs* args)->HRESULT {
-                        args->put_Handled(TRUE);
-                        return S_OK;
-                      }).Get(),
-                    nullptr);
-                }
-
-                localWebView->add_DocumentTitleChanged(
-                  Callback<ICoreWebView2DocumentTitleChangedEventHandler>(
-                    [activeId, hwnd](ICoreWebView2*, IUnknown*)->HRESULT
-                    {
-                      WebViewInstanceRecord* r = GetInstanceById(activeId);
-                      HWND target = (r && r->hwnd && IsWindow(r->hwnd)) ? r->hwnd : (IsWindow(hwnd)?hwnd:NULL);
-                      if (target) UpdateTitlesExtractAndApply(target); else LogF("[CallbackSkip] TitleChanged dead hwnd activeId='%s'", activeId.c_str());
-                      return S_OK;
-                    }).Get(), nullptr);
-
-                localWebView->add_NavigationStarting(
-                  Callback<ICoreWebView2NavigationStartingEventHandler>(
-                    [activeId, hwnd](ICoreWebView2*, ICoreWebView2NavigationStartingEventArgs* args)->HRESULT
-                    {
-                      wil::unique_cotaskmem_string uri;
-                      if (args && SUCCEEDED(args->get_Uri(&uri))) LogF("[NavigationStarting] %S", uri.get());
-                      WebViewInstanceRecord* r = GetInstanceById(activeId);
-                      HWND target = (r && r->hwnd && IsWindow(r->hwnd)) ? r->hwnd : (IsWindow(hwnd)?hwnd:NULL);
-                      if (target) UpdateTitlesExtractAndApply(target); else LogF("[CallbackSkip] NavStarting dead hwnd activeId='%s'", activeId.c_str());
-                      return S_OK;
-                    }).Get(), nullptr);
-
-                localWebView->add_NavigationCompleted(
-                  Callback<ICoreWebView2NavigationCompletedEventHandler>(
-                    [activeId, hwnd](ICoreWebView2*, ICoreWebView2NavigationCompletedEventArgs* args)->HRESULT
-                    {
-                      BOOL ok = FALSE; if (args) args->get_IsSuccess(&ok);
-                      COREWEBVIEW2_WEB_ERROR_STATUS st = COREWEBVIEW2_WEB_ERROR_STATUS_UNKNOWN;
-                      if (args) args->get_WebErrorStatus(&st);
-                      LogF("[NavigationCompleted] ok=%d status=%d", (int)ok, (int)st);
-                      WebViewInstanceRecord* r = GetInstanceById(activeId);
-                      HWND target = (r && r->hwnd && IsWindow(r->hwnd)) ? r->hwnd : (IsWindow(hwnd)?hwnd:NULL);
-                      if (target) UpdateTitlesExtractAndApply(target); else LogF("[CallbackSkip] NavCompleted dead hwnd activeId='%s'", activeId.c_str());
-                      return S_OK;
-                    }).Get(), nullptr);
-              }
-
-              RECT rc; GetClientRect(hwnd, &rc);
-              LayoutTitleBarAndWebView(hwnd, false);
-              controller->put_IsVisible(TRUE);
-              LogRaw("Navigate initial URL...");
-              WebViewInstanceRecord* recInit = GetInstanceById(activeId);
-              if (recInit && recInit->webview) recInit->webview->Navigate(wurl.c_str());
-              UpdateTitlesExtractAndApply(hwnd);
-              return S_OK;
-            }).Get());
+        g_sharedEnvPending = false;
+        std::vector<EnvWaiter> waiters; waiters.swap(g_envWaiters);
+        LogF("[EnvCompleted] hr=0x%lX env=%p waiters=%zu", (long)result, (void*)env, waiters.size());
+        if (FAILED(result) || !env || g_backendShutDown) return S_OK; // after shutdown: not kept, nothing to release
+        g_sharedEnv = env;
+        for (auto& w : waiters) w(env);
         return S_OK;
       }).Get());
   LogF("CreateCoreWebView2EnvironmentWithOptions returned 0x%lX", (long)hrEnv);
+  if (FAILED(hrEnv)) { g_sharedEnvPending = false; g_envWaiters.clear(); }
+}
+
+static void ReplenishControllerPool(ICoreWebView2Environment* env)
+{
+  const int target = GetWebViewPoolTarget();
+  if (!env || target <= 0) return;
+  if (!g_poolParking)
+    g_poolParking = CreateWindowExW(WS_EX_TOOLWINDOW, L"STATIC", L"", WS_POPUP, 0, 0, 16, 16, nullptr, nullptr, (HINSTANCE)g_hInst, nullptr);
+  if (!g_poolParking) return;
+  while ((int)g_controllerPool.size() + g_poolCreating < target) {
+    ++g_poolCreating;
+    HRESULT hr = env->CreateCoreWebView2Controller(g_poolParking,
+      Callback<ICoreWebView2CreateCoreWebView2ControllerCompletedHandler>(
+        [](HRESULT result, ICoreWebView2Controller* c)->HRESULT
+        {
+          --g_poolCreating;
+          if (FAILED(result) || !c) { LogF("[Pool] prewarm failed hr=0x%lX", (long)result); return S_OK; }
+          if (!g_sharedEnv || g_backendShutDown) { c->Close(); return S_OK; } // backend shut down meanwhile
+          c->put_IsVisible(FALSE);
+          c->AddRef(); g_controllerPool.push_back(c);
+          LogF("[Pool] controller parked (%zu ready)", g_controllerPool.size());
+          return S_OK;
+        }).Get());
+    if (FAILED(hr)) { --g_poolCreating; LogF("[Pool] CreateCoreWebView2Controller hr=0x%lX", (long)hr); break; }
+  }
+}
+
+// Caller owns the returned reference
+static ICoreWebView2Controller* TakePooledController(HWND newParent)
+{
+  while (!g_controllerPool.empty()) {
+    ICoreWebView2Controller* c = g_controllerPool.back(); g_controllerPool.pop_back();
+    if (SUCCEEDED(c->put_ParentWindow(newParent))) return c;
+    c->Close(); c->Release(); // browser process went away while parked
+  }
+  return nullptr;
+}
+
+void WebViewBackendShutdown()
+{
+  g_backendShutDown = true;
+  for (ICoreWebView2Controller* c : g_controllerPool) { c->Close(); c->Release(); }
+  g_controllerPool.clear();
+  g_envWaiters.clear();
+  g_sharedEnv.reset();
+  if (g_poolParking) { DestroyWindow(g_poolParking); g_poolParking = nullptr; }
+}
+
+// Binds a ready controller (fresh or pooled) to the instance record, wires events and navigates.
+static void AttachControllerToInstance(HWND hwnd, const std::wstring& wurl, const std::string& activeId,
+                                       ICoreWebView2Environment* env, ICoreWebView2Controller* controller)
+{
+  wil::com_ptr<ICoreWebView2> localWebView;
+  controller->get_CoreWebView2(&localWebView);
+
+  // Store into instance record
+  WebViewInstanceRecord* rec = GetInstanceById(activeId);
+  if (rec) {
+    // Release any previous pointers before overwriting (should normally be null for first creation)
+    if (rec->controller) { rec->controller->Release(); rec->controller = nullptr; }
+    if (rec->webview)    { rec->webview->Release();    rec->webview = nullptr; rec->contentFilterInstalled = false; }
+    if (rec->environment) { rec->environment->Release(); rec->environment=nullptr; }
+    rec->controller = controller; if (rec->controller) rec->controller->AddRef();
+    rec->webview    = localWebView.get(); if (rec->webview) rec->webview->AddRef();
+    if (env) { env->AddRef(); rec->environment = env; }
+    g_instances.SetNativeView(rec, rec->webview);
+    if (!rec->hwnd) g_instances.SetHwnd(rec, hwnd);
+    rec->stats.ViewCreated(PerfNowUs());
+  }
+  else {
+    LogF("[ControllerCompleted] instance '%s' not found, releasing controller immediately", activeId.c_str());
+    controller->Close();
+    return;
+  }
+
+  if (localWebView)
+  {
+    // Subscribe to controller focus events for more reliable multi-dock focus tracking
+    if (rec && rec->controller) {
+      auto gotCb = Microsoft::WRL::Callback<ICoreWebView2FocusChangedEventHandler>(
+        [rec](ICoreWebView2Controller* /*sender*/, IUnknown* /*args*/) -> HRESULT {
+          OnInstanceFocusEvent(rec, "GotFocus");
+          LogDebugF("[FocusEvt] GotFocus id='%s' tick=%lu", rec->id.c_str(), (unsigned long)rec->lastFocusTick);
+          return S_OK;
+        });
+      EventRegistrationToken tok1{}; if (SUCCEEDED(rec->controller->add_GotFocus(gotCb.Get(), (EventRegistrationToken*)&tok1))) rec->gotFocusToken = *(WebViewInstanceRecord::EventRegistrationToken*)&tok1;
+      auto lostCb = Microsoft::WRL::Callback<ICoreWebView2FocusChangedEventHandler>(
+        [rec](ICoreWebView2Controller* /*sender*/, IUnknown* /*args*/) -> HRESULT {
+          // LostFocus not always essential, but we log for diagnostics (do NOT update lastFocusTick)
+          LogDebugF("[FocusEvt] LostFocus id='%s'", rec->id.c_str());
+          return S_OK;
+        });
+      EventRegistrationToken tok2{}; rec->controller->add_LostFocus(lostCb.Get(), (EventRegistrationToken*)&tok2); rec->lostFocusToken = *(WebViewInstanceRecord::EventRegistrationToken*)&tok2;
+    }
+    // Intercept Ctrl+F via AcceleratorKeyPressed to suppress default WebView find dialog
+    if (rec && rec->controller) {
+      EventRegistrationToken accelTok{};
+      rec->controller->add_AcceleratorKeyPressed(Callback<ICoreWebView2AcceleratorKeyPressedEventHandler>(
+        [rec](ICoreWebView2Controller* /*sender*/, ICoreWebView2AcceleratorKeyPressedEventArgs* args)->HRESULT {
+          COREWEBVIEW2_KEY_EVENT_KIND kind; if (FAILED(args->get_KeyEventKind(&kind))) return S_OK;
+          if (kind != COREWEBVIEW2_KEY_EVENT_KIND_KEY_DOWN && kind != COREWEBVIEW2_KEY_EVENT_KIND_SYSTEM_KEY_DOWN) return S_OK;
+          UINT key=0; args->get_VirtualKey(&key);
+          INT modifiers=0; args->get_KeyEventLParam(&modifiers); // modifiers not directly exposed; use GetKeyState as fallback
+          bool ctrl = (GetKeyState(VK_CONTROL)&0x8000)!=0;
+          bool shift = (GetKeyState(VK_SHIFT)&0x8000)!=0;
+          if (ctrl && (key=='F' || key=='f')) {
+            // Mark handled to suppress default dialog
+            args->put_Handled(TRUE);
+            // Show or navigate find bar
+            if (!rec->showFindBar) {
+              rec->showFindBar = true; LogRaw("[AccelCtrlF] show find bar");
+              bool titleVisible = (rec->titleBar && IsWindow(rec->titleBar) && IsWindowVisible(rec->titleBar));
+              LayoutTitleBarAndWebView(rec->hwnd, titleVisible);
+              RWV_WinEnsureFindBarShim(rec->hwnd);
+              if (rec->findEdit && IsWindow(rec->findEdit)) { SetFocus(rec->findEdit); SendMessageW(rec->findEdit, EM_SETSEL, 0, -1); }
+            } else {
+              RWV_WinEnsureFindBarShim(rec->hwnd);
+              if (rec->findEdit && IsWindow(rec->findEdit)) SetFocus(rec->findEdit);
+              g_findEnterActive = true; g_findLastEnterTick = GetTickCount();
+              WinFindNavigate(rec, !shift);
+              LogF("[AccelCtrlF] nav %s query='%s'", shift?"prev":"next", rec->findQuery.c_str());
+              if (rec->findEdit && IsWindow(rec->findEdit)) SendMessageW(rec->findEdit, EM_SETSEL, (WPARAM)-1, (LPARAM)-1);
+            }
+            // Update focus chain explicitly (user intent is on this instance)
+            UpdateFocusChain(rec->id);
+          }
+          return S_OK;
+        }
+      ).Get(), &accelTok);
+    }
+    // Try to acquire native Find interface once controller/webview ready
+    WebViewInstanceRecord* recAcquire = GetInstanceById(activeId);
+    if (recAcquire && recAcquire->webview) {
+      // Query latest extended interface that exposes get_Find (ICoreWebView2_28 onwards). We use raw QueryInterface by IID.
+      // The header might not expose symbolic name; use documented IID via __uuidof trick if available, else skip.
+      // Simplified: attempt to QI for ICoreWebView2_28 by GUID (fallback: ignore if not found).
+      // NOTE: If newer SDK not available in this header subset, this will safely fail.
+      struct ICoreWebView2_28; // forward (avoid including heavy sections)
+      // We cannot directly use __uuidof(ICoreWebView2_28) without full declaration; skip until WinEnsureNativeFind.
+    }
+    wil::com_ptr<ICoreWebView2Settings> settings;
+    if (SUCCEEDED(localWebView->get_Settings(&settings)) && settings)
+      settings->put_AreDefaultContextMenusEnabled(FALSE);
+
+    // JS bridge: ПКМ из WebView2 -> локальное меню (без JS find fallback)
+    {
+      static const wchar_t* kFRZCtxJS = LR"JS(
+        window.addEventListener('contextmenu', function(e){
+          e.preventDefault();
+          var scale = window.devicePixelRatio || 1;
+          var px = Math.round(e.screenX * scale);
+          var py = Math.round(e.screenY * scale);
+          var s = 'CTX|' + px + '|' + py;
+          if (window.chrome && window.chrome.webview) window.chrome.webview.postMessage(s);
+        }, true);
+      )JS";
+      localWebView->AddScriptToExecuteOnDocumentCreated(
+        kFRZCtxJS,
+        Callback<ICoreWebView2AddScriptToExecuteOnDocumentCreatedCompletedHandler>(
+          [](HRESULT /*ec*/, PCWSTR /*id*/) -> HRESULT { return S_OK; }
+        ).Get());
+      localWebView->AddScriptToExecuteOnDocumentCreated(
+        Widen(kStateStreamJS).c_str(),
+        Callback<ICoreWebView2AddScriptToExecuteOnDocumentCreatedCompletedHandler>(
+          [](HRESULT /*ec*/, PCWSTR /*id*/) -> HRESULT { return S_OK; }
+        ).Get());
+      localWebView->AddScriptToExecuteOnDocumentCreated(
+        Widen(kSharedBufferJS).c_str(),
+        Callback<ICoreWebView2AddScriptToExecuteOnDocumentCreatedCompletedHandler>(
+          [](HRESULT /*ec*/, PCWSTR /*id*/) -> HRESULT { return S_OK; }
+        ).Get());
+    }
+
+    // rwv:// assets from the embedded bundle (in-memory, ETag revalidation); with a request filter active
+    // (WebViewApplyContentFilter adds the "*" filter) every other request is checked here as well
+    localWebView->AddWebResourceRequestedFilter(L"rwv://*", COREWEBVIEW2_WEB_RESOURCE_CONTEXT_ALL);
+    localWebView->add_WebResourceRequested(
+      Callback<ICoreWebView2WebResourceRequestedEventHandler>(
+        [activeId](ICoreWebView2*, ICoreWebView2WebResourceRequestedEventArgs* args)->HRESULT {
+          wil::com_ptr<ICoreWebView2WebResourceRequest> req;
+          wil::unique_cotaskmem_string uri;
+          if (!g_sharedEnv || FAILED(args->get_Request(&req)) || !req || FAILED(req->get_Uri(&uri)) || !uri) return S_OK;
+          const std::string url = Narrow(std::wstring(uri.get()));
+          if (_strnicmp(url.c_str(), "rwv:", 4) != 0) {
+            if (ContentFilterBlocks(GetInstanceById(activeId), url.data(), url.size())) {
+              wil::com_ptr<ICoreWebView2WebResourceResponse> blocked;
+              if (SUCCEEDED(g_sharedEnv->CreateWebResourceResponse(nullptr, 403, L"Blocked", L"", &blocked)) && blocked)
+                args->put_Response(blocked.get());
+            }
+            return S_OK;
+          }
+          std::string ifNoneMatch;
+          wil::com_ptr<ICoreWebView2HttpRequestHeaders> reqHeaders;
+          wil::unique_cotaskmem_string inm;
+          if (SUCCEEDED(req->get_Headers(&reqHeaders)) && reqHeaders && SUCCEEDED(reqHeaders->GetHeader(L"If-None-Match", &inm)) && inm)
+            ifNoneMatch = Narrow(std::wstring(inm.get()));
+          AssetReply reply;
+          ServeAppAsset(url, ifNoneMatch.empty() ? nullptr : ifNoneMatch.c_str(), reply);
+          wil::com_ptr<IStream> body;
+          if (reply.body) body.attach(SHCreateMemStream((const BYTE*)reply.body->data(), (UINT)reply.body->size()));
+          const std::wstring headers = L"Content-Type: " + Widen(reply.mime) + L"\r\nETag: " + Widen(reply.etag) +
+                                       L"\r\nCache-Control: no-cache\r\nAccess-Control-Allow-Origin: *";
+          const wchar_t* reason = reply.status == 200 ? L"OK" : reply.status == 304 ? L"Not Modified" : reply.status == 404 ? L"Not Found" : L"Error";
+          wil::com_ptr<ICoreWebView2WebResourceResponse> resp;
+          if (SUCCEEDED(g_sharedEnv->CreateWebResourceResponse(body.get(), reply.status, reason, headers.c_str(), &resp)) && resp)
+            args->put_Response(resp.get());
+          return S_OK;
+        }).Get(), nullptr);
+
+    // Receive 'CTX|x|y' и показать локальное меню
+    localWebView->add_WebMessageReceived(
+      Callback<ICoreWebView2WebMessageReceivedEventHandler>(
+        [hwnd](ICoreWebView2*, ICoreWebView2WebMessageReceivedEventArgs* args)->HRESULT {
+          wil::unique_cotaskmem_string json;
+          if (SUCCEEDED(args->get_WebMessageAsJson(&json)) && json) {
+            std::string s = Narrow(std::wstring(json.get()));
+            if (!s.empty() && s.front()=='"' && s.back()=='"') s = s.substr(1, s.size()-2);
+            if (s.rfind("CTX|", 0) == 0) {
+              int sx=0, sy=0;
+              #ifdef _WIN32
+                sscanf_s(s.c_str()+4, "%d|%d", &sx, &sy);
+              #else
+                sscanf(s.c_str()+4, "%d|%d", &sx, &sy);
+              #endif
+              PostMessage(hwnd, WM_CONTEXTMENU, (WPARAM)hwnd, MAKELPARAM(sx, sy));
+            } else if (IsPageBridgeMessage(s.c_str())) {
+              OnPageBridgeMessage(GetInstanceByHwnd(hwnd), s);
+            }
+          }
+          return S_OK;
+        }).Get(), nullptr);
+
+    // Глушим дефолтное контекстное меню Edge
+    Microsoft::WRL::ComPtr<ICoreWebView2_13> wv13;
+    if (localWebView && SUCCEEDED(localWebView.get()->QueryInterface(IID_PPV_ARGS(&wv13)))) {
+      wv13->add_ContextMenuRequested(
+        Callback<ICoreWebView2ContextMenuRequestedEventHandler>(
+          [](ICoreWebView2*, ICoreWebView2ContextMenuRequestedEventArgs* args)->HRESULT {
+            args->put_Handled(TRUE);
+            return S_OK;
+          }).Get(),
+        nullptr);
+    }
+
+    localWebView->add_DocumentTitleChanged(
+      Callback<ICoreWebView2DocumentTitleChangedEventHandler>(
+        [activeId, hwnd](ICoreWebView2*, IUnknown*)->HRESULT
+        {
+          WebViewInstanceRecord* r = GetInstanceById(activeId);
+          HWND target = (r && r->hwnd && IsWindow(r->hwnd)) ? r->hwnd : (IsWindow(hwnd)?hwnd:NULL);
+          if (target) RequestTitlesRefresh(target); else LogF("[CallbackSkip] TitleChanged dead hwnd activeId='%s'", activeId.c_str());
+          return S_OK;
+        }).Get(), nullptr);
+
+    localWebView->add_NavigationStarting(
+      Callback<ICoreWebView2NavigationStartingEventHandler>(
+        [activeId, hwnd](ICoreWebView2*, ICoreWebView2NavigationStartingEventArgs* args)->HRESULT
+        {
+          wil::unique_cotaskmem_string uri;
+          if (args && SUCCEEDED(args->get_Uri(&uri))) LogF("[NavigationStarting] %S", uri.get());
+          WebViewInstanceRecord* r = GetInstanceById(activeId);
+          if (r) r->stats.NavStarted(PerfNowUs());
+          HWND target = (r && r->hwnd && IsWindow(r->hwnd)) ? r->hwnd : (IsWindow(hwnd)?hwnd:NULL);
+          if (target) RequestTitlesRefresh(target); else LogF("[CallbackSkip] NavStarting dead hwnd activeId='%s'", activeId.c_str());
+          return S_OK;
+        }).Get(), nullptr);
+
+    localWebView->add_NavigationCompleted(
+      Callback<ICoreWebView2NavigationCompletedEventHandler>(
+        [activeId, hwnd](ICoreWebView2*, ICoreWebView2NavigationCompletedEventArgs* args)->HRESULT
+        {
+          BOOL ok = FALSE; if (args) args->get_IsSuccess(&ok);
+          COREWEBVIEW2_WEB_ERROR_STATUS st = COREWEBVIEW2_WEB_ERROR_STATUS_UNKNOWN;
+          if (args) args->get_WebErrorStatus(&st);
+          LogF("[NavigationCompleted] ok=%d status=%d", (int)ok, (int)st);
+          WebViewInstanceRecord* r = GetInstanceById(activeId);
+          HWND target = (r && r->hwnd && IsWindow(r->hwnd)) ? r->hwnd : (IsWindow(hwnd)?hwnd:NULL);
+          if (target) RequestTitlesRefresh(target); else LogF("[CallbackSkip] NavCompleted dead hwnd activeId='%s'", activeId.c_str());
+          if (r && ok) OnInstancePageLoaded(r);
+          else if (r) r->stats.NavFinished(PerfNowUs(), false);
+          return S_OK;
+        }).Get(), nullptr);
+  }
+
+  RECT rc; GetClientRect(hwnd, &rc);
+  LayoutTitleBarAndWebView(hwnd, false);
+  controller->put_IsVisible(TRUE);
+  LogRaw("Navigate initial URL...");
+  WebViewInstanceRecord* recInit = GetInstanceById(activeId);
+  if (recInit) { recInit->contentFilterInstalled = false; WebViewApplyContentFilter(recInit); } // before the first request
+  if (recInit && recInit->webview) recInit->webview->Navigate(wurl.c_str());
+  RequestTitlesRefresh(hwnd);
+}
+
+void StartWebView(HWND hwnd, const std::string& initial_url)
+{
+  std::wstring wurl(initial_url.begin(), initial_url.end());
+  // Determine current active instance id for association
+  std::string activeId = g_instanceId.empty()?std::string("wv_default"):g_instanceId;
+  const DWORD t0 = GetTickCount();
+
+  WithSharedEnvironment([hwnd, wurl, activeId, t0](ICoreWebView2Environment* env)
+  {
+    if (!IsWindow(hwnd)) { LogF("[StartWebView] host gone before environment was ready id='%s'", activeId.c_str()); return; }
+    if (ICoreWebView2Controller* pooled = TakePooledController(hwnd)) {
+      LogF("[Pool] id='%s' attached parked controller after %lu ms", activeId.c_str(), (unsigned long)(GetTickCount() - t0));
+      AttachControllerToInstance(hwnd, wurl, activeId, env, pooled);
+      pooled->Release(); // the record took its own reference
+      ReplenishControllerPool(env);
+      return;
+    }
+    env->CreateCoreWebView2Controller(hwnd,
+      Callback<ICoreWebView2CreateCoreWebView2ControllerCompletedHandler>(
+        [hwnd, wurl, activeId, env, t0](HRESULT result, ICoreWebView2Controller* controller)->HRESULT
+        {
+          LogF("[ControllerCompleted] hr=0x%lX controller=%p after %lu ms", (long)result, (void*)controller, (unsigned long)(GetTickCount() - t0));
+          if (!controller) return S_OK;
+          AttachControllerToInstance(hwnd, wurl, activeId, env, controller);
+          ReplenishControllerPool(env);
+          return S_OK;
+        }).Get());
+  });
 }
 
 // ================= Native Find helpers =================
@@ -390,7 +556,7 @@ void WinEnsureNativeFind(WebViewInstanceRecord* rec)
     [rec](ICoreWebView2Find*, IUnknown*)->HRESULT { WinNativeFindUpdateCounters(rec); return S_OK; }
   ).Get(), (EventRegistrationToken*)&rec->nativeFindActiveToken);
   auto hr2 = rec->nativeFind->add_MatchCountChanged(Callback<ICoreWebView2FindMatchCountChangedEventHandler>(
-    [rec](ICoreWebView2Find*, IUnknown*)->HRESULT { WinNativeFindUpdateCounters(rec); return S_OK; }
+    [rec](ICoreWebView2Find*, IUnknown*)->HRESULT { WinNativeFindUpdateCounters(rec); rec->stats.FindCounted(PerfNowUs(), rec->findTotalMatches); return S_OK; }
   ).Get(), (EventRegistrationToken*)&rec->nativeFindCountToken);
   LogF("[FindNative] ready find=%p opts=%p ev1=0x%lX ev2=0x%lX", (void*)rec->nativeFind, (void*)rec->nativeFindOpts, (long)hr1, (long)hr2);
 }
@@ -433,6 +599,7 @@ void WinFindStartOrUpdate(WebViewInstanceRecord* rec)
   // If previously active and query changed, stop to start a new session from top
   if (rec->nativeFindActive) rec->nativeFind->Stop();
   rec->nativeFindActive = true;
+  rec->stats.FindStarted(PerfNowUs()); // closed by the next MatchCountChanged
   HRESULT hrStart = rec->nativeFind->Start(rec->nativeFindOpts, Callback<ICoreWebView2FindStartCompletedHandler>(
     [rec](HRESULT /*result*/) -> HRESULT { /* initial events will follow */ return S_OK; }
   ).Get());
@@ -462,6 +629,194 @@ void WinFindClose(WebViewInstanceRecord* rec)
   }
 }
 
+// ================= Script / hibernation hooks =================
+void WebViewEvalScript(WebViewInstanceRecord* rec, const std::string& js, ScriptResultFn fn)
+{
+  if (!rec || !rec->webview) { if (fn) fn(rec ? rec->id : std::string(), std::string()); return; }
+  const std::string id = rec->id;
+  rec->stats.BridgeOut(js.size());
+  rec->webview->ExecuteScript(Widen(js).c_str(), Callback<ICoreWebView2ExecuteScriptCompletedHandler>(
+    [id, fn](HRESULT hr, LPCWSTR json) -> HRESULT {
+      if (!fn) return S_OK;
+      std::string out;
+      if (SUCCEEDED(hr) && json) {
+        // ExecuteScript hands back JSON: unquote strings, pass anything else through verbatim
+        const std::string raw = Narrow(json);
+        JsonCursor c(raw.data(), raw.size()); JsonValue v;
+        if (c.ReadValue(v) && v.type == JsonType::String) {
+          std::vector<char> buf(raw.size() + 1); JsonCopyString(v, buf.data(), buf.size()); out = buf.data();
+        } else if (raw != "null") out = raw;
+      }
+      fn(id, out);
+      return S_OK;
+    }).Get());
+}
+
+// CapturePreview only writes PNG: the bytes go to the capture worker as they are (written through for a
+// full-size PNG, decoded there with WebViewDecodeSnapshot otherwise), nothing is decoded on the UI thread
+void WebViewSnapshot(WebViewInstanceRecord* rec, int token, SnapshotFn fn)
+{
+  if (!rec || !rec->webview) { fn(rec ? rec->id : std::string(), token, nullptr, "no view"); return; }
+  const std::string id = rec->id;
+  wil::com_ptr<IStream> stream;
+  stream.attach(SHCreateMemStream(nullptr, 0));
+  if (!stream) { fn(id, token, nullptr, "cannot create stream"); return; }
+  HRESULT hr = rec->webview->CapturePreview(COREWEBVIEW2_CAPTURE_PREVIEW_IMAGE_FORMAT_PNG, stream.get(),
+    Callback<ICoreWebView2CapturePreviewCompletedHandler>(
+      [id, token, fn, stream](HRESULT res) -> HRESULT {
+        CapturePixels px;
+        STATSTG st{};
+        if (SUCCEEDED(res) && SUCCEEDED(stream->Stat(&st, STATFLAG_NONAME)) && st.cbSize.QuadPart > 0) {
+          px.encoded.resize((size_t)st.cbSize.QuadPart);
+          LARGE_INTEGER zero{}; ULONG got = 0;
+          if (FAILED(stream->Seek(zero, STREAM_SEEK_SET, nullptr)) || FAILED(stream->Read(px.encoded.data(), (ULONG)px.encoded.size(), &got))) got = 0;
+          px.encoded.resize(got);
+        }
+        if (px.encoded.empty()) { LogF("[Capture] CapturePreview failed id='%s' hr=0x%lX", id.c_str(), (long)res); fn(id, token, nullptr, "CapturePreview failed"); }
+        else fn(id, token, &px, nullptr);
+        return S_OK;
+      }).Get());
+  if (FAILED(hr)) { LogF("[Capture] CapturePreview refused id='%s' hr=0x%lX", id.c_str(), (long)hr); fn(id, token, nullptr, "CapturePreview failed"); }
+}
+
+bool WebViewDecodeSnapshot(const uint8_t* data, size_t len, CapturePixels& out)
+{
+  static thread_local bool s_com = false; // capture worker: its own MTA
+  if (!s_com) { CoInitializeEx(nullptr, COINIT_MULTITHREADED); s_com = true; }
+  wil::com_ptr<IWICImagingFactory> fac;
+  wil::com_ptr<IWICStream> stream;
+  wil::com_ptr<IWICBitmapDecoder> dec;
+  wil::com_ptr<IWICBitmapFrameDecode> frame;
+  wil::com_ptr<IWICFormatConverter> conv;
+  if (FAILED(CoCreateInstance(CLSID_WICImagingFactory, nullptr, CLSCTX_INPROC_SERVER, IID_PPV_ARGS(&fac)))) return false;
+  if (FAILED(fac->CreateStream(&stream)) || FAILED(stream->InitializeFromMemory((BYTE*)data, (DWORD)len))) return false;
+  if (FAILED(fac->CreateDecoderFromStream(stream.get(), nullptr, WICDecodeMetadataCacheOnLoad, &dec))) return false;
+  if (FAILED(dec->GetFrame(0, &frame)) || FAILED(fac->CreateFormatConverter(&conv))) return false;
+  if (FAILED(conv->Initialize(frame.get(), GUID_WICPixelFormat32bppBGRA, WICBitmapDitherTypeNone, nullptr, 0.0, WICBitmapPaletteTypeCustom))) return false;
+  UINT w = 0, h = 0;
+  if (FAILED(frame->GetSize(&w, &h)) || !w || !h) return false;
+  out.w = (int)w; out.h = (int)h; out.rowBytes = (int)w * 4; out.premultiplied = false;
+  out.px.resize((size_t)out.rowBytes * h);
+  return SUCCEEDED(conv->CopyPixels(nullptr, (UINT)out.rowBytes, (UINT)out.px.size(), out.px.data()));
+}
+
+// PostWebMessageAsJson: no script compilation, no result marshalling (the page side listens on chrome.webview)
+void WebViewPostState(WebViewInstanceRecord* rec, const std::string& json)
+{
+  if (!rec || !rec->webview) return;
+  rec->stats.BridgeOut(json.size());
+  rec->webview->PostWebMessageAsJson(Widen("{\"rwvState\":" + json + "}").c_str());
+}
+
+// Shared buffers: memory from ICoreWebView2Environment12::CreateSharedBuffer, mapped read-only into the page
+// once per document (PostSharedBufferToScript); later publishes are a {"rwvBuffer":name} message only.
+// Runtimes without shared buffers fall back to heap memory and base64 publishes.
+void WebViewSharedBufferAlloc(WebViewInstanceRecord* rec, SharedBufferSlot& slot, uint32_t capacity)
+{
+  ICoreWebView2SharedBuffer* old = (ICoreWebView2SharedBuffer*)slot.native;
+  Microsoft::WRL::ComPtr<ICoreWebView2Environment12> env12;
+  ICoreWebView2SharedBuffer* buf = nullptr; BYTE* mem = nullptr;
+  if (rec && rec->environment && SUCCEEDED(rec->environment->QueryInterface(IID_PPV_ARGS(&env12))) && env12 &&
+      SUCCEEDED(env12->CreateSharedBuffer(SharedBufferSlot::BytesFor(capacity), &buf)) && buf &&
+      SUCCEEDED(buf->get_Buffer(&mem)) && mem) {
+    slot.AdoptMapped(mem, capacity, buf);
+  } else {
+    if (buf) buf->Release();
+    slot.AllocHeap(capacity); // copies what the old memory held before it is closed below
+  }
+  if (old) { old->Close(); old->Release(); }
+}
+
+void WebViewSharedBufferPublish(WebViewInstanceRecord* rec, SharedBufferSlot& slot)
+{
+  if (!rec || !rec->webview) return;
+  if (!slot.mapped) {
+    const std::string js = SharedBufferPutScript(slot);
+    slot.bytesShipped += js.size();
+    WebViewEvalScript(rec, js, nullptr);
+    return;
+  }
+  const std::wstring meta = L"{\"rwvBuffer\":\"" + Widen(slot.name) + L"\"}";
+  if (!slot.attached) {
+    Microsoft::WRL::ComPtr<ICoreWebView2_17> wv17;
+    if (FAILED(rec->webview->QueryInterface(IID_PPV_ARGS(&wv17))) || !wv17) return;
+    if (SUCCEEDED(wv17->PostSharedBufferToScript((ICoreWebView2SharedBuffer*)slot.native, COREWEBVIEW2_SHARED_BUFFER_ACCESS_READ_ONLY, meta.c_str())))
+      slot.attached = true; // the page publishes on receipt
+    return;
+  }
+  rec->webview->PostWebMessageAsJson(meta.c_str());
+}
+
+void WebViewSharedBufferFree(SharedBufferSlot& slot)
+{
+  if (ICoreWebView2SharedBuffer* b = (ICoreWebView2SharedBuffer*)slot.native) { b->Close(); b->Release(); }
+  slot.native = nullptr; slot.mem = nullptr; slot.mapped = slot.attached = false;
+  slot.heap.clear();
+}
+
+// WebResourceRequested only fires for URLs matching a filter: "*" is added while the instance has a
+// request filter and removed again when it is switched off (rwv://* stays for the assets)
+void WebViewApplyContentFilter(WebViewInstanceRecord* rec)
+{
+  if (!rec || !rec->webview) return;
+  const bool want = ContentFilterFor(rec) != nullptr;
+  if (want == rec->contentFilterInstalled) return;
+  const HRESULT hr = want ? rec->webview->AddWebResourceRequestedFilter(L"*", COREWEBVIEW2_WEB_RESOURCE_CONTEXT_ALL)
+                          : rec->webview->RemoveWebResourceRequestedFilter(L"*", COREWEBVIEW2_WEB_RESOURCE_CONTEXT_ALL);
+  if (SUCCEEDED(hr)) rec->contentFilterInstalled = want;
+  LogF("[Filter][win] id='%s' %s hr=0x%lX", rec->id.c_str(), want ? "on" : "off", (long)hr);
+}
+
+bool WebViewCanSuspend() { return true; }
+
+bool WebViewSuspend(WebViewInstanceRecord* rec)
+{
+  if (!rec || !rec->webview || !rec->controller) return false;
+  Microsoft::WRL::ComPtr<ICoreWebView2_3> wv3;
+  if (FAILED(rec->webview->QueryInterface(IID_PPV_ARGS(&wv3))) || !wv3) return false;
+  rec->controller->put_IsVisible(FALSE); // TrySuspend requires a hidden web view
+  const std::string id = rec->id;
+  HRESULT hr = wv3->TrySuspend(Callback<ICoreWebView2TrySuspendCompletedHandler>(
+    [id](HRESULT res, BOOL ok) -> HRESULT {
+      LogF("[Hibernate] TrySuspend id='%s' hr=0x%lX suspended=%d", id.c_str(), (long)res, (int)ok);
+      return S_OK;
+    }).Get());
+  return SUCCEEDED(hr);
+}
+
+void WebViewResume(WebViewInstanceRecord* rec)
+{
+  if (!rec || !rec->webview || !rec->controller) return;
+  Microsoft::WRL::ComPtr<ICoreWebView2_3> wv3;
+  if (SUCCEEDED(rec->webview->QueryInterface(IID_PPV_ARGS(&wv3))) && wv3) wv3->Resume();
+  rec->controller->put_IsVisible(TRUE);
+}
+
+bool WebViewIsPlayingAudio(WebViewInstanceRecord* rec)
+{
+  if (!rec || !rec->webview) return false;
+  Microsoft::WRL::ComPtr<ICoreWebView2_8> wv8; BOOL playing = FALSE;
+  if (SUCCEEDED(rec->webview->QueryInterface(IID_PPV_ARGS(&wv8))) && wv8) wv8->get_IsDocumentPlayingAudio(&playing);
+  return playing != FALSE;
+}
+
+bool WebViewHasView(WebViewInstanceRecord* rec) { return rec && rec->controller; }
+
+void WebViewDestroyView(WebViewInstanceRecord* rec)
+{
+  if (!rec) return;
+  WinFindClose(rec);
+  if (rec->controller) {
+    if (rec->gotFocusToken.value)  rec->controller->remove_GotFocus(*(::EventRegistrationToken*)&rec->gotFocusToken);
+    if (rec->lostFocusToken.value) rec->controller->remove_LostFocus(*(::EventRegistrationToken*)&rec->lostFocusToken);
+    rec->gotFocusToken = {}; rec->lostFocusToken = {};
+    rec->controller->Close(); rec->controller->Release(); rec->controller = nullptr;
+  }
+  if (rec->webview)     { rec->webview->Release();     rec->webview = nullptr; rec->contentFilterInstalled = false; }
+  if (rec->environment) { rec->environment->Release(); rec->environment = nullptr; }
+  g_instances.SetNativeView(rec, nullptr);
+}
+
 void NavigateExisting(const std::string& url)
 {
   if (url.empty()) return;
@@ -482,7 +837,7 @@ void NavigateExistingInstance(const std::string& instanceId, const std::string&
   std::wstring wurl(url.begin(), url.end());
   HRESULT hr = rec->webview->Navigate(wurl.c_str());
   LogF("[NavigateExistingInstance] id='%s' Navigate('%s') hr=0x%lX", instanceId.c_str(), url.c_str(), (long)hr);
-  rec->lastUrl = url;
+  rec->lastUrl = url; MarkInstanceStateDirty();
 }
 
 #endif // _WIN32
@@ -0,0 +1,13 @@
+(function () {
+  var S = window.__rwvState;
+  if (!S) return;
+  var names = { 0: 'stopped', 1: 'playing', 2: 'paused', 5: 'recording', 6: 'rec paused' };
+  function fmt(t) { var m = Math.floor(t / 60), s = t - m * 60; return m + ':' + (s < 10 ? '0' : '') + s.toFixed(3); }
+  S.onchange = function (d, st) {
+    var t = st.transport;
+    if (t.play !== undefined) document.getElementById('play').textContent = names[t.play] || t.play;
+    if (t.pos !== undefined) document.getElementById('pos').textContent = fmt(t.pos);
+    if (t.bpm !== undefined) document.getElementById('bpm').textContent = t.bpm.toFixed(2);
+  };
+  S.subscribe(['transport'], 30);
+})();